@@ -92,6 +92,8 @@ private:
     SerialIdentifier jack;
     SimpleTimer emitMacTimer;
     const int emitMacInterval = 250;
+    // Built on the first emit; nothing in it changes afterwards
+    std::string macBeacon;
     bool transitionToSendIdState = false;
 };
 
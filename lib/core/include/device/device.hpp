@@ -75,6 +75,14 @@ public:
         return targetDriver ? static_cast<T*>(targetDriver->abstractSelf()) : nullptr;
     }
 
+    // Per-driver and per-state tick timing; nullptr unless built with
+    // LOOP_PROFILING (see utils/loop-profiler.hpp).
+#ifdef LOOP_PROFILING
+    LoopProfiler* getLoopProfiler() { return &loopProfiler; }
+#else
+    LoopProfiler* getLoopProfiler() { return nullptr; }
+#endif
+
 protected:
     explicit Device(const DriverConfig& deviceConfig) : driverManager(deviceConfig) {
         driverManager.initialize();
@@ -84,4 +92,7 @@ private:
     DriverManager driverManager;
     AppConfig appConfig;
     StateId currentAppId;
+#ifdef LOOP_PROFILING
+    LoopProfiler loopProfiler;
+#endif
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "driver-interface.hpp"
+#include "utils/loop-profiler.hpp"
 #include <map>
 #include <utility>
 #include <functional>
@@ -29,6 +30,16 @@ class DriverManager {
         }
     }
 
+#ifdef LOOP_PROFILING
+    // execDrivers(), timing each exec() into its own section
+    void execDrivers(LoopProfiler& profiler) {
+        for(auto& driver : driverConfig) {
+            LoopProfileScope scope(profiler, profiler.driverSection(driver.first.c_str()));
+            driver.second->exec();
+        }
+    }
+#endif
+
     void dismountDrivers() {
         for(auto& driver : driverConfig) {
             delete driver.second;
@@ -3,6 +3,11 @@
 #include <cstdint>
 #include <functional>
 #include "peer-comms-types.hpp"
+#include "wireless/send-queue.hpp"
+#include "wireless/link-quality.hpp"
+#include "wireless/multicast-group.hpp"
+#include "wireless/bulk-transfer.hpp"
+#include "wireless/traffic-stats.hpp"
 
 enum class PeerCommsState {
     CONNECTED,
@@ -14,14 +19,81 @@ public:
     using PacketCallback = std::function<void(const uint8_t* src, const uint8_t* data, const size_t length, void* ctx)>;
 
     virtual ~PeerCommsInterface() = default;
+    // Queues `data` as one packet. Returns -1 if it is longer than
+    // MAX_SEND_PACKET_LEN (see sendBulk()) or can't be queued right now.
     virtual int sendData(const uint8_t* dst, PktType packetType, const uint8_t* data, const size_t length) = 0;
+
+    // Same as sendData() with an explicit priority class and deadline. Drivers
+    // without a prioritized send queue ignore the options.
+    virtual int sendData(const uint8_t* dst, PktType packetType, const uint8_t* data, const size_t length,
+                         const SendOptions& options) {
+        (void)options;
+        return sendData(dst, packetType, data, length);
+    }
+
+    // One broadcast frame to every peer that joined `group`; see
+    // MulticastMembership. Returns -1 if the driver has no multicast support,
+    // in which case callers fall back to unicast.
+    virtual int sendMulticast(MulticastGroup group, PktType packetType, const uint8_t* data, const size_t length,
+                              const SendOptions& options) {
+        (void)group; (void)packetType; (void)data; (void)length; (void)options;
+        return -1;
+    }
+
+    // Start or stop accepting multicasts addressed to `group`.
+    virtual int joinMulticastGroup(MulticastGroup group) { (void)group; return -1; }
+    virtual void leaveMulticastGroup(MulticastGroup group) { (void)group; }
     virtual void setPacketHandler(PktType packetType, PacketCallback callback, void* ctx) = 0;
     virtual void clearPacketHandler(PktType packetType) = 0;
+
+    // Drop repeats of a `packetType` packet, identified by the sequence byte at
+    // `seqOffset` in its payload, before its handler runs; see DuplicateFilter.
+    // `onDuplicate` (optional) sees each dropped repeat so the receiver can
+    // re-ACK it. Drivers without a filter deliver everything, so handlers keep
+    // their own idempotence checks.
+    virtual void setDuplicateSuppression(PktType packetType, uint8_t seqOffset,
+                                         PacketCallback onDuplicate, void* ctx) {
+        (void)packetType; (void)seqOffset; (void)onDuplicate; (void)ctx;
+    }
+    virtual void clearDuplicateSuppression(PktType packetType) { (void)packetType; }
+
+    // Bundle small control messages (acks, confirms, role announcements) sent
+    // to the same destination within one exec() into a single frame; see
+    // PacketCoalescer. Drivers without bundling send each message on its own.
+    virtual void setCoalescingEnabled(bool enabled) { (void)enabled; }
+
+    // Windowed, receiver-paced transfer of a message too large for sendData()
+    // (see BulkTransfer). Returns a transfer id (> 0) to poll with
+    // getBulkTransferStatus(), or -1 if the driver has no bulk support or
+    // cannot start another transfer. The receiver's handler for `channel`
+    // gets the whole message once its checksum has been verified.
+    virtual int sendBulk(const uint8_t* dst, uint8_t channel, const uint8_t* data, const size_t length) {
+        (void)dst; (void)channel; (void)data; (void)length;
+        return -1;
+    }
+    virtual bool getBulkTransferStatus(int transferId, BulkTransferStatus& out) {
+        (void)transferId; (void)out;
+        return false;
+    }
+    virtual void cancelBulkTransfer(int transferId) { (void)transferId; }
+    virtual void setBulkHandler(uint8_t channel, PacketCallback callback, void* ctx) {
+        (void)channel; (void)callback; (void)ctx;
+    }
+    virtual void clearBulkHandler(uint8_t channel) { (void)channel; }
     virtual const uint8_t* getGlobalBroadcastAddress() = 0;
     virtual uint8_t* getMacAddress() = 0;
     virtual void removePeer(uint8_t* macAddr) = 0;
     virtual int addEspNowPeer(const uint8_t* macAddr) = 0;
     virtual int removeEspNowPeer(const uint8_t* macAddr) = 0;
+
+    // Registers a peer that must survive peer-table pressure (direct jack
+    // peers, the chain champion). Unpinned peers are evicted least recently
+    // used first when the table is full. Drivers without a bounded table
+    // treat this as addEspNowPeer().
+    virtual int pinEspNowPeer(const uint8_t* macAddr) { return addEspNowPeer(macAddr); }
+
+    // Makes a pinned peer evictable again without removing it.
+    virtual void unpinEspNowPeer(const uint8_t* macAddr) { (void)macAddr; }
     virtual void setPeerCommsState(PeerCommsState state) = 0;
     virtual PeerCommsState getPeerCommsState() = 0;
     virtual void connect() = 0;
@@ -30,6 +102,22 @@ public:
     // Returns the last observed RSSI for a peer, or -1 if unknown/unavailable.
     virtual int getRssiForPeer(const uint8_t* macAddr) { (void)macAddr; return -1; }
 
+    // Protocol-level ACK round trip toward a peer, for the link-quality table.
+    virtual void reportAckRtt(const uint8_t* macAddr, unsigned long rttMs) { (void)macAddr; (void)rttMs; }
+
+    // Smoothed delivery ratio, RTT and RSSI for a peer. False if the driver
+    // keeps no estimates or knows nothing about the peer yet.
+    virtual bool getLinkEstimate(const uint8_t* macAddr, LinkEstimate& out) {
+        (void)macAddr; (void)out;
+        return false;
+    }
+
+    // Frames, bytes, fragments, failures and queueing delay per packet type and
+    // direction since the last reset; see TrafficStats. False if the driver
+    // keeps no counters.
+    virtual bool getTrafficSnapshot(TrafficStats::Snapshot& out) { (void)out; return false; }
+    virtual void resetTrafficStats() {}
+
 protected:
 
 };
\ No newline at end of file
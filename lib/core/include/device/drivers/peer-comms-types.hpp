@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 //PktType determines which callback will handle the packet on the receiving end
@@ -20,6 +21,11 @@ enum class PktType : uint8_t
     kShootoutCommandAck = 12,
     kSymbolMatchCommand = 13,
     kFdnConnect = 14,
+    kFragmentNack = 15,      //Transport-level, consumed by the driver (FragmentNackPayload)
+    kMulticast = 16,         //Transport-level, MulticastHdr + inner payload; unwrapped by the driver
+    kBundle = 17,            //Transport-level, BundleEntryHdr + payload repeated; unwrapped by the driver
+    kBulkTransfer = 18,      //Transport-level, BulkHdr + op fields; consumed by the driver's BulkTransfer
+    kLinkCaps = 19,          //Transport-level, LinkCapsPayload; consumed by the driver
     kNumPacketTypes //Not a real packet type, DO NOT USE
 };
 
@@ -32,6 +38,125 @@ struct DataPktHdr
     uint8_t idxInCluster;
 } __attribute__((packed));
 
+//Largest frame the radio carries in one transmission (ESP_NOW_MAX_DATA_LEN)
+constexpr size_t PEER_COMMS_MAX_FRAME_LEN = 250;
+//Payload bytes per frame once the cluster header is accounted for
+constexpr size_t PEER_COMMS_MAX_FRAME_PAYLOAD = PEER_COMMS_MAX_FRAME_LEN - sizeof(DataPktHdr);
+
+//ESP-NOW v2 (IDF 5.4+) frames, used toward peers whose LinkCapsPayload says
+//they take them (ESP_NOW_MAX_DATA_LEN_V2)
+constexpr size_t PEER_COMMS_MAX_FRAME_LEN_V2 = 1470;
+constexpr size_t PEER_COMMS_MAX_FRAME_PAYLOAD_V2 = PEER_COMMS_MAX_FRAME_LEN_V2 - sizeof(DataPktHdr);
+
+//pktLen of every frame in a cluster sent in v2 frames, which don't fit the
+//length byte. The frame length comes from the radio instead, and every
+//fragment but the last carries PEER_COMMS_MAX_FRAME_PAYLOAD_V2 bytes.
+constexpr uint8_t DATA_PKT_LEN_LONG = 0;
+
+//Sent to a unicast peer the first time it is added to the peer table, so each
+//side learns the largest frame the other can receive. Until a peer's caps
+//arrive it is sent PEER_COMMS_MAX_FRAME_LEN frames; broadcasts always are.
+struct LinkCapsPayload
+{
+    uint16_t maxFrameLen;
+    uint8_t flags;          //LINK_CAPS_*
+} __attribute__((packed));
+
+//The receiver should answer with its own caps
+constexpr uint8_t LINK_CAPS_REPLY_REQUESTED = 0x01;
+
+//Sent by a receiver holding an incomplete cluster: asks the sender to repeat
+//only the fragments whose bit is set in `missing` (bit i = idxInCluster i)
+struct FragmentNackPayload
+{
+    PktType packetType;
+    uint8_t numPktsInCluster;
+    uint8_t missing[32];
+} __attribute__((packed));
+
+//Prefixes a broadcast payload addressed to a multicast group. Receivers that
+//haven't joined `group` drop it; members see an ordinary `packetType` packet.
+struct MulticastHdr
+{
+    uint16_t group;
+    PktType packetType;
+} __attribute__((packed));
+
+//Precedes each small message packed into a kBundle payload; `length` bytes of
+//`packetType` payload follow
+struct BundleEntryHdr
+{
+    PktType packetType;
+    uint8_t length;
+} __attribute__((packed));
+
+//Bulk transfer messages. OPEN, DATA and CANCEL travel sender -> receiver;
+//CREDIT and REFUSE travel back. `transferId` is chosen by the sender.
+enum class BulkOp : uint8_t
+{
+    OPEN = 0,
+    DATA = 1,
+    CREDIT = 2,
+    CANCEL = 3,
+    REFUSE = 4,
+};
+
+enum class BulkRefuseReason : uint8_t
+{
+    NO_HANDLER = 0,         //nothing listens on the channel
+    TOO_LARGE = 1,
+    NO_ROOM = 2,            //every incoming slot is busy
+    UNKNOWN_TRANSFER = 3,   //DATA for a transfer the receiver doesn't hold
+    CORRUPT = 4,            //checksum mismatch once complete
+};
+
+struct BulkHdr
+{
+    BulkOp op;
+    uint16_t transferId;
+} __attribute__((packed));
+
+struct BulkOpenPayload
+{
+    BulkHdr hdr;
+    uint8_t channel;
+    uint32_t totalLength;
+    uint32_t crc32;
+} __attribute__((packed));
+
+//Followed by the chunk's bytes
+struct BulkDataHdr
+{
+    BulkHdr hdr;
+    uint32_t offset;
+} __attribute__((packed));
+
+//Everything below ackOffset has arrived; the sender may send up to windowEnd
+struct BulkCreditPayload
+{
+    BulkHdr hdr;
+    uint32_t ackOffset;
+    uint32_t windowEnd;
+} __attribute__((packed));
+
+struct BulkRefusePayload
+{
+    BulkHdr hdr;
+    BulkRefuseReason reason;
+} __attribute__((packed));
+
+//Followed by `peerCount` MACs (6 bytes each)
+struct ChainAnnouncementHdr
+{
+    uint8_t announcementId;
+    uint8_t peerCount;
+} __attribute__((packed));
+
+struct ChainAnnouncementAckPayload
+{
+    uint8_t announcementId;
+} __attribute__((packed));
+
 struct ChainConfirmPayload
 {
     uint8_t originatorMac[6];
@@ -4,4 +4,13 @@ class PlatformClock {
 public:
     virtual ~PlatformClock() = default;
     virtual unsigned long milliseconds() = 0;
-};
\ No newline at end of file
+
+    // For timing code rather than scheduling it; wraps like milliseconds().
+    // Clocks without a finer source report milliseconds() * 1000.
+    virtual unsigned long microseconds() { return milliseconds() * 1000UL; }
+
+    // Called by SimpleTimer::setTimer() with the first time at which the
+    // timer reads as expired. Hardware clocks ignore it; a simulated clock
+    // uses it to skip idle time straight to the next deadline.
+    virtual void onTimerArmed(unsigned long deadlineMs) { (void)deadlineMs; }
+};
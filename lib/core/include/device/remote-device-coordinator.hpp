@@ -7,6 +7,8 @@
 #include "device/serial-manager.hpp"
 #include "utils/simple-timer.hpp"
 #include "wireless/handshake-wireless-manager.hpp"
+#include "wireless/reliable-channel.hpp"
+#include "wireless/packet-registry.hpp"
 #include "device/device-type.hpp"
 
 class Device;
@@ -25,6 +27,15 @@ enum class PortStatus {
         std::vector<std::array<uint8_t, 6>> peerMacAddresses;
 };
 
+// Chain announcement wire format: [id(1)][count(1)][mac(6)]*count.
+// Replaces `out` with the encoded announcement and returns its length.
+size_t encodeChainAnnouncement(uint8_t announcementId, const std::vector<std::array<uint8_t, 6>>& peers,
+                               std::vector<uint8_t>& out);
+
+// Replaces `peers` with the announced MACs. The length must already have
+// been checked against peerCount (packetHandler<> does).
+void decodeChainAnnouncement(const ChainAnnouncementHdr& announcement, std::vector<std::array<uint8_t, 6>>& peers);
+
 class RemoteDeviceCoordinator {
 public:
     RemoteDeviceCoordinator();
@@ -62,6 +73,12 @@ public:
     // Reachable via either jack (direct peer or daisy-chained).
     virtual bool canReachPeer(const uint8_t* mac) const;
 
+    // `mac` is among getPortState(port).peerMacAddresses, without copying them.
+    bool portHasPeer(SerialIdentifier port, const uint8_t* mac) const;
+
+    // Some peer is reachable through both ports, i.e. they close a ring.
+    bool portsSharePeer(SerialIdentifier a, SerialIdentifier b) const;
+
     /**
      * Called when a chain announcement is received from a direct peer.
      * Replaces the port's daisy-chained peer list with the announced list,
@@ -77,52 +94,45 @@ public:
     // Direct peer drops only; daisy-chained drops arrive via chain announcements.
     void setPeerLostCallback(std::function<void(const uint8_t*)> callback);
 
-    void processChainAnnouncementPacket(const uint8_t* fromMac, const uint8_t* data, size_t dataLen);
+    // Header plus `peerCount` MACs; length already checked by packetHandler<>
+    void processChainAnnouncementPacket(const uint8_t* fromMac, const ChainAnnouncementHdr& announcement, size_t dataLen);
 
     using AnnouncementEmitCallback = std::function<void(const uint8_t* toMac, uint8_t announcementId, const std::vector<std::array<uint8_t, 6>>& peers)>;
     void setAnnouncementEmitCallback(AnnouncementEmitCallback callback);
 
-    void processChainAnnouncementAckPacket(const uint8_t* fromMac, const uint8_t* data, size_t dataLen);
+    void processChainAnnouncementAckPacket(const uint8_t* fromMac, const ChainAnnouncementAckPayload& ack, size_t dataLen);
 
     void registerPeer(const uint8_t* macAddress);
     void unregisterPeer(const uint8_t* macAddress);
 
+    // Registers a peer the ESP-NOW peer table must never evict (direct jack
+    // peers, the chain champion). unpinPeer() returns it to LRU eviction.
+    void pinPeer(const uint8_t* macAddress);
+    void unpinPeer(const uint8_t* macAddress);
+
     // Retry / reliability observability. Cumulative since boot. For hardware
-    // validation tuning of ackTimeoutMs_ and maxRetries_ against the real
+    // validation tuning of the shared ReliableChannel config against the real
     // deployment. ackLatencyMs / ackCount give mean RTT; abandons / (sends +
     // retries) gives loss rate at the chain-announcement layer.
-    struct RetryStats {
-        uint32_t sends = 0;
-        uint32_t retries = 0;
-        uint32_t abandons = 0;
-        uint32_t ackLatencyMsSum = 0;
-        uint32_t ackCount = 0;
-    };
-    RetryStats getRetryStats() const { return retryStats_; }
+    using RetryStats = ReliableChannel::Stats;
+    RetryStats getRetryStats() const { return announcements_.getStats(); }
 
 private:
-    RetryStats retryStats_;
     static constexpr size_t kNumPorts = 3;
     std::array<std::vector<std::array<uint8_t, 6>>, kNumPorts> daisyChainedByPort_;
     std::array<std::optional<std::array<uint8_t, 6>>, kNumPorts> previousDirectPeer_;
-    uint8_t nextAnnouncementId_ = 1;
-
-    struct PendingAnnouncement {
-        bool active = false;
-        uint8_t announcementId = 0;
-        uint8_t retries = 0;
-        std::vector<std::array<uint8_t, 6>> peers;
-        SimpleTimer timer;
-    };
-    std::array<PendingAnnouncement, kNumPorts> pendingByPort_;
-    static constexpr unsigned long ackTimeoutMs_ = 100;
-    static constexpr uint8_t maxRetries_ = 3;
+
+    // One outstanding announcement per port, tagged by port index. The peer
+    // list is kept here so a retransmit can rebuild the packet.
+    ReliableChannel announcements_;
+    std::array<std::vector<std::array<uint8_t, 6>>, kNumPorts> pendingPeersByPort_;
     // ESP-NOW peer-table capacity is 20 on ESP32-S3. Reserve margin for the
     // direct peer on each jack, the champion registration on supporters, and
     // brief transient registrations during chain reconfig.
     static constexpr size_t kMaxChainPeersPerPort = 18;
 
     void emitAnnouncementVia(SerialIdentifier viaPort, const std::vector<std::array<uint8_t, 6>>& peers);
+    bool retransmitAnnouncement(const uint8_t* toMac, uint8_t announcementId, SerialIdentifier viaPort);
     std::vector<std::array<uint8_t, 6>> peersReachableVia(SerialIdentifier port);
 
     size_t portIndex(SerialIdentifier port) const;
@@ -153,7 +163,16 @@ private:
     HandshakeApp* outputPortHandshake = nullptr;
     HandshakeApp* secondaryInputPortHandshake = nullptr;
 
+    // Fixed storage, so the per-tick port walks don't allocate
+    struct PortList {
+        std::array<SerialIdentifier, kNumPorts> ports{};
+        size_t count = 0;
+
+        const SerialIdentifier* begin() const { return ports.data(); }
+        const SerialIdentifier* end() const { return ports.data() + count; }
+    };
+
     // Returns the list of ports that have active handshake apps.
-    std::vector<SerialIdentifier> activePorts() const;
+    PortList activePorts() const;
     HandshakeApp* handshakeAppForPort(SerialIdentifier port) const;
 };
@@ -5,6 +5,7 @@
 #include "device/drivers/http-client-interface.hpp"
 #include "device/drivers/logger.hpp"
 #include "wireless/wireless-types.hpp"
+#include "wireless/reliable-channel.hpp"
 #include "device/drivers/peer-comms-types.hpp"
 #include "protocol-constants.hpp"
 
@@ -175,6 +176,16 @@ public:
      * @return 0 on success, negative on error
      */
     int sendEspNowData(const uint8_t* dst, PktType packetType, const uint8_t* data, size_t length) {
+        return sendEspNowData(dst, packetType, data, length, defaultSendOptions(packetType));
+    }
+
+    /**
+     * Send data via ESP-NOW with an explicit priority class and deadline.
+     * @param options Priority and maximum queueing delay; see SendOptions
+     * @return 0 on success, negative on error
+     */
+    int sendEspNowData(const uint8_t* dst, PktType packetType, const uint8_t* data, size_t length,
+                       const SendOptions& options) {
         // Auto-switch to ESP-NOW mode if needed
         if (currentMode != WirelessMode::ESPNOW) {
             LOG_I(WM_TAG, "Auto-switching to ESP-NOW mode for peer communication");
@@ -186,7 +197,78 @@ public:
             return -1;
         }
         
-        return peerComms->sendData(dst, packetType, data, length);
+        return peerComms->sendData(dst, packetType, data, length, options);
+    }
+
+    /**
+     * Send one broadcast frame to every peer that joined `group`. Nothing is
+     * acknowledged; keep it to traffic that tolerates loss.
+     * @return 0 on success, negative on error, if the driver can't multicast
+     *         or if multicast sends are off (see setEspNowMulticast())
+     */
+    int sendEspNowMulticast(MulticastGroup group, PktType packetType, const uint8_t* data, size_t length,
+                            const SendOptions& options) {
+        if (!espNowMulticastEnabled) {
+            return -1;
+        }
+        if (currentMode != WirelessMode::ESPNOW) {
+            LOG_I(WM_TAG, "Auto-switching to ESP-NOW mode for peer communication");
+            enablePeerCommsMode();
+        }
+
+        if (!isEspNowReady()) {
+            LOG_W(WM_TAG, "Cannot send ESP-NOW multicast - ESP-NOW not ready");
+            return -1;
+        }
+
+        return peerComms->sendMulticast(group, packetType, data, length, options);
+    }
+
+    /**
+     * Start a flow-controlled transfer of a message too large for one
+     * sendEspNowData() call.
+     * @param channel Selects the receiver's bulk handler (< BulkTransfer::kMaxChannels)
+     * @return transfer id (> 0) to poll with getBulkTransferStatus(), negative on error
+     */
+    int sendEspNowBulk(const uint8_t* dst, uint8_t channel, const uint8_t* data, size_t length) {
+        if (currentMode != WirelessMode::ESPNOW) {
+            LOG_I(WM_TAG, "Auto-switching to ESP-NOW mode for peer communication");
+            enablePeerCommsMode();
+        }
+
+        if (!isEspNowReady()) {
+            LOG_W(WM_TAG, "Cannot start ESP-NOW bulk transfer - ESP-NOW not ready");
+            return -1;
+        }
+
+        return peerComms->sendBulk(dst, channel, data, length);
+    }
+
+    bool getBulkTransferStatus(int transferId, BulkTransferStatus& out) {
+        return peerComms->getBulkTransferStatus(transferId, out);
+    }
+
+    void cancelBulkTransfer(int transferId) {
+        peerComms->cancelBulkTransfer(transferId);
+    }
+
+    /**
+     * Receive whole bulk messages sent on `channel`.
+     */
+    void setEspNowBulkHandler(uint8_t channel, PeerCommsInterface::PacketCallback callback, void* ctx) {
+        peerComms->setBulkHandler(channel, callback, ctx);
+    }
+
+    /**
+     * Accept multicasts addressed to `group`.
+     * @return 0 on success, negative if the driver can't join another group
+     */
+    int joinMulticastGroup(MulticastGroup group) {
+        return peerComms->joinMulticastGroup(group);
+    }
+
+    void leaveMulticastGroup(MulticastGroup group) {
+        peerComms->leaveMulticastGroup(group);
     }
     
     /**
@@ -204,6 +286,33 @@ public:
         peerComms->clearPacketHandler(packetType);
     }
 
+    /**
+     * Have the driver drop repeated packets of a type before its handler runs.
+     * @param seqOffset Payload byte holding the sender's sequence number (0 = untracked)
+     * @param onDuplicate Optional; sees each dropped repeat, e.g. to re-ACK it
+     */
+    void setEspNowDuplicateSuppression(PktType packetType, uint8_t seqOffset,
+                                       PeerCommsInterface::PacketCallback onDuplicate, void* ctx) {
+        peerComms->setDuplicateSuppression(packetType, seqOffset, onDuplicate, ctx);
+    }
+
+    /**
+     * Let the driver pack small control messages to the same peer into one
+     * frame per loop tick. Off by default.
+     */
+    void setEspNowCoalescing(bool enabled) {
+        peerComms->setCoalescingEnabled(enabled);
+    }
+
+    /**
+     * Let sendEspNowMulticast() send. Off by default: older firmware drops
+     * kMulticast frames, so callers fall back to unicast until every peer
+     * understands them. Joining groups and receiving work either way.
+     */
+    void setEspNowMulticast(bool enabled) {
+        espNowMulticastEnabled = enabled;
+    }
+
     /**
      * Register a MAC as an ESP-NOW peer, making it eligible for unicast sends.
      */
@@ -217,6 +326,49 @@ public:
     int removeEspNowPeer(const uint8_t* mac) {
         return peerComms->removeEspNowPeer(mac);
     }
+
+    /**
+     * Smoothed link quality toward a peer as seen by the driver.
+     * @return false if nothing is known about the peer
+     */
+    bool getLinkEstimate(const uint8_t* mac, LinkEstimate& out) {
+        return peerComms->getLinkEstimate(mac, out);
+    }
+
+    /**
+     * Share a retry channel's RTT knowledge with the driver's link-quality
+     * table: its clean ACK samples feed the table, and peers it hasn't
+     * measured yet start from the table's SRTT instead of the default RTO.
+     */
+    void bindLinkQuality(ReliableChannel& channel) {
+        channel.setRttObserver([this](const uint8_t* peer, unsigned long rttMs) {
+            peerComms->reportAckRtt(peer, rttMs);
+        });
+        channel.setRttSeed([this](const uint8_t* peer, unsigned long& srttMs, unsigned long& rttvarMs) {
+            LinkEstimate estimate;
+            if (!peerComms->getLinkEstimate(peer, estimate) || !estimate.hasRtt) {
+                return false;
+            }
+            srttMs = estimate.srttMs;
+            rttvarMs = estimate.rttvarMs;
+            return true;
+        });
+    }
+
+    /**
+     * Register a MAC as an ESP-NOW peer that is never evicted to make room
+     * for others, until unpinned or removed.
+     */
+    int pinEspNowPeer(const uint8_t* mac) {
+        return peerComms->pinEspNowPeer(mac);
+    }
+
+    /**
+     * Let a pinned peer be evicted again when the peer table fills.
+     */
+    void unpinEspNowPeer(const uint8_t* mac) {
+        peerComms->unpinEspNowPeer(mac);
+    }
     
     /**
      * Get the device's MAC address.
@@ -261,4 +413,5 @@ private:
     PeerCommsInterface* peerComms;
     HttpClientInterface* httpClient;
     WirelessMode currentMode;
+    bool espNowMulticastEnabled = false;
 };
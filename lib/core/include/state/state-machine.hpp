@@ -100,7 +100,17 @@ public:
     }
 
     void onStateLoop(Device *PDN) override {
+#ifdef LOOP_PROFILING
+        LoopProfiler* profiler = PDN ? PDN->getLoopProfiler() : nullptr;
+        if (profiler) {
+            LoopProfileScope scope(*profiler, profiler->stateSection(getStateId(), currentState->getStateId()));
+            asLifecycle(currentState)->loop(PDN);
+        } else {
+            asLifecycle(currentState)->loop(PDN);
+        }
+#else
         asLifecycle(currentState)->loop(PDN);
+#endif
         checkStateTransitions();
         if (stateChangeReady) {
             commitState(PDN);
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Heap-allocation accounting for native builds.
+//
+// With ALLOC_TRACKING defined (native, native_cli_test and native_perf),
+// alloc-tracker.cpp replaces the global operator new and delete and counts
+// every allocation: process-wide, per thread, into each open
+// AllocationScope, and per named region. Without it nothing is hooked,
+// isInstalled() is false and every count stays zero, so budget checks
+// should skip rather than pass vacuously. ASan and TSan builds bring their
+// own allocator and leave it off.
+//
+// Regions are compiled into game code with ALLOC_REGION("name"), simulator
+// plumbing is left out with ALLOC_UNCOUNTED(); both cost nothing unless
+// ALLOC_TRACKING is defined.
+
+struct AllocationCounts {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;             // requested, not what malloc rounded to
+    uint64_t frees = 0;
+
+    AllocationCounts operator-(const AllocationCounts& other) const {
+        AllocationCounts diff;
+        diff.allocations = allocations - other.allocations;
+        diff.bytes = bytes - other.bytes;
+        diff.frees = frees - other.frees;
+        return diff;
+    }
+};
+
+class AllocationTracker {
+public:
+    // Regions past this many names share the last slot, "(other)"
+    static constexpr size_t kMaxRegions = 32;
+
+    struct Region {
+        const char* name = nullptr;
+        AllocationCounts counts;    // inclusive of nested regions
+        uint64_t entries = 0;
+    };
+
+    // True when operator new is hooked in this binary
+    static bool isInstalled();
+
+    // Everything allocated since the process started, on any thread
+    static AllocationCounts getTotals();
+
+    // Everything the calling thread has allocated
+    static AllocationCounts getThreadTotals();
+
+    // Per-region totals since the last resetRegions(), in first-seen order.
+    // Returns the number of regions copied into `out`.
+    static size_t getRegions(Region* out, size_t maxRegions);
+
+    // Between runs only; a scope still open adds to whatever takes its slot
+    static void resetRegions();
+
+private:
+    friend class AllocationScope;
+    static size_t findRegion(const char* name);
+    static void addToRegion(size_t index, const AllocationCounts& counts);
+};
+
+// Counts what the calling thread allocates between construction and
+// destruction (or now, for getCounts()), nested scopes included. Named
+// scopes also add their counts to that region when they close.
+//
+//     AllocationScope scope;
+//     device.loop();
+//     EXPECT_EQ(scope.getCounts().allocations, 0u);
+class AllocationScope {
+public:
+    explicit AllocationScope(const char* regionName = nullptr);
+    ~AllocationScope();
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+    AllocationCounts getCounts() const;
+
+private:
+    AllocationCounts start_;
+    size_t region_;
+};
+
+// Allocations the calling thread makes while one is alive aren't counted at
+// all. For native drivers whose buffering stands in for hardware (a UART
+// FIFO, the air), so budgets see what the firmware itself would allocate.
+class UncountedAllocations {
+public:
+    UncountedAllocations();
+    ~UncountedAllocations();
+
+    UncountedAllocations(const UncountedAllocations&) = delete;
+    UncountedAllocations& operator=(const UncountedAllocations&) = delete;
+};
+
+#ifdef ALLOC_TRACKING
+#define ALLOC_REGION_CONCAT_(a, b) a##b
+#define ALLOC_REGION_NAME_(line) ALLOC_REGION_CONCAT_(allocRegion_, line)
+#define ALLOC_REGION(name) AllocationScope ALLOC_REGION_NAME_(__LINE__)(name)
+#define ALLOC_UNCOUNTED() UncountedAllocations ALLOC_REGION_NAME_(__LINE__)
+#else
+#define ALLOC_REGION(name) do {} while (0)
+#define ALLOC_UNCOUNTED() do {} while (0)
+#endif
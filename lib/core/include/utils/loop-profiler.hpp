@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+class PlatformClock;
+
+// Execution-time histograms for Device::loop().
+//
+// With LOOP_PROFILING defined, Device times the whole tick and each
+// driver's exec(), and StateMachine times each state's onStateLoop(), in
+// microseconds from the platform clock. Without it nothing is timed, Device
+// has no profiler and getLoopProfiler() returns nullptr. Nested sections
+// count inside their parent: a handshake state's time is also part of the
+// quickdraw state that synced it.
+//
+// Fixed storage, no allocation, not thread safe; it's driven from the loop.
+
+// Bucket 0 is under 1 us, bucket i (1..14) is [2^(i-1), 2^i) us, and the last
+// bucket is everything from 16.384 ms up.
+constexpr size_t LOOP_PROFILE_BUCKETS = 16;
+
+struct LoopProfileSection {
+    enum class Kind : uint8_t {
+        kTick,      // all of Device::loop()
+        kDriver,    // one driver's exec()
+        kState,     // one state's onStateLoop()
+    };
+
+    Kind kind = Kind::kTick;
+    const char* name = nullptr;     // drivers, or "(other)" once the table is full
+    int machineId = -1;             // states: the StateMachine's state id
+    int stateId = -1;
+    uint32_t count = 0;
+    uint32_t overBudget = 0;        // calls longer than the tick budget on their own
+    uint64_t totalUs = 0;
+    uint32_t maxUs = 0;
+    uint32_t buckets[LOOP_PROFILE_BUCKETS] = {};
+
+    // Upper bound of the bucket holding the `percent` percentile, 0 with no
+    // calls. Histograms only know the bucket, so this overestimates by up
+    // to 2x; maxUs is exact.
+    uint32_t percentileUs(double percent) const;
+};
+
+class LoopProfiler {
+public:
+    // Sections past this many share the last slot, "(other)"
+    static constexpr size_t kMaxSections = 32;
+    static constexpr uint32_t kDefaultTickBudgetUs = 10000;
+
+    static size_t bucketFor(uint32_t us);
+    // Exclusive upper bound of `bucket` in us; UINT32_MAX for the last one
+    static uint32_t bucketUpperUs(size_t bucket);
+
+    // Times come from `clock`, or SimpleTimer's platform clock when unset
+    void setClock(PlatformClock* clock) { clock_ = clock; }
+    unsigned long nowUs() const;
+
+    void setTickBudgetUs(uint32_t budgetUs) { tickBudgetUs_ = budgetUs; }
+    uint32_t getTickBudgetUs() const { return tickBudgetUs_; }
+
+    // Index of the section, added on first use. `name` is kept, not copied:
+    // DriverManager passes its map keys, which outlive the profiler.
+    size_t tickSection();
+    size_t driverSection(const char* name);
+    size_t stateSection(int machineId, int stateId);
+
+    void record(size_t section, uint32_t elapsedUs);
+
+    size_t getSectionCount() const { return sectionCount_; }
+    const LoopProfileSection& getSection(size_t index) const { return sections_[index]; }
+
+    // Forgets every section; the next ticks start them over
+    void reset();
+
+private:
+    size_t add(const LoopProfileSection& key);
+
+    PlatformClock* clock_ = nullptr;
+    uint32_t tickBudgetUs_ = kDefaultTickBudgetUs;
+    LoopProfileSection sections_[kMaxSections];
+    size_t sectionCount_ = 0;
+};
+
+// Times its own lifetime into one section
+class LoopProfileScope {
+public:
+    LoopProfileScope(LoopProfiler& profiler, size_t section)
+        : profiler_(profiler), section_(section), startUs_(profiler.nowUs()) {}
+
+    ~LoopProfileScope() {
+        profiler_.record(section_, static_cast<uint32_t>(profiler_.nowUs() - startUs_));
+    }
+
+    LoopProfileScope(const LoopProfileScope&) = delete;
+    LoopProfileScope& operator=(const LoopProfileScope&) = delete;
+
+private:
+    LoopProfiler& profiler_;
+    size_t section_;
+    unsigned long startUs_;
+};
+
+// "tick", "driver:<name>" or "state:<machineId>/<stateId>"
+int formatLoopProfileLabel(const LoopProfileSection& section, char* out, size_t outLen);
+
+// One line under `label`, e.g.
+//   "driver:light n=5012 mean 41us p50<64 p99<128 max 310us over 0"
+// Returns what snprintf returns.
+int formatLoopProfileRow(const LoopProfileSection& section, const char* label, char* out, size_t outLen);
+
+// The non-empty buckets, e.g. "<32us:4810 <64us:190 <128us:11 >=16ms:1"
+int formatLoopProfileHistogram(const LoopProfileSection& section, char* out, size_t outLen);
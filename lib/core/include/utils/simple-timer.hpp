@@ -54,6 +54,10 @@ public:
         duration = timerDelay;
         updateTime();
         start = now;
+        if (clock != nullptr) {
+            // expired() is strict, so the first expired reading is one later
+            clock->onTimerArmed(start + duration + 1);
+        }
     }
 
     unsigned long now = 0;
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "device/drivers/peer-comms-types.hpp"
+
+// CRC-32 (IEEE 802.3, reflected). Pass the previous result as `crc` to
+// continue over more data.
+uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc = 0);
+
+enum class BulkTransferState : uint8_t {
+    kOpening,       // waiting for the receiver's first credit
+    kSending,
+    kComplete,      // receiver confirmed every byte and the checksum
+    kFailed,        // refused, or no progress after maxTimeouts
+    kCancelled,
+};
+
+struct BulkTransferStatus {
+    BulkTransferState state = BulkTransferState::kOpening;
+    uint32_t totalLength = 0;
+    uint32_t ackedOffset = 0;       // bytes the receiver holds contiguously
+    uint32_t retransmits = 0;       // chunks sent again after a gap or timeout
+    bool refused = false;
+    BulkRefuseReason refuseReason = BulkRefuseReason::NO_HANDLER;
+};
+
+// Windowed, receiver-paced transfer of messages too large for the fragment
+// layer (over MAX_SEND_PACKET_LEN), such as a match history or a player profile.
+//
+// The sender announces the transfer with OPEN (length and CRC-32 of the whole
+// message). The receiver allocates a buffer and answers with CREDIT: the
+// contiguous offset it holds and how far past it the sender may go. DATA
+// chunks carry their byte offset, so they may arrive out of order. The
+// receiver credits again every half window, on every gap or repeat, and once
+// complete. A repeated credit with no progress makes the sender go back to the
+// acked offset. So does a retransmit timeout with no credit at all.
+//
+// Offsets are resumable. A receiver keeps a stalled transfer for holdMs, keyed
+// by source, length and checksum. Sending the same bytes again, even under a new
+// transfer id, resumes from what already arrived instead of starting over.
+// The checksum is verified once the last byte is in; a mismatch is refused
+// and the partial data dropped.
+//
+// Drivers feed kBulkTransfer packets to onPacket() and call service() every
+// exec(). Both send through `emit`, which returns non-zero when the driver
+// cannot queue the packet right now; unsent chunks are retried on the next
+// service(). Not thread safe; drivers use it from the loop thread only.
+class BulkTransfer {
+public:
+    static constexpr size_t kChunkLen = PEER_COMMS_MAX_FRAME_PAYLOAD - sizeof(BulkDataHdr);
+    static constexpr uint8_t kMaxChannels = 8;
+
+    // Sends one kBulkTransfer payload to `dst`.
+    using Emit = std::function<int(const uint8_t* dst, const uint8_t* data, size_t length)>;
+
+    enum class Result {
+        kNone,
+        kComplete,      // an incoming transfer finished; see completed()
+        kRejected,      // malformed or for nothing we know
+    };
+
+    struct Config {
+        size_t maxOutgoing = 2;
+        size_t maxIncoming = 2;
+        size_t maxTransferBytes = 64 * 1024;
+        size_t windowBytes = 8 * kChunkLen;
+        unsigned long retransmitMs = 250;
+        uint8_t maxTimeouts = 8;
+        unsigned long holdMs = 30000;
+    };
+
+    struct Stats {
+        uint32_t started = 0;
+        uint32_t completedOut = 0;
+        uint32_t completedIn = 0;
+        uint32_t resumed = 0;       // incoming transfers picked up mid-way
+        uint32_t failed = 0;
+        uint32_t chunksSent = 0;
+        uint32_t retransmits = 0;
+        uint32_t corrupt = 0;
+        uint32_t rejected = 0;
+    };
+
+    struct Completed {
+        uint8_t srcMac[6];
+        uint8_t channel;
+        std::vector<uint8_t> data;
+    };
+
+    BulkTransfer();
+    explicit BulkTransfer(const Config& config);
+
+    // Starts sending a copy of `data` to `dst`. Returns the transfer id (> 0),
+    // or -1 if the message is empty or too large, the channel is out of range,
+    // or every outgoing slot is busy.
+    int start(const uint8_t* dst, uint8_t channel, const uint8_t* data, size_t length, unsigned long nowMs);
+
+    // Stops an outgoing transfer and tells the receiver to drop its partial copy.
+    void cancel(int transferId, const Emit& emit);
+
+    // False if `transferId` is unknown. Finished transfers stay queryable
+    // until their slot is reused.
+    bool getStatus(int transferId, BulkTransferStatus& out) const;
+
+    // Only OPENs on listened channels are accepted.
+    void listen(uint8_t channel, bool enabled);
+
+    Result onPacket(const uint8_t* srcMac, const uint8_t* data, size_t length,
+                    unsigned long nowMs, const Emit& emit);
+
+    // Valid after onPacket() returns kComplete. The caller may move data out.
+    Completed& completed() { return completed_; }
+
+    // Sends whatever the window allows, handles retransmit timeouts and drops
+    // incoming transfers idle for holdMs.
+    void service(unsigned long nowMs, const Emit& emit);
+
+    size_t activeOutgoing() const;
+    size_t activeIncoming() const;
+    const Stats& getStats() const { return stats_; }
+    const Config& getConfig() const { return config_; }
+
+private:
+    struct Outgoing {
+        bool used = false;
+        uint16_t id = 0;
+        uint8_t dstMac[6] = {};
+        uint8_t channel = 0;
+        std::vector<uint8_t> data;
+        uint32_t crc = 0;
+        BulkTransferStatus status;
+        uint32_t nextOffset = 0;
+        uint32_t highestSent = 0;
+        uint32_t windowEnd = 0;
+        uint32_t goBackOffset = UINT32_MAX;
+        unsigned long lastProgressMs = 0;
+        unsigned long lastOpenMs = 0;
+        bool openSent = false;
+        uint8_t timeouts = 0;
+    };
+
+    struct Incoming {
+        bool used = false;
+        bool done = false;          // delivered; kept to re-credit late repeats
+        uint8_t srcMac[6] = {};
+        uint16_t id = 0;
+        uint8_t channel = 0;
+        uint32_t totalLength = 0;
+        uint32_t crc = 0;
+        std::vector<uint8_t> data;
+        std::vector<bool> received;
+        uint32_t contiguous = 0;
+        uint32_t lastCredited = 0;
+        unsigned long lastActivityMs = 0;
+    };
+
+    bool isActive(const Outgoing& out) const {
+        return out.used && (out.status.state == BulkTransferState::kOpening ||
+                            out.status.state == BulkTransferState::kSending);
+    }
+
+    Outgoing* findOutgoing(uint16_t id);
+    const Outgoing* findOutgoing(uint16_t id) const;
+    Incoming* findIncoming(const uint8_t* srcMac, uint16_t id);
+
+    void onOpen(const uint8_t* srcMac, const BulkOpenPayload& open, unsigned long nowMs, const Emit& emit);
+    Result onData(const uint8_t* srcMac, const BulkDataHdr& hdr, const uint8_t* chunk, size_t chunkLen,
+                  unsigned long nowMs, const Emit& emit);
+    void onCredit(Outgoing& out, const BulkCreditPayload& credit, unsigned long nowMs);
+    void onRefuse(Outgoing& out, const BulkRefusePayload& refuse);
+
+    void serviceOutgoing(Outgoing& out, unsigned long nowMs, const Emit& emit);
+    void fail(Outgoing& out);
+    void sendCredit(Incoming& in, const Emit& emit);
+    void sendRefuse(const uint8_t* dst, uint16_t id, BulkRefuseReason reason, const Emit& emit);
+
+    Config config_;
+    Stats stats_;
+    std::vector<Outgoing> outgoing_;
+    std::vector<Incoming> incoming_;
+    Completed completed_;
+    uint16_t nextId_ = 1;
+    uint8_t listening_ = 0;
+};
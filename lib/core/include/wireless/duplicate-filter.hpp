@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "device/drivers/peer-comms-types.hpp"
+
+// Receive-side duplicate suppression keyed by (source MAC, packet type,
+// sequence number).
+//
+// ESP-NOW repeats a frame whose MAC-layer ACK was lost, and the retry layers
+// (ReliableChannel users) repeat packets whose protocol ACK was lost, so the
+// same packet can reach a handler several times. Packet types opt in with
+// setRule(), naming the payload byte that carries their sequence number;
+// sequence 0 is the "untracked" sentinel and always passes. Each (source,
+// type) stream remembers its last `window` sequence numbers for `holdMs`, so a
+// sender that reboots and restarts its counter is only muted briefly.
+//
+// Memory is bounded by Config and allocated once at construction. Streams
+// beyond maxStreams replace the least recently used one. Not thread safe;
+// drivers filter on the loop thread.
+class DuplicateFilter {
+public:
+    static constexpr size_t kMaxWindow = 32;
+
+    struct Config {
+        size_t maxStreams = 16;
+        size_t window = 8;              // clamped to kMaxWindow
+        unsigned long holdMs = 5000;
+    };
+
+    struct Stats {
+        uint32_t hits = 0;              // duplicates dropped
+        uint32_t misses = 0;            // first sighting of a tracked sequence
+        uint32_t untracked = 0;         // no rule, sequence 0, or too short
+        uint32_t evictions = 0;         // streams replaced to make room
+    };
+
+    DuplicateFilter();
+    explicit DuplicateFilter(const Config& config);
+
+    // Tracks `packetType` by the sequence byte at `seqOffset` in its payload.
+    void setRule(PktType packetType, uint8_t seqOffset);
+    void clearRule(PktType packetType);
+    bool hasRule(PktType packetType) const;
+
+    // Records the packet and returns true if the same (src, type, seq) was
+    // already seen within the window; the caller should drop it.
+    bool isDuplicate(const uint8_t* srcMac, PktType packetType,
+                     const uint8_t* payload, size_t length, unsigned long nowMs);
+
+    // Forgets every stream from `srcMac`.
+    void forget(const uint8_t* srcMac);
+    void clear();
+
+    size_t streamCount() const;
+    const Stats& getStats() const { return stats_; }
+    const Config& getConfig() const { return config_; }
+
+private:
+    static constexpr uint8_t kNoRule = 0xFF;
+
+    struct Stream {
+        bool used = false;
+        uint8_t mac[6] = {};
+        PktType packetType = PktType::kNumPacketTypes;
+        uint8_t count = 0;
+        uint8_t head = 0;
+        uint32_t lastUsed = 0;
+        std::array<uint8_t, kMaxWindow> seqs{};
+        std::array<unsigned long, kMaxWindow> seenMs{};
+    };
+
+    Stream& streamFor(const uint8_t* srcMac, PktType packetType);
+
+    Config config_;
+    std::array<uint8_t, static_cast<size_t>(PktType::kNumPacketTypes)> seqOffsets_;
+    std::vector<Stream> streams_;
+    uint32_t useCounter_ = 0;
+    Stats stats_;
+};
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "device/drivers/peer-comms-types.hpp"
+
+// Bit i set = fragment i of a cluster. 256 bits covers the full uint8_t index space.
+struct FragmentBitmap {
+    uint8_t bits[32] = {};
+
+    void set(uint8_t idx) { bits[idx >> 3] |= static_cast<uint8_t>(1u << (idx & 7)); }
+    bool test(uint8_t idx) const { return (bits[idx >> 3] >> (idx & 7)) & 1u; }
+    void clear();
+    size_t count() const;
+};
+
+struct FragmentResendRequest {
+    uint8_t srcMac[6];
+    FragmentNackPayload nack;
+};
+
+// Platform-neutral selective-repeat reassembly of DataPktHdr clusters.
+//
+// Clusters are keyed by (source MAC, packet type). Fragments may arrive in any
+// order; a bitmap tracks which indices are present and the cluster completes
+// once every bit is set. An incomplete cluster that has been quiet for
+// resendAfterMs produces a resend request naming only the missing indices;
+// after staleTimeoutMs of silence it is evicted.
+//
+// The wire header carries no cluster id, so a repeated index 0 on an
+// incomplete cluster is treated as the sender starting over (senders always
+// transmit a new cluster in order). Any other repeated index is a duplicate.
+//
+// Clusters sent in v2 frames mark every frame with DATA_PKT_LEN_LONG and are
+// placed by PEER_COMMS_MAX_FRAME_PAYLOAD_V2 instead. A frame whose size
+// doesn't match the cluster it lands in restarts it, like a new shape.
+//
+// Not thread safe; drivers hold their own lock around it.
+class FragmentReassembler {
+public:
+    enum class Result {
+        kIncomplete,    // accepted, cluster still missing fragments
+        kComplete,      // cluster finished; see completed()
+        kDuplicate,     // index already held, ignored
+        kRejected,      // malformed header or length
+    };
+
+    struct Config {
+        size_t maxClusters = 4;
+        unsigned long resendAfterMs = 50;
+        unsigned long staleTimeoutMs = 500;
+        uint8_t maxResendRequests = 3;
+    };
+
+    struct Stats {
+        uint32_t completed = 0;
+        uint32_t outOfOrder = 0;
+        uint32_t duplicates = 0;
+        uint32_t rejected = 0;
+        uint32_t evicted = 0;
+        uint32_t resendRequests = 0;
+    };
+
+    struct Completed {
+        uint8_t srcMac[6];
+        PktType packetType;
+        std::vector<uint8_t> data;
+    };
+
+    FragmentReassembler();
+    explicit FragmentReassembler(const Config& config);
+
+    // `frame` is a full frame starting with DataPktHdr.
+    Result onFragment(const uint8_t* srcMac, const uint8_t* frame, size_t frameLen, unsigned long nowMs);
+
+    // Valid after onFragment() returns kComplete. The caller may move data out.
+    Completed& completed() { return completed_; }
+
+    // Drops clusters idle for staleTimeoutMs. Returns how many were evicted.
+    size_t expire(unsigned long nowMs);
+
+    // Appends a request for every incomplete cluster that is due one.
+    size_t collectResendRequests(unsigned long nowMs, std::vector<FragmentResendRequest>& out);
+
+    size_t activeClusters() const;
+    const Stats& getStats() const { return stats_; }
+    const Config& getConfig() const { return config_; }
+
+private:
+    struct Cluster {
+        bool active = false;
+        uint8_t srcMac[6] = {};
+        PktType packetType = PktType::kNumPacketTypes;
+        uint8_t numPktsInCluster = 0;
+        uint8_t nextExpectedIdx = 0;
+        size_t fragmentLen = PEER_COMMS_MAX_FRAME_PAYLOAD;
+        size_t lastFragmentLen = 0;
+        FragmentBitmap received;
+        std::vector<uint8_t> buffer;
+        unsigned long lastActivityMs = 0;
+        uint8_t resendRequests = 0;
+    };
+
+    Cluster* find(const uint8_t* srcMac, PktType packetType);
+    Cluster* claim(unsigned long nowMs);
+    void start(Cluster& cluster, const uint8_t* srcMac, const DataPktHdr* hdr, size_t fragmentLen,
+               unsigned long nowMs);
+
+    Config config_;
+    Stats stats_;
+    std::vector<Cluster> clusters_;
+    Completed completed_;
+};
+
+// Sender-side copies of recent multi-frame clusters, so a FragmentNackPayload
+// can be answered by re-queuing just the missing frames. Entries are keyed by
+// (destination MAC, packet type); a newer cluster to the same key replaces the
+// older one. Single-frame sends are never cached.
+class FragmentRetransmitCache {
+public:
+    struct Cluster {
+        std::vector<uint8_t> data;
+        size_t fragmentLen = PEER_COMMS_MAX_FRAME_PAYLOAD;     // as passed to buildFragment()
+    };
+
+    explicit FragmentRetransmitCache(size_t maxEntries = 4, unsigned long ttlMs = 1000);
+
+    void store(const uint8_t* dstMac, PktType packetType, const uint8_t* data, size_t length, unsigned long nowMs,
+               size_t fragmentLen = PEER_COMMS_MAX_FRAME_PAYLOAD);
+
+    // The cached cluster, or nullptr if unknown/expired or the cluster shape
+    // no longer matches the NACK.
+    const Cluster* find(const uint8_t* dstMac, const FragmentNackPayload& nack, unsigned long nowMs) const;
+
+    size_t size() const;
+
+private:
+    struct Entry {
+        bool active = false;
+        uint8_t dstMac[6] = {};
+        PktType packetType = PktType::kNumPacketTypes;
+        Cluster cluster;
+        unsigned long storedMs = 0;
+    };
+
+    std::vector<Entry> entries_;
+    unsigned long ttlMs_;
+};
+
+// Payload bytes per fragment toward a peer that receives frames of up to
+// `maxFrameLen` bytes: PEER_COMMS_MAX_FRAME_PAYLOAD_V2 if it takes v2 frames,
+// PEER_COMMS_MAX_FRAME_PAYLOAD otherwise.
+inline size_t fragmentLenFor(size_t maxFrameLen) {
+    return maxFrameLen >= PEER_COMMS_MAX_FRAME_LEN_V2 ? PEER_COMMS_MAX_FRAME_PAYLOAD_V2 : PEER_COMMS_MAX_FRAME_PAYLOAD;
+}
+
+// Number of `fragmentLen` frames needed for `length` bytes.
+inline size_t fragmentCount(size_t length, size_t fragmentLen = PEER_COMMS_MAX_FRAME_PAYLOAD) {
+    return length / fragmentLen + (length % fragmentLen == 0 ? 0 : 1);
+}
+
+// Writes frame `idx` of a cluster carrying `data` into `out` (at least
+// sizeof(DataPktHdr) + fragmentLen bytes). Returns the frame length.
+// fragmentLen is PEER_COMMS_MAX_FRAME_PAYLOAD or, for v2 frames marked
+// DATA_PKT_LEN_LONG, PEER_COMMS_MAX_FRAME_PAYLOAD_V2.
+size_t buildFragment(uint8_t* out, PktType packetType, const uint8_t* data, size_t length,
+                     uint8_t idx, uint8_t numPktsInCluster, size_t fragmentLen = PEER_COMMS_MAX_FRAME_PAYLOAD);
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "device/drivers/peer-comms-types.hpp"
+
+// Fixed-capacity slab of equally sized frame buffers for the send path.
+//
+// All storage lives inside the pool, so steady-state sends never touch the
+// heap. acquire() pops a block off an index free list, release() pushes it
+// back; both are O(1).
+//
+// When every block is in use acquire() returns nullptr and the exhausted
+// counter is bumped. Drivers treat that as a failed sendData(): nothing from
+// the cluster is queued and -1 is returned, so the caller's normal retry path
+// (RDC/chain/shootout ack timers) tries again after the radio drains the
+// queue. Size the pool for the largest cluster plus whatever is normally in
+// flight; reserve() lets callers check for a whole cluster up front.
+//
+// Not thread safe. Drivers serialize acquire/release with the same lock that
+// guards their send queue.
+template <size_t BlockSize, size_t BlockCount>
+class FramePool {
+    static_assert(BlockCount > 0 && BlockCount <= UINT16_MAX, "FramePool block count out of range");
+
+public:
+    FramePool() {
+        for (size_t i = 0; i < BlockCount; i++) {
+            freeList_[i] = static_cast<uint16_t>(BlockCount - 1 - i);
+        }
+        freeCount_ = BlockCount;
+    }
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    // True if `count` blocks can be acquired right now. Counts as an
+    // exhaustion event when it can't, since the caller is about to fail.
+    bool reserve(size_t count) {
+        if (count > freeCount_) {
+            exhaustedCount_++;
+            return false;
+        }
+        return true;
+    }
+
+    uint8_t* acquire() {
+        if (freeCount_ == 0) {
+            exhaustedCount_++;
+            return nullptr;
+        }
+        uint16_t idx = freeList_[--freeCount_];
+        acquireCount_++;
+        size_t used = BlockCount - freeCount_;
+        if (used > highWater_) {
+            highWater_ = used;
+        }
+        return blocks_[idx].data();
+    }
+
+    // Returns a block to the pool. Pointers the pool doesn't own are ignored.
+    void release(uint8_t* block) {
+        if (!owns(block) || freeCount_ >= BlockCount) {
+            return;
+        }
+        size_t idx = static_cast<size_t>(block - blocks_[0].data()) / BlockSize;
+        freeList_[freeCount_++] = static_cast<uint16_t>(idx);
+        releaseCount_++;
+    }
+
+    bool owns(const uint8_t* block) const {
+        const uint8_t* base = blocks_[0].data();
+        if (block < base || block >= base + BlockSize * BlockCount) {
+            return false;
+        }
+        return (static_cast<size_t>(block - base) % BlockSize) == 0;
+    }
+
+    static constexpr size_t blockSize() { return BlockSize; }
+    static constexpr size_t capacity() { return BlockCount; }
+
+    size_t available() const { return freeCount_; }
+    size_t inUse() const { return BlockCount - freeCount_; }
+    size_t getHighWater() const { return highWater_; }
+    uint32_t getAcquireCount() const { return acquireCount_; }
+    uint32_t getReleaseCount() const { return releaseCount_; }
+    uint32_t getExhaustedCount() const { return exhaustedCount_; }
+
+    void resetCounters() {
+        acquireCount_ = 0;
+        releaseCount_ = 0;
+        exhaustedCount_ = 0;
+        highWater_ = inUse();
+    }
+
+private:
+    std::array<std::array<uint8_t, BlockSize>, BlockCount> blocks_;
+    std::array<uint16_t, BlockCount> freeList_;
+    size_t freeCount_ = 0;
+    size_t highWater_ = 0;
+    uint32_t acquireCount_ = 0;
+    uint32_t releaseCount_ = 0;
+    uint32_t exhaustedCount_ = 0;
+};
+
+// Pool shape shared by EspNowManager and NativePeerCommsDriver: one block per
+// radio frame, enough for a 32-frame cluster or a burst of small sends.
+constexpr size_t SEND_FRAME_POOL_BLOCKS = 32;
+using SendFramePool = FramePool<PEER_COMMS_MAX_FRAME_LEN, SEND_FRAME_POOL_BLOCKS>;
+
+// Largest payload sendData() takes: a cluster that fills the whole small pool.
+// Anything bigger could never be reserved, so it is refused up front; use
+// sendBulk() instead.
+constexpr size_t MAX_SEND_PACKET_LEN = SEND_FRAME_POOL_BLOCKS * PEER_COMMS_MAX_FRAME_PAYLOAD;
+
+// v2 frames for peers that take them. Kept small since each block is 1470
+// bytes; a cluster that doesn't fit falls back to the small pool.
+constexpr size_t LARGE_SEND_FRAME_POOL_BLOCKS = 8;
+using LargeSendFramePool = FramePool<PEER_COMMS_MAX_FRAME_LEN_V2, LARGE_SEND_FRAME_POOL_BLOCKS>;
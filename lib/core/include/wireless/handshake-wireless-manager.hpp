@@ -22,6 +22,15 @@ enum HSCommand {
     HS_INVALID_COMMAND = 0xFF
 };
 
+// Wire format of kHandshakeCommand. Defined here so the codec benchmark can
+// build packets without duplicating the layout.
+struct HandshakePacket {
+    int sendingJack;
+    int receicingJack;
+    int deviceType;
+    int command;
+} __attribute__((packed));
+
 struct Peer {
     std::array<uint8_t, 6> macAddr;
     SerialIdentifier sid;
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Smoothed view of one peer link. Counters are cumulative since the peer
+// entered the table.
+struct LinkEstimate {
+    uint32_t txDelivered = 0;
+    uint32_t txFailed = 0;
+    // Smoothed share of send attempts the radio reported delivered, 0..1000.
+    // 1000 until the first attempt.
+    uint16_t deliveryPermille = 1000;
+
+    // Protocol-level ACK round trip (RFC 6298 SRTT/RTTVAR)
+    bool hasRtt = false;
+    unsigned long srttMs = 0;
+    unsigned long rttvarMs = 0;
+    uint32_t rttSamples = 0;
+
+    bool hasRssi = false;
+    int rssiDbm = 0;
+
+    unsigned long lastUpdateMs = 0;
+};
+
+// Per-peer link quality, keyed by MAC.
+//
+// Drivers feed it send-callback outcomes and whatever RSSI the radio reports.
+// The retry layer (ReliableChannel, through WirelessManager::bindLinkQuality)
+// adds clean ACK round trips and reads SRTT back to seed its retransmit
+// timeouts, so a slow link learned by one protocol benefits the others.
+//
+// Delivery ratio and RSSI are exponentially weighted (1/8 and 1/4); the first
+// sample initialises each. Peers beyond kMaxPeers replace the least recently
+// updated entry. Fixed storage, no allocation. Not thread safe: the owning
+// driver locks around it, since the radio reports from its own task.
+class LinkQualityTable {
+public:
+    static constexpr size_t kMaxPeers = 32;
+
+    void recordSend(const uint8_t* mac, bool delivered, unsigned long nowMs);
+    void recordAckRtt(const uint8_t* mac, unsigned long rttMs, unsigned long nowMs);
+    void recordRssi(const uint8_t* mac, int rssiDbm, unsigned long nowMs);
+
+    // False if nothing is known about `mac`.
+    bool get(const uint8_t* mac, LinkEstimate& out) const;
+
+    bool remove(const uint8_t* mac);
+    void clear();
+    size_t size() const;
+
+private:
+    struct Entry {
+        bool used = false;
+        uint8_t mac[6] = {};
+        bool hasDelivery = false;
+        uint32_t lastUsed = 0;
+        LinkEstimate estimate;
+    };
+
+    Entry& entryFor(const uint8_t* mac, unsigned long nowMs);
+    const Entry* find(const uint8_t* mac) const;
+
+    std::array<Entry, kMaxPeers> entries_{};
+    uint32_t useCounter_ = 0;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "device/drivers/peer-comms-types.hpp"
+
+// Compact tag naming a set of receivers. 0 is never a valid group.
+using MulticastGroup = uint16_t;
+constexpr MulticastGroup NO_MULTICAST_GROUP = 0;
+
+// Derives the group tag for `name`, optionally scoped to one device (a chain's
+// champion, a shootout's coordinator) so neighbouring chains and tournaments
+// don't share a group. Every member computes the same tag independently.
+MulticastGroup multicastGroupFor(const char* name, const uint8_t* scopeMac = nullptr);
+
+// Prepends the MulticastHdr for `group` to `data`, replacing `out`.
+void buildMulticastPayload(MulticastGroup group, PktType packetType,
+                           const uint8_t* data, size_t length, std::vector<uint8_t>& out);
+
+// Groups this device has joined, and the receive-side filter for kMulticast
+// packets.
+//
+// A multicast send is one broadcast frame carrying a MulticastHdr, so it costs
+// one transmission however many peers listen. There are no MAC-layer ACKs or
+// retries on broadcast: use it for traffic that is fire-and-forget anyway.
+//
+// Fixed storage, no allocation. Not thread safe; drivers join, leave and
+// filter on the loop thread.
+class MulticastMembership {
+public:
+    static constexpr size_t kMaxGroups = 8;
+
+    struct Stats {
+        uint32_t accepted = 0;
+        uint32_t filtered = 0;      // not a member
+        uint32_t malformed = 0;
+    };
+
+    // False if `group` is invalid or kMaxGroups are already joined. Joining
+    // a group twice is harmless.
+    bool join(MulticastGroup group);
+    bool leave(MulticastGroup group);
+    void clear();
+
+    bool isMember(MulticastGroup group) const;
+    size_t size() const { return size_; }
+
+    // Unwraps a kMulticast payload addressed to a joined group, pointing
+    // `packetType`, `payload` and `payloadLen` at the inner packet. False if
+    // it's for another group or malformed.
+    bool accept(const uint8_t* data, size_t length,
+                PktType& packetType, const uint8_t*& payload, size_t& payloadLen);
+
+    const Stats& getStats() const { return stats_; }
+
+private:
+    std::array<MulticastGroup, kMaxGroups> groups_{};
+    size_t size_ = 0;
+    Stats stats_;
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "device/drivers/peer-comms-types.hpp"
+#include "wireless/send-queue.hpp"
+
+// Small control messages eligible for bundling: acks, confirms and role
+// announcements. Each is a few bytes that would otherwise cost a frame.
+bool isCoalescible(PktType packetType);
+
+// Send-side bundling of small control messages, per destination, per loop tick.
+//
+// While enabled, drivers stage eligible messages here instead of queueing a
+// frame for each. flush(), called once or twice per exec(), turns each
+// destination's staged messages into one kBundle packet (BundleEntryHdr +
+// payload, repeated), or into the original packet if only one was staged. The
+// bundle takes the most urgent priority class and earliest deadline among its
+// messages. Receivers unwrap bundles with forEachBundled() before dispatch, so
+// handlers see the original packets.
+//
+// A send to a destination that has staged messages flushes them first, so
+// per-destination order is preserved. Staged messages wait at most until the
+// next flush; sendData() has already returned 0 for them, which is fine for
+// control traffic that carries its own retries.
+//
+// Fixed storage, no allocation. Not thread safe; drivers call it under their
+// send lock.
+class PacketCoalescer {
+public:
+    static constexpr size_t kMaxDestinations = 8;
+    // Larger messages gain little from sharing a frame
+    static constexpr size_t kMaxMessageLen = 32;
+    static constexpr size_t kMaxBundleLen = PEER_COMMS_MAX_FRAME_PAYLOAD;
+
+    struct Stats {
+        uint32_t staged = 0;        // messages taken by stage()
+        uint32_t bundles = 0;       // kBundle packets emitted
+        uint32_t singles = 0;       // staged messages emitted on their own
+        uint32_t framesSaved = 0;   // staged - (bundles + singles)
+    };
+
+    void setEnabled(bool enabled) { enabled_ = enabled; }
+    bool isEnabled() const { return enabled_; }
+
+    // Stages the message for `dst`. False (nothing staged) when coalescing is
+    // off, the message isn't eligible, or it doesn't fit: the caller should
+    // flush(dst) and retry once, then send it normally.
+    bool stage(const uint8_t* dst, PktType packetType, const uint8_t* data, size_t length,
+               const SendOptions& options, unsigned long nowMs);
+
+    // Emits every destination's staged messages through
+    // `emit(const uint8_t* dst, PktType, const uint8_t* data, size_t length, const SendOptions&)`.
+    template <typename EmitFn>
+    void flush(unsigned long nowMs, EmitFn&& emit) {
+        for (auto& pending : pending_) {
+            if (pending.used) {
+                emitPending(pending, nowMs, emit);
+            }
+        }
+    }
+
+    // Emits only `dst`'s staged messages. False if it had none.
+    template <typename EmitFn>
+    bool flush(const uint8_t* dst, unsigned long nowMs, EmitFn&& emit) {
+        Pending* pending = find(dst);
+        if (!pending) {
+            return false;
+        }
+        emitPending(*pending, nowMs, emit);
+        return true;
+    }
+
+    bool hasPending() const;
+    const Stats& getStats() const { return stats_; }
+
+private:
+    struct Pending {
+        bool used = false;
+        uint8_t mac[6] = {};
+        uint8_t count = 0;
+        size_t length = 0;
+        SendPriority priority = SendPriority::kBulk;
+        bool hasDeadline = false;
+        unsigned long deadlineMs = 0;
+        std::array<uint8_t, kMaxBundleLen> data{};
+    };
+
+    template <typename EmitFn>
+    void emitPending(Pending& pending, unsigned long nowMs, EmitFn& emit) {
+        SendOptions options;
+        options.priority = pending.priority;
+        if (pending.hasDeadline) {
+            // Already late messages still get the shortest deadline there is
+            long remaining = static_cast<long>(pending.deadlineMs - nowMs);
+            options.maxAgeMs = remaining > 0 ? static_cast<unsigned long>(remaining) : 1;
+        }
+        if (pending.count == 1) {
+            BundleEntryHdr hdr;
+            memcpy(&hdr, pending.data.data(), sizeof(hdr));
+            stats_.singles++;
+            emit(pending.mac, hdr.packetType, pending.data.data() + sizeof(hdr), hdr.length, options);
+        } else {
+            stats_.bundles++;
+            stats_.framesSaved += pending.count - 1;
+            emit(pending.mac, PktType::kBundle, pending.data.data(), pending.length, options);
+        }
+        pending = Pending();
+    }
+
+    Pending* find(const uint8_t* mac);
+
+    bool enabled_ = false;
+    std::array<Pending, kMaxDestinations> pending_{};
+    Stats stats_;
+};
+
+// Calls `fn(PktType, const uint8_t* payload, size_t length)` for each message
+// in a kBundle payload. A malformed bundle (truncated entry, transport-level or
+// unknown inner type) is rejected whole: returns false without calling `fn`.
+template <typename Fn>
+bool forEachBundled(const uint8_t* data, size_t length, Fn&& fn) {
+    size_t entries = 0;
+    for (size_t pos = 0; pos < length; entries++) {
+        BundleEntryHdr hdr;
+        if (length - pos < sizeof(hdr)) {
+            return false;
+        }
+        memcpy(&hdr, data + pos, sizeof(hdr));
+        pos += sizeof(hdr);
+        if (!isCoalescible(hdr.packetType) || length - pos < hdr.length) {
+            return false;
+        }
+        pos += hdr.length;
+    }
+    if (entries == 0) {
+        return false;
+    }
+    for (size_t pos = 0; pos < length;) {
+        BundleEntryHdr hdr;
+        memcpy(&hdr, data + pos, sizeof(hdr));
+        pos += sizeof(hdr);
+        fn(hdr.packetType, data + pos, static_cast<size_t>(hdr.length));
+        pos += hdr.length;
+    }
+    return true;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include "device/drivers/peer-comms-types.hpp"
+
+// Wire layout of a packet type: the packed struct its payload starts with and
+// the lengths it may arrive at. Specialise it next to the payload struct by
+// deriving from FixedPacketLayout or PrefixPacketLayout. Types without a
+// layout can't be used with decodePacket() or packetHandler().
+template <PktType Type>
+struct PacketLayout;
+
+namespace packet_layout_detail {
+
+template <typename T>
+struct CheckWireStruct {
+    static_assert(std::is_trivially_copyable<T>::value, "wire payloads must be trivially copyable");
+    static_assert(alignof(T) == 1, "wire payloads must be packed");
+    static_assert(sizeof(T) <= PEER_COMMS_MAX_FRAME_PAYLOAD, "wire payload header must fit in one frame");
+    static constexpr bool ok = true;
+};
+
+template <typename Method>
+struct MemberOf;
+
+template <typename C, typename R, typename... Args>
+struct MemberOf<R (C::*)(Args...)> {
+    using type = C;
+};
+
+}  // namespace packet_layout_detail
+
+// Payload is exactly one T, no more and no less
+template <typename T>
+struct FixedPacketLayout {
+    static_assert(packet_layout_detail::CheckWireStruct<T>::ok, "");
+    using Payload = T;
+    static bool validLength(const T&, size_t length) { return length == sizeof(T); }
+};
+
+// Payload is a T followed by a variable tail, which the handler parses
+template <typename T>
+struct PrefixPacketLayout {
+    static_assert(packet_layout_detail::CheckWireStruct<T>::ok, "");
+    using Payload = T;
+    static bool validLength(const T&, size_t length) { return length >= sizeof(T); }
+};
+
+// Returns the payload viewed as its struct, or nullptr if `length` doesn't
+// match the layout. The struct is packed, so the view is valid at any address.
+template <PktType Type>
+const typename PacketLayout<Type>::Payload* decodePacket(const uint8_t* data, size_t length) {
+    using Payload = typename PacketLayout<Type>::Payload;
+    if (data == nullptr || length < sizeof(Payload)) {
+        return nullptr;
+    }
+    const Payload* payload = reinterpret_cast<const Payload*>(data);
+    return PacketLayout<Type>::validLength(*payload, length) ? payload : nullptr;
+}
+
+// A PacketCallback that decodes `Type` and calls `Method` on the context
+// object. Method is `void C::m(const uint8_t* src, const Payload& payload,
+// size_t length)`; malformed packets are dropped before it runs. For example:
+//
+//   wirelessManager->setEspNowPacketHandler(PktType::kRoleAnnounce,
+//       packetHandler<PktType::kRoleAnnounce, &Quickdraw::onRoleAnnouncePacket>, this);
+template <PktType Type, auto Method>
+void packetHandler(const uint8_t* src, const uint8_t* data, const size_t length, void* ctx) {
+    using Target = typename packet_layout_detail::MemberOf<decltype(Method)>::type;
+    const auto* payload = decodePacket<Type>(data, length);
+    if (payload == nullptr || ctx == nullptr) {
+        return;
+    }
+    (static_cast<Target*>(ctx)->*Method)(src, *payload, length);
+}
+
+// One handler slot per packet type, indexed by the type itself. Drivers use it
+// in place of a map so dispatch is a bounds check and an array load.
+class PacketHandlerTable {
+public:
+    // Same signature as PeerCommsInterface::PacketCallback
+    using Callback = std::function<void(const uint8_t* src, const uint8_t* data, const size_t length, void* ctx)>;
+
+    void set(PktType type, Callback callback, void* ctx) {
+        if (!inRange(type)) return;
+        Entry& entry = entries_[static_cast<size_t>(type)];
+        entry.callback = std::move(callback);
+        entry.context = ctx;
+    }
+
+    void clear(PktType type) {
+        set(type, nullptr, nullptr);
+    }
+
+    bool has(PktType type) const {
+        return inRange(type) && static_cast<bool>(entries_[static_cast<size_t>(type)].callback);
+    }
+
+    // False if `type` is out of range or has no handler
+    bool dispatch(const uint8_t* src, PktType type, const uint8_t* data, size_t length) const {
+        if (!inRange(type)) return false;
+        const Entry& entry = entries_[static_cast<size_t>(type)];
+        if (!entry.callback) return false;
+        entry.callback(src, data, length, entry.context);
+        return true;
+    }
+
+private:
+    struct Entry {
+        Callback callback;
+        void* context = nullptr;
+    };
+
+    static bool inRange(PktType type) {
+        return static_cast<size_t>(type) < static_cast<size_t>(PktType::kNumPacketTypes);
+    }
+
+    std::array<Entry, static_cast<size_t>(PktType::kNumPacketTypes)> entries_{};
+};
+
+// Layouts for payloads declared in peer-comms-types.hpp. Game payloads that
+// live with their feature (ChainGameEventPayload, QuickdrawPacket) register
+// theirs beside the struct.
+template <>
+struct PacketLayout<PktType::kChainAnnouncement> : PrefixPacketLayout<ChainAnnouncementHdr> {
+    static bool validLength(const ChainAnnouncementHdr& hdr, size_t length) {
+        return length == sizeof(ChainAnnouncementHdr) + static_cast<size_t>(hdr.peerCount) * 6;
+    }
+};
+
+template <> struct PacketLayout<PktType::kChainAnnouncementAck> : FixedPacketLayout<ChainAnnouncementAckPayload> {};
+template <> struct PacketLayout<PktType::kChainConfirm> : FixedPacketLayout<ChainConfirmPayload> {};
+template <> struct PacketLayout<PktType::kRoleAnnounce> : FixedPacketLayout<RoleAnnouncePayload> {};
+template <> struct PacketLayout<PktType::kRoleAnnounceAck> : FixedPacketLayout<RoleAnnounceAckPayload> {};
+template <> struct PacketLayout<PktType::kChainGameEventAck> : FixedPacketLayout<ChainGameEventAckPayload> {};
+template <> struct PacketLayout<PktType::kShootoutCommand> : PrefixPacketLayout<ShootoutPacket> {};
+template <> struct PacketLayout<PktType::kShootoutCommandAck> : FixedPacketLayout<ShootoutAckPayload> {};
+template <> struct PacketLayout<PktType::kFragmentNack> : FixedPacketLayout<FragmentNackPayload> {};
+template <> struct PacketLayout<PktType::kMulticast> : PrefixPacketLayout<MulticastHdr> {};
+template <> struct PacketLayout<PktType::kBundle> : PrefixPacketLayout<BundleEntryHdr> {};
+template <> struct PacketLayout<PktType::kBulkTransfer> : PrefixPacketLayout<BulkHdr> {};
+template <> struct PacketLayout<PktType::kLinkCaps> : FixedPacketLayout<LinkCapsPayload> {};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include "device/drivers/peer-comms-types.hpp"
+
+// Largest payload a single receive slot can hold. One full radio frame, so
+// every frame the radio can deliver fits without a heap allocation.
+constexpr size_t PACKET_RING_SLOT_SIZE = PEER_COMMS_MAX_FRAME_LEN;
+
+struct PacketRingSlot {
+    PktType type;
+    uint8_t srcMac[6];
+    size_t len;
+    uint8_t data[PACKET_RING_SLOT_SIZE];
+    // Only used for reassembled multi-frame payloads handed over by pushLarge()
+    std::vector<uint8_t> large;
+
+    const uint8_t* payload() const { return large.empty() ? data : large.data(); }
+};
+
+// Single-producer / single-consumer ring of preallocated receive slots.
+//
+// The producer (WiFi task on device, broker delivery in native builds) calls
+// push(); the consumer (driver exec() on the main loop) walks front()/pop().
+// Neither side takes a lock or touches the heap. A slot is only handed back
+// to the producer after pop(), so handlers may read front()->data in place.
+//
+// Two failure counters are kept instead of growing:
+//  - overflows: push() found the ring full (consumer fell behind)
+//  - drops:     payload larger than PACKET_RING_SLOT_SIZE was rejected
+//
+// Reassembled clusters can exceed a slot. Their reassembly buffer is moved in
+// with pushLarge() rather than copied, so the only allocation is the one the
+// reassembler already made; pop() releases it.
+template <size_t Capacity>
+class PacketRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "PacketRing capacity must be a power of two");
+
+public:
+    // Producer side. Returns false (and counts it) if the packet was not queued.
+    bool push(PktType type, const uint8_t* srcMac, const uint8_t* data, size_t len) {
+        if (len > PACKET_RING_SLOT_SIZE) {
+            drops_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        if (head - tail >= Capacity) {
+            overflows_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        PacketRingSlot& slot = slots_[head & (Capacity - 1)];
+        slot.type = type;
+        memcpy(slot.srcMac, srcMac, sizeof(slot.srcMac));
+        slot.len = len;
+        if (len > 0) {
+            memcpy(slot.data, data, len);
+        }
+
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer side. Takes ownership of `data` (a completed reassembly buffer).
+    // On failure `data` is left untouched.
+    bool pushLarge(PktType type, const uint8_t* srcMac, std::vector<uint8_t>&& data) {
+        if (data.size() <= PACKET_RING_SLOT_SIZE) {
+            return push(type, srcMac, data.data(), data.size());
+        }
+
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        if (head - tail >= Capacity) {
+            overflows_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        PacketRingSlot& slot = slots_[head & (Capacity - 1)];
+        slot.type = type;
+        memcpy(slot.srcMac, srcMac, sizeof(slot.srcMac));
+        slot.len = data.size();
+        slot.large = std::move(data);
+
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Oldest queued slot, or nullptr if empty.
+    const PacketRingSlot* front() const {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (head_.load(std::memory_order_acquire) == tail) {
+            return nullptr;
+        }
+        return &slots_[tail & (Capacity - 1)];
+    }
+
+    // Consumer side. Releases the slot returned by front() back to the producer.
+    void pop() {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (head_.load(std::memory_order_acquire) == tail) {
+            return;
+        }
+        std::vector<uint8_t>().swap(slots_[tail & (Capacity - 1)].large);
+        tail_.store(tail + 1, std::memory_order_release);
+    }
+
+    // Snapshot of queued slots. Exact from the consumer, approximate elsewhere.
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+    uint32_t getOverflowCount() const { return overflows_.load(std::memory_order_relaxed); }
+    uint32_t getDropCount() const { return drops_.load(std::memory_order_relaxed); }
+
+    void resetCounters() {
+        overflows_.store(0, std::memory_order_relaxed);
+        drops_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::array<PacketRingSlot, Capacity> slots_{};
+    std::atomic<size_t> head_{0};
+    std::atomic<size_t> tail_{0};
+    std::atomic<uint32_t> overflows_{0};
+    std::atomic<uint32_t> drops_{0};
+};
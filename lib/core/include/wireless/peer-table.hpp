@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "device/drivers/peer-comms-types.hpp"
+
+// ESP-NOW holds at most 20 peers (ESP_NOW_MAX_TOTAL_PEER_NUM), the broadcast
+// address included.
+constexpr size_t PEER_TABLE_CAPACITY = 20;
+
+// Peers whose LinkCapsPayload is remembered, resident or not: a 32-player
+// shootout with room to spare.
+constexpr size_t PEER_CAPS_CAPACITY = 64;
+
+// Mirror of the radio's peer table that decides what to evict when it fills.
+//
+// Every registration and unicast send admits the destination, which refreshes
+// its position in LRU order. When a new peer arrives at a full table, the
+// least recently used unpinned entry is chosen for eviction and handed back
+// to the driver to delete from the radio. Pinned entries (the broadcast
+// address, direct peers on the jacks, the chain champion) are never evicted;
+// if every entry is pinned the admission fails.
+//
+// Alongside the entries it remembers the largest frame each peer receives,
+// learned from LinkCapsPayload. Caps are kept per MAC apart from residency,
+// so an evicted peer coming back is not asked again; with more than
+// PEER_CAPS_CAPACITY peers the least recently heard one is forgotten.
+//
+// Fixed storage, no allocation. Not thread safe; drivers guard it.
+class PeerTable {
+public:
+    enum class Admit : uint8_t {
+        kPresent,       // already resident; usage refreshed
+        kAdded,         // took a free entry
+        kEvicted,       // took the entry of the peer copied to `evicted`
+        kFull,          // every entry is pinned
+    };
+
+    struct Stats {
+        uint32_t hits = 0;
+        uint32_t adds = 0;
+        uint32_t evictions = 0;
+        uint32_t rejected = 0;
+    };
+
+    explicit PeerTable(size_t capacity = PEER_TABLE_CAPACITY);
+
+    // Makes `mac` resident. `pin` protects it from eviction until unpin() or
+    // remove(); admitting an already pinned peer unpinned leaves the pin in
+    // place. On kEvicted the displaced MAC is written to `evicted` and the
+    // caller must remove it from the radio.
+    Admit admit(const uint8_t* mac, bool pin, uint8_t* evicted);
+
+    // Makes a pinned entry evictable again. False if `mac` isn't resident.
+    bool unpin(const uint8_t* mac);
+
+    // Forgets `mac`. False if it wasn't resident.
+    bool remove(const uint8_t* mac);
+
+    // Forgets every entry. Recorded caps stay.
+    void clear();
+
+    // Records what `mac` said it receives, whether or not it is resident.
+    void setMaxFrameLen(const uint8_t* mac, size_t maxFrameLen);
+
+    // PEER_COMMS_MAX_FRAME_LEN until the peer's caps arrive.
+    size_t maxFrameLen(const uint8_t* mac) const;
+
+    // True the first time it's called for a MAC neither heard from nor
+    // asked before, after which the request is remembered. Drivers ask for
+    // caps only then, so LRU churn doesn't turn into caps traffic.
+    bool shouldRequestCaps(const uint8_t* mac);
+
+    bool contains(const uint8_t* mac) const { return find(mac) != nullptr; }
+    bool isPinned(const uint8_t* mac) const;
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    size_t pinnedCount() const;
+
+    const Stats& getStats() const { return stats_; }
+
+private:
+    struct Entry {
+        bool used = false;
+        bool pinned = false;
+        uint8_t mac[6] = {};
+        uint32_t lastUsed = 0;
+    };
+
+    struct Caps {
+        bool used = false;
+        uint8_t mac[6] = {};
+        uint32_t lastUsed = 0;
+        uint16_t maxFrameLen = PEER_COMMS_MAX_FRAME_LEN;
+    };
+
+    Entry* find(const uint8_t* mac);
+    const Entry* find(const uint8_t* mac) const;
+    const Caps* findCaps(const uint8_t* mac) const;
+    Caps& findOrAddCaps(const uint8_t* mac);
+
+    std::array<Entry, PEER_TABLE_CAPACITY> entries_{};
+    std::array<Caps, PEER_CAPS_CAPACITY> caps_{};
+    size_t capacity_;
+    size_t size_ = 0;
+    uint32_t useCounter_ = 0;
+    Stats stats_;
+};
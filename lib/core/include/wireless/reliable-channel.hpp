@@ -0,0 +1,151 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "utils/simple-timer.hpp"
+
+// Sequence/ACK/retransmit bookkeeping shared by the game-layer protocols
+// (RDC chain announcements, chain-duel role announces and game events,
+// shootout commands).
+//
+// The channel never touches the radio. Callers send the first copy
+// themselves, track() it, and feed ACKs back through ack(). poll() runs from
+// the owner's sync() and invokes the retransmit callback for every entry
+// whose timer has lapsed; once maxRetries retransmits have gone unanswered
+// the next expiry abandons the entry instead.
+//
+// Sequence numbers are allocated per peer and skip 0, which every protocol
+// on top of this uses as its "no ACK wanted" sentinel. Callers that send one
+// packet to many peers under a single id (shootout) pass the id in with
+// trackWithSeq() instead.
+//
+// The retransmit timeout follows RFC 6298 per peer: ACK latency on
+// first-transmission entries feeds SRTT/RTTVAR, and RTO = SRTT + 4 * RTTVAR
+// clamped to [minRtoMs, maxRtoMs]. Samples from retransmitted entries are
+// ambiguous and skipped (Karn). Each retry doubles the timeout, up to
+// maxBackoffShift doublings. With no samples yet the RTO comes from the
+// RTT seed callback if it knows the peer, else initialRtoMs. Clean samples
+// are also passed to the RTT observer so other layers can learn from them.
+//
+// Not thread safe; owned and driven from the main loop.
+class ReliableChannel {
+public:
+    struct Config {
+        unsigned long initialRtoMs = 100;
+        unsigned long minRtoMs = 100;
+        unsigned long maxRtoMs = 2000;
+        uint8_t maxRetries = 3;
+        uint8_t maxBackoffShift = 7;
+        // Peers whose sequence/RTT state is remembered. Idle peers past this
+        // are forgotten least-recently-used first.
+        size_t maxPeers = 32;
+    };
+
+    // Cumulative since construction. ackLatencyMsSum / ackCount gives mean
+    // ACK latency; abandons / (sends + retries) gives loss rate.
+    struct Stats {
+        uint32_t sends = 0;
+        uint32_t retries = 0;
+        uint32_t abandons = 0;
+        uint32_t ackLatencyMsSum = 0;
+        uint32_t ackCount = 0;
+    };
+
+    // Puts a tracked message back on the air. Return false if it can no
+    // longer be delivered (peer gone, state moved on); the entry is then
+    // dropped without counting as an abandon.
+    using RetransmitCallback = std::function<bool(const uint8_t* peer, uint8_t seq, uint8_t tag, uint32_t context)>;
+
+    // Fired once per entry that ran out of retries, after it is removed.
+    using AbandonCallback = std::function<void(const uint8_t* peer, uint8_t seq, uint8_t tag, uint32_t context)>;
+
+    // Receives each RTT sample the channel itself uses (first transmissions only).
+    using RttObserver = std::function<void(const uint8_t* peer, unsigned long rttMs)>;
+
+    // Supplies a starting SRTT/RTTVAR for a peer the channel has no samples
+    // for. Return false if unknown.
+    using RttSeed = std::function<bool(const uint8_t* peer, unsigned long& srttMs, unsigned long& rttvarMs)>;
+
+    ReliableChannel();
+    explicit ReliableChannel(const Config& config);
+
+    void setRetransmitCallback(RetransmitCallback callback) { retransmitCallback_ = std::move(callback); }
+    void setAbandonCallback(AbandonCallback callback) { abandonCallback_ = std::move(callback); }
+    void setRttObserver(RttObserver observer) { rttObserver_ = std::move(observer); }
+    void setRttSeed(RttSeed seed) { rttSeed_ = std::move(seed); }
+
+    // Next sequence number for `peer`. Use for untracked sends that share
+    // the peer's sequence space.
+    uint8_t nextSeq(const uint8_t* peer);
+
+    // Allocates a sequence number for `peer` and starts its retransmit timer.
+    // Call right after the first transmission. A pending entry for the same
+    // (peer, tag) is superseded. Returns the sequence number.
+    uint8_t track(const uint8_t* peer, uint8_t tag, uint32_t context = 0);
+
+    // Same as track() with a caller-chosen sequence number.
+    void trackWithSeq(const uint8_t* peer, uint8_t seq, uint8_t tag, uint32_t context = 0);
+
+    // Clears the entry matching (peer, seq, tag). Returns false for stale or
+    // unknown ACKs.
+    bool ack(const uint8_t* peer, uint8_t seq, uint8_t tag);
+
+    // Drops pending entries without counting them as abandoned.
+    size_t cancel(const uint8_t* peer, uint8_t tag);
+    size_t cancelTag(uint8_t tag);
+    void clear();
+
+    // Retransmits or abandons every expired entry.
+    void poll();
+
+    size_t pendingCount() const { return pending_.size(); }
+    size_t pendingCount(uint8_t tag) const;
+    bool isPending(const uint8_t* peer, uint8_t tag) const;
+
+    // Current base retransmit timeout toward `peer`, before backoff.
+    unsigned long rtoMs(const uint8_t* peer) const;
+
+    const Stats& getStats() const { return stats_; }
+    const Config& getConfig() const { return config_; }
+
+private:
+    struct PeerState {
+        std::array<uint8_t, 6> mac;
+        uint8_t nextSeq = 1;
+        bool hasRtt = false;
+        unsigned long srttMs = 0;
+        unsigned long rttvarMs = 0;
+        uint32_t lastUsed = 0;
+    };
+
+    struct Pending {
+        std::array<uint8_t, 6> peer;
+        uint8_t seq;
+        uint8_t tag;
+        uint32_t context;
+        uint8_t retries;
+        SimpleTimer timer;
+    };
+
+    size_t indexOf(const uint8_t* peer, uint8_t seq, uint8_t tag) const;
+    PeerState& peerState(const uint8_t* peer);
+    const PeerState* findPeer(const uint8_t* peer) const;
+    unsigned long rtoFor(const PeerState& state) const;
+    unsigned long timeoutFor(const uint8_t* peer, uint8_t retries);
+    void sampleRtt(PeerState& state, unsigned long rttMs);
+    void evictIdlePeer();
+
+    Config config_;
+    Stats stats_;
+    std::vector<PeerState> peers_;
+    std::vector<Pending> pending_;
+    uint32_t useCounter_ = 0;
+    RetransmitCallback retransmitCallback_;
+    AbandonCallback abandonCallback_;
+    RttObserver rttObserver_;
+    RttSeed rttSeed_;
+};
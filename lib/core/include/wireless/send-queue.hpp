@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "device/drivers/peer-comms-types.hpp"
+#include "wireless/frame-pool.hpp"
+
+// Scheduling class of an outgoing packet. Lower value transmits first.
+enum class SendPriority : uint8_t {
+    kDuel = 0,      // Quickdraw and chain-duel traffic; a late frame decides a duel
+    kControl = 1,   // Chain/shootout/handshake control and their acks
+    kBulk = 2,      // Periodic broadcasts and anything that can wait
+};
+
+constexpr size_t SEND_PRIORITY_COUNT = 3;
+
+struct SendOptions {
+    SendPriority priority = SendPriority::kControl;
+    // Drop the packet if it has not started transmitting this many ms after
+    // sendData(). 0 = no deadline.
+    unsigned long maxAgeMs = 0;
+};
+
+// Class used for sendData() calls that don't pass SendOptions.
+SendOptions defaultSendOptions(PktType packetType);
+
+// One frame waiting for the radio. `ptr` is a SendFramePool block (or a
+// LargeSendFramePool block for a v2 frame) owned by the driver; the scheduler
+// only moves the descriptor around.
+struct QueuedFrame {
+    uint8_t dstMac[6];
+    uint8_t* ptr;
+    size_t len;
+    PktType packetType;
+    SendPriority priority;
+    uint8_t idxInCluster;
+    unsigned long enqueuedMs;
+    unsigned long deadlineMs;   // only meaningful when hasDeadline
+    bool hasDeadline;
+};
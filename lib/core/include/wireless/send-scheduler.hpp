@@ -0,0 +1,230 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "wireless/send-queue.hpp"
+
+// Send-side scheduling shared by EspNowManager and NativePeerCommsDriver.
+//
+// Every destination MAC has its own FIFO per SendPriority; the broadcast
+// address is one more destination. next() serves the highest class that has
+// a frame ready and rotates between destinations within it, so a bracket fanned
+// out to 31 peers interleaves instead of queueing behind the slowest peer.
+//
+// Up to Config::maxInFlight frames may be on air at once but only one per
+// destination. That keeps each destination's frames in order and lets a send
+// callback, which only reports the address, be matched to its frame.
+//
+// A failed send, whether refused by the radio or reported failed by the send
+// callback, keeps the frame at its destination for retry and holds that
+// destination off with exponential backoff. Other destinations keep sending.
+// After maxRetries retries the frame is given up.
+//
+// Deadlines are checked when a cluster reaches the head of its FIFO. If its
+// first frame is past its deadline, the whole cluster is dropped and each frame
+// is passed to the caller's drop function so pool blocks can be released.
+// Once a cluster's first frame has gone out the rest are always sent.
+//
+// Storage is fixed and sized to the send pools, since every queued or in-flight
+// frame holds a pool block. Nothing here allocates. Not thread safe; drivers
+// call it under their send lock.
+class SendScheduler {
+public:
+    static constexpr size_t kCapacity = SEND_FRAME_POOL_BLOCKS + LARGE_SEND_FRAME_POOL_BLOCKS;
+    // A busy destination holds at least one pool block, so with one entry per
+    // block push() never runs out of destinations for a reserved frame
+    static constexpr size_t kMaxDestinations = kCapacity;
+
+    struct Config {
+        size_t maxInFlight = 4;
+        uint8_t maxRetries = 5;
+        unsigned long backoffBaseMs = 2;
+        unsigned long backoffMaxMs = 64;
+    };
+
+    // Per destination, cumulative except depth.
+    struct DestinationStats {
+        size_t depth = 0;               // frames queued right now
+        size_t maxDepth = 0;
+        uint32_t started = 0;           // frames handed to the radio for the first time
+        uint32_t delivered = 0;
+        uint32_t failed = 0;            // given up after maxRetries
+        uint32_t retries = 0;
+        uint32_t expired = 0;
+        // push() to first transmission; divide by started for the mean
+        unsigned long queueDelayMsSum = 0;
+        unsigned long queueDelayMsMax = 0;
+        // First transmission to successful completion; divide by delivered
+        unsigned long txLatencyMsSum = 0;
+        unsigned long txLatencyMsMax = 0;
+    };
+
+    struct Stats {
+        std::array<uint32_t, SEND_PRIORITY_COUNT> enqueued{};
+        std::array<uint32_t, SEND_PRIORITY_COUNT> dequeued{};
+        std::array<uint32_t, SEND_PRIORITY_COUNT> expired{};
+        uint32_t retries = 0;
+        uint32_t failed = 0;
+        // Most frames that were on air at the same time
+        size_t maxInFlight = 0;
+        // Longest time any frame waited between push() and first transmission
+        unsigned long maxQueueDelayMs = 0;
+    };
+
+    SendScheduler();
+    explicit SendScheduler(const Config& config);
+
+    // Returns false (frame not queued) when storage or the destination table
+    // is full.
+    bool push(const QueuedFrame& frame);
+
+    // Picks the next frame to put on air and marks it in flight. Expired
+    // clusters met on the way are removed and each frame handed to
+    // `onDrop(const QueuedFrame&)`. Returns false when nothing may be sent now:
+    // the queue is empty, the in-flight limit is reached, or every destination
+    // with work is busy or backing off.
+    template <typename DropFn>
+    bool next(unsigned long nowMs, QueuedFrame& out, DropFn&& onDrop) {
+        if (onAir_ >= config_.maxInFlight) {
+            return false;
+        }
+        for (size_t p = 0; p < SEND_PRIORITY_COUNT; p++) {
+            for (size_t step = 1; step <= kMaxDestinations; step++) {
+                size_t d = (cursor_[p] + step) % kMaxDestinations;
+                Destination& dest = destinations_[d];
+                if (!dest.used || dest.onAir || isBackingOff(dest, nowMs)) {
+                    continue;
+                }
+                if (dest.hasInFlight) {
+                    // A retry goes out at its own class, ahead of newer frames
+                    if (static_cast<size_t>(dest.inFlight.priority) != p) {
+                        continue;
+                    }
+                } else {
+                    dropExpired(dest, p, nowMs, onDrop);
+                    if (dest.head[p] == kNone) {
+                        continue;
+                    }
+                    startNext(dest, p, nowMs);
+                }
+                markOnAir(dest);
+                cursor_[p] = d;
+                out = dest.inFlight;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Reports the outcome of the frame last returned by next() for `dst`.
+    // Returns true when that frame is finished, either delivered or out of
+    // retries, and copies it into `finished` so the caller can release its
+    // block. Returns false when it will be retried after a backoff, or when
+    // nothing was in flight to `dst`.
+    bool onSendDone(const uint8_t* dst, bool delivered, unsigned long nowMs, QueuedFrame& finished);
+
+    // Copies the frame currently on air to `dst`, so a send callback that
+    // only reports the address can tell what it was. False if none is.
+    bool peekOnAir(const uint8_t* dst, QueuedFrame& out) const;
+
+    // Empties every queue, passing each frame to `onDrop`. Frames in flight
+    // stay with the radio and finish through onSendDone(). Not counted as
+    // expiry.
+    template <typename DropFn>
+    void clear(DropFn&& onDrop) {
+        for (auto& dest : destinations_) {
+            if (!dest.used) {
+                continue;
+            }
+            for (size_t p = 0; p < SEND_PRIORITY_COUNT; p++) {
+                while (dest.head[p] != kNone) {
+                    onDrop(popHead(dest, p));
+                }
+            }
+        }
+    }
+
+    // Frames waiting, not counting those in flight
+    size_t size() const { return queued_; }
+    size_t size(SendPriority priority) const;
+    bool empty() const { return queued_ == 0; }
+    size_t inFlight() const { return onAir_; }
+
+    // False if `mac` has no entry (never used, or evicted while idle).
+    bool getDestinationStats(const uint8_t* mac, DestinationStats& out) const;
+
+    // Calls fn(const uint8_t* mac, const DestinationStats&) per known destination.
+    template <typename Fn>
+    void forEachDestination(Fn&& fn) const {
+        for (const auto& dest : destinations_) {
+            if (dest.used) {
+                fn(dest.mac, dest.stats);
+            }
+        }
+    }
+
+    const Stats& getStats() const { return stats_; }
+    const Config& getConfig() const { return config_; }
+    void resetStats();
+
+private:
+    static constexpr uint8_t kNone = 0xFF;
+    static_assert(kCapacity < kNone, "slot indices must fit in uint8_t");
+
+    struct Destination {
+        bool used = false;
+        uint8_t mac[6] = {};
+        std::array<uint8_t, SEND_PRIORITY_COUNT> head{};
+        std::array<uint8_t, SEND_PRIORITY_COUNT> tail{};
+        QueuedFrame inFlight = {};
+        bool hasInFlight = false;   // holding a frame: on air or awaiting retry
+        bool onAir = false;
+        uint8_t retries = 0;
+        uint8_t consecutiveFailures = 0;
+        unsigned long startedMs = 0;
+        unsigned long backoffUntilMs = 0;
+        uint32_t lastUsed = 0;
+        DestinationStats stats;
+    };
+
+    Destination* find(const uint8_t* mac);
+    const Destination* find(const uint8_t* mac) const;
+    Destination* findOrAdd(const uint8_t* mac);
+    QueuedFrame popHead(Destination& dest, size_t p);
+    void startNext(Destination& dest, size_t p, unsigned long nowMs);
+    void markOnAir(Destination& dest);
+
+    static bool isBackingOff(const Destination& dest, unsigned long nowMs) {
+        return dest.consecutiveFailures > 0 &&
+               static_cast<long>(nowMs - dest.backoffUntilMs) < 0;
+    }
+
+    // Only a cluster that hasn't started transmitting can expire
+    static bool isExpired(const QueuedFrame& frame, unsigned long nowMs) {
+        return frame.hasDeadline && frame.idxInCluster == 0 &&
+               static_cast<long>(nowMs - frame.deadlineMs) > 0;
+    }
+
+    template <typename DropFn>
+    void dropExpired(Destination& dest, size_t p, unsigned long nowMs, DropFn& onDrop) {
+        while (dest.head[p] != kNone && isExpired(slots_[dest.head[p]], nowMs)) {
+            do {
+                onDrop(popHead(dest, p));
+                dest.stats.expired++;
+                stats_.expired[p]++;
+            } while (dest.head[p] != kNone && slots_[dest.head[p]].idxInCluster != 0);
+        }
+    }
+
+    Config config_;
+    Stats stats_;
+    std::array<QueuedFrame, kCapacity> slots_{};
+    std::array<uint8_t, kCapacity> nextSlot_{};
+    uint8_t freeHead_ = 0;
+    std::array<Destination, kMaxDestinations> destinations_{};
+    std::array<size_t, SEND_PRIORITY_COUNT> cursor_{};
+    size_t queued_ = 0;
+    size_t onAir_ = 0;
+    uint32_t useCounter_ = 0;
+};
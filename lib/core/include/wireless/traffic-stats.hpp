@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "device/drivers/peer-comms-types.hpp"
+
+enum class TrafficDirection : uint8_t {
+    kTx,
+    kRx,
+};
+
+// What one packet type cost in one direction. Frames are counted per
+// transmission, so a retried frame counts again; that is what it cost in
+// airtime.
+struct TrafficCounters {
+    uint32_t frames = 0;
+    uint32_t bytes = 0;             // whole frames, DataPktHdr included
+    uint32_t fragments = 0;         // frames belonging to multi-frame clusters
+    // Tx: sends the radio refused or never got acknowledged.
+    // Rx: frames dropped before dispatch (receive ring full).
+    uint32_t failures = 0;
+    // Tx only: push() into the send queue to each transmission
+    unsigned long queueDelayMsSum = 0;
+    unsigned long queueDelayMsMax = 0;
+};
+
+// ESP-NOW goes out at 1 Mbps with a long preamble unless the rate is changed:
+// 192 us of PLCP preamble and header, then 8 us per byte of the 802.11 action
+// frame (24 header, 4 FCS, 15 of category, OUI and vendor element) and ours.
+constexpr unsigned long ESP_NOW_PREAMBLE_US = 192;
+constexpr unsigned long ESP_NOW_FRAME_OVERHEAD_BYTES = 43;
+constexpr unsigned long ESP_NOW_US_PER_BYTE = 8;
+
+// Estimated time on air for `counters`, ignoring contention and link-layer
+// ACKs. Good enough to compare packet types and to budget a channel.
+unsigned long long estimateAirtimeUs(const TrafficCounters& counters);
+
+// Short, stable name for printing ("ChainAnnouncement"), or "?" if out of range.
+const char* pktTypeName(PktType type);
+
+// Per-PktType, per-direction traffic counters.
+//
+// Drivers count each frame as it is handed to the radio (tx) or arrives from
+// it (rx), under the type in its DataPktHdr. Bundles and multicasts count as
+// kBundle and kMulticast, since that is what went on air. Fixed storage, no
+// allocation. Not thread safe: the owning driver locks around it, since the
+// radio reports from its own task.
+class TrafficStats {
+public:
+    static constexpr size_t kNumTypes = static_cast<size_t>(PktType::kNumPacketTypes);
+
+    struct Snapshot {
+        std::array<TrafficCounters, kNumTypes> tx{};
+        std::array<TrafficCounters, kNumTypes> rx{};
+        unsigned long sinceMs = 0;      // last reset
+        unsigned long takenMs = 0;
+
+        const TrafficCounters& get(TrafficDirection direction, PktType type) const {
+            return (direction == TrafficDirection::kTx ? tx : rx)[static_cast<size_t>(type)];
+        }
+
+        // Sum over every packet type
+        TrafficCounters total(TrafficDirection direction) const;
+    };
+
+    void recordTx(PktType type, size_t frameLen, bool fragment, unsigned long queueDelayMs);
+    void recordRx(PktType type, size_t frameLen, bool fragment);
+    void recordFailure(TrafficDirection direction, PktType type);
+
+    // Copies every counter; cheap enough to call from a debug command
+    void snapshot(unsigned long nowMs, Snapshot& out) const;
+    void reset(unsigned long nowMs);
+
+private:
+    TrafficCounters* find(TrafficDirection direction, PktType type);
+
+    Snapshot counters_;
+};
+
+// One line for `type`, e.g.
+//   "ChainAnnouncement tx 40f 3120B 0frag 1fail q 2/9ms air 44ms | rx 38f 2964B 0drop"
+// Returns what snprintf returns. Callers skip types with no frames either way.
+int formatTrafficRow(const TrafficStats::Snapshot& snapshot, PktType type, char* out, size_t outLen);
@@ -24,11 +24,12 @@ void InputIdleState::onStateMounted(Device *PDN) {
 
 void InputIdleState::onStateLoop(Device *PDN) {
     if (emitMacTimer.expired()) {
-        PDN->getSerialManager()->writeString(
-            SEND_MAC_ADDRESS + MacToString(PDN->getWirelessManager()->getMacAddress()) +
-            PORT_SEPARATOR + std::to_string((int)jack) +
-            DEVICE_TYPE_SEPARATOR + std::to_string((int)PDN->getDeviceType()),
-            jack);
+        if (macBeacon.empty()) {
+            macBeacon = SEND_MAC_ADDRESS + MacToString(PDN->getWirelessManager()->getMacAddress()) +
+                PORT_SEPARATOR + std::to_string((int)jack) +
+                DEVICE_TYPE_SEPARATOR + std::to_string((int)PDN->getDeviceType());
+        }
+        PDN->getSerialManager()->writeString(macBeacon, jack);
         emitMacTimer.setTimer(emitMacInterval);
     }
 }
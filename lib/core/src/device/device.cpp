@@ -1,6 +1,7 @@
 #include "device/device.hpp"
 #include "state/state-machine.hpp"
 #include "device/drivers/logger.hpp"
+#include "utils/alloc-tracker.hpp"
 #include <utility>
 
 const char* TAG = "Device";
@@ -28,7 +29,18 @@ void Device::setActiveApp(StateId appId) {
 }
 
 void Device::loop() {
-    driverManager.execDrivers();
+#ifdef LOOP_PROFILING
+    LoopProfileScope tick(loopProfiler, loopProfiler.tickSection());
+#endif
+    {
+        ALLOC_REGION("device.drivers");
+#ifdef LOOP_PROFILING
+        driverManager.execDrivers(loopProfiler);
+#else
+        driverManager.execDrivers();
+#endif
+    }
+    ALLOC_REGION("device.state-loop");
     auto app = appConfig.find(currentAppId);
     if(app != appConfig.end()) {
         app->second->onStateLoop(this);
@@ -10,7 +10,42 @@
 #include "wireless/mac-functions.hpp"
 #include "device/drivers/peer-comms-types.hpp"
 
-RemoteDeviceCoordinator::RemoteDeviceCoordinator() : handshakeWirelessManager(HandshakeWirelessManager()) {}
+size_t encodeChainAnnouncement(uint8_t announcementId, const std::vector<std::array<uint8_t, 6>>& peers,
+                               std::vector<uint8_t>& out) {
+    out.resize(sizeof(ChainAnnouncementHdr) + peers.size() * 6);
+    auto* hdr = reinterpret_cast<ChainAnnouncementHdr*>(out.data());
+    hdr->announcementId = announcementId;
+    hdr->peerCount = static_cast<uint8_t>(peers.size());
+    uint8_t* macs = out.data() + sizeof(ChainAnnouncementHdr);
+    for (size_t i = 0; i < peers.size(); i++) {
+        memcpy(macs + i * 6, peers[i].data(), 6);
+    }
+    return out.size();
+}
+
+void decodeChainAnnouncement(const ChainAnnouncementHdr& announcement, std::vector<std::array<uint8_t, 6>>& peers) {
+    const uint8_t* macs = reinterpret_cast<const uint8_t*>(&announcement) + sizeof(ChainAnnouncementHdr);
+    peers.resize(announcement.peerCount);
+    for (size_t i = 0; i < peers.size(); i++) {
+        memcpy(peers[i].data(), macs + i * 6, 6);
+    }
+}
+
+RemoteDeviceCoordinator::RemoteDeviceCoordinator() : handshakeWirelessManager(HandshakeWirelessManager()) {
+    announcements_.setRetransmitCallback(
+        [this](const uint8_t* peer, uint8_t seq, uint8_t, uint32_t context) {
+            return retransmitAnnouncement(peer, seq, static_cast<SerialIdentifier>(context));
+        });
+    announcements_.setAbandonCallback(
+        [this](const uint8_t* t, uint8_t seq, uint8_t tag, uint32_t) {
+            LOG_W("RDC",
+                "kChainAnnouncement abandoned after %u retries: target=%02X:%02X:%02X:%02X:%02X:%02X id=%u",
+                (unsigned)announcements_.getConfig().maxRetries,
+                t[0], t[1], t[2], t[3], t[4], t[5],
+                (unsigned)seq);
+            pendingPeersByPort_[tag].clear();
+        });
+}
 
 RemoteDeviceCoordinator::~RemoteDeviceCoordinator() {
     delete inputPortHandshake;
@@ -22,6 +57,9 @@ RemoteDeviceCoordinator::~RemoteDeviceCoordinator() {
 void RemoteDeviceCoordinator::initialize(WirelessManager* wirelessManager, SerialManager* serialManager, Device* PDN) {
     this->serialManager = serialManager;
     this->wirelessManager_ = wirelessManager;
+    if (wirelessManager != nullptr) {
+        wirelessManager->bindLinkQuality(announcements_);
+    }
 
     handshakeWirelessManager.initialize(wirelessManager);
 
@@ -51,37 +89,29 @@ void RemoteDeviceCoordinator::initialize(WirelessManager* wirelessManager, Seria
 
     announcementEmitCallback_ = [this](const uint8_t* toMac, uint8_t announcementId, const std::vector<std::array<uint8_t, 6>>& peers) {
         std::vector<uint8_t> buf;
-        buf.push_back(announcementId);
-        buf.push_back(static_cast<uint8_t>(peers.size()));
-        for (const auto& mac : peers) {
-            buf.insert(buf.end(), mac.begin(), mac.end());
-        }
+        encodeChainAnnouncement(announcementId, peers, buf);
         wirelessManager_->sendEspNowData(toMac, PktType::kChainAnnouncement, buf.data(), buf.size());
     };
 
     wirelessManager->setEspNowPacketHandler(
         PktType::kChainAnnouncement,
-        [](const uint8_t* macAddress, const uint8_t* data, const size_t dataLen, void* ctx) {
-            static_cast<RemoteDeviceCoordinator*>(ctx)->processChainAnnouncementPacket(macAddress, data, dataLen);
-        },
+        packetHandler<PktType::kChainAnnouncement, &RemoteDeviceCoordinator::processChainAnnouncementPacket>,
         this
     );
 
     wirelessManager->setEspNowPacketHandler(
         PktType::kChainAnnouncementAck,
-        [](const uint8_t* macAddress, const uint8_t* data, const size_t dataLen, void* ctx) {
-            static_cast<RemoteDeviceCoordinator*>(ctx)->processChainAnnouncementAckPacket(macAddress, data, dataLen);
-        },
+        packetHandler<PktType::kChainAnnouncementAck, &RemoteDeviceCoordinator::processChainAnnouncementAckPacket>,
         this
     );
 }
 
-std::vector<SerialIdentifier> RemoteDeviceCoordinator::activePorts() const {
-    std::vector<SerialIdentifier> ports;
-    if (inputPortHandshake)          ports.push_back(SerialIdentifier::INPUT_JACK);
-    if (outputPortHandshake)         ports.push_back(SerialIdentifier::OUTPUT_JACK);
-    if (secondaryInputPortHandshake) ports.push_back(SerialIdentifier::INPUT_JACK_SECONDARY);
-    return ports;
+RemoteDeviceCoordinator::PortList RemoteDeviceCoordinator::activePorts() const {
+    PortList list;
+    if (inputPortHandshake)          list.ports[list.count++] = SerialIdentifier::INPUT_JACK;
+    if (outputPortHandshake)         list.ports[list.count++] = SerialIdentifier::OUTPUT_JACK;
+    if (secondaryInputPortHandshake) list.ports[list.count++] = SerialIdentifier::INPUT_JACK_SECONDARY;
+    return list;
 }
 
 HandshakeApp* RemoteDeviceCoordinator::handshakeAppForPort(SerialIdentifier port) const {
@@ -93,31 +123,23 @@ HandshakeApp* RemoteDeviceCoordinator::handshakeAppForPort(SerialIdentifier port
     }
 }
 
-void RemoteDeviceCoordinator::processChainAnnouncementAckPacket(const uint8_t* fromMac, const uint8_t* data, size_t dataLen) {
-    if (dataLen < 1) return;
-    uint8_t ackedId = data[0];
+void RemoteDeviceCoordinator::processChainAnnouncementAckPacket(const uint8_t* fromMac, const ChainAnnouncementAckPayload& ack, size_t) {
+    uint8_t ackedId = ack.announcementId;
 
     for (SerialIdentifier port : activePorts()) {
         const Peer* directPeer = handshakeWirelessManager.getMacPeer(port);
         if (directPeer == nullptr || memcmp(directPeer->macAddr.data(), fromMac, 6) != 0) continue;
 
-        PendingAnnouncement& pending = pendingByPort_[portIndex(port)];
-        if (pending.active && pending.announcementId == ackedId) {
-            retryStats_.ackLatencyMsSum += pending.timer.getElapsedTime();
-            retryStats_.ackCount++;
-            pending.active = false;
-            pending.timer.invalidate();
+        size_t idx = portIndex(port);
+        if (announcements_.ack(fromMac, ackedId, static_cast<uint8_t>(idx))) {
+            pendingPeersByPort_[idx].clear();
             return;
         }
     }
 }
 
-void RemoteDeviceCoordinator::processChainAnnouncementPacket(const uint8_t* fromMac, const uint8_t* data, size_t dataLen) {
-    // Wire format: [id(1)][count(1)][mac(6)]*count
-    if (dataLen < 2) return;
-    uint8_t announcementId = data[0];
-    uint8_t peerCount = data[1];
-    if (dataLen != 2 + (size_t)peerCount * 6) return;
+void RemoteDeviceCoordinator::processChainAnnouncementPacket(const uint8_t* fromMac, const ChainAnnouncementHdr& announcement, size_t) {
+    uint8_t announcementId = announcement.announcementId;
 
     // Determine which port this sender is the direct peer of. Gate on the
     // handshake having reached CONNECTED — announcements during CONNECTING
@@ -137,15 +159,13 @@ void RemoteDeviceCoordinator::processChainAnnouncementPacket(const uint8_t* from
     if (!found) return;
 
     std::vector<std::array<uint8_t, 6>> peers;
-    for (uint8_t i = 0; i < peerCount; i++) {
-        std::array<uint8_t, 6> mac;
-        memcpy(mac.data(), data + 2 + i * 6, 6);
-        peers.push_back(mac);
-    }
+    decodeChainAnnouncement(announcement, peers);
 
     onChainAnnouncementReceived(fromMac, port, peers);
 
-    wirelessManager_->sendEspNowData(fromMac, PktType::kChainAnnouncementAck, &announcementId, 1);
+    ChainAnnouncementAckPayload ack{announcementId};
+    wirelessManager_->sendEspNowData(fromMac, PktType::kChainAnnouncementAck,
+                                     reinterpret_cast<const uint8_t*>(&ack), sizeof(ack));
 }
 
 void RemoteDeviceCoordinator::sync(Device* PDN) {
@@ -176,6 +196,8 @@ void RemoteDeviceCoordinator::sync(Device* PDN) {
                     emitAnnouncementVia(otherPort, {});
                 }
             }
+            // Still registered for chain traffic, but no longer protected
+            unpinPeer(prev->data());
             if (peerLostCallback_) {
                 peerLostCallback_(prev->data());
             }
@@ -183,7 +205,7 @@ void RemoteDeviceCoordinator::sync(Device* PDN) {
         }
 
         if (nowPresent && !wasPresent) {
-            registerPeer(directPeer->macAddr.data());
+            pinPeer(directPeer->macAddr.data());
             // Notify all other ports about the new direct peer.
             for (SerialIdentifier otherPort : activePorts()) {
                 if (otherPort == port) continue;
@@ -206,32 +228,7 @@ void RemoteDeviceCoordinator::sync(Device* PDN) {
     }
 
     // Retransmit any unacked pending announcements past the ack timeout.
-    for (SerialIdentifier port : activePorts()) {
-        PendingAnnouncement& pending = pendingByPort_[portIndex(port)];
-        if (pending.active && pending.timer.expired()) {
-            const Peer* directPeer = handshakeWirelessManager.getMacPeer(port);
-            if (directPeer != nullptr && announcementEmitCallback_ && pending.retries < maxRetries_) {
-                announcementEmitCallback_(directPeer->macAddr.data(), pending.announcementId, pending.peers);
-                pending.retries++;
-                pending.timer.setTimer(ackTimeoutMs_ << pending.retries);
-                retryStats_.retries++;
-            } else {
-                if (pending.retries >= maxRetries_ && directPeer != nullptr) {
-                    const uint8_t* t = directPeer->macAddr.data();
-                    LOG_W("RDC",
-                        "kChainAnnouncement abandoned after %u retries: target=%02X:%02X:%02X:%02X:%02X:%02X id=%u",
-                        (unsigned)maxRetries_,
-                        t[0], t[1], t[2], t[3], t[4], t[5],
-                        (unsigned)pending.announcementId);
-                    retryStats_.abandons++;
-                }
-                pending.active = false;
-                pending.retries = 0;
-                pending.peers.clear();
-                pending.timer.invalidate();
-            }
-        }
-    }
+    announcements_.poll();
 }
 
 size_t RemoteDeviceCoordinator::portIndex(SerialIdentifier port) const {
@@ -325,20 +322,31 @@ void RemoteDeviceCoordinator::emitAnnouncementVia(SerialIdentifier viaPort, cons
     const Peer* directPeer = handshakeWirelessManager.getMacPeer(viaPort);
     if (directPeer == nullptr || !announcementEmitCallback_) return;
 
-    uint8_t id = nextAnnouncementId_++;
-    if (nextAnnouncementId_ == 0) nextAnnouncementId_ = 1;
-
-    PendingAnnouncement& pending = pendingByPort_[portIndex(viaPort)];
-    pending.active = true;
-    pending.announcementId = id;
-    pending.retries = 0;
-    pending.peers = peers;
-    pending.timer.setTimer(ackTimeoutMs_);
-    retryStats_.sends++;
+    // A newer announcement on the port supersedes the old one, even if the
+    // direct peer has changed since.
+    size_t idx = portIndex(viaPort);
+    announcements_.cancelTag(static_cast<uint8_t>(idx));
+    pendingPeersByPort_[idx] = peers;
+    uint8_t id = announcements_.track(directPeer->macAddr.data(), static_cast<uint8_t>(idx),
+                                      static_cast<uint32_t>(viaPort));
 
     announcementEmitCallback_(directPeer->macAddr.data(), id, peers);
 }
 
+bool RemoteDeviceCoordinator::retransmitAnnouncement(const uint8_t* toMac, uint8_t announcementId,
+                                                     SerialIdentifier viaPort) {
+    // Drop silently if the port's direct peer went away or was replaced; the
+    // topology change emits a fresh announcement of its own.
+    const Peer* directPeer = handshakeWirelessManager.getMacPeer(viaPort);
+    if (directPeer == nullptr || !announcementEmitCallback_ ||
+        memcmp(directPeer->macAddr.data(), toMac, 6) != 0) {
+        pendingPeersByPort_[portIndex(viaPort)].clear();
+        return false;
+    }
+    announcementEmitCallback_(toMac, announcementId, pendingPeersByPort_[portIndex(viaPort)]);
+    return true;
+}
+
 std::vector<std::array<uint8_t, 6>> RemoteDeviceCoordinator::peersReachableVia(SerialIdentifier port) {
     std::vector<std::array<uint8_t, 6>> result;
     const Peer* direct = handshakeWirelessManager.getMacPeer(port);
@@ -421,6 +429,25 @@ bool RemoteDeviceCoordinator::canReachPeer(const uint8_t* mac) const {
     return false;
 }
 
+bool RemoteDeviceCoordinator::portHasPeer(SerialIdentifier port, const uint8_t* mac) const {
+    if (!mac) return false;
+    const Peer* directPeer = handshakeWirelessManager.getMacPeer(port);
+    if (directPeer != nullptr && memcmp(directPeer->macAddr.data(), mac, 6) == 0) return true;
+    for (const auto& daisy : daisyChainedByPort_[portIndex(port)]) {
+        if (memcmp(daisy.data(), mac, 6) == 0) return true;
+    }
+    return false;
+}
+
+bool RemoteDeviceCoordinator::portsSharePeer(SerialIdentifier a, SerialIdentifier b) const {
+    const Peer* directPeer = handshakeWirelessManager.getMacPeer(a);
+    if (directPeer != nullptr && portHasPeer(b, directPeer->macAddr.data())) return true;
+    for (const auto& daisy : daisyChainedByPort_[portIndex(a)]) {
+        if (portHasPeer(b, daisy.data())) return true;
+    }
+    return false;
+}
+
 void RemoteDeviceCoordinator::addDaisyChainedPeer(SerialIdentifier port, const uint8_t* macAddress) {
     std::array<uint8_t, 6> mac;
     memcpy(mac.data(), macAddress, 6);
@@ -458,6 +485,18 @@ void RemoteDeviceCoordinator::registerPeer(const uint8_t* macAddress) {
     }
 }
 
+void RemoteDeviceCoordinator::pinPeer(const uint8_t* macAddress) {
+    if (wirelessManager_ != nullptr) {
+        wirelessManager_->pinEspNowPeer(macAddress);
+    }
+}
+
+void RemoteDeviceCoordinator::unpinPeer(const uint8_t* macAddress) {
+    if (wirelessManager_ != nullptr) {
+        wirelessManager_->unpinEspNowPeer(macAddress);
+    }
+}
+
 void RemoteDeviceCoordinator::notifyConnect() {
     if (chainChangeCallback_) chainChangeCallback_();
 }
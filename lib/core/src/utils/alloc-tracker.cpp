@@ -0,0 +1,189 @@
+#ifdef NATIVE_BUILD
+
+#include "utils/alloc-tracker.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> g_allocations{0};
+std::atomic<uint64_t> g_bytes{0};
+std::atomic<uint64_t> g_frees{0};
+
+thread_local AllocationCounts t_counts;
+thread_local int t_uncountedDepth = 0;
+
+constexpr size_t kNoRegion = AllocationTracker::kMaxRegions;
+
+// Fixed storage: nothing here may allocate, or the hooks would count it
+std::mutex g_regionMutex;
+AllocationTracker::Region g_regions[AllocationTracker::kMaxRegions];
+size_t g_regionCount = 0;
+
+} // namespace
+
+#ifdef ALLOC_TRACKING
+
+namespace {
+
+void* countedAlloc(size_t size) {
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr && t_uncountedDepth == 0) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_bytes.fetch_add(size, std::memory_order_relaxed);
+        t_counts.allocations++;
+        t_counts.bytes += size;
+    }
+    return ptr;
+}
+
+void countedFree(void* ptr) {
+    if (!ptr) return;
+    if (t_uncountedDepth == 0) {
+        g_frees.fetch_add(1, std::memory_order_relaxed);
+        t_counts.frees++;
+    }
+    std::free(ptr);
+}
+
+} // namespace
+
+// Over-aligned new/delete keep the library versions and aren't counted;
+// nothing in the game asks for them.
+
+void* operator new(size_t size) {
+    void* ptr = countedAlloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](size_t size) {
+    void* ptr = countedAlloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    countedFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    countedFree(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    countedFree(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    countedFree(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    countedFree(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    countedFree(ptr);
+}
+
+bool AllocationTracker::isInstalled() {
+    return true;
+}
+
+#else
+
+bool AllocationTracker::isInstalled() {
+    return false;
+}
+
+#endif // ALLOC_TRACKING
+
+AllocationCounts AllocationTracker::getTotals() {
+    AllocationCounts counts;
+    counts.allocations = g_allocations.load(std::memory_order_relaxed);
+    counts.bytes = g_bytes.load(std::memory_order_relaxed);
+    counts.frees = g_frees.load(std::memory_order_relaxed);
+    return counts;
+}
+
+AllocationCounts AllocationTracker::getThreadTotals() {
+    return t_counts;
+}
+
+size_t AllocationTracker::getRegions(Region* out, size_t maxRegions) {
+    std::lock_guard<std::mutex> lock(g_regionMutex);
+    size_t count = g_regionCount < maxRegions ? g_regionCount : maxRegions;
+    for (size_t i = 0; i < count; i++) {
+        out[i] = g_regions[i];
+    }
+    return count;
+}
+
+void AllocationTracker::resetRegions() {
+    std::lock_guard<std::mutex> lock(g_regionMutex);
+    for (size_t i = 0; i < kMaxRegions; i++) {
+        g_regions[i] = Region();
+    }
+    g_regionCount = 0;
+}
+
+size_t AllocationTracker::findRegion(const char* name) {
+    if (!name) return kNoRegion;
+    std::lock_guard<std::mutex> lock(g_regionMutex);
+    for (size_t i = 0; i < g_regionCount; i++) {
+        if (g_regions[i].name == name || strcmp(g_regions[i].name, name) == 0) {
+            return i;
+        }
+    }
+    if (g_regionCount == kMaxRegions) {
+        return kMaxRegions - 1;
+    }
+    size_t index = g_regionCount++;
+    g_regions[index].name = index == kMaxRegions - 1 ? "(other)" : name;
+    return index;
+}
+
+void AllocationTracker::addToRegion(size_t index, const AllocationCounts& counts) {
+    if (index == kNoRegion) return;
+    std::lock_guard<std::mutex> lock(g_regionMutex);
+    Region& region = g_regions[index];
+    region.counts.allocations += counts.allocations;
+    region.counts.bytes += counts.bytes;
+    region.counts.frees += counts.frees;
+    region.entries++;
+}
+
+AllocationScope::AllocationScope(const char* regionName)
+    : start_(AllocationTracker::getThreadTotals())
+    , region_(AllocationTracker::findRegion(regionName)) {
+}
+
+AllocationScope::~AllocationScope() {
+    AllocationTracker::addToRegion(region_, getCounts());
+}
+
+AllocationCounts AllocationScope::getCounts() const {
+    return AllocationTracker::getThreadTotals() - start_;
+}
+
+UncountedAllocations::UncountedAllocations() {
+    t_uncountedDepth++;
+}
+
+UncountedAllocations::~UncountedAllocations() {
+    t_uncountedDepth--;
+}
+
+#endif // NATIVE_BUILD
@@ -0,0 +1,145 @@
+#include "utils/loop-profiler.hpp"
+#include "utils/simple-timer.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+uint32_t LoopProfileSection::percentileUs(double percent) const {
+    if (count == 0) return 0;
+    // Nearest rank, as the bench runner computes it from raw samples
+    uint64_t rank = static_cast<uint64_t>(percent / 100.0 * (count - 1) + 0.5) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < LOOP_PROFILE_BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return LoopProfiler::bucketUpperUs(i);
+        }
+    }
+    return LoopProfiler::bucketUpperUs(LOOP_PROFILE_BUCKETS - 1);
+}
+
+size_t LoopProfiler::bucketFor(uint32_t us) {
+    size_t bucket = 0;
+    while (us > 0 && bucket < LOOP_PROFILE_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+uint32_t LoopProfiler::bucketUpperUs(size_t bucket) {
+    if (bucket >= LOOP_PROFILE_BUCKETS - 1) return UINT32_MAX;
+    return 1u << bucket;
+}
+
+unsigned long LoopProfiler::nowUs() const {
+    PlatformClock* clock = clock_ ? clock_ : SimpleTimer::getPlatformClock();
+    return clock ? clock->microseconds() : 0;
+}
+
+size_t LoopProfiler::tickSection() {
+    LoopProfileSection key;
+    key.kind = LoopProfileSection::Kind::kTick;
+    return add(key);
+}
+
+size_t LoopProfiler::driverSection(const char* name) {
+    LoopProfileSection key;
+    key.kind = LoopProfileSection::Kind::kDriver;
+    key.name = name;
+    return add(key);
+}
+
+size_t LoopProfiler::stateSection(int machineId, int stateId) {
+    LoopProfileSection key;
+    key.kind = LoopProfileSection::Kind::kState;
+    key.machineId = machineId;
+    key.stateId = stateId;
+    return add(key);
+}
+
+size_t LoopProfiler::add(const LoopProfileSection& key) {
+    for (size_t i = 0; i < sectionCount_; i++) {
+        const LoopProfileSection& section = sections_[i];
+        if (section.kind != key.kind) continue;
+        if (key.kind == LoopProfileSection::Kind::kDriver &&
+            section.name != key.name && strcmp(section.name, key.name) != 0) continue;
+        if (section.machineId != key.machineId || section.stateId != key.stateId) continue;
+        return i;
+    }
+    if (sectionCount_ == kMaxSections) {
+        return kMaxSections - 1;
+    }
+    size_t index = sectionCount_++;
+    sections_[index] = key;
+    if (index == kMaxSections - 1) {
+        sections_[index].kind = LoopProfileSection::Kind::kDriver;
+        sections_[index].name = "(other)";
+    }
+    return index;
+}
+
+void LoopProfiler::record(size_t section, uint32_t elapsedUs) {
+    if (section >= sectionCount_) return;
+    LoopProfileSection& entry = sections_[section];
+    entry.count++;
+    entry.totalUs += elapsedUs;
+    if (elapsedUs > entry.maxUs) entry.maxUs = elapsedUs;
+    if (elapsedUs > tickBudgetUs_) entry.overBudget++;
+    entry.buckets[bucketFor(elapsedUs)]++;
+}
+
+void LoopProfiler::reset() {
+    for (size_t i = 0; i < kMaxSections; i++) {
+        sections_[i] = LoopProfileSection();
+    }
+    sectionCount_ = 0;
+}
+
+int formatLoopProfileLabel(const LoopProfileSection& section, char* out, size_t outLen) {
+    switch (section.kind) {
+        case LoopProfileSection::Kind::kTick:
+            return snprintf(out, outLen, "tick");
+        case LoopProfileSection::Kind::kDriver:
+            return snprintf(out, outLen, "driver:%s", section.name ? section.name : "?");
+        case LoopProfileSection::Kind::kState:
+        default:
+            return snprintf(out, outLen, "state:%d/%d", section.machineId, section.stateId);
+    }
+}
+
+int formatLoopProfileRow(const LoopProfileSection& section, const char* label, char* out, size_t outLen) {
+    unsigned long mean = section.count ? static_cast<unsigned long>(section.totalUs / section.count) : 0;
+    char p50[16];
+    char p99[16];
+    uint32_t p50Us = section.percentileUs(50);
+    uint32_t p99Us = section.percentileUs(99);
+    snprintf(p50, sizeof(p50), p50Us == UINT32_MAX ? ">=16ms" : "<%lu", static_cast<unsigned long>(p50Us));
+    snprintf(p99, sizeof(p99), p99Us == UINT32_MAX ? ">=16ms" : "<%lu", static_cast<unsigned long>(p99Us));
+    return snprintf(out, outLen, "%s n=%lu mean %luus p50%s p99%s max %luus over %lu",
+                    label, static_cast<unsigned long>(section.count), mean, p50, p99,
+                    static_cast<unsigned long>(section.maxUs), static_cast<unsigned long>(section.overBudget));
+}
+
+int formatLoopProfileHistogram(const LoopProfileSection& section, char* out, size_t outLen) {
+    size_t used = 0;
+    if (outLen > 0) out[0] = '\0';
+    for (size_t i = 0; i < LOOP_PROFILE_BUCKETS; i++) {
+        if (section.buckets[i] == 0) continue;
+        char cell[32];
+        int n;
+        if (i == LOOP_PROFILE_BUCKETS - 1) {
+            n = snprintf(cell, sizeof(cell), "%s>=16ms:%lu", used ? " " : "",
+                         static_cast<unsigned long>(section.buckets[i]));
+        } else {
+            n = snprintf(cell, sizeof(cell), "%s<%luus:%lu", used ? " " : "",
+                         static_cast<unsigned long>(LoopProfiler::bucketUpperUs(i)),
+                         static_cast<unsigned long>(section.buckets[i]));
+        }
+        if (used + n < outLen) {
+            memcpy(out + used, cell, n + 1);
+        }
+        used += n;
+    }
+    return static_cast<int>(used);
+}
@@ -0,0 +1,458 @@
+#include "wireless/bulk-transfer.hpp"
+#include <algorithm>
+#include <cstring>
+
+uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc) {
+    // Nibble table: small enough for flash, fast enough for a 64 KiB message
+    static const uint32_t kTable[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc = kTable[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+        crc = kTable[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+    return ~crc;
+}
+
+BulkTransfer::BulkTransfer() : BulkTransfer(Config()) {}
+
+BulkTransfer::BulkTransfer(const Config& config) :
+    config_(config),
+    outgoing_(config.maxOutgoing),
+    incoming_(config.maxIncoming) {
+    // A window narrower than one chunk could never be filled
+    config_.windowBytes = std::max(config_.windowBytes, kChunkLen);
+}
+
+int BulkTransfer::start(const uint8_t* dst, uint8_t channel, const uint8_t* data, size_t length,
+                        unsigned long nowMs) {
+    static const uint8_t kBroadcast[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    if (length == 0 || length > config_.maxTransferBytes || channel >= kMaxChannels ||
+        memcmp(dst, kBroadcast, sizeof(kBroadcast)) == 0) {
+        return -1;
+    }
+
+    // Prefer a never-used slot so finished transfers stay queryable longer
+    Outgoing* slot = nullptr;
+    for (auto& out : outgoing_) {
+        if (!out.used) {
+            slot = &out;
+            break;
+        }
+        if (!slot && !isActive(out)) {
+            slot = &out;
+        }
+    }
+    if (!slot) {
+        return -1;
+    }
+
+    *slot = Outgoing();
+    slot->used = true;
+    slot->id = nextId_++;
+    if (nextId_ == 0) {
+        nextId_ = 1;
+    }
+    memcpy(slot->dstMac, dst, sizeof(slot->dstMac));
+    slot->channel = channel;
+    slot->data.assign(data, data + length);
+    slot->crc = crc32(data, length);
+    slot->status.totalLength = static_cast<uint32_t>(length);
+    slot->lastProgressMs = nowMs;
+    stats_.started++;
+    return slot->id;
+}
+
+void BulkTransfer::cancel(int transferId, const Emit& emit) {
+    Outgoing* out = findOutgoing(static_cast<uint16_t>(transferId));
+    if (!out || !isActive(*out)) {
+        return;
+    }
+    BulkHdr hdr;
+    hdr.op = BulkOp::CANCEL;
+    hdr.transferId = out->id;
+    emit(out->dstMac, reinterpret_cast<const uint8_t*>(&hdr), sizeof(hdr));
+    out->status.state = BulkTransferState::kCancelled;
+    out->data.clear();
+    out->data.shrink_to_fit();
+}
+
+bool BulkTransfer::getStatus(int transferId, BulkTransferStatus& out) const {
+    if (transferId <= 0 || transferId > UINT16_MAX) {
+        return false;
+    }
+    const Outgoing* transfer = findOutgoing(static_cast<uint16_t>(transferId));
+    if (!transfer) {
+        return false;
+    }
+    out = transfer->status;
+    return true;
+}
+
+void BulkTransfer::listen(uint8_t channel, bool enabled) {
+    if (channel >= kMaxChannels) {
+        return;
+    }
+    uint8_t bit = static_cast<uint8_t>(1u << channel);
+    listening_ = enabled ? (listening_ | bit) : (listening_ & ~bit);
+}
+
+BulkTransfer::Result BulkTransfer::onPacket(const uint8_t* srcMac, const uint8_t* data, size_t length,
+                                            unsigned long nowMs, const Emit& emit) {
+    BulkHdr hdr;
+    if (length < sizeof(hdr)) {
+        stats_.rejected++;
+        return Result::kRejected;
+    }
+    memcpy(&hdr, data, sizeof(hdr));
+
+    switch (hdr.op) {
+        case BulkOp::OPEN: {
+            BulkOpenPayload open;
+            if (length < sizeof(open)) {
+                break;
+            }
+            memcpy(&open, data, sizeof(open));
+            onOpen(srcMac, open, nowMs, emit);
+            return Result::kNone;
+        }
+        case BulkOp::DATA: {
+            BulkDataHdr dataHdr;
+            if (length <= sizeof(dataHdr)) {
+                break;
+            }
+            memcpy(&dataHdr, data, sizeof(dataHdr));
+            return onData(srcMac, dataHdr, data + sizeof(dataHdr), length - sizeof(dataHdr), nowMs, emit);
+        }
+        case BulkOp::CREDIT: {
+            BulkCreditPayload credit;
+            if (length < sizeof(credit)) {
+                break;
+            }
+            memcpy(&credit, data, sizeof(credit));
+            Outgoing* out = findOutgoing(credit.hdr.transferId);
+            if (!out || memcmp(out->dstMac, srcMac, sizeof(out->dstMac)) != 0) {
+                break;
+            }
+            onCredit(*out, credit, nowMs);
+            return Result::kNone;
+        }
+        case BulkOp::CANCEL: {
+            Incoming* in = findIncoming(srcMac, hdr.transferId);
+            if (in) {
+                *in = Incoming();
+            }
+            return Result::kNone;
+        }
+        case BulkOp::REFUSE: {
+            BulkRefusePayload refuse;
+            if (length < sizeof(refuse)) {
+                break;
+            }
+            memcpy(&refuse, data, sizeof(refuse));
+            Outgoing* out = findOutgoing(refuse.hdr.transferId);
+            if (!out || memcmp(out->dstMac, srcMac, sizeof(out->dstMac)) != 0) {
+                break;
+            }
+            onRefuse(*out, refuse);
+            return Result::kNone;
+        }
+    }
+    stats_.rejected++;
+    return Result::kRejected;
+}
+
+void BulkTransfer::service(unsigned long nowMs, const Emit& emit) {
+    for (auto& out : outgoing_) {
+        if (isActive(out)) {
+            serviceOutgoing(out, nowMs, emit);
+        }
+    }
+    for (auto& in : incoming_) {
+        if (in.used && nowMs - in.lastActivityMs > config_.holdMs) {
+            in = Incoming();
+        }
+    }
+}
+
+size_t BulkTransfer::activeOutgoing() const {
+    return std::count_if(outgoing_.begin(), outgoing_.end(),
+                         [this](const Outgoing& out) { return isActive(out); });
+}
+
+size_t BulkTransfer::activeIncoming() const {
+    return std::count_if(incoming_.begin(), incoming_.end(),
+                         [](const Incoming& in) { return in.used && !in.done; });
+}
+
+BulkTransfer::Outgoing* BulkTransfer::findOutgoing(uint16_t id) {
+    for (auto& out : outgoing_) {
+        if (out.used && out.id == id) {
+            return &out;
+        }
+    }
+    return nullptr;
+}
+
+const BulkTransfer::Outgoing* BulkTransfer::findOutgoing(uint16_t id) const {
+    return const_cast<BulkTransfer*>(this)->findOutgoing(id);
+}
+
+BulkTransfer::Incoming* BulkTransfer::findIncoming(const uint8_t* srcMac, uint16_t id) {
+    for (auto& in : incoming_) {
+        if (in.used && in.id == id && memcmp(in.srcMac, srcMac, sizeof(in.srcMac)) == 0) {
+            return &in;
+        }
+    }
+    return nullptr;
+}
+
+void BulkTransfer::onOpen(const uint8_t* srcMac, const BulkOpenPayload& open, unsigned long nowMs,
+                          const Emit& emit) {
+    uint16_t id = open.hdr.transferId;
+    if (open.channel >= kMaxChannels || !(listening_ & (1u << open.channel))) {
+        sendRefuse(srcMac, id, BulkRefuseReason::NO_HANDLER, emit);
+        return;
+    }
+    if (open.totalLength == 0 || open.totalLength > config_.maxTransferBytes) {
+        sendRefuse(srcMac, id, BulkRefuseReason::TOO_LARGE, emit);
+        return;
+    }
+
+    Incoming* in = findIncoming(srcMac, id);
+    if (in && (in->totalLength != open.totalLength || in->crc != open.crc32)) {
+        // The sender restarted and reused the id for a different message
+        *in = Incoming();
+        in = nullptr;
+    }
+    if (!in) {
+        // Same bytes under a new id: pick up where the stalled copy left off
+        for (auto& candidate : incoming_) {
+            if (candidate.used && !candidate.done && candidate.totalLength == open.totalLength &&
+                candidate.crc == open.crc32 && memcmp(candidate.srcMac, srcMac, sizeof(candidate.srcMac)) == 0) {
+                in = &candidate;
+                in->id = id;
+                stats_.resumed++;
+                break;
+            }
+        }
+    }
+    if (!in) {
+        for (auto& candidate : incoming_) {
+            if (!candidate.used) {
+                in = &candidate;
+                break;
+            }
+            if (candidate.done && (!in || candidate.lastActivityMs < in->lastActivityMs)) {
+                in = &candidate;
+            }
+        }
+        if (!in) {
+            sendRefuse(srcMac, id, BulkRefuseReason::NO_ROOM, emit);
+            return;
+        }
+        *in = Incoming();
+        in->used = true;
+        memcpy(in->srcMac, srcMac, sizeof(in->srcMac));
+        in->id = id;
+        in->channel = open.channel;
+        in->totalLength = open.totalLength;
+        in->crc = open.crc32;
+        in->data.resize(open.totalLength);
+        in->received.assign((open.totalLength + kChunkLen - 1) / kChunkLen, false);
+    }
+    in->lastActivityMs = nowMs;
+    sendCredit(*in, emit);
+}
+
+BulkTransfer::Result BulkTransfer::onData(const uint8_t* srcMac, const BulkDataHdr& hdr, const uint8_t* chunk,
+                                          size_t chunkLen, unsigned long nowMs, const Emit& emit) {
+    Incoming* in = findIncoming(srcMac, hdr.hdr.transferId);
+    if (!in) {
+        sendRefuse(srcMac, hdr.hdr.transferId, BulkRefuseReason::UNKNOWN_TRANSFER, emit);
+        stats_.rejected++;
+        return Result::kRejected;
+    }
+    in->lastActivityMs = nowMs;
+    if (in->done) {
+        // Our final credit was lost
+        sendCredit(*in, emit);
+        return Result::kNone;
+    }
+
+    uint32_t offset = hdr.offset;
+    if (offset % kChunkLen != 0 || offset >= in->totalLength ||
+        chunkLen != std::min<size_t>(kChunkLen, in->totalLength - offset) ||
+        offset >= in->contiguous + config_.windowBytes) {
+        stats_.rejected++;
+        return Result::kRejected;
+    }
+
+    size_t idx = offset / kChunkLen;
+    if (in->received[idx]) {
+        sendCredit(*in, emit);
+        return Result::kNone;
+    }
+    bool inOrder = offset == in->contiguous;
+    memcpy(in->data.data() + offset, chunk, chunkLen);
+    in->received[idx] = true;
+    while (in->contiguous < in->totalLength && in->received[in->contiguous / kChunkLen]) {
+        in->contiguous = static_cast<uint32_t>(std::min<size_t>(in->contiguous + kChunkLen, in->totalLength));
+    }
+
+    if (in->contiguous == in->totalLength) {
+        if (crc32(in->data.data(), in->data.size()) != in->crc) {
+            stats_.corrupt++;
+            sendRefuse(srcMac, in->id, BulkRefuseReason::CORRUPT, emit);
+            *in = Incoming();
+            return Result::kRejected;
+        }
+        memcpy(completed_.srcMac, in->srcMac, sizeof(completed_.srcMac));
+        completed_.channel = in->channel;
+        completed_.data = std::move(in->data);
+        in->data = std::vector<uint8_t>();
+        in->received = std::vector<bool>();
+        in->done = true;
+        sendCredit(*in, emit);
+        stats_.completedIn++;
+        return Result::kComplete;
+    }
+
+    // A gap tells the sender at once; otherwise credit every half window
+    if (!inOrder || in->contiguous - in->lastCredited >= config_.windowBytes / 2) {
+        sendCredit(*in, emit);
+    }
+    return Result::kNone;
+}
+
+void BulkTransfer::onCredit(Outgoing& out, const BulkCreditPayload& credit, unsigned long nowMs) {
+    if (!isActive(out) || credit.ackOffset > out.status.totalLength) {
+        return;
+    }
+    BulkTransferStatus& status = out.status;
+
+    if (status.state == BulkTransferState::kOpening) {
+        status.state = BulkTransferState::kSending;
+        out.timeouts = 0;
+        out.lastProgressMs = nowMs;
+    }
+    if (credit.ackOffset == status.totalLength) {
+        status.state = BulkTransferState::kComplete;
+        status.ackedOffset = status.totalLength;
+        out.data.clear();
+        out.data.shrink_to_fit();
+        stats_.completedOut++;
+        return;
+    }
+
+    if (credit.ackOffset > status.ackedOffset) {
+        status.ackedOffset = credit.ackOffset;
+        out.timeouts = 0;
+        out.lastProgressMs = nowMs;
+    } else if (credit.ackOffset == status.ackedOffset && out.nextOffset > status.ackedOffset &&
+               out.goBackOffset != status.ackedOffset) {
+        // The receiver is missing the chunk at ackedOffset; once per offset,
+        // later losses of the same chunk wait for the timeout
+        out.nextOffset = status.ackedOffset;
+        out.goBackOffset = status.ackedOffset;
+    }
+    out.windowEnd = std::min(std::max(out.windowEnd, credit.windowEnd), status.totalLength);
+    out.nextOffset = std::max(out.nextOffset, status.ackedOffset);
+}
+
+void BulkTransfer::onRefuse(Outgoing& out, const BulkRefusePayload& refuse) {
+    if (!isActive(out)) {
+        return;
+    }
+    out.status.refused = true;
+    out.status.refuseReason = refuse.reason;
+    fail(out);
+}
+
+void BulkTransfer::serviceOutgoing(Outgoing& out, unsigned long nowMs, const Emit& emit) {
+    BulkTransferStatus& status = out.status;
+    bool timedOut = nowMs - out.lastProgressMs >= config_.retransmitMs;
+
+    if (status.state == BulkTransferState::kOpening ||
+        (timedOut && out.windowEnd <= status.ackedOffset)) {
+        // Opening, or probing a closed window whose credit may have been lost
+        if (out.openSent && nowMs - out.lastOpenMs < config_.retransmitMs) {
+            return;
+        }
+        if (out.openSent && ++out.timeouts > config_.maxTimeouts) {
+            fail(out);
+            return;
+        }
+        BulkOpenPayload open;
+        open.hdr.op = BulkOp::OPEN;
+        open.hdr.transferId = out.id;
+        open.channel = out.channel;
+        open.totalLength = status.totalLength;
+        open.crc32 = out.crc;
+        if (emit(out.dstMac, reinterpret_cast<const uint8_t*>(&open), sizeof(open)) == 0) {
+            out.openSent = true;
+            out.lastOpenMs = nowMs;
+        }
+        return;
+    }
+
+    if (timedOut) {
+        if (++out.timeouts > config_.maxTimeouts) {
+            fail(out);
+            return;
+        }
+        out.nextOffset = status.ackedOffset;
+        out.goBackOffset = UINT32_MAX;
+        out.lastProgressMs = nowMs;
+    }
+
+    uint8_t packet[PEER_COMMS_MAX_FRAME_PAYLOAD];
+    uint32_t limit = std::min(out.windowEnd, status.totalLength);
+    while (out.nextOffset < limit) {
+        size_t len = std::min<size_t>(kChunkLen, status.totalLength - out.nextOffset);
+        BulkDataHdr hdr;
+        hdr.hdr.op = BulkOp::DATA;
+        hdr.hdr.transferId = out.id;
+        hdr.offset = out.nextOffset;
+        memcpy(packet, &hdr, sizeof(hdr));
+        memcpy(packet + sizeof(hdr), out.data.data() + out.nextOffset, len);
+        if (emit(out.dstMac, packet, sizeof(hdr) + len) != 0) {
+            break;
+        }
+        stats_.chunksSent++;
+        if (out.nextOffset < out.highestSent) {
+            status.retransmits++;
+            stats_.retransmits++;
+        }
+        out.nextOffset += static_cast<uint32_t>(len);
+        out.highestSent = std::max(out.highestSent, out.nextOffset);
+    }
+}
+
+void BulkTransfer::fail(Outgoing& out) {
+    out.status.state = BulkTransferState::kFailed;
+    out.data.clear();
+    out.data.shrink_to_fit();
+    stats_.failed++;
+}
+
+void BulkTransfer::sendCredit(Incoming& in, const Emit& emit) {
+    BulkCreditPayload credit;
+    credit.hdr.op = BulkOp::CREDIT;
+    credit.hdr.transferId = in.id;
+    credit.ackOffset = in.done ? in.totalLength : in.contiguous;
+    credit.windowEnd = static_cast<uint32_t>(
+        std::min<size_t>(in.totalLength, static_cast<size_t>(credit.ackOffset) + config_.windowBytes));
+    in.lastCredited = credit.ackOffset;
+    emit(in.srcMac, reinterpret_cast<const uint8_t*>(&credit), sizeof(credit));
+}
+
+void BulkTransfer::sendRefuse(const uint8_t* dst, uint16_t id, BulkRefuseReason reason, const Emit& emit) {
+    BulkRefusePayload refuse;
+    refuse.hdr.op = BulkOp::REFUSE;
+    refuse.hdr.transferId = id;
+    refuse.reason = reason;
+    emit(dst, reinterpret_cast<const uint8_t*>(&refuse), sizeof(refuse));
+}
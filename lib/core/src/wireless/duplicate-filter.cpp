@@ -0,0 +1,101 @@
+#include "wireless/duplicate-filter.hpp"
+#include <algorithm>
+#include <cstring>
+
+DuplicateFilter::DuplicateFilter() : DuplicateFilter(Config()) {}
+
+DuplicateFilter::DuplicateFilter(const Config& config) :
+    config_(config),
+    streams_(std::max<size_t>(config.maxStreams, 1)) {
+    config_.window = std::min(std::max<size_t>(config_.window, 1), kMaxWindow);
+    seqOffsets_.fill(kNoRule);
+}
+
+void DuplicateFilter::setRule(PktType packetType, uint8_t seqOffset) {
+    if (static_cast<size_t>(packetType) < seqOffsets_.size() && seqOffset != kNoRule) {
+        seqOffsets_[static_cast<size_t>(packetType)] = seqOffset;
+    }
+}
+
+void DuplicateFilter::clearRule(PktType packetType) {
+    if (static_cast<size_t>(packetType) < seqOffsets_.size()) {
+        seqOffsets_[static_cast<size_t>(packetType)] = kNoRule;
+    }
+}
+
+bool DuplicateFilter::hasRule(PktType packetType) const {
+    return static_cast<size_t>(packetType) < seqOffsets_.size() &&
+           seqOffsets_[static_cast<size_t>(packetType)] != kNoRule;
+}
+
+bool DuplicateFilter::isDuplicate(const uint8_t* srcMac, PktType packetType,
+                                  const uint8_t* payload, size_t length, unsigned long nowMs) {
+    if (!hasRule(packetType)) {
+        stats_.untracked++;
+        return false;
+    }
+    uint8_t offset = seqOffsets_[static_cast<size_t>(packetType)];
+    if (length <= offset || payload[offset] == 0) {
+        stats_.untracked++;
+        return false;
+    }
+    uint8_t seq = payload[offset];
+
+    Stream& stream = streamFor(srcMac, packetType);
+    for (uint8_t i = 0; i < stream.count; i++) {
+        if (stream.seqs[i] == seq && nowMs - stream.seenMs[i] <= config_.holdMs) {
+            stats_.hits++;
+            return true;
+        }
+    }
+
+    // Oldest sighting makes way once the window is full
+    stream.seqs[stream.head] = seq;
+    stream.seenMs[stream.head] = nowMs;
+    stream.head = static_cast<uint8_t>((stream.head + 1) % config_.window);
+    if (stream.count < config_.window) {
+        stream.count++;
+    }
+    stats_.misses++;
+    return false;
+}
+
+void DuplicateFilter::forget(const uint8_t* srcMac) {
+    for (auto& stream : streams_) {
+        if (stream.used && memcmp(stream.mac, srcMac, sizeof(stream.mac)) == 0) {
+            stream = Stream();
+        }
+    }
+}
+
+void DuplicateFilter::clear() {
+    std::fill(streams_.begin(), streams_.end(), Stream());
+}
+
+size_t DuplicateFilter::streamCount() const {
+    return std::count_if(streams_.begin(), streams_.end(), [](const Stream& s) { return s.used; });
+}
+
+DuplicateFilter::Stream& DuplicateFilter::streamFor(const uint8_t* srcMac, PktType packetType) {
+    useCounter_++;
+    Stream* victim = nullptr;
+    for (auto& stream : streams_) {
+        if (stream.used && stream.packetType == packetType &&
+            memcmp(stream.mac, srcMac, sizeof(stream.mac)) == 0) {
+            stream.lastUsed = useCounter_;
+            return stream;
+        }
+        if (!victim || (victim->used && (!stream.used || stream.lastUsed < victim->lastUsed))) {
+            victim = &stream;
+        }
+    }
+    if (victim->used) {
+        stats_.evictions++;
+    }
+    *victim = Stream();
+    victim->used = true;
+    memcpy(victim->mac, srcMac, sizeof(victim->mac));
+    victim->packetType = packetType;
+    victim->lastUsed = useCounter_;
+    return *victim;
+}
@@ -0,0 +1,272 @@
+#include "wireless/fragment-reassembly.hpp"
+#include <algorithm>
+#include <cstring>
+
+void FragmentBitmap::clear() {
+    memset(bits, 0, sizeof(bits));
+}
+
+size_t FragmentBitmap::count() const {
+    size_t total = 0;
+    for (uint8_t byte : bits) {
+        total += __builtin_popcount(byte);
+    }
+    return total;
+}
+
+// ============================================
+// FragmentReassembler
+// ============================================
+
+FragmentReassembler::FragmentReassembler() : FragmentReassembler(Config()) {}
+
+FragmentReassembler::FragmentReassembler(const Config& config) :
+    config_(config),
+    clusters_(std::max<size_t>(config.maxClusters, 1))
+{
+}
+
+FragmentReassembler::Result FragmentReassembler::onFragment(const uint8_t* srcMac, const uint8_t* frame,
+                                                            size_t frameLen, unsigned long nowMs) {
+    if (frameLen < sizeof(DataPktHdr)) {
+        stats_.rejected++;
+        return Result::kRejected;
+    }
+
+    const auto* hdr = reinterpret_cast<const DataPktHdr*>(frame);
+    const uint8_t numPkts = hdr->numPktsInCluster;
+    const uint8_t idx = hdr->idxInCluster;
+    const bool longFrame = hdr->pktLen == DATA_PKT_LEN_LONG;
+    const size_t pktLen = longFrame ? frameLen : hdr->pktLen;
+    if (numPkts == 0 || idx >= numPkts ||
+        pktLen < sizeof(DataPktHdr) || pktLen > frameLen) {
+        stats_.rejected++;
+        return Result::kRejected;
+    }
+
+    // Every fragment but the last is full, which is what lets us place it by index
+    const size_t fragmentLen = longFrame ? PEER_COMMS_MAX_FRAME_PAYLOAD_V2 : PEER_COMMS_MAX_FRAME_PAYLOAD;
+    const size_t payloadLen = pktLen - sizeof(DataPktHdr);
+    if (payloadLen > fragmentLen ||
+        (idx + 1 < numPkts && payloadLen != fragmentLen)) {
+        stats_.rejected++;
+        return Result::kRejected;
+    }
+
+    const uint8_t* payload = frame + sizeof(DataPktHdr);
+
+    if (numPkts == 1) {
+        memcpy(completed_.srcMac, srcMac, sizeof(completed_.srcMac));
+        completed_.packetType = hdr->packetType;
+        completed_.data.assign(payload, payload + payloadLen);
+        stats_.completed++;
+        return Result::kComplete;
+    }
+
+    Cluster* cluster = find(srcMac, hdr->packetType);
+    if (cluster && (cluster->numPktsInCluster != numPkts || cluster->fragmentLen != fragmentLen)) {
+        start(*cluster, srcMac, hdr, fragmentLen, nowMs);
+    } else if (cluster && cluster->received.test(idx)) {
+        if (idx != 0) {
+            stats_.duplicates++;
+            return Result::kDuplicate;
+        }
+        start(*cluster, srcMac, hdr, fragmentLen, nowMs);
+    }
+
+    if (!cluster) {
+        cluster = claim(nowMs);
+        start(*cluster, srcMac, hdr, fragmentLen, nowMs);
+    }
+
+    if (idx != cluster->nextExpectedIdx) {
+        stats_.outOfOrder++;
+    }
+    cluster->nextExpectedIdx = idx + 1;
+
+    memcpy(cluster->buffer.data() + idx * fragmentLen, payload, payloadLen);
+    if (idx + 1 == numPkts) {
+        cluster->lastFragmentLen = payloadLen;
+    }
+    cluster->received.set(idx);
+    cluster->lastActivityMs = nowMs;
+
+    if (cluster->received.count() < numPkts) {
+        return Result::kIncomplete;
+    }
+
+    cluster->buffer.resize((numPkts - 1) * fragmentLen + cluster->lastFragmentLen);
+    memcpy(completed_.srcMac, cluster->srcMac, sizeof(completed_.srcMac));
+    completed_.packetType = cluster->packetType;
+    completed_.data = std::move(cluster->buffer);
+    cluster->buffer.clear();
+    cluster->active = false;
+    stats_.completed++;
+    return Result::kComplete;
+}
+
+size_t FragmentReassembler::expire(unsigned long nowMs) {
+    size_t evicted = 0;
+    for (auto& cluster : clusters_) {
+        if (cluster.active && nowMs - cluster.lastActivityMs >= config_.staleTimeoutMs) {
+            cluster.active = false;
+            evicted++;
+        }
+    }
+    stats_.evicted += evicted;
+    return evicted;
+}
+
+size_t FragmentReassembler::collectResendRequests(unsigned long nowMs, std::vector<FragmentResendRequest>& out) {
+    size_t added = 0;
+    for (auto& cluster : clusters_) {
+        if (!cluster.active || cluster.resendRequests >= config_.maxResendRequests) {
+            continue;
+        }
+        if (nowMs - cluster.lastActivityMs < config_.resendAfterMs) {
+            continue;
+        }
+
+        FragmentResendRequest request;
+        memcpy(request.srcMac, cluster.srcMac, sizeof(request.srcMac));
+        request.nack.packetType = cluster.packetType;
+        request.nack.numPktsInCluster = cluster.numPktsInCluster;
+        FragmentBitmap missing;
+        for (size_t i = 0; i < cluster.numPktsInCluster; i++) {
+            if (!cluster.received.test(static_cast<uint8_t>(i))) {
+                missing.set(static_cast<uint8_t>(i));
+            }
+        }
+        memcpy(request.nack.missing, missing.bits, sizeof(request.nack.missing));
+        out.push_back(request);
+
+        cluster.resendRequests++;
+        cluster.lastActivityMs = nowMs;
+        stats_.resendRequests++;
+        added++;
+    }
+    return added;
+}
+
+size_t FragmentReassembler::activeClusters() const {
+    return std::count_if(clusters_.begin(), clusters_.end(),
+                         [](const Cluster& c) { return c.active; });
+}
+
+FragmentReassembler::Cluster* FragmentReassembler::find(const uint8_t* srcMac, PktType packetType) {
+    for (auto& cluster : clusters_) {
+        if (cluster.active && cluster.packetType == packetType &&
+            memcmp(cluster.srcMac, srcMac, sizeof(cluster.srcMac)) == 0) {
+            return &cluster;
+        }
+    }
+    return nullptr;
+}
+
+FragmentReassembler::Cluster* FragmentReassembler::claim(unsigned long nowMs) {
+    Cluster* oldest = &clusters_[0];
+    for (auto& cluster : clusters_) {
+        if (!cluster.active) {
+            return &cluster;
+        }
+        if (nowMs - cluster.lastActivityMs > nowMs - oldest->lastActivityMs) {
+            oldest = &cluster;
+        }
+    }
+    stats_.evicted++;
+    return oldest;
+}
+
+void FragmentReassembler::start(Cluster& cluster, const uint8_t* srcMac, const DataPktHdr* hdr, size_t fragmentLen,
+                                unsigned long nowMs) {
+    cluster.active = true;
+    memcpy(cluster.srcMac, srcMac, sizeof(cluster.srcMac));
+    cluster.packetType = hdr->packetType;
+    cluster.numPktsInCluster = hdr->numPktsInCluster;
+    cluster.nextExpectedIdx = 0;
+    cluster.fragmentLen = fragmentLen;
+    cluster.lastFragmentLen = 0;
+    cluster.received.clear();
+    cluster.buffer.resize(hdr->numPktsInCluster * fragmentLen);
+    cluster.lastActivityMs = nowMs;
+    cluster.resendRequests = 0;
+}
+
+// ============================================
+// FragmentRetransmitCache
+// ============================================
+
+FragmentRetransmitCache::FragmentRetransmitCache(size_t maxEntries, unsigned long ttlMs) :
+    entries_(std::max<size_t>(maxEntries, 1)),
+    ttlMs_(ttlMs)
+{
+}
+
+void FragmentRetransmitCache::store(const uint8_t* dstMac, PktType packetType, const uint8_t* data,
+                                    size_t length, unsigned long nowMs, size_t fragmentLen) {
+    Entry* target = nullptr;
+    Entry* oldest = &entries_[0];
+    for (auto& entry : entries_) {
+        if (entry.active && entry.packetType == packetType &&
+            memcmp(entry.dstMac, dstMac, sizeof(entry.dstMac)) == 0) {
+            target = &entry;
+            break;
+        }
+        if (!entry.active && (!target)) {
+            target = &entry;
+        }
+        if (nowMs - entry.storedMs > nowMs - oldest->storedMs) {
+            oldest = &entry;
+        }
+    }
+    if (!target) {
+        target = oldest;
+    }
+
+    target->active = true;
+    memcpy(target->dstMac, dstMac, sizeof(target->dstMac));
+    target->packetType = packetType;
+    target->cluster.data.assign(data, data + length);
+    target->cluster.fragmentLen = fragmentLen;
+    target->storedMs = nowMs;
+}
+
+const FragmentRetransmitCache::Cluster* FragmentRetransmitCache::find(const uint8_t* dstMac,
+                                                                      const FragmentNackPayload& nack,
+                                                                      unsigned long nowMs) const {
+    for (const auto& entry : entries_) {
+        if (!entry.active || entry.packetType != nack.packetType ||
+            memcmp(entry.dstMac, dstMac, sizeof(entry.dstMac)) != 0) {
+            continue;
+        }
+        if (nowMs - entry.storedMs > ttlMs_ ||
+            fragmentCount(entry.cluster.data.size(), entry.cluster.fragmentLen) != nack.numPktsInCluster) {
+            return nullptr;
+        }
+        return &entry.cluster;
+    }
+    return nullptr;
+}
+
+size_t FragmentRetransmitCache::size() const {
+    return std::count_if(entries_.begin(), entries_.end(),
+                         [](const Entry& e) { return e.active; });
+}
+
+size_t buildFragment(uint8_t* out, PktType packetType, const uint8_t* data, size_t length,
+                     uint8_t idx, uint8_t numPktsInCluster, size_t fragmentLen) {
+    size_t offset = static_cast<size_t>(idx) * fragmentLen;
+    size_t thisLen = offset < length ? std::min(length - offset, fragmentLen) : 0;
+
+    auto* hdr = reinterpret_cast<DataPktHdr*>(out);
+    hdr->pktLen = fragmentLen > PEER_COMMS_MAX_FRAME_PAYLOAD
+        ? DATA_PKT_LEN_LONG
+        : static_cast<uint8_t>(sizeof(DataPktHdr) + thisLen);
+    hdr->packetType = packetType;
+    hdr->numPktsInCluster = numPktsInCluster;
+    hdr->idxInCluster = idx;
+    if (thisLen > 0) {
+        memcpy(out + sizeof(DataPktHdr), data + offset, thisLen);
+    }
+    return sizeof(DataPktHdr) + thisLen;
+}
@@ -5,13 +5,6 @@
 #include "wireless/handshake-wireless-manager.hpp"
 #include "device/drivers/peer-comms-interface.hpp"
 
-struct HandshakePacket {
-    int sendingJack;
-    int receicingJack;
-    int deviceType;
-    int command;
-} __attribute__((packed));
-
 HandshakeWirelessManager::HandshakeWirelessManager() {}
 
 HandshakeWirelessManager::~HandshakeWirelessManager() {
@@ -0,0 +1,103 @@
+#include "wireless/link-quality.hpp"
+#include <algorithm>
+#include <cstring>
+
+void LinkQualityTable::recordSend(const uint8_t* mac, bool delivered, unsigned long nowMs) {
+    Entry& entry = entryFor(mac, nowMs);
+    LinkEstimate& est = entry.estimate;
+    int sample = delivered ? 1000 : 0;
+    if (!entry.hasDelivery) {
+        est.deliveryPermille = static_cast<uint16_t>(sample);
+        entry.hasDelivery = true;
+    } else {
+        int smoothed = est.deliveryPermille + (sample - est.deliveryPermille) / 8;
+        est.deliveryPermille = static_cast<uint16_t>(std::min(std::max(smoothed, 0), 1000));
+    }
+    if (delivered) {
+        est.txDelivered++;
+    } else {
+        est.txFailed++;
+    }
+}
+
+void LinkQualityTable::recordAckRtt(const uint8_t* mac, unsigned long rttMs, unsigned long nowMs) {
+    LinkEstimate& est = entryFor(mac, nowMs).estimate;
+    if (!est.hasRtt) {
+        est.srttMs = rttMs;
+        est.rttvarMs = rttMs / 2;
+        est.hasRtt = true;
+    } else {
+        unsigned long delta = est.srttMs > rttMs ? est.srttMs - rttMs : rttMs - est.srttMs;
+        est.rttvarMs = (3 * est.rttvarMs + delta) / 4;
+        est.srttMs = (7 * est.srttMs + rttMs) / 8;
+    }
+    est.rttSamples++;
+}
+
+void LinkQualityTable::recordRssi(const uint8_t* mac, int rssiDbm, unsigned long nowMs) {
+    LinkEstimate& est = entryFor(mac, nowMs).estimate;
+    if (!est.hasRssi) {
+        est.rssiDbm = rssiDbm;
+        est.hasRssi = true;
+    } else {
+        est.rssiDbm = (3 * est.rssiDbm + rssiDbm) / 4;
+    }
+}
+
+bool LinkQualityTable::get(const uint8_t* mac, LinkEstimate& out) const {
+    const Entry* entry = find(mac);
+    if (!entry) {
+        return false;
+    }
+    out = entry->estimate;
+    return true;
+}
+
+bool LinkQualityTable::remove(const uint8_t* mac) {
+    Entry* entry = const_cast<Entry*>(find(mac));
+    if (!entry) {
+        return false;
+    }
+    *entry = Entry();
+    return true;
+}
+
+void LinkQualityTable::clear() {
+    entries_.fill(Entry());
+}
+
+size_t LinkQualityTable::size() const {
+    return std::count_if(entries_.begin(), entries_.end(), [](const Entry& e) { return e.used; });
+}
+
+LinkQualityTable::Entry& LinkQualityTable::entryFor(const uint8_t* mac, unsigned long nowMs) {
+    useCounter_++;
+    Entry* entry = const_cast<Entry*>(find(mac));
+    if (!entry) {
+        entry = &entries_[0];
+        for (auto& candidate : entries_) {
+            if (!candidate.used) {
+                entry = &candidate;
+                break;
+            }
+            if (candidate.lastUsed < entry->lastUsed) {
+                entry = &candidate;
+            }
+        }
+        *entry = Entry();
+        entry->used = true;
+        memcpy(entry->mac, mac, sizeof(entry->mac));
+    }
+    entry->lastUsed = useCounter_;
+    entry->estimate.lastUpdateMs = nowMs;
+    return *entry;
+}
+
+const LinkQualityTable::Entry* LinkQualityTable::find(const uint8_t* mac) const {
+    for (const auto& entry : entries_) {
+        if (entry.used && memcmp(entry.mac, mac, sizeof(entry.mac)) == 0) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,95 @@
+#include "wireless/multicast-group.hpp"
+#include <algorithm>
+#include <cstring>
+
+MulticastGroup multicastGroupFor(const char* name, const uint8_t* scopeMac) {
+    // FNV-1a over the name and scope, folded to 16 bits
+    uint32_t hash = 2166136261u;
+    auto mix = [&hash](uint8_t byte) {
+        hash ^= byte;
+        hash *= 16777619u;
+    };
+    for (const char* c = name; c && *c; c++) {
+        mix(static_cast<uint8_t>(*c));
+    }
+    if (scopeMac) {
+        for (int i = 0; i < 6; i++) {
+            mix(scopeMac[i]);
+        }
+    }
+    MulticastGroup group = static_cast<MulticastGroup>((hash >> 16) ^ (hash & 0xFFFF));
+    return group == NO_MULTICAST_GROUP ? 1 : group;
+}
+
+void buildMulticastPayload(MulticastGroup group, PktType packetType,
+                           const uint8_t* data, size_t length, std::vector<uint8_t>& out) {
+    MulticastHdr hdr;
+    hdr.group = group;
+    hdr.packetType = packetType;
+    out.resize(sizeof(hdr) + length);
+    memcpy(out.data(), &hdr, sizeof(hdr));
+    if (length > 0) {
+        memcpy(out.data() + sizeof(hdr), data, length);
+    }
+}
+
+bool MulticastMembership::join(MulticastGroup group) {
+    if (group == NO_MULTICAST_GROUP) {
+        return false;
+    }
+    if (isMember(group)) {
+        return true;
+    }
+    if (size_ == kMaxGroups) {
+        return false;
+    }
+    groups_[size_++] = group;
+    return true;
+}
+
+bool MulticastMembership::leave(MulticastGroup group) {
+    auto end = groups_.begin() + size_;
+    auto it = std::find(groups_.begin(), end, group);
+    if (group == NO_MULTICAST_GROUP || it == end) {
+        return false;
+    }
+    *it = groups_[--size_];
+    groups_[size_] = NO_MULTICAST_GROUP;
+    return true;
+}
+
+void MulticastMembership::clear() {
+    groups_.fill(NO_MULTICAST_GROUP);
+    size_ = 0;
+}
+
+bool MulticastMembership::isMember(MulticastGroup group) const {
+    return group != NO_MULTICAST_GROUP &&
+           std::find(groups_.begin(), groups_.begin() + size_, group) != groups_.begin() + size_;
+}
+
+bool MulticastMembership::accept(const uint8_t* data, size_t length,
+                                 PktType& packetType, const uint8_t*& payload, size_t& payloadLen) {
+    MulticastHdr hdr;
+    if (length < sizeof(hdr)) {
+        stats_.malformed++;
+        return false;
+    }
+    memcpy(&hdr, data, sizeof(hdr));
+    // Transport-level types never travel inside a multicast
+    if (static_cast<int>(hdr.packetType) >= static_cast<int>(PktType::kNumPacketTypes) ||
+        hdr.packetType == PktType::kFragmentNack || hdr.packetType == PktType::kMulticast ||
+        hdr.packetType == PktType::kBundle) {
+        stats_.malformed++;
+        return false;
+    }
+    if (!isMember(hdr.group)) {
+        stats_.filtered++;
+        return false;
+    }
+    packetType = hdr.packetType;
+    payload = data + sizeof(hdr);
+    payloadLen = length - sizeof(hdr);
+    stats_.accepted++;
+    return true;
+}
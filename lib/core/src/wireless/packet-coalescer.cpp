@@ -0,0 +1,72 @@
+#include "wireless/packet-coalescer.hpp"
+#include <algorithm>
+
+bool isCoalescible(PktType packetType) {
+    switch (packetType) {
+        case PktType::kChainAnnouncementAck:
+        case PktType::kChainConfirm:
+        case PktType::kRoleAnnounce:
+        case PktType::kRoleAnnounceAck:
+        case PktType::kChainGameEventAck:
+        case PktType::kShootoutCommandAck:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool PacketCoalescer::stage(const uint8_t* dst, PktType packetType, const uint8_t* data, size_t length,
+                            const SendOptions& options, unsigned long nowMs) {
+    if (!enabled_ || !isCoalescible(packetType) || length > kMaxMessageLen) {
+        return false;
+    }
+
+    Pending* pending = find(dst);
+    if (!pending) {
+        auto freeSlot = std::find_if(pending_.begin(), pending_.end(),
+                                     [](const Pending& p) { return !p.used; });
+        if (freeSlot == pending_.end()) {
+            return false;
+        }
+        pending = &*freeSlot;
+        pending->used = true;
+        memcpy(pending->mac, dst, sizeof(pending->mac));
+    }
+
+    BundleEntryHdr hdr;
+    hdr.packetType = packetType;
+    hdr.length = static_cast<uint8_t>(length);
+    if (pending->length + sizeof(hdr) + length > kMaxBundleLen) {
+        return false;
+    }
+    memcpy(pending->data.data() + pending->length, &hdr, sizeof(hdr));
+    if (length > 0) {
+        memcpy(pending->data.data() + pending->length + sizeof(hdr), data, length);
+    }
+    pending->length += sizeof(hdr) + length;
+    pending->count++;
+
+    pending->priority = std::min(pending->priority, options.priority);
+    if (options.maxAgeMs > 0) {
+        unsigned long deadline = nowMs + options.maxAgeMs;
+        if (!pending->hasDeadline || static_cast<long>(deadline - pending->deadlineMs) < 0) {
+            pending->deadlineMs = deadline;
+        }
+        pending->hasDeadline = true;
+    }
+    stats_.staged++;
+    return true;
+}
+
+bool PacketCoalescer::hasPending() const {
+    return std::any_of(pending_.begin(), pending_.end(), [](const Pending& p) { return p.used; });
+}
+
+PacketCoalescer::Pending* PacketCoalescer::find(const uint8_t* mac) {
+    for (auto& pending : pending_) {
+        if (pending.used && memcmp(pending.mac, mac, sizeof(pending.mac)) == 0) {
+            return &pending;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,147 @@
+#include "wireless/peer-table.hpp"
+#include <algorithm>
+#include <cstring>
+
+PeerTable::PeerTable(size_t capacity) :
+    capacity_(std::min(capacity, PEER_TABLE_CAPACITY)) {}
+
+PeerTable::Admit PeerTable::admit(const uint8_t* mac, bool pin, uint8_t* evicted) {
+    useCounter_++;
+    Entry* entry = find(mac);
+    if (entry) {
+        entry->lastUsed = useCounter_;
+        entry->pinned = entry->pinned || pin;
+        stats_.hits++;
+        return Admit::kPresent;
+    }
+
+    Admit result = Admit::kAdded;
+    if (size_ < capacity_) {
+        for (size_t i = 0; i < capacity_; i++) {
+            if (!entries_[i].used) {
+                entry = &entries_[i];
+                break;
+            }
+        }
+        size_++;
+    } else {
+        for (size_t i = 0; i < capacity_; i++) {
+            Entry& candidate = entries_[i];
+            if (!candidate.pinned && (!entry || candidate.lastUsed < entry->lastUsed)) {
+                entry = &candidate;
+            }
+        }
+        if (!entry) {
+            stats_.rejected++;
+            return Admit::kFull;
+        }
+        if (evicted) {
+            memcpy(evicted, entry->mac, sizeof(entry->mac));
+        }
+        stats_.evictions++;
+        result = Admit::kEvicted;
+    }
+
+    entry->used = true;
+    entry->pinned = pin;
+    memcpy(entry->mac, mac, sizeof(entry->mac));
+    entry->lastUsed = useCounter_;
+    stats_.adds++;
+    return result;
+}
+
+bool PeerTable::unpin(const uint8_t* mac) {
+    Entry* entry = find(mac);
+    if (!entry) {
+        return false;
+    }
+    entry->pinned = false;
+    return true;
+}
+
+bool PeerTable::remove(const uint8_t* mac) {
+    Entry* entry = find(mac);
+    if (!entry) {
+        return false;
+    }
+    *entry = Entry();
+    size_--;
+    return true;
+}
+
+void PeerTable::clear() {
+    entries_.fill(Entry());
+    size_ = 0;
+}
+
+void PeerTable::setMaxFrameLen(const uint8_t* mac, size_t maxFrameLen) {
+    findOrAddCaps(mac).maxFrameLen = static_cast<uint16_t>(std::min<size_t>(maxFrameLen, UINT16_MAX));
+}
+
+size_t PeerTable::maxFrameLen(const uint8_t* mac) const {
+    const Caps* caps = findCaps(mac);
+    return caps ? caps->maxFrameLen : PEER_COMMS_MAX_FRAME_LEN;
+}
+
+bool PeerTable::shouldRequestCaps(const uint8_t* mac) {
+    if (findCaps(mac)) {
+        return false;
+    }
+    findOrAddCaps(mac);
+    return true;
+}
+
+bool PeerTable::isPinned(const uint8_t* mac) const {
+    const Entry* entry = find(mac);
+    return entry && entry->pinned;
+}
+
+size_t PeerTable::pinnedCount() const {
+    return std::count_if(entries_.begin(), entries_.end(),
+                         [](const Entry& e) { return e.used && e.pinned; });
+}
+
+PeerTable::Entry* PeerTable::find(const uint8_t* mac) {
+    for (size_t i = 0; i < capacity_; i++) {
+        Entry& entry = entries_[i];
+        if (entry.used && memcmp(entry.mac, mac, sizeof(entry.mac)) == 0) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+const PeerTable::Entry* PeerTable::find(const uint8_t* mac) const {
+    return const_cast<PeerTable*>(this)->find(mac);
+}
+
+const PeerTable::Caps* PeerTable::findCaps(const uint8_t* mac) const {
+    for (const Caps& caps : caps_) {
+        if (caps.used && memcmp(caps.mac, mac, sizeof(caps.mac)) == 0) {
+            return &caps;
+        }
+    }
+    return nullptr;
+}
+
+// Takes a free slot, else the least recently heard peer's
+PeerTable::Caps& PeerTable::findOrAddCaps(const uint8_t* mac) {
+    useCounter_++;
+    Caps* slot = const_cast<Caps*>(findCaps(mac));
+    if (!slot) {
+        for (Caps& candidate : caps_) {
+            if (!candidate.used) {
+                slot = &candidate;
+                break;
+            }
+            if (!slot || candidate.lastUsed < slot->lastUsed) {
+                slot = &candidate;
+            }
+        }
+        *slot = Caps();
+        slot->used = true;
+        memcpy(slot->mac, mac, sizeof(slot->mac));
+    }
+    slot->lastUsed = useCounter_;
+    return *slot;
+}
@@ -0,0 +1,212 @@
+#include "wireless/reliable-channel.hpp"
+#include <algorithm>
+#include <cstring>
+
+ReliableChannel::ReliableChannel() : ReliableChannel(Config()) {}
+
+ReliableChannel::ReliableChannel(const Config& config) : config_(config) {}
+
+uint8_t ReliableChannel::nextSeq(const uint8_t* peer) {
+    PeerState& state = peerState(peer);
+    uint8_t seq = state.nextSeq++;
+    if (state.nextSeq == 0) state.nextSeq = 1;
+    return seq;
+}
+
+uint8_t ReliableChannel::track(const uint8_t* peer, uint8_t tag, uint32_t context) {
+    uint8_t seq = nextSeq(peer);
+    trackWithSeq(peer, seq, tag, context);
+    return seq;
+}
+
+void ReliableChannel::trackWithSeq(const uint8_t* peer, uint8_t seq, uint8_t tag, uint32_t context) {
+    cancel(peer, tag);
+
+    Pending entry;
+    memcpy(entry.peer.data(), peer, 6);
+    entry.seq = seq;
+    entry.tag = tag;
+    entry.context = context;
+    entry.retries = 0;
+    entry.timer.setTimer(timeoutFor(peer, 0));
+    pending_.push_back(entry);
+    stats_.sends++;
+}
+
+bool ReliableChannel::ack(const uint8_t* peer, uint8_t seq, uint8_t tag) {
+    size_t idx = indexOf(peer, seq, tag);
+    if (idx == pending_.size()) return false;
+
+    Pending& entry = pending_[idx];
+    unsigned long latency = entry.timer.getElapsedTime();
+    stats_.ackLatencyMsSum += latency;
+    stats_.ackCount++;
+    if (entry.retries == 0) {
+        sampleRtt(peerState(peer), latency);
+        if (rttObserver_) {
+            rttObserver_(peer, latency);
+        }
+    }
+    pending_.erase(pending_.begin() + idx);
+    return true;
+}
+
+size_t ReliableChannel::cancel(const uint8_t* peer, uint8_t tag) {
+    size_t before = pending_.size();
+    pending_.erase(std::remove_if(pending_.begin(), pending_.end(), [&](const Pending& p) {
+        return p.tag == tag && memcmp(p.peer.data(), peer, 6) == 0;
+    }), pending_.end());
+    return before - pending_.size();
+}
+
+size_t ReliableChannel::cancelTag(uint8_t tag) {
+    size_t before = pending_.size();
+    pending_.erase(std::remove_if(pending_.begin(), pending_.end(), [&](const Pending& p) {
+        return p.tag == tag;
+    }), pending_.end());
+    return before - pending_.size();
+}
+
+void ReliableChannel::clear() {
+    pending_.clear();
+}
+
+void ReliableChannel::poll() {
+    // Callbacks may track, cancel or clear. Entries are re-located by key
+    // after each one rather than trusting indices across the call.
+    for (size_t i = 0; i < pending_.size(); ) {
+        if (!pending_[i].timer.expired()) { ++i; continue; }
+
+        Pending entry = pending_[i];
+        if (entry.retries >= config_.maxRetries) {
+            pending_.erase(pending_.begin() + i);
+            stats_.abandons++;
+            if (abandonCallback_) {
+                abandonCallback_(entry.peer.data(), entry.seq, entry.tag, entry.context);
+            }
+            continue;
+        }
+
+        bool resent = retransmitCallback_ &&
+            retransmitCallback_(entry.peer.data(), entry.seq, entry.tag, entry.context);
+
+        size_t idx = indexOf(entry.peer.data(), entry.seq, entry.tag);
+        if (idx == pending_.size()) continue;
+        if (!resent) {
+            pending_.erase(pending_.begin() + idx);
+            i = idx;
+            continue;
+        }
+
+        Pending& live = pending_[idx];
+        live.retries++;
+        live.timer.setTimer(timeoutFor(live.peer.data(), live.retries));
+        stats_.retries++;
+        i = idx + 1;
+    }
+}
+
+size_t ReliableChannel::pendingCount(uint8_t tag) const {
+    return std::count_if(pending_.begin(), pending_.end(),
+                         [tag](const Pending& p) { return p.tag == tag; });
+}
+
+bool ReliableChannel::isPending(const uint8_t* peer, uint8_t tag) const {
+    return std::any_of(pending_.begin(), pending_.end(), [&](const Pending& p) {
+        return p.tag == tag && memcmp(p.peer.data(), peer, 6) == 0;
+    });
+}
+
+unsigned long ReliableChannel::rtoMs(const uint8_t* peer) const {
+    const PeerState* state = findPeer(peer);
+    return state ? rtoFor(*state) : config_.initialRtoMs;
+}
+
+size_t ReliableChannel::indexOf(const uint8_t* peer, uint8_t seq, uint8_t tag) const {
+    for (size_t i = 0; i < pending_.size(); i++) {
+        const Pending& p = pending_[i];
+        if (p.seq == seq && p.tag == tag && memcmp(p.peer.data(), peer, 6) == 0) {
+            return i;
+        }
+    }
+    return pending_.size();
+}
+
+ReliableChannel::PeerState& ReliableChannel::peerState(const uint8_t* peer) {
+    useCounter_++;
+    for (auto& state : peers_) {
+        if (memcmp(state.mac.data(), peer, 6) == 0) {
+            state.lastUsed = useCounter_;
+            return state;
+        }
+    }
+
+    if (peers_.size() >= config_.maxPeers) {
+        evictIdlePeer();
+    }
+    PeerState state;
+    memcpy(state.mac.data(), peer, 6);
+    state.lastUsed = useCounter_;
+    peers_.push_back(state);
+    return peers_.back();
+}
+
+const ReliableChannel::PeerState* ReliableChannel::findPeer(const uint8_t* peer) const {
+    for (const auto& state : peers_) {
+        if (memcmp(state.mac.data(), peer, 6) == 0) {
+            return &state;
+        }
+    }
+    return nullptr;
+}
+
+unsigned long ReliableChannel::rtoFor(const PeerState& state) const {
+    if (!state.hasRtt) {
+        return config_.initialRtoMs;
+    }
+    unsigned long rto = state.srttMs + std::max<unsigned long>(1, 4 * state.rttvarMs);
+    return std::min(std::max(rto, config_.minRtoMs), config_.maxRtoMs);
+}
+
+unsigned long ReliableChannel::timeoutFor(const uint8_t* peer, uint8_t retries) {
+    PeerState& state = peerState(peer);
+    if (!state.hasRtt && rttSeed_) {
+        state.hasRtt = rttSeed_(peer, state.srttMs, state.rttvarMs);
+    }
+    unsigned long base = rtoFor(state);
+    uint8_t shift = std::min(retries, config_.maxBackoffShift);
+    unsigned long timeout = base << shift;
+    // Guard the shift against overflow as well as the configured ceiling
+    if ((timeout >> shift) != base || timeout > config_.maxRtoMs) {
+        timeout = std::max(base, config_.maxRtoMs);
+    }
+    return timeout;
+}
+
+void ReliableChannel::sampleRtt(PeerState& state, unsigned long rttMs) {
+    if (!state.hasRtt) {
+        state.srttMs = rttMs;
+        state.rttvarMs = rttMs / 2;
+        state.hasRtt = true;
+        return;
+    }
+    unsigned long delta = state.srttMs > rttMs ? state.srttMs - rttMs : rttMs - state.srttMs;
+    state.rttvarMs = (3 * state.rttvarMs + delta) / 4;
+    state.srttMs = (7 * state.srttMs + rttMs) / 8;
+}
+
+void ReliableChannel::evictIdlePeer() {
+    auto victim = peers_.end();
+    for (auto it = peers_.begin(); it != peers_.end(); ++it) {
+        bool busy = std::any_of(pending_.begin(), pending_.end(), [&](const Pending& p) {
+            return p.peer == it->mac;
+        });
+        if (busy) continue;
+        if (victim == peers_.end() || it->lastUsed < victim->lastUsed) {
+            victim = it;
+        }
+    }
+    if (victim != peers_.end()) {
+        peers_.erase(victim);
+    }
+}
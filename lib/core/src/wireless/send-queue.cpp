@@ -0,0 +1,21 @@
+#include "wireless/send-queue.hpp"
+
+SendOptions defaultSendOptions(PktType packetType) {
+    SendOptions options;
+    switch (packetType) {
+        case PktType::kQuickdrawCommand:
+        case PktType::kChainGameEvent:
+        case PktType::kChainGameEventAck:
+            options.priority = SendPriority::kDuel;
+            break;
+        case PktType::kPlayerInfoBroadcast:
+        case PktType::kDebugPacket:
+        case PktType::kBulkTransfer:
+            options.priority = SendPriority::kBulk;
+            break;
+        default:
+            options.priority = SendPriority::kControl;
+            break;
+    }
+    return options;
+}
@@ -0,0 +1,206 @@
+#include "wireless/send-scheduler.hpp"
+#include <algorithm>
+#include <cstring>
+
+SendScheduler::SendScheduler() : SendScheduler(Config()) {}
+
+SendScheduler::SendScheduler(const Config& config) : config_(config) {
+    for (size_t i = 0; i < kCapacity; i++) {
+        nextSlot_[i] = static_cast<uint8_t>(i + 1 < kCapacity ? i + 1 : kNone);
+    }
+    freeHead_ = 0;
+    // Start every rotation at destination 0
+    cursor_.fill(kMaxDestinations - 1);
+}
+
+bool SendScheduler::push(const QueuedFrame& frame) {
+    if (freeHead_ == kNone) {
+        return false;
+    }
+    Destination* dest = findOrAdd(frame.dstMac);
+    if (!dest) {
+        return false;
+    }
+
+    uint8_t slot = freeHead_;
+    freeHead_ = nextSlot_[slot];
+    slots_[slot] = frame;
+    nextSlot_[slot] = kNone;
+
+    size_t p = std::min(static_cast<size_t>(frame.priority), SEND_PRIORITY_COUNT - 1);
+    slots_[slot].priority = static_cast<SendPriority>(p);
+    if (dest->head[p] == kNone) {
+        dest->head[p] = slot;
+    } else {
+        nextSlot_[dest->tail[p]] = slot;
+    }
+    dest->tail[p] = slot;
+
+    queued_++;
+    dest->stats.depth++;
+    dest->stats.maxDepth = std::max(dest->stats.maxDepth, dest->stats.depth);
+    stats_.enqueued[p]++;
+    return true;
+}
+
+bool SendScheduler::onSendDone(const uint8_t* dst, bool delivered, unsigned long nowMs,
+                               QueuedFrame& finished) {
+    Destination* dest = find(dst);
+    if (!dest || !dest->onAir) {
+        return false;
+    }
+    dest->onAir = false;
+    onAir_--;
+
+    if (delivered) {
+        unsigned long latency = nowMs - dest->startedMs;
+        dest->stats.delivered++;
+        dest->stats.txLatencyMsSum += latency;
+        dest->stats.txLatencyMsMax = std::max(dest->stats.txLatencyMsMax, latency);
+        dest->consecutiveFailures = 0;
+    } else {
+        if (dest->consecutiveFailures < 0xFF) {
+            dest->consecutiveFailures++;
+        }
+        uint8_t shift = std::min<uint8_t>(dest->consecutiveFailures - 1, 16);
+        unsigned long backoff = std::min(config_.backoffBaseMs << shift, config_.backoffMaxMs);
+        dest->backoffUntilMs = nowMs + backoff;
+
+        if (dest->retries < config_.maxRetries) {
+            dest->retries++;
+            dest->stats.retries++;
+            stats_.retries++;
+            return false;
+        }
+        dest->stats.failed++;
+        stats_.failed++;
+    }
+
+    finished = dest->inFlight;
+    dest->hasInFlight = false;
+    dest->retries = 0;
+    return true;
+}
+
+bool SendScheduler::peekOnAir(const uint8_t* dst, QueuedFrame& out) const {
+    const Destination* dest = find(dst);
+    if (!dest || !dest->onAir) {
+        return false;
+    }
+    out = dest->inFlight;
+    return true;
+}
+
+size_t SendScheduler::size(SendPriority priority) const {
+    size_t p = static_cast<size_t>(priority);
+    size_t count = 0;
+    for (const auto& dest : destinations_) {
+        if (!dest.used || p >= SEND_PRIORITY_COUNT) {
+            continue;
+        }
+        for (uint8_t slot = dest.head[p]; slot != kNone; slot = nextSlot_[slot]) {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool SendScheduler::getDestinationStats(const uint8_t* mac, DestinationStats& out) const {
+    const Destination* dest = find(mac);
+    if (!dest) {
+        return false;
+    }
+    out = dest->stats;
+    return true;
+}
+
+void SendScheduler::resetStats() {
+    stats_ = Stats();
+    for (auto& dest : destinations_) {
+        size_t depth = dest.stats.depth;
+        dest.stats = DestinationStats();
+        dest.stats.depth = depth;
+        dest.stats.maxDepth = depth;
+    }
+}
+
+SendScheduler::Destination* SendScheduler::find(const uint8_t* mac) {
+    for (auto& dest : destinations_) {
+        if (dest.used && memcmp(dest.mac, mac, sizeof(dest.mac)) == 0) {
+            return &dest;
+        }
+    }
+    return nullptr;
+}
+
+const SendScheduler::Destination* SendScheduler::find(const uint8_t* mac) const {
+    return const_cast<SendScheduler*>(this)->find(mac);
+}
+
+SendScheduler::Destination* SendScheduler::findOrAdd(const uint8_t* mac) {
+    useCounter_++;
+    Destination* dest = find(mac);
+    if (dest) {
+        dest->lastUsed = useCounter_;
+        return dest;
+    }
+
+    // Take a free entry, else forget the least recently used idle destination
+    Destination* victim = nullptr;
+    for (auto& candidate : destinations_) {
+        if (!candidate.used) {
+            victim = &candidate;
+            break;
+        }
+        bool idle = candidate.stats.depth == 0 && !candidate.hasInFlight;
+        if (idle && (!victim || candidate.lastUsed < victim->lastUsed)) {
+            victim = &candidate;
+        }
+    }
+    if (!victim) {
+        return nullptr;
+    }
+
+    *victim = Destination();
+    victim->used = true;
+    memcpy(victim->mac, mac, sizeof(victim->mac));
+    victim->head.fill(kNone);
+    victim->tail.fill(kNone);
+    victim->lastUsed = useCounter_;
+    return victim;
+}
+
+QueuedFrame SendScheduler::popHead(Destination& dest, size_t p) {
+    uint8_t slot = dest.head[p];
+    QueuedFrame frame = slots_[slot];
+    dest.head[p] = nextSlot_[slot];
+    if (dest.head[p] == kNone) {
+        dest.tail[p] = kNone;
+    }
+    nextSlot_[slot] = freeHead_;
+    freeHead_ = slot;
+
+    queued_--;
+    dest.stats.depth--;
+    return frame;
+}
+
+void SendScheduler::startNext(Destination& dest, size_t p, unsigned long nowMs) {
+    dest.inFlight = popHead(dest, p);
+    dest.hasInFlight = true;
+    dest.retries = 0;
+    dest.startedMs = nowMs;
+
+    unsigned long waited = nowMs - dest.inFlight.enqueuedMs;
+    dest.stats.started++;
+    dest.stats.queueDelayMsSum += waited;
+    dest.stats.queueDelayMsMax = std::max(dest.stats.queueDelayMsMax, waited);
+    stats_.dequeued[p]++;
+    stats_.maxQueueDelayMs = std::max(stats_.maxQueueDelayMs, waited);
+}
+
+void SendScheduler::markOnAir(Destination& dest) {
+    dest.onAir = true;
+    onAir_++;
+    stats_.maxInFlight = std::max(stats_.maxInFlight, onAir_);
+}
@@ -0,0 +1,104 @@
+#include "wireless/traffic-stats.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+unsigned long long estimateAirtimeUs(const TrafficCounters& counters) {
+    unsigned long long perFrame = ESP_NOW_PREAMBLE_US + ESP_NOW_FRAME_OVERHEAD_BYTES * ESP_NOW_US_PER_BYTE;
+    return counters.frames * perFrame +
+           static_cast<unsigned long long>(counters.bytes) * ESP_NOW_US_PER_BYTE;
+}
+
+const char* pktTypeName(PktType type) {
+    switch (type) {
+        case PktType::kPlayerInfoBroadcast:  return "PlayerInfo";
+        case PktType::kQuickdrawCommand:     return "Quickdraw";
+        case PktType::kDebugPacket:          return "Debug";
+        case PktType::kHandshakeCommand:     return "Handshake";
+        case PktType::kChainAnnouncement:    return "ChainAnnouncement";
+        case PktType::kChainAnnouncementAck: return "ChainAnnouncementAck";
+        case PktType::kChainGameEvent:       return "ChainGameEvent";
+        case PktType::kChainConfirm:         return "ChainConfirm";
+        case PktType::kRoleAnnounce:         return "RoleAnnounce";
+        case PktType::kRoleAnnounceAck:      return "RoleAnnounceAck";
+        case PktType::kChainGameEventAck:    return "ChainGameEventAck";
+        case PktType::kShootoutCommand:      return "ShootoutCommand";
+        case PktType::kShootoutCommandAck:   return "ShootoutCommandAck";
+        case PktType::kSymbolMatchCommand:   return "SymbolMatch";
+        case PktType::kFdnConnect:           return "FdnConnect";
+        case PktType::kFragmentNack:         return "FragmentNack";
+        case PktType::kMulticast:            return "Multicast";
+        case PktType::kBundle:               return "Bundle";
+        case PktType::kBulkTransfer:         return "BulkTransfer";
+        case PktType::kLinkCaps:             return "LinkCaps";
+        default:                             return "?";
+    }
+}
+
+TrafficCounters TrafficStats::Snapshot::total(TrafficDirection direction) const {
+    const auto& counters = direction == TrafficDirection::kTx ? tx : rx;
+    TrafficCounters sum;
+    for (const TrafficCounters& c : counters) {
+        sum.frames += c.frames;
+        sum.bytes += c.bytes;
+        sum.fragments += c.fragments;
+        sum.failures += c.failures;
+        sum.queueDelayMsSum += c.queueDelayMsSum;
+        sum.queueDelayMsMax = std::max(sum.queueDelayMsMax, c.queueDelayMsMax);
+    }
+    return sum;
+}
+
+TrafficCounters* TrafficStats::find(TrafficDirection direction, PktType type) {
+    size_t index = static_cast<size_t>(type);
+    if (index >= kNumTypes) {
+        return nullptr;
+    }
+    return &(direction == TrafficDirection::kTx ? counters_.tx : counters_.rx)[index];
+}
+
+void TrafficStats::recordTx(PktType type, size_t frameLen, bool fragment, unsigned long queueDelayMs) {
+    TrafficCounters* c = find(TrafficDirection::kTx, type);
+    if (!c) return;
+    c->frames++;
+    c->bytes += static_cast<uint32_t>(frameLen);
+    if (fragment) c->fragments++;
+    c->queueDelayMsSum += queueDelayMs;
+    c->queueDelayMsMax = std::max(c->queueDelayMsMax, queueDelayMs);
+}
+
+void TrafficStats::recordRx(PktType type, size_t frameLen, bool fragment) {
+    TrafficCounters* c = find(TrafficDirection::kRx, type);
+    if (!c) return;
+    c->frames++;
+    c->bytes += static_cast<uint32_t>(frameLen);
+    if (fragment) c->fragments++;
+}
+
+void TrafficStats::recordFailure(TrafficDirection direction, PktType type) {
+    TrafficCounters* c = find(direction, type);
+    if (c) c->failures++;
+}
+
+void TrafficStats::snapshot(unsigned long nowMs, Snapshot& out) const {
+    out = counters_;
+    out.takenMs = nowMs;
+}
+
+void TrafficStats::reset(unsigned long nowMs) {
+    counters_ = Snapshot();
+    counters_.sinceMs = nowMs;
+}
+
+int formatTrafficRow(const TrafficStats::Snapshot& snapshot, PktType type, char* out, size_t outLen) {
+    const TrafficCounters& tx = snapshot.get(TrafficDirection::kTx, type);
+    const TrafficCounters& rx = snapshot.get(TrafficDirection::kRx, type);
+    unsigned long meanDelay = tx.frames ? tx.queueDelayMsSum / tx.frames : 0;
+    return snprintf(out, outLen,
+                    "%s tx %luf %luB %lufrag %lufail q %lu/%lums air %llums | rx %luf %luB %ludrop",
+                    pktTypeName(type),
+                    (unsigned long)tx.frames, (unsigned long)tx.bytes,
+                    (unsigned long)tx.fragments, (unsigned long)tx.failures,
+                    meanDelay, tx.queueDelayMsMax, estimateAirtimeUs(tx) / 1000,
+                    (unsigned long)rx.frames, (unsigned long)rx.bytes, (unsigned long)rx.failures);
+}
@@ -2,8 +2,6 @@
 
 #include <algorithm>
 #include <vector>
-#include <queue>
-#include <unordered_map>
 #include <Arduino.h>
 #include <WiFi.h>
 #include <esp_now.h>
@@ -12,16 +10,28 @@
 #include "device/drivers/logger.hpp"
 #include "device/drivers/driver-interface.hpp"
 #include "wireless/mac-functions.hpp"
+#include "wireless/packet-ring.hpp"
+#include "wireless/frame-pool.hpp"
+#include "wireless/fragment-reassembly.hpp"
+#include "wireless/send-scheduler.hpp"
+#include "wireless/peer-table.hpp"
+#include "wireless/link-quality.hpp"
+#include "wireless/multicast-group.hpp"
+#include "wireless/duplicate-filter.hpp"
+#include "wireless/packet-coalescer.hpp"
+#include "wireless/bulk-transfer.hpp"
+#include "wireless/packet-registry.hpp"
+#include "wireless/traffic-stats.hpp"
 #include "device/drivers/peer-comms-types.hpp"
 #include "esp32-driver-constants.hpp"
 
 #define DEBUG_PRINT_ESP_NOW 0
 
-//Change to 1 to enable tracking rssi for peers
-//This works, but requires wifi to be in promiscuous mode
-//which likely prevents connecting to access points and
-//requires an unknown but likely high amount of processing
-//power
+//Change to 1 to also sample rssi from promiscuous mode, which sees every
+//ESP-NOW frame in the air rather than only those addressed to us.
+//This works, but likely prevents connecting to access points and
+//requires an unknown but likely high amount of processing power.
+//Frames we receive always carry rssi into the link-quality table.
 #define PDN_ENABLE_RSSI_TRACKING 0
 
 //Use this mac address in order to reach all nearby devices
@@ -29,6 +39,25 @@ constexpr uint8_t PEER_BROADCAST_ADDR[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
 
 constexpr size_t MAX_PKT_DATA_SIZE = ESP_NOW_MAX_DATA_LEN - sizeof(DataPktHdr);
 
+static_assert(PACKET_RING_SLOT_SIZE >= ESP_NOW_MAX_DATA_LEN,
+              "Receive ring slots must hold a full ESP-NOW frame");
+static_assert(SendFramePool::blockSize() >= ESP_NOW_MAX_DATA_LEN,
+              "Send pool blocks must hold a full ESP-NOW frame");
+static_assert(MAX_PKT_DATA_SIZE == PEER_COMMS_MAX_FRAME_PAYLOAD,
+              "Core fragmentation helpers assume ESP-NOW frame sizes");
+
+//IDF 5.4 added ESP-NOW v2, whose frames carry up to ESP_NOW_MAX_DATA_LEN_V2
+//bytes. Older IDFs only build v1 and never advertise more than 250.
+#ifdef ESP_NOW_MAX_DATA_LEN_V2
+static_assert(ESP_NOW_MAX_DATA_LEN_V2 == PEER_COMMS_MAX_FRAME_LEN_V2,
+              "Core fragmentation helpers assume ESP-NOW v2 frame sizes");
+static_assert(LargeSendFramePool::blockSize() >= ESP_NOW_MAX_DATA_LEN_V2,
+              "Large send pool blocks must hold a full ESP-NOW v2 frame");
+#endif
+
+//Number of received packets that can wait for exec() before new ones are dropped
+constexpr size_t ESP_NOW_RECV_RING_CAPACITY = 32;
+
 //Singleton class that handles communication over ESP-NOW protocol.
 class EspNowManager : public PeerCommsDriverInterface
 {
@@ -45,20 +74,48 @@ public:
     // === PEER COMMS INTERFACE === //
 
     void exec() override {
-        std::queue<DeferredPacket> pending;
-        xSemaphoreTake(recvMutex_, portMAX_DELAY);
-        std::swap(pending, recvQueue_);
-        xSemaphoreGive(recvMutex_);
-
-        while (!pending.empty()) {
-            auto& pkt = pending.front();
-            PacketCallback cb = m_pktHandlerCallbacks[(int)pkt.type].first;
-            if (cb) {
-                cb(pkt.srcMac, pkt.data.data(), pkt.data.size(),
-                   m_pktHandlerCallbacks[(int)pkt.type].second);
+        serviceReassembly();
+
+        //Pushes bulk chunks the receivers' credit allows and retransmits on timeout
+        m_bulk.service(millis(), m_bulkEmit);
+
+        //Control messages staged since the last exec() go out bundled
+        FlushCoalesced();
+
+        //Picks up destinations whose send backoff has lapsed
+        PumpSends();
+
+        //Only drain what was queued on entry so the WiFi task can't starve the loop
+        size_t pending = recvRing_.size();
+        while (pending-- > 0) {
+            const PacketRingSlot* slot = recvRing_.front();
+            if (!slot) {
+                break;
             }
-            pending.pop();
+            PktType type = slot->type;
+            const uint8_t* payload = slot->payload();
+            size_t len = slot->len;
+            const uint8_t* srcMac = slot->srcMac;
+            //Multicasts for groups we haven't joined stop here
+            if (type == PktType::kMulticast && !m_multicast.accept(payload, len, type, payload, len)) {
+                recvRing_.pop();
+                continue;
+            }
+            if (type == PktType::kBundle) {
+                bool wellFormed = forEachBundled(payload, len, [&](PktType inner, const uint8_t* data, size_t length) {
+                    DispatchPacket(srcMac, inner, data, length);
+                });
+                if (!wellFormed) {
+                    LOG_W("ENC", "Dropped malformed bundle (%u bytes)\n", (unsigned)len);
+                }
+            } else {
+                DispatchPacket(srcMac, type, payload, len);
+            }
+            recvRing_.pop();
         }
+
+        //Replies the handlers just sent share frames too
+        FlushCoalesced();
     }
 
     void connect() override {
@@ -113,84 +170,55 @@ public:
 
     //Queues up data for sending, may not send right away
     int sendData(const uint8_t* dst, PktType packetType, const uint8_t* data, const size_t length) override {
-        if(length > (255 * MAX_PKT_DATA_SIZE))
-        {
-            LOG_W("ENC", "ESP-NOW: Tried to send too large of buffer: %u of max %u\n",
-                length, 
-                255 * MAX_PKT_DATA_SIZE);
-            return -1;
-        }
+        return sendData(dst, packetType, data, length, defaultSendOptions(packetType));
+    }
 
-        //Calculate the total number of ESP_NOW_MAX_DATA_LEN (250) byte packets we'll 
-        //need to send the whole buffer
-        uint8_t numInCluster = length / MAX_PKT_DATA_SIZE + 
-                               (length % MAX_PKT_DATA_SIZE == 0 ? 0 : 1);
-        
-        //Allocate entire send buffer up front so we don't fail an allocation part way through
-        //the cluster
-        //We'll use alloca for tracking the buffers while we set them up since this should
-        //require a very small amount of memory making the risk of stack overflow very small
-        //This will also be much faster than malloc/free which would be wasteful for such a
-        //small allocation
-        auto sendBuffers = static_cast<uint8_t**>(alloca(sizeof(uint8_t*) * numInCluster));
-        size_t bytesLeft = length;
-        for(int i = 0; i < numInCluster; ++i)
+    //Queues up data in the given priority class. Higher classes go out first;
+    //a packet still queued past options.maxAgeMs is dropped unsent.
+    int sendData(const uint8_t* dst, PktType packetType, const uint8_t* data, const size_t length,
+                 const SendOptions& options) override {
+        //A cluster bigger than the whole send pool could never be reserved
+        if(length > MAX_SEND_PACKET_LEN)
         {
-            size_t thisBuffer = std::min(bytesLeft, MAX_PKT_DATA_SIZE);
-            sendBuffers[i] = (uint8_t*)ps_malloc(sizeof(DataPktHdr) + thisBuffer);
-            if(!sendBuffers[i])
-            {
-                //free anything we already allocated
-                for(int j = 0; j < i; ++j)
-                    free(sendBuffers[j]);
-
-                //TODO: Return better error code once we have them
-                LOG_E("ENC", "Failed to allocate buffers for ESP-NOW send queue");
-                LOG_E("ENC", "Needed to allocate a total of %lu bytes\n", length);
-                return -1;
-            }
-            bytesLeft -= thisBuffer;
+            LOG_W("ENC", "ESP-NOW: Tried to send too large of buffer: %u of max %u, use sendBulk\n",
+                length,
+                MAX_SEND_PACKET_LEN);
+            return -1;
         }
 
         xSemaphoreTake(sendMutex_, portMAX_DELAY);
-        bool willNeedToStartSend = m_sendQueue.empty();
-
-        //Build up each packet
-        bytesLeft = length;
-        for(int pktIdx = 0; pktIdx < numInCluster; ++pktIdx)
-        {
-            size_t thisBuffer = std::min(bytesLeft, MAX_PKT_DATA_SIZE);
-#if DEBUG_PRINT_ESP_NOW
-            ESP_LOGD("ENC", "ESPNOW SendData pktIdx: %i thisBuffer: %u\n", pktIdx, thisBuffer);
-#endif
-
-            //Each packet needs a header, build it directly in the send buffer
-            auto* hdr = reinterpret_cast<DataPktHdr*>(sendBuffers[pktIdx]);
-            hdr->idxInCluster = pktIdx;
-            hdr->numPktsInCluster = numInCluster;
-            hdr->pktLen = sizeof(DataPktHdr) + thisBuffer;
-            hdr->packetType = packetType;
+        unsigned long now = millis();
+
+        //Small control messages wait for the end of the tick to share a frame.
+        //Anything else to the same peer first flushes what is waiting for it.
+        bool staged = m_coalescer.stage(dst, packetType, data, length, options, now) ||
+                      (m_coalescer.flush(dst, now, CoalescedEmitterLocked{this}) &&
+                       m_coalescer.stage(dst, packetType, data, length, options, now));
+        int result = staged ? 0 : QueuePacketLocked(dst, packetType, data, length, options, now);
+        xSemaphoreGive(sendMutex_);
 
-            //Copy the actual data into the send buffer following the header
-            size_t dataOffset = pktIdx * MAX_PKT_DATA_SIZE;
-            memcpy(sendBuffers[pktIdx] + sizeof(DataPktHdr), data + dataOffset, thisBuffer);
+        if(!staged) {
+            PumpSends();
+        }
+        return result;
+    }
 
-            //Now add it to the send queue
-            DataSendBuffer buffer;
-            memcpy(buffer.dstMac, dst, ESP_NOW_ETH_ALEN);
-            buffer.ptr = sendBuffers[pktIdx];
-            buffer.len = hdr->pktLen;
-            m_sendQueue.push(buffer);
+    //Broadcasts the payload once, tagged with the group; receivers that haven't
+    //joined it drop the frame in exec()
+    int sendMulticast(MulticastGroup group, PktType packetType, const uint8_t* data, const size_t length,
+                      const SendOptions& options) override {
+        buildMulticastPayload(group, packetType, data, length, m_multicastScratch);
+        return sendData(PEER_BROADCAST_ADDR, PktType::kMulticast,
+                        m_multicastScratch.data(), m_multicastScratch.size(), options);
+    }
 
-            bytesLeft -= thisBuffer;
-        }
-        xSemaphoreGive(sendMutex_);
+    //Membership is only touched from the loop task, like exec()
+    int joinMulticastGroup(MulticastGroup group) override {
+        return m_multicast.join(group) ? 0 : -1;
+    }
 
-        if(willNeedToStartSend)
-        {
-            SendFrontPkt();
-        }
-        return 0;
+    void leaveMulticastGroup(MulticastGroup group) override {
+        m_multicast.leave(group);
     }
 
     //Set the packet handler for a particular packet type
@@ -200,13 +228,84 @@ public:
     //userArg will be saved per packet type and will be passed in unmodified to
     //packet handler for that packet type (when a packet of that type is receieved)
     void setPacketHandler(PktType packetType, PacketCallback callback, void* ctx) override {
-        m_pktHandlerCallbacks[(int)packetType].first = callback;
-        m_pktHandlerCallbacks[(int)packetType].second = ctx;
+        m_pktHandlers.set(packetType, callback, ctx);
     }
 
     //Unregister packet handler for specified packet type
     void clearPacketHandler(PktType packetType) override {
-        m_pktHandlerCallbacks[(int)packetType].first = nullptr;
+        m_pktHandlers.clear(packetType);
+    }
+
+    //Filtering happens in exec(), so like the handlers this is loop-task only
+    void setDuplicateSuppression(PktType packetType, uint8_t seqOffset,
+                                 PacketCallback onDuplicate, void* ctx) override {
+        m_duplicates.setRule(packetType, seqOffset);
+        m_dupHandlers.set(packetType, onDuplicate, ctx);
+    }
+
+    void clearDuplicateSuppression(PktType packetType) override {
+        m_duplicates.clearRule(packetType);
+        m_dupHandlers.clear(packetType);
+    }
+
+    const DuplicateFilter::Stats& GetDuplicateFilterStats() const {
+        return m_duplicates.getStats();
+    }
+
+    //Bulk transfers run from exec() on the loop task, like the handlers
+    int sendBulk(const uint8_t* dst, uint8_t channel, const uint8_t* data, const size_t length) override {
+        int transferId = m_bulk.start(dst, channel, data, length, millis());
+        if(transferId > 0) {
+            m_bulk.service(millis(), m_bulkEmit);
+        } else {
+            LOG_W("ENC", "Could not start bulk transfer of %u bytes\n", (unsigned)length);
+        }
+        return transferId;
+    }
+
+    bool getBulkTransferStatus(int transferId, BulkTransferStatus& out) override {
+        return m_bulk.getStatus(transferId, out);
+    }
+
+    void cancelBulkTransfer(int transferId) override {
+        m_bulk.cancel(transferId, m_bulkEmit);
+    }
+
+    void setBulkHandler(uint8_t channel, PacketCallback callback, void* ctx) override {
+        if(channel < BulkTransfer::kMaxChannels) {
+            m_bulkHandlerCallbacks[channel].first = callback;
+            m_bulkHandlerCallbacks[channel].second = ctx;
+            m_bulk.listen(channel, true);
+        }
+    }
+
+    void clearBulkHandler(uint8_t channel) override {
+        if(channel < BulkTransfer::kMaxChannels) {
+            m_bulkHandlerCallbacks[channel].first = nullptr;
+            m_bulk.listen(channel, false);
+        }
+    }
+
+    const BulkTransfer::Stats& GetBulkTransferStats() const {
+        return m_bulk.getStats();
+    }
+
+    //Turning bundling off sends whatever is staged right away
+    void setCoalescingEnabled(bool enabled) override {
+        xSemaphoreTake(sendMutex_, portMAX_DELAY);
+        m_coalescer.setEnabled(enabled);
+        xSemaphoreGive(sendMutex_);
+        if(!enabled) {
+            FlushCoalesced();
+        }
+    }
+
+    //Control messages staged, bundles sent and frames saved by bundling
+    PacketCoalescer::Stats GetCoalescerStats() {
+        xSemaphoreTake(sendMutex_, portMAX_DELAY);
+        PacketCoalescer::Stats stats = m_coalescer.getStats();
+        xSemaphoreGive(sendMutex_);
+        return stats;
     }
 
     // Called by DriverManager at startup - we don't initialize ESP-NOW here
@@ -218,9 +317,9 @@ public:
     }
 
     int GetRssiForPeer(const uint8_t* macAddr) {
-        uint64_t macAddr64 = MacToUInt64(macAddr);
-        if(m_rssiTracker.count(macAddr64) > 0)
-            return m_rssiTracker[macAddr64];
+        LinkEstimate estimate;
+        if(getLinkEstimate(macAddr, estimate) && estimate.hasRssi)
+            return estimate.rssiDbm;
         return -1;
     }
 
@@ -228,6 +327,32 @@ public:
         return GetRssiForPeer(macAddr);
     }
 
+    void reportAckRtt(const uint8_t* macAddr, unsigned long rttMs) override {
+        xSemaphoreTake(linkMutex_, portMAX_DELAY);
+        m_linkQuality.recordAckRtt(macAddr, rttMs, millis());
+        xSemaphoreGive(linkMutex_);
+    }
+
+    bool getLinkEstimate(const uint8_t* macAddr, LinkEstimate& out) override {
+        xSemaphoreTake(linkMutex_, portMAX_DELAY);
+        bool known = m_linkQuality.get(macAddr, out);
+        xSemaphoreGive(linkMutex_);
+        return known;
+    }
+
+    bool getTrafficSnapshot(TrafficStats::Snapshot& out) override {
+        xSemaphoreTake(linkMutex_, portMAX_DELAY);
+        m_traffic.snapshot(millis(), out);
+        xSemaphoreGive(linkMutex_);
+        return true;
+    }
+
+    void resetTrafficStats() override {
+        xSemaphoreTake(linkMutex_, portMAX_DELAY);
+        m_traffic.reset(millis());
+        xSemaphoreGive(linkMutex_);
+    }
+
     // Public methods for ESP-NOW callback handling
     // (used when re-initializing ESP-NOW in EspNowState)
     void HandleReceivedData(const esp_now_recv_info_t *esp_now_info, const uint8_t *data, int data_len) {
@@ -240,44 +365,71 @@ public:
         EspNowSendCallback(esp_now_info, status);
     }
 
-private:
-    static EspNowManager* instance;
+    //Packets dropped because the receive ring was full when they arrived
+    uint32_t GetRecvOverflowCount() const {
+        return recvRing_.getOverflowCount();
+    }
 
-    // Struct definitions must come before methods that use them
-    struct DeferredPacket {
-        PktType type;
-        uint8_t srcMac[6];
-        std::vector<uint8_t> data;
-    };
+    //Packets dropped because the reassembled payload didn't fit a ring slot
+    uint32_t GetRecvDropCount() const {
+        return recvRing_.getDropCount();
+    }
 
-    struct DataSendBuffer
-    {
-        uint8_t dstMac[6];
-        uint8_t* ptr;
-        size_t len;
-    };
+    //sendData() calls rejected because the send pool had no room for the cluster
+    uint32_t GetSendPoolExhaustedCount() const {
+        return m_sendPool.getExhaustedCount();
+    }
 
-    struct DataRecvBuffer
-    {
-        uint8_t* data;
-        unsigned long mostRecentRecvPktTime;
-        uint8_t expectedNextIdx;
-    };
+    //Most send pool blocks ever in use at once
+    size_t GetSendPoolHighWater() const {
+        return m_sendPool.getHighWater();
+    }
+
+    //Peer-table hits, adds, LRU evictions and admissions refused because every entry was pinned
+    PeerTable::Stats GetPeerTableStats() {
+        xSemaphoreTake(peerMutex_, portMAX_DELAY);
+        PeerTable::Stats stats = m_peerTable.getStats();
+        xSemaphoreGive(peerMutex_);
+        return stats;
+    }
+
+    //Per-class scheduler counters: enqueued, dequeued, expired, retries, in-flight high water
+    SendScheduler::Stats GetSendSchedulerStats() {
+        xSemaphoreTake(sendMutex_, portMAX_DELAY);
+        SendScheduler::Stats stats = m_sendScheduler.getStats();
+        xSemaphoreGive(sendMutex_);
+        return stats;
+    }
+
+    //Queue depth and latency toward one destination. False if it has no entry.
+    bool GetDestinationSendStats(const uint8_t* macAddr, SendScheduler::DestinationStats& out) {
+        xSemaphoreTake(sendMutex_, portMAX_DELAY);
+        bool found = m_sendScheduler.getDestinationStats(macAddr, out);
+        xSemaphoreGive(sendMutex_);
+        return found;
+    }
+
+private:
+    static EspNowManager* instance;
 
     explicit EspNowManager(const std::string& name) :
         PeerCommsDriverInterface(name),
-        m_pktHandlerCallbacks((int)PktType::kNumPacketTypes, std::pair<PacketCallback, void*>(nullptr, nullptr)),
-        m_maxRetries(5),
-        m_curRetries(0),
-        recvMutex_(xSemaphoreCreateMutex()),
-        sendMutex_(xSemaphoreCreateMutex())
+        m_bulkHandlerCallbacks(BulkTransfer::kMaxChannels, std::pair<PacketCallback, void*>(nullptr, nullptr)),
+        m_bulkEmit([this](const uint8_t* dst, const uint8_t* data, size_t length) {
+            return sendData(dst, PktType::kBulkTransfer, data, length);
+        }),
+        sendMutex_(xSemaphoreCreateMutex()),
+        peerMutex_(xSemaphoreCreateMutex()),
+        linkMutex_(xSemaphoreCreateMutex()),
+        reassemblyMutex_(xSemaphoreCreateMutex())
     {
-
+#if PDN_ENABLE_RSSI_TRACKING
         wifi_promiscuous_filter_t filter = {
             .filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT};
         esp_wifi_set_promiscuous_filter(&filter);
         esp_wifi_set_promiscuous_rx_cb(EspNowManager::WifiPromiscuousRecvCallback);
         esp_wifi_set_promiscuous(true);
+#endif
         // ESP-NOW initialization happens in connect() -> initializeEspNow()
         // after WiFi has been set up
     }
@@ -305,7 +457,22 @@ private:
             return -1;
         }
 
-        // Register broadcast peer
+        //v2 radios take long frames from peers that say they send them; we
+        //say so in LinkCapsPayload when a peer is added
+        m_maxFrameLen = ESP_NOW_MAX_DATA_LEN;
+#ifdef ESP_NOW_MAX_DATA_LEN_V2
+        uint32_t version = 0;
+        if(esp_now_get_version(&version) == ESP_OK && version >= 2) {
+            m_maxFrameLen = ESP_NOW_MAX_DATA_LEN_V2;
+        }
+#endif
+        LOG_I("ENC", "ESP-NOW max frame %u bytes\n", (unsigned)m_maxFrameLen);
+
+        // Register broadcast peer. It holds one of the 20 table entries for good.
+        xSemaphoreTake(peerMutex_, portMAX_DELAY);
+        m_peerTable.clear();
+        m_peerTable.admit(PEER_BROADCAST_ADDR, true, nullptr);
+        xSemaphoreGive(peerMutex_);
         esp_now_peer_info_t broadcastPeer = {};
         memcpy(broadcastPeer.peer_addr, PEER_BROADCAST_ADDR, ESP_NOW_ETH_ALEN);
         err = esp_now_add_peer(&broadcastPeer);
@@ -320,6 +487,7 @@ private:
         return 0;
     }
 
+#if PDN_ENABLE_RSSI_TRACKING
     //Callback for receiving raw Wifi packets, used for rssi tracking
     static void WifiPromiscuousRecvCallback(void *buf, wifi_promiscuous_pkt_type_t type) {
         const wifi_promiscuous_pkt_t* pkt = (wifi_promiscuous_pkt_t*)buf;
@@ -336,9 +504,31 @@ private:
         //6 bytes for first mac addr (which is receiver)
         //=10 byte offset to get to sender
         const uint8_t* srcMac = (pkt->payload) + 10;
-        uint64_t srcMac64 = MacToUInt64(srcMac);
 
-        EspNowManager::GetInstance()->m_rssiTracker[srcMac64] = rssi;
+        EspNowManager::GetInstance()->RecordRssi(srcMac, rssi);
+    }
+#endif
+
+    //Runs on the WiFi task, so the table is only touched under linkMutex_
+    void RecordRssi(const uint8_t* srcMac, int rssi) {
+        xSemaphoreTake(linkMutex_, portMAX_DELAY);
+        m_linkQuality.recordRssi(srcMac, rssi, millis());
+        xSemaphoreGive(linkMutex_);
+    }
+
+    //Counts one frame, or one failure when !ok. Called from the WiFi task and
+    //the loop, so the counters are only touched under linkMutex_
+    void RecordTraffic(TrafficDirection direction, PktType type, size_t frameLen, bool fragment,
+                       unsigned long queueDelayMs, bool ok) {
+        xSemaphoreTake(linkMutex_, portMAX_DELAY);
+        if(!ok) {
+            m_traffic.recordFailure(direction, type);
+        } else if(direction == TrafficDirection::kTx) {
+            m_traffic.recordTx(type, frameLen, fragment, queueDelayMs);
+        } else {
+            m_traffic.recordRx(type, frameLen, fragment);
+        }
+        xSemaphoreGive(linkMutex_);
     }
 
     //ESP-NOW callbacks
@@ -362,8 +552,18 @@ private:
         ESP_LOGD("ENC", "Packet Type: %i\n", pktHdr->packetType);
 #endif
 
-        if(pktHdr->numPktsInCluster > 1) {
-            manager->handleMultiPacketCluster(esp_now_info->src_addr, data, pktHdr);
+        if(esp_now_info->rx_ctrl) {
+            manager->RecordRssi(esp_now_info->src_addr, esp_now_info->rx_ctrl->rssi);
+        }
+        manager->RecordTraffic(TrafficDirection::kRx, pktHdr->packetType, data_len,
+                               pktHdr->numPktsInCluster > 1, 0, true);
+
+        //A v2 frame is longer than a receive slot, so even a single one goes
+        //through the reassembler, which hands it over whole
+        if(pktHdr->packetType == PktType::kFragmentNack) {
+            manager->handleFragmentNack(esp_now_info->src_addr, data, data_len);
+        } else if(pktHdr->numPktsInCluster > 1 || pktHdr->pktLen == DATA_PKT_LEN_LONG) {
+            manager->handleMultiPacketCluster(esp_now_info->src_addr, data, data_len);
         } else {
             manager->handleSinglePacket(esp_now_info->src_addr, data, pktHdr);
         }
@@ -374,84 +574,237 @@ private:
         HandlePktCallback(pktHdr->packetType, mac_addr, data + sizeof(DataPktHdr), pktHdr->pktLen - sizeof(DataPktHdr));
     }
 
-    void handleMultiPacketCluster(const uint8_t* mac_addr, const uint8_t* data, const DataPktHdr* pktHdr) {
-        uint64_t macAddr64 = MacToUInt64(mac_addr);
-        
-        if(pktHdr->idxInCluster == 0) {
-            handleFirstPacketInCluster(macAddr64, pktHdr);
+    //Fragments may arrive in any order; the reassembler tracks them in a bitmap
+    //and hands back the whole cluster once every index is present
+    void handleMultiPacketCluster(const uint8_t* mac_addr, const uint8_t* data, int data_len) {
+        xSemaphoreTake(reassemblyMutex_, portMAX_DELAY);
+        auto result = m_reassembler.onFragment(mac_addr, data, data_len, millis());
+        if(result == FragmentReassembler::Result::kComplete) {
+            FragmentReassembler::Completed& done = m_reassembler.completed();
+            if((int)done.packetType < (int)PktType::kNumPacketTypes &&
+               !recvRing_.pushLarge(done.packetType, done.srcMac, std::move(done.data))) {
+                LOG_W("ENC", "Dropped reassembled cluster type %u (recv ring full)\n", (int)done.packetType);
+            }
+        } else if(result == FragmentReassembler::Result::kRejected) {
+            LOG_W("ENC", "Rejected malformed cluster fragment\n");
         }
-        
-        handleSubsequentPacket(mac_addr, data, pktHdr, macAddr64);
+        xSemaphoreGive(reassemblyMutex_);
     }
 
-    void handleFirstPacketInCluster(uint64_t macAddr64, const DataPktHdr* pktHdr) {
-        // If there's an existing cluster for this mac address, release it
-        // as that means we lost a packet somewhere
-        auto existingBuffer = m_recvBuffers.find(macAddr64);
-        if(existingBuffer != m_recvBuffers.end()) {
-            free(existingBuffer->second.data);
-            m_recvBuffers.erase(existingBuffer);
+    //Peer is missing fragments of a cluster we sent; queue only those again
+    void handleFragmentNack(const uint8_t* mac_addr, const uint8_t* data, int data_len) {
+        if(data_len < (int)(sizeof(DataPktHdr) + sizeof(FragmentNackPayload))) {
+            return;
+        }
+        FragmentNackPayload nack;
+        memcpy(&nack, data + sizeof(DataPktHdr), sizeof(nack));
+
+        xSemaphoreTake(sendMutex_, portMAX_DELAY);
+        const FragmentRetransmitCache::Cluster* cluster = m_retransmitCache.find(mac_addr, nack, millis());
+        if(!cluster) {
+            cluster = m_retransmitCache.find(PEER_BROADCAST_ADDR, nack, millis());
+        }
+        if(!cluster) {
+            xSemaphoreGive(sendMutex_);
+            LOG_D("ENC", "NACK for unknown cluster type %u\n", (int)nack.packetType);
+            return;
         }
 
-        DataRecvBuffer newBuffer;
-        newBuffer.data = (uint8_t*)ps_malloc(pktHdr->numPktsInCluster * MAX_PKT_DATA_SIZE);
-        newBuffer.expectedNextIdx = 1;
-        m_recvBuffers[macAddr64] = newBuffer;
+        FragmentBitmap missing;
+        memcpy(missing.bits, nack.missing, sizeof(missing.bits));
+        SendOptions options = defaultSendOptions(nack.packetType);
+        for(int idx = 0; idx < nack.numPktsInCluster; ++idx) {
+            if(!missing.test(idx)) {
+                continue;
+            }
+            bool reserved = cluster->fragmentLen > MAX_PKT_DATA_SIZE ? m_largeSendPool.reserve(1)
+                                                                     : m_sendPool.reserve(1);
+            if(!reserved) {
+                break;
+            }
+            QueueFrameLocked(mac_addr, nack.packetType, cluster->data.data(), cluster->data.size(), idx,
+                             nack.numPktsInCluster, options, millis(), cluster->fragmentLen);
+        }
+        xSemaphoreGive(sendMutex_);
+
+        PumpSends();
     }
 
-    void handleSubsequentPacket(const uint8_t* mac_addr, const uint8_t* data, const DataPktHdr* pktHdr, uint64_t macAddr64) {
-        auto existingBuffer = m_recvBuffers.find(macAddr64);
-        
-        // If no buffer exists, we missed the start packet
-        if(existingBuffer == m_recvBuffers.end()) {
-            LOG_W("ENC", "No recv buffer for mid cluster pkt. We must have missed first pkt.");
-            return;
+    //Evict stale clusters and ask senders to repeat whatever is still missing.
+    //Runs on the main loop; the WiFi task fills the reassembler.
+    void serviceReassembly() {
+        xSemaphoreTake(reassemblyMutex_, portMAX_DELAY);
+        unsigned long now = millis();
+        m_reassembler.expire(now);
+        m_reassembler.collectResendRequests(now, m_resendScratch);
+        xSemaphoreGive(reassemblyMutex_);
+
+        for(const auto& request : m_resendScratch) {
+            sendData(request.srcMac, PktType::kFragmentNack,
+                     reinterpret_cast<const uint8_t*>(&request.nack), sizeof(request.nack));
         }
+        m_resendScratch.clear();
+    }
 
-        DataRecvBuffer& recvBuffer = existingBuffer->second;
-        
-        if(!validatePacketSequence(pktHdr, recvBuffer, existingBuffer)) {
-            return;
+    //Builds and queues every frame of one packet. Caller holds sendMutex_.
+    int QueuePacketLocked(const uint8_t* dst, PktType packetType, const uint8_t* data, size_t length,
+                          const SendOptions& options, unsigned long now) {
+        //Calculate the total number of frames we'll need to send the whole buffer:
+        //ESP_NOW_MAX_DATA_LEN (250) bytes each, or v2 frames to a peer that takes them
+        size_t fragmentLen = ChooseFragmentLenLocked(dst, length);
+        bool large = fragmentLen > MAX_PKT_DATA_SIZE;
+        uint8_t numInCluster = static_cast<uint8_t>(fragmentCount(length, fragmentLen));
+
+        //Reserve the entire cluster up front so we don't run out of blocks part way
+        //through. If the pool is exhausted nothing is queued and the caller gets -1;
+        //blocks come back as the radio drains the queue, so the caller's own retry
+        //timer will succeed on a later tick. sendData() already refused clusters
+        //larger than the whole pool. v2 clusters were only chosen because the
+        //large pool could hold them.
+        if(!large && !m_sendPool.reserve(numInCluster))
+        {
+            LOG_W("ENC", "ESP-NOW send pool exhausted: need %u blocks, %u free\n",
+                  numInCluster, (unsigned)m_sendPool.available());
+            return -1;
         }
 
-        copyPacketData(data, pktHdr, recvBuffer);
-        ++existingBuffer->second.expectedNextIdx;
-        
-        if(isClusterComplete(existingBuffer->second, pktHdr)) {
-            finalizeCluster(mac_addr, pktHdr, recvBuffer, existingBuffer);
+        //Build up each packet
+        for(int pktIdx = 0; pktIdx < numInCluster; ++pktIdx)
+        {
+#if DEBUG_PRINT_ESP_NOW
+            ESP_LOGD("ENC", "ESPNOW SendData pktIdx: %i of %u\n", pktIdx, numInCluster);
+#endif
+            QueueFrameLocked(dst, packetType, data, length, pktIdx, numInCluster, options, now, fragmentLen);
+        }
+
+        //Keep a copy of multi-packet clusters so a receiver's NACK can be answered
+        //with just the fragments it lost
+        if(numInCluster > 1)
+        {
+            m_retransmitCache.store(dst, packetType, data, length, now, fragmentLen);
         }
+        return 0;
     }
 
-    bool validatePacketSequence(const DataPktHdr* pktHdr, DataRecvBuffer& recvBuffer, 
-                                std::unordered_map<uint64_t, DataRecvBuffer>::iterator& existingBuffer) {
-        if(pktHdr->idxInCluster != recvBuffer.expectedNextIdx) {
-            LOG_W("ENC", "Received pkt %u when expecting %u. Must have missed a packet in cluster.\n",
-                  recvBuffer.expectedNextIdx, pktHdr->idxInCluster);
-            free(recvBuffer.data);
-            m_recvBuffers.erase(existingBuffer);
-            return false;
+    //Payload bytes per frame toward dst. Unicast to a peer whose caps allow v2
+    //frames uses them if the whole cluster fits the large pool; broadcasts and
+    //everything else use ESP_NOW_MAX_DATA_LEN frames. Caller holds sendMutex_.
+    size_t ChooseFragmentLenLocked(const uint8_t* dst, size_t length) {
+        if(length <= MAX_PKT_DATA_SIZE || memcmp(dst, PEER_BROADCAST_ADDR, ESP_NOW_ETH_ALEN) == 0) {
+            return MAX_PKT_DATA_SIZE;
         }
-        return true;
+        xSemaphoreTake(peerMutex_, portMAX_DELAY);
+        size_t peerMaxFrameLen = m_peerTable.maxFrameLen(dst);
+        xSemaphoreGive(peerMutex_);
+
+        size_t fragmentLen = fragmentLenFor(std::min(m_maxFrameLen, peerMaxFrameLen));
+        if(fragmentLen > MAX_PKT_DATA_SIZE &&
+           fragmentCount(length, fragmentLen) > m_largeSendPool.available()) {
+            return MAX_PKT_DATA_SIZE;
+        }
+        return fragmentLen;
     }
 
-    void copyPacketData(const uint8_t* data, const DataPktHdr* pktHdr, DataRecvBuffer& recvBuffer) {
-        size_t bufferOffset = pktHdr->idxInCluster * MAX_PKT_DATA_SIZE;
-        memcpy(recvBuffer.data + bufferOffset, data + sizeof(DataPktHdr), pktHdr->pktLen - sizeof(DataPktHdr));
+    //Blocks come from either pool; each ignores the other's. Caller holds sendMutex_.
+    void ReleaseFrameLocked(uint8_t* frame) {
+        m_sendPool.release(frame);
+        m_largeSendPool.release(frame);
     }
 
-    bool isClusterComplete(const DataRecvBuffer& recvBuffer, const DataPktHdr* pktHdr) {
-        return recvBuffer.expectedNextIdx == pktHdr->numPktsInCluster;
+    //Tells dst the largest frame we take. Queued rather than coalesced, since
+    //PumpSends() may be the caller.
+    void QueueLinkCaps(const uint8_t* dst, uint8_t flags) {
+        LinkCapsPayload caps;
+        caps.maxFrameLen = static_cast<uint16_t>(m_maxFrameLen);
+        caps.flags = flags;
+        xSemaphoreTake(sendMutex_, portMAX_DELAY);
+        QueuePacketLocked(dst, PktType::kLinkCaps, reinterpret_cast<const uint8_t*>(&caps), sizeof(caps),
+                          defaultSendOptions(PktType::kLinkCaps), millis());
+        xSemaphoreGive(sendMutex_);
     }
 
-    void finalizeCluster(const uint8_t* mac_addr, const DataPktHdr* pktHdr, DataRecvBuffer& recvBuffer,
-                         std::unordered_map<uint64_t, DataRecvBuffer>::iterator& existingBuffer) {
-        size_t totalClusterSize = (pktHdr->numPktsInCluster - 1) * MAX_PKT_DATA_SIZE;
-        totalClusterSize += pktHdr->pktLen - sizeof(DataPktHdr);
-        
-        HandlePktCallback(pktHdr->packetType, mac_addr, recvBuffer.data, totalClusterSize);
-        
-        free(recvBuffer.data);
-        m_recvBuffers.erase(existingBuffer);
+    //Records a peer's caps without adding it to the radio, so hearing from a
+    //peer never evicts another. A request gets ours back; the peer only asks
+    //the first time it adds us.
+    void HandleLinkCaps(const uint8_t* srcMac, const uint8_t* payload, size_t len) {
+        const LinkCapsPayload* caps = decodePacket<PktType::kLinkCaps>(payload, len);
+        if(!caps) {
+            return;
+        }
+        xSemaphoreTake(peerMutex_, portMAX_DELAY);
+        m_peerTable.setMaxFrameLen(srcMac, caps->maxFrameLen);
+        xSemaphoreGive(peerMutex_);
+
+        if(caps->flags & LINK_CAPS_REPLY_REQUESTED) {
+            QueueLinkCaps(srcMac, 0);
+            PumpSends();
+        }
+    }
+
+    //Queues what m_coalescer.flush() hands back. Caller holds sendMutex_.
+    struct CoalescedEmitterLocked {
+        EspNowManager* manager;
+        void operator()(const uint8_t* dst, PktType packetType, const uint8_t* data, size_t length,
+                        const SendOptions& options) const {
+            manager->QueuePacketLocked(dst, packetType, data, length, options, millis());
+        }
+    };
+
+    //Queues every bundle staged since the last flush and starts sending them
+    void FlushCoalesced() {
+        xSemaphoreTake(sendMutex_, portMAX_DELAY);
+        bool pending = m_coalescer.hasPending();
+        if(pending) {
+            m_coalescer.flush(millis(), CoalescedEmitterLocked{this});
+        }
+        xSemaphoreGive(sendMutex_);
+        if(pending) {
+            PumpSends();
+        }
+    }
+
+    //Hands one logical packet to its handler, or to the duplicate hook if it
+    //repeats one already seen
+    void DispatchPacket(const uint8_t* srcMac, PktType type, const uint8_t* payload, size_t len) {
+        if (type == PktType::kLinkCaps) {
+            HandleLinkCaps(srcMac, payload, len);
+            return;
+        }
+        if (type == PktType::kBulkTransfer) {
+            if (m_bulk.onPacket(srcMac, payload, len, millis(), m_bulkEmit) == BulkTransfer::Result::kComplete) {
+                BulkTransfer::Completed& done = m_bulk.completed();
+                const auto& handler = m_bulkHandlerCallbacks[done.channel];
+                if (handler.first) {
+                    handler.first(done.srcMac, done.data.data(), done.data.size(), handler.second);
+                }
+            }
+            return;
+        }
+        bool duplicate = m_duplicates.isDuplicate(srcMac, type, payload, len, millis());
+        (duplicate ? m_dupHandlers : m_pktHandlers).dispatch(srcMac, type, payload, len);
+    }
+
+    //Builds one fragment in a pool block and queues it for its destination.
+    //Caller holds sendMutex_ and has already reserved the block, in the large
+    //pool for v2 fragments.
+    void QueueFrameLocked(const uint8_t* dst, PktType packetType, const uint8_t* data, size_t length,
+                          uint8_t idx, uint8_t numInCluster, const SendOptions& options, unsigned long now,
+                          size_t fragmentLen = MAX_PKT_DATA_SIZE) {
+        uint8_t* frame = fragmentLen > MAX_PKT_DATA_SIZE ? m_largeSendPool.acquire() : m_sendPool.acquire();
+
+        QueuedFrame queued;
+        memcpy(queued.dstMac, dst, ESP_NOW_ETH_ALEN);
+        queued.ptr = frame;
+        queued.len = buildFragment(frame, packetType, data, length, idx, numInCluster, fragmentLen);
+        queued.packetType = packetType;
+        queued.priority = options.priority;
+        queued.idxInCluster = idx;
+        queued.enqueuedMs = now;
+        queued.hasDeadline = options.maxAgeMs > 0;
+        queued.deadlineMs = now + options.maxAgeMs;
+        //The scheduler has a frame slot and a destination entry per block in both
+        //pools, so this can't fail once reserved
+        m_sendScheduler.push(queued);
     }
 
     static void EspNowSendCallback(const esp_now_send_info_t *esp_now_info, esp_now_send_status_t status) {
@@ -461,91 +814,112 @@ private:
         ESP_LOGD("ENC", "ESPNOW Send Callback");
 #endif
 
-        if(status == ESP_NOW_SEND_SUCCESS)
+        bool delivered = status == ESP_NOW_SEND_SUCCESS;
+        if(delivered)
         {
             LOG_D("ENC", "Send SUCCESS");
-            manager->MoveToNextSendPkt();
         }
-        else
+
+        //Broadcasts are never acknowledged, so only unicast outcomes say anything about a link
+        if(memcmp(esp_now_info->des_addr, PEER_BROADCAST_ADDR, ESP_NOW_ETH_ALEN) != 0)
         {
-            if(manager->m_curRetries < manager->m_maxRetries)
-            {
-                LOG_W("ENC", "Send FAILED (retry %d/%d)",
-                      manager->m_curRetries + 1, manager->m_maxRetries);
-                ++manager->m_curRetries;
-            }
-            else
-            {
-                LOG_E("ENC", "Send FAILED - giving up after %d retries",
-                      manager->m_maxRetries);
-                manager->MoveToNextSendPkt();
-            }
+            xSemaphoreTake(manager->linkMutex_, portMAX_DELAY);
+            manager->m_linkQuality.recordSend(esp_now_info->des_addr, delivered, millis());
+            xSemaphoreGive(manager->linkMutex_);
         }
-
-        //TODO: Catch error and do reporting and push to next pkt
-        manager->SendFrontPkt();
+        manager->CompleteSend(esp_now_info->des_addr, delivered);
+        manager->PumpSends();
     }
 
-    //Attempt to send the next packet in send queue
-    int SendFrontPkt() {
-        xSemaphoreTake(sendMutex_, portMAX_DELAY);
-        if(m_sendQueue.empty()) {
+    //Hands frames to the radio until the scheduler has nothing sendable:
+    //every destination is busy or backing off, or the in-flight limit is hit.
+    //Packets past their deadline are dropped here, before they reach the radio.
+    void PumpSends() {
+        while(true) {
+            QueuedFrame frame;
+            xSemaphoreTake(sendMutex_, portMAX_DELAY);
+            bool ready = m_sendScheduler.next(millis(), frame, [this](const QueuedFrame& dropped) {
+                LOG_D("ENC", "Dropped expired pkt type %u before send\n", (int)dropped.packetType);
+                ReleaseFrameLocked(dropped.ptr);
+            });
             xSemaphoreGive(sendMutex_);
-            return 0;
-        }
-        auto buffer = m_sendQueue.front();
-        xSemaphoreGive(sendMutex_);
-
-        //If this is the first packet in cluster, make sure the peer is registered
-        auto* hdr = reinterpret_cast<DataPktHdr*>(buffer.ptr);
-        if(hdr->idxInCluster == 0 && (memcmp(buffer.dstMac, PEER_BROADCAST_ADDR, ESP_NOW_ETH_ALEN) != 0))
-            EnsurePeerIsRegistered(buffer.dstMac);
+            if(!ready) {
+                return;
+            }
 
-        esp_err_t err;
-        do
-        {
-            err = esp_now_send(buffer.dstMac, buffer.ptr, buffer.len);
-            if(err != ESP_OK)
-            {
-                ++m_curRetries;
-                if(m_curRetries >= m_maxRetries)
-                {
-                    LOG_E("ENC", "ESPNOW Failed after max retries. Err: %i\n", err);
-                    //TODO: Pop all packets in the current cluster?
-                    MoveToNextSendPkt();
-                    SendFrontPkt();
-                    //TODO: Return correct error code
-                    return -1;
-                }
+            //Make sure the peer is registered; it may have been evicted since the
+            //cluster started
+            if(memcmp(frame.dstMac, PEER_BROADCAST_ADDR, ESP_NOW_ETH_ALEN) != 0)
+                EnsurePeerIsRegistered(frame.dstMac);
+
+            //Read before sending: once esp_now_send returns, the send callback
+            //may already have released the block to another sender
+            bool fragment = reinterpret_cast<const DataPktHdr*>(frame.ptr)->numPktsInCluster > 1;
+
+            //A refusal (e.g. the driver's own queue is full) backs this destination
+            //off instead of spinning on esp_now_send
+            esp_err_t err = esp_now_send(frame.dstMac, frame.ptr, frame.len);
+            if(err == ESP_OK) {
+                RecordTraffic(TrafficDirection::kTx, frame.packetType, frame.len,
+                              fragment, millis() - frame.enqueuedMs, true);
+            } else {
+                LOG_W("ENC", "esp_now_send refused pkt type %u: 0x%X\n", (int)frame.packetType, err);
+                CompleteSend(frame.dstMac, false);
             }
-        } while (err != ESP_OK);
-        
-        return 0;
+        }
     }
 
-    //Free front packet in send queue and pop it from queue
-    void MoveToNextSendPkt() {
+    //Reports a send outcome to the scheduler and returns the frame's block to
+    //the pool once it is delivered or out of retries
+    void CompleteSend(const uint8_t* dstMac, bool delivered) {
+        QueuedFrame finished;
+        QueuedFrame onAir;
         xSemaphoreTake(sendMutex_, portMAX_DELAY);
-        if (!m_sendQueue.empty()) {
-            free(m_sendQueue.front().ptr);
-            m_sendQueue.pop();
+        bool known = m_sendScheduler.peekOnAir(dstMac, onAir);
+        bool done = m_sendScheduler.onSendDone(dstMac, delivered, millis(), finished);
+        if(done) {
+            ReleaseFrameLocked(finished.ptr);
         }
         xSemaphoreGive(sendMutex_);
-        m_curRetries = 0;
+
+        if(known && !delivered) {
+            RecordTraffic(TrafficDirection::kTx, onAir.packetType, onAir.len, false, 0, false);
+        }
+
+        if(done && !delivered) {
+            LOG_E("ENC", "Send FAILED - giving up after %d retries",
+                  m_sendScheduler.getConfig().maxRetries);
+        } else if(!done && !delivered) {
+            LOG_W("ENC", "Send FAILED, retrying after backoff");
+        }
     }
 
-    int EnsurePeerIsRegistered(const uint8_t* mac_addr) {
-        if(esp_now_is_peer_exist(mac_addr))
+    //Makes sure mac_addr is in the radio's peer table, evicting the least recently
+    //used unpinned peer if the table is full. Every unicast send passes through
+    //here, which is what keeps the LRU order current.
+    int EnsurePeerIsRegistered(const uint8_t* mac_addr, bool pinned = false) {
+        uint8_t evicted[ESP_NOW_ETH_ALEN];
+        xSemaphoreTake(peerMutex_, portMAX_DELAY);
+        PeerTable::Admit result = m_peerTable.admit(mac_addr, pinned, evicted);
+        if(result == PeerTable::Admit::kPresent)
+        {
+            xSemaphoreGive(peerMutex_);
             return 0;
-
-        esp_now_peer_num_t num_peers;
-        esp_now_get_peer_num(&num_peers);
-        if(num_peers.total_num > 19)
+        }
+        if(result == PeerTable::Admit::kFull)
         {
-            LOG_W("ENC", "ESP-NOW peer table full (20/20); cannot add new peer. "
-                          "RDC should have evicted unused peers first.");
+            xSemaphoreGive(peerMutex_);
+            LOG_W("ENC", "ESP-NOW peer table full (%u/%u) and every entry is pinned; cannot add new peer.",
+                  (unsigned)m_peerTable.size(), (unsigned)m_peerTable.capacity());
             return -1;
         }
+        if(result == PeerTable::Admit::kEvicted)
+        {
+            esp_now_del_peer(evicted);
+            LOG_I("ENC", "Evicted LRU peer: %02X:%02X:%02X:%02X:%02X:%02X",
+                  evicted[0], evicted[1], evicted[2],
+                  evicted[3], evicted[4], evicted[5]);
+        }
 
         esp_now_peer_info_t new_peer = {};
         memcpy(new_peer.peer_addr, mac_addr, ESP_NOW_ETH_ALEN);
@@ -554,25 +928,58 @@ private:
         new_peer.encrypt = false;
 
         esp_err_t err = esp_now_add_peer(&new_peer);
-        if (err != ESP_OK) {
+        if (err != ESP_OK && err != ESP_ERR_ESPNOW_EXIST) {
+            m_peerTable.remove(mac_addr);
+            xSemaphoreGive(peerMutex_);
             LOG_E("ENC", "Failed to add peer: 0x%X", err);
             return -1;
         }
+        //Caps outlive the entry, so only a peer never heard from is asked; until
+        //its caps arrive it gets ESP_NOW_MAX_DATA_LEN frames
+        bool requestCaps = m_peerTable.shouldRequestCaps(mac_addr);
+        xSemaphoreGive(peerMutex_);
 
         LOG_I("ENC", "Added peer: %02X:%02X:%02X:%02X:%02X:%02X",
               mac_addr[0], mac_addr[1], mac_addr[2],
               mac_addr[3], mac_addr[4], mac_addr[5]);
 
+        if(requestCaps) {
+            QueueLinkCaps(mac_addr, LINK_CAPS_REPLY_REQUESTED);
+        }
         return 0;
     }
 
-    SemaphoreHandle_t recvMutex_;
-    std::queue<DeferredPacket> recvQueue_;
+    //Filled by the WiFi task in HandlePktCallback, drained by exec() on the main loop.
+    //Lock-free single producer / single consumer, so the receive path never allocates.
+    PacketRing<ESP_NOW_RECV_RING_CAPACITY> recvRing_;
 
     SemaphoreHandle_t sendMutex_;
 
-    //Storage for packet handler callbacks and their user args
-    std::vector<std::pair<PacketCallback, void*>> m_pktHandlerCallbacks;
+    //Guards m_peerTable and the radio's peer list: sends register peers from
+    //both the main loop and the WiFi task's send callback
+    SemaphoreHandle_t peerMutex_;
+
+    //Guards m_linkQuality and m_traffic: send and receive callbacks update them on the WiFi
+    //task while the main loop reads them and reports ACK round trips
+    SemaphoreHandle_t linkMutex_;
+
+    //Guards m_reassembler: fragments arrive on the WiFi task, timeouts are
+    //serviced from exec(). Single-frame packets never take this lock.
+    SemaphoreHandle_t reassemblyMutex_;
+
+    //Packet handler callbacks and their user args, indexed by packet type
+    PacketHandlerTable m_pktHandlers;
+
+    //Repeats dropped in exec() before m_pktHandlers, and the hooks that see
+    //them instead
+    DuplicateFilter m_duplicates;
+    PacketHandlerTable m_dupHandlers;
+
+    //Flow-controlled transfers in both directions and the per-channel handlers
+    //that receive finished messages. Loop task only.
+    std::vector<std::pair<PacketCallback, void*>> m_bulkHandlerCallbacks;
+    BulkTransfer::Emit m_bulkEmit;
+    BulkTransfer m_bulk;
 
     void HandlePktCallback(const PktType packetType, const uint8_t* srcMacAddr, const uint8_t* pktData, const size_t pktLen) {
         if((int)packetType >= (int)PktType::kNumPacketTypes)
@@ -581,14 +988,16 @@ private:
             return;
         }
 
-        DeferredPacket pkt;
-        pkt.type = packetType;
-        memcpy(pkt.srcMac, srcMacAddr, 6);
-        pkt.data.assign(pktData, pktData + pktLen);
-
-        xSemaphoreTake(recvMutex_, portMAX_DELAY);
-        recvQueue_.push(std::move(pkt));
-        xSemaphoreGive(recvMutex_);
+        //Single frames only; they always fit a slot. Multi-frame clusters and
+        //long frames reach the ring through the reassembler and pushLarge().
+        if(!recvRing_.push(packetType, srcMacAddr, pktData, pktLen))
+        {
+            RecordTraffic(TrafficDirection::kRx, packetType, 0, false, 0, false);
+            LOG_W("ENC", "Dropped recv pkt type %u len %u (overflows %lu, drops %lu)\n",
+                  (int)packetType, (unsigned)pktLen,
+                  (unsigned long)recvRing_.getOverflowCount(),
+                  (unsigned long)recvRing_.getDropCount());
+        }
     }
 
     uint8_t* getMacAddress() override {
@@ -601,15 +1010,28 @@ private:
     }
 
     void removePeer(uint8_t* macAddr) override {
-        esp_now_del_peer(macAddr);
+        removeEspNowPeer(macAddr);
     }
 
     int addEspNowPeer(const uint8_t* macAddr) override {
         return EnsurePeerIsRegistered(macAddr);
     }
 
+    int pinEspNowPeer(const uint8_t* macAddr) override {
+        return EnsurePeerIsRegistered(macAddr, true);
+    }
+
+    void unpinEspNowPeer(const uint8_t* macAddr) override {
+        xSemaphoreTake(peerMutex_, portMAX_DELAY);
+        m_peerTable.unpin(macAddr);
+        xSemaphoreGive(peerMutex_);
+    }
+
     int removeEspNowPeer(const uint8_t* macAddr) override {
+        xSemaphoreTake(peerMutex_, portMAX_DELAY);
+        m_peerTable.remove(macAddr);
         esp_err_t err = esp_now_del_peer(macAddr);
+        xSemaphoreGive(peerMutex_);
         if (err != ESP_OK && err != ESP_ERR_ESPNOW_NOT_FOUND) {
             LOG_W("ENC", "Failed to remove peer: 0x%X", err);
             return -1;
@@ -622,16 +1044,36 @@ private:
     //Storage for MAC address
     uint8_t macAddress_[6];
 
-    //Storage for retry handling
-    uint8_t m_maxRetries;
-    uint8_t m_curRetries;
+    //Per-destination queues, frames in flight and retry backoff, guarded by sendMutex_
+    SendScheduler m_sendScheduler;
+
+    //Which peers the radio holds and which to evict next, guarded by peerMutex_
+    PeerTable m_peerTable;
+
+    //Backing storage for every queued frame, guarded by sendMutex_
+    SendFramePool m_sendPool;
+    LargeSendFramePool m_largeSendPool;
+
+    //Largest frame this radio takes, advertised to peers in LinkCapsPayload
+    size_t m_maxFrameLen = ESP_NOW_MAX_DATA_LEN;
+
+    //Selective-repeat reassembly of multi-packet clusters
+    FragmentReassembler m_reassembler;
+    std::vector<FragmentResendRequest> m_resendScratch;
+
+    //Copies of recently sent clusters for answering NACKs, guarded by sendMutex_
+    FragmentRetransmitCache m_retransmitCache;
+
+    //Small control messages waiting to share a frame, guarded by sendMutex_
+    PacketCoalescer m_coalescer;
 
-    //Packet send queue
-    std::queue<DataSendBuffer> m_sendQueue;
+    //Per-peer delivery ratio, ACK RTT and rssi, guarded by linkMutex_
+    LinkQualityTable m_linkQuality;
 
-    //Receive buffer tracking for multi-packet clusters
-    std::unordered_map<uint64_t, DataRecvBuffer> m_recvBuffers;
+    //Frames, bytes and failures per packet type and direction, guarded by linkMutex_
+    TrafficStats m_traffic;
 
-    //Storage for rssi, which is captured by wifi promiscuous callback
-    std::unordered_map<uint64_t, int> m_rssiTracker;
+    //Joined multicast groups, and the buffer multicast payloads are framed in
+    MulticastMembership m_multicast;
+    std::vector<uint8_t> m_multicastScratch;
 };
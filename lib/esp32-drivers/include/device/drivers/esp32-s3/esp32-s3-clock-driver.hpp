@@ -22,4 +22,8 @@ public:
     unsigned long milliseconds() override {
         return millis();
     }
+
+    unsigned long microseconds() override {
+        return micros();
+    }
 };
\ No newline at end of file
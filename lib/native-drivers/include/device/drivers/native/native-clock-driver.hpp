@@ -21,4 +21,9 @@ class NativeClockDriver : public PlatformClockDriverInterface {
     unsigned long milliseconds() override {
         return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
     }
+
+    // Monotonic, unlike milliseconds(); only ever used for durations
+    unsigned long microseconds() override {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
 };
\ No newline at end of file
@@ -1,13 +1,19 @@
 #pragma once
 
 #include <vector>
-#include <queue>
 #include <map>
+#include <unordered_map>
 #include <array>
+#include <algorithm>
 #include <cstring>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <random>
 #include "device/drivers/peer-comms-types.hpp"
+#include "device/drivers/native/native-peer-capture.hpp"
+#include "device/drivers/platform-clock.hpp"
+#include "utils/simple-timer.hpp"
 
 // Forward declaration
 class NativePeerCommsDriver;
@@ -17,8 +23,41 @@ struct PeerPacket {
     std::array<uint8_t, 6> srcMac;
     std::array<uint8_t, 6> dstMac;
     PktType packetType;
-    std::vector<uint8_t> data;
+    // Shared by every receiver's copy of a broadcast; never written once queued
+    std::shared_ptr<const std::vector<uint8_t>> payload;
     bool isBroadcast;
+    bool isFrame = false;   // payload is a raw DataPktHdr frame, not a whole payload
+    // Set once link profiles are in use: the copy is for rxMac alone, and
+    // rssiDbm is what that receiver hears if its link has a profile
+    bool hasReceiver = false;
+    std::array<uint8_t, 6> rxMac{};
+    bool hasRssi = false;
+    int rssiDbm = 0;
+
+    const uint8_t* bytes() const { return payload->data(); }
+    size_t size() const { return payload->size(); }
+};
+
+// Return false to drop the frame in flight. Used by tests to simulate loss.
+using FrameFilter = std::function<bool(const PeerPacket&)>;
+
+// Synthetic radio conditions for one directed link (src -> dst). Every
+// impairment is off by default; probabilities are per transmission, 0..1000.
+struct LinkProfile {
+    int rssiDbm = -50;          // reported to the receiver with every packet
+    uint16_t lossPermille = 0;  // independent (Bernoulli) loss
+    // Burst loss as a two-state Gilbert model: each transmission may enter
+    // the bad state, where everything is lost until it leaves again. Mean
+    // burst length is 1000 / burstExitPermille transmissions.
+    uint16_t burstEnterPermille = 0;
+    uint16_t burstExitPermille = 1000;
+    uint32_t latencyMs = 0;     // fixed one-way delay
+    uint32_t jitterMs = 0;      // plus a uniform 0..jitterMs per copy
+    // Held back a further reorderHoldMs so later frames overtake it
+    uint16_t reorderPermille = 0;
+    uint32_t reorderHoldMs = 20;
+    uint16_t duplicatePermille = 0;     // delivered twice, each copy delayed on its own
+    uint32_t bandwidthBytesPerSec = 0;  // frames queue behind each other; 0 for no cap
 };
 
 /**
@@ -37,48 +76,263 @@ public:
     NativePeerBroker& operator=(const NativePeerBroker&) = delete;
 
     /**
-     * Register a peer comms driver with its MAC address.
-     * Called when a NativePeerCommsDriver is initialized.
+     * Register a peer comms driver with its MAC address and the largest frame
+     * its radio handles. Called when a NativePeerCommsDriver is initialized.
      */
-    void registerPeer(NativePeerCommsDriver* peer, const uint8_t* macAddress) {
+    void registerPeer(NativePeerCommsDriver* peer, const uint8_t* macAddress,
+                      size_t maxFrameLen = PEER_COMMS_MAX_FRAME_LEN) {
         std::lock_guard<std::mutex> lock(mutex_);
-        std::array<uint8_t, 6> mac;
+        MacAddress mac;
         std::memcpy(mac.data(), macAddress, 6);
-        peers_[mac] = peer;
+        maxFrameLens_[mac] = maxFrameLen;
+        auto table = std::make_shared<PeerTable>(*peers_);
+        if (table->byMac.count(mac) == 0) {
+            table->sorted.insert(std::lower_bound(table->sorted.begin(), table->sorted.end(), mac), mac);
+        }
+        table->byMac[mac] = peer;
+        peers_ = std::move(table);
     }
 
     /**
      * Unregister a peer comms driver.
-     * Called when a NativePeerCommsDriver is destroyed.
+     * Called when a NativePeerCommsDriver is destroyed. Waits for a delivery
+     * running on another thread, which may still hand the driver packets.
      */
     void unregisterPeer(const uint8_t* macAddress) {
+        std::lock_guard<std::mutex> delivering(deliveryMutex_);
         std::lock_guard<std::mutex> lock(mutex_);
-        std::array<uint8_t, 6> mac;
+        MacAddress mac;
         std::memcpy(mac.data(), macAddress, 6);
-        peers_.erase(mac);
+        if (peers_->byMac.count(mac) == 0) {
+            return;
+        }
+        maxFrameLens_.erase(mac);
+        auto table = std::make_shared<PeerTable>(*peers_);
+        table->byMac.erase(mac);
+        table->sorted.erase(std::lower_bound(table->sorted.begin(), table->sorted.end(), mac));
+        peers_ = std::move(table);
+    }
+
+    /**
+     * Change the largest frame `macAddress` sends or receives. Frames longer
+     * than PEER_COMMS_MAX_FRAME_LEN are refused from a sender whose limit is
+     * lower, and never reach a receiver whose limit is lower, as an older
+     * radio wouldn't hear them.
+     */
+    void setPeerMaxFrameLen(const uint8_t* macAddress, size_t maxFrameLen) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        MacAddress mac;
+        std::memcpy(mac.data(), macAddress, 6);
+        maxFrameLens_[mac] = maxFrameLen;
+    }
+
+    /**
+     * Frames refused or undelivered because they exceeded a radio's limit,
+     * counted once per sender refusal or receiver that missed one.
+     */
+    uint32_t getOversizeFrameCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return oversizeFrames_;
     }
 
     /**
      * Queue a packet for delivery.
      * If dstMac is the broadcast address, packet is delivered to all peers except sender.
+     * Returns false if a unicast was lost on its link profile, which the
+     * sender sees the way it would see a missing MAC-layer ACK.
      */
-    void sendPacket(const uint8_t* srcMac, const uint8_t* dstMac, 
+    bool sendPacket(const uint8_t* srcMac, const uint8_t* dstMac, 
                     PktType packetType, const uint8_t* data, size_t length) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
         PeerPacket packet;
         std::memcpy(packet.srcMac.data(), srcMac, 6);
         std::memcpy(packet.dstMac.data(), dstMac, 6);
         packet.packetType = packetType;
-        packet.data.assign(data, data + length);
+        packet.payload = std::make_shared<const std::vector<uint8_t>>(data, data + length);
         packet.isBroadcast = isBroadcastAddress(dstMac);
-        
-        pendingPackets_.push(packet);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        framesSent_++;
+        capture(packet);
+        return transmit(packet);
+    }
+
+    /**
+     * Queue a single raw frame (DataPktHdr + payload) for delivery.
+     * Drivers use this for multi-frame clusters and transport-level frames so
+     * the receiver's reassembler sees what the radio would hand it.
+     * Returns false on unicast link loss, as sendPacket(), and when the frame
+     * is longer than either radio takes (see setPeerMaxFrameLen()).
+     */
+    bool sendFrame(const uint8_t* srcMac, const uint8_t* dstMac, const uint8_t* frame, size_t length) {
+        PeerPacket packet;
+        std::memcpy(packet.srcMac.data(), srcMac, 6);
+        std::memcpy(packet.dstMac.data(), dstMac, 6);
+        packet.packetType = length >= sizeof(DataPktHdr)
+            ? reinterpret_cast<const DataPktHdr*>(frame)->packetType
+            : PktType::kNumPacketTypes;
+        packet.payload = std::make_shared<const std::vector<uint8_t>>(frame, frame + length);
+        packet.isBroadcast = isBroadcastAddress(dstMac);
+        packet.isFrame = true;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (length > PEER_COMMS_MAX_FRAME_LEN && !fitsRadio(packet.srcMac, length)) {
+            return false;
+        }
+        framesSent_++;
+        capture(packet);
+        return transmit(packet);
+    }
+
+    /**
+     * Write every transmission to `path` as a pcap file Wireshark can open
+     * (see native-peer-capture.hpp), lost ones included. Whole packets are
+     * written with the DataPktHdr the radio would carry. Returns false if
+     * the file can't be created.
+     */
+    bool startCapture(const char* path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return capture_.open(path);
+    }
+
+    void stopCapture() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        capture_.close();
+    }
+
+    uint32_t getCapturedFrameCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return capture_.getFramesWritten();
+    }
+
+    /**
+     * Send the frames in a capture again from their original sources, as
+     * far apart on the platform clock as they were captured, starting now.
+     * They are fed in by deliverPackets() and go through link profiles and
+     * capture like live traffic. Returns false if the file can't be read.
+     */
+    bool startReplay(const char* path) {
+        PeerCaptureReader reader;
+        if (!reader.open(path)) {
+            return false;
+        }
+        std::vector<CapturedFrame> frames;
+        CapturedFrame frame;
+        while (reader.next(frame)) {
+            frames.push_back(frame);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        replayFrames_ = std::move(frames);
+        replayNext_ = 0;
+        replayStartMs_ = nowMs();
+        return true;
+    }
+
+    /**
+     * Replay frames to or from `captured` as `live`, so a capture can be
+     * fed to devices with different MACs. Kept until stopReplay().
+     */
+    void mapReplayAddress(const uint8_t* captured, const uint8_t* live) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        MacAddress from;
+        MacAddress to;
+        std::memcpy(from.data(), captured, 6);
+        std::memcpy(to.data(), live, 6);
+        replayMap_[from] = to;
+    }
+
+    void stopReplay() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        replayFrames_.clear();
+        replayNext_ = 0;
+        replayMap_.clear();
+    }
+
+    /**
+     * True while a replay has frames left to send.
+     */
+    bool isReplaying() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return replayNext_ < replayFrames_.size();
+    }
+
+    /**
+     * Frames for which the filter returns false are dropped at delivery.
+     * Pass nullptr to deliver everything again.
+     */
+    void setFrameFilter(FrameFilter filter) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        frameFilter_ = std::move(filter);
+    }
+
+    /**
+     * Shuffle raw frames within each delivery batch, deterministically from
+     * `seed`. Whole-payload packets keep their positions.
+     */
+    void enableFrameReordering(uint32_t seed) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reorderFrames_ = true;
+        reorderRng_.seed(seed);
+    }
+
+    void disableFrameReordering() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reorderFrames_ = false;
+    }
+
+    /**
+     * Apply `profile` to packets from `srcMac` to `dstMac`. Every impairment
+     * is decided when the frame is sent, per receiver for broadcasts, so a
+     * unicast sender's send-done sees loss. Receivers are told the profile's
+     * RSSI. Delays are measured on SimpleTimer's platform clock.
+     */
+    void setLinkProfile(const uint8_t* srcMac, const uint8_t* dstMac, const LinkProfile& profile) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        LinkKey key = linkKey(srcMac, dstMac);
+        linkProfiles_[key] = profile;
+        linkStates_.erase(key);
+    }
+
+    /**
+     * Apply `profile` to every link that has no profile of its own.
+     */
+    void setDefaultLinkProfile(const LinkProfile& profile) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        defaultProfile_ = profile;
+        hasDefaultProfile_ = true;
+        linkStates_.clear();
+    }
+
+    /**
+     * Remove every link profile, the default included. Frames still held
+     * back by latency are released to the next deliverPackets().
+     */
+    void clearLinkProfiles() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        linkProfiles_.clear();
+        hasDefaultProfile_ = false;
+        linkStates_.clear();
+        for (auto& [due, packet] : delayedPackets_) {
+            pendingPackets_.push_back(std::move(packet));
+        }
+        delayedPackets_.clear();
+    }
+
+    /**
+     * Reseed the generator behind every link impairment, so a run with the
+     * same seed and the same traffic is impaired the same way.
+     */
+    void seedLinkImpairments(uint32_t seed) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        impairRng_.seed(seed);
     }
 
     /**
      * Deliver pending packets to registered peers.
      * Should be called from the main loop to process queued messages.
+     * Cost is proportional to the copies delivered: the queue is swapped
+     * out under the lock and each receiver is a hash lookup. Packets sent
+     * by handlers during delivery wait for the next call.
      */
     void deliverPackets();
 
@@ -108,27 +362,71 @@ public:
      * Get count of registered peers.
      */
     size_t getPeerCount() const {
-        return peers_.size();
+        std::lock_guard<std::mutex> lock(mutex_);
+        return peers_->byMac.size();
     }
     
     /**
-     * Get count of pending packets waiting to be delivered.
+     * Get count of pending packets waiting to be delivered, including
+     * copies held back by link latency.
      */
     size_t getPendingPacketCount() const {
-        return pendingPackets_.size();
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pendingPackets_.size() + delayedPackets_.size();
     }
     
+    /**
+     * When deliverPackets() next has something to hand out: now if packets
+     * are queued, else the earliest copy held back by link latency or the
+     * next replayed frame. False if nothing is in flight. A virtual clock
+     * uses it to skip time in which no packet can arrive.
+     */
+    bool getNextDeliveryMs(unsigned long& out) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        bool found = false;
+        auto consider = [&](unsigned long ms) {
+            out = found ? std::min(out, ms) : ms;
+            found = true;
+        };
+        if (!pendingPackets_.empty()) {
+            consider(nowMs());
+        }
+        if (!delayedPackets_.empty()) {
+            consider(delayedPackets_.begin()->first.first);
+        }
+        if (replayNext_ < replayFrames_.size()) {
+            uint64_t offsetUs = replayFrames_[replayNext_].timestampUs - replayFrames_.front().timestampUs;
+            consider(replayStartMs_ + static_cast<unsigned long>((offsetUs + 999) / 1000));
+        }
+        return found;
+    }
+
+    /**
+     * Transmissions made through sendPacket() and sendFrame(), lost ones
+     * included. A broadcast counts once however many peers hear it, as on air.
+     */
+    uint32_t getFramesSent() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return framesSent_;
+    }
+
+    void resetFramesSent() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        framesSent_ = 0;
+    }
+
     /**
      * Check if a MAC address is registered.
      */
     bool isPeerRegistered(const uint8_t* macAddress) const {
-        std::array<uint8_t, 6> mac;
+        MacAddress mac;
         std::memcpy(mac.data(), macAddress, 6);
-        return peers_.find(mac) != peers_.end();
+        std::lock_guard<std::mutex> lock(mutex_);
+        return peers_->byMac.count(mac) != 0;
     }
 
 private:
-    NativePeerBroker() : nextMacId_(1) {
+    NativePeerBroker() : peers_(std::make_shared<PeerTable>()), nextMacId_(1) {
         // Initialize broadcast address (all 0xFF)
         std::memset(broadcastAddress_, 0xFF, 6);
     }
@@ -144,9 +442,232 @@ private:
         return std::memcmp(a.data(), b, 6) == 0;
     }
 
-    std::map<std::array<uint8_t, 6>, NativePeerCommsDriver*> peers_;
-    std::queue<PeerPacket> pendingPackets_;
+    using MacAddress = std::array<uint8_t, 6>;
+    using LinkKey = std::array<uint8_t, 12>;
+
+    // FNV-1a over the address bytes; MACs from generateUniqueMac() differ
+    // only in their last two bytes, so every byte has to count
+    template <size_t N>
+    struct ByteArrayHash {
+        size_t operator()(const std::array<uint8_t, N>& bytes) const {
+            uint64_t hash = 1469598103934665603ULL;
+            for (uint8_t b : bytes) {
+                hash = (hash ^ b) * 1099511628211ULL;
+            }
+            return static_cast<size_t>(hash);
+        }
+    };
+
+    // Registered drivers. Replaced rather than edited when a peer comes or
+    // goes, so deliverPackets() can walk a table without holding the lock
+    // while handlers register or remove peers.
+    struct PeerTable {
+        std::unordered_map<MacAddress, NativePeerCommsDriver*, ByteArrayHash<6>> byMac;
+        std::vector<MacAddress> sorted;     // broadcast fan-out order, stable across runs
+    };
+
+    static LinkKey linkKey(const uint8_t* srcMac, const uint8_t* dstMac) {
+        LinkKey key;
+        std::memcpy(key.data(), srcMac, 6);
+        std::memcpy(key.data() + 6, dstMac, 6);
+        return key;
+    }
+
+    // Per-link state behind the impairments
+    struct LinkState {
+        bool inBurst = false;
+        uint64_t busyUntilUs = 0;   // bandwidth cap: when the last frame finishes
+    };
+
+    // Delivery time, then send order
+    using DelayKey = std::pair<unsigned long, uint64_t>;
+
+    static unsigned long nowMs() {
+        PlatformClock* clock = SimpleTimer::getPlatformClock();
+        return clock ? clock->milliseconds() : 0;
+    }
+
+    // Caller holds mutex_
+    void capture(const PeerPacket& packet) {
+        if (!capture_.isOpen()) {
+            return;
+        }
+        uint64_t timestampUs = static_cast<uint64_t>(nowMs()) * 1000;
+        if (packet.isFrame) {
+            capture_.write(timestampUs, packet.srcMac.data(), packet.dstMac.data(),
+                           packet.bytes(), packet.size(), nullptr, 0);
+            return;
+        }
+        DataPktHdr hdr;
+        hdr.pktLen = static_cast<uint8_t>(sizeof(DataPktHdr) + packet.size());
+        hdr.packetType = packet.packetType;
+        hdr.numPktsInCluster = 1;
+        hdr.idxInCluster = 0;
+        capture_.write(timestampUs, packet.srcMac.data(), packet.dstMac.data(),
+                       reinterpret_cast<const uint8_t*>(&hdr), sizeof(hdr), packet.bytes(), packet.size());
+    }
+
+    // Caller holds mutex_. Sends the replayed frames that have fallen due.
+    void pumpReplay(unsigned long now) {
+        if (replayNext_ >= replayFrames_.size()) {
+            return;
+        }
+        uint64_t firstUs = replayFrames_.front().timestampUs;
+        uint64_t elapsedUs = static_cast<uint64_t>(now - replayStartMs_) * 1000;
+        while (replayNext_ < replayFrames_.size() &&
+               replayFrames_[replayNext_].timestampUs - firstUs <= elapsedUs) {
+            const CapturedFrame& captured = replayFrames_[replayNext_++];
+            auto mapped = [this](const MacAddress& mac) {
+                auto it = replayMap_.find(mac);
+                return it != replayMap_.end() ? it->second : mac;
+            };
+
+            PeerPacket packet;
+            packet.srcMac = mapped(captured.srcMac);
+            packet.dstMac = mapped(captured.dstMac);
+            packet.isBroadcast = isBroadcastAddress(packet.dstMac.data());
+            const auto* hdr = reinterpret_cast<const DataPktHdr*>(captured.frame.data());
+            packet.packetType = hdr->packetType;
+            // Single-frame packets travel whole, as the driver sends them
+            if (hdr->numPktsInCluster == 1 && hdr->pktLen == captured.frame.size()) {
+                packet.payload = std::make_shared<const std::vector<uint8_t>>(
+                    captured.frame.begin() + sizeof(DataPktHdr), captured.frame.end());
+            } else {
+                packet.payload = std::make_shared<const std::vector<uint8_t>>(captured.frame);
+                packet.isFrame = true;
+            }
+            framesSent_++;
+            capture(packet);
+            transmit(packet);
+        }
+    }
+
+    // Caller holds mutex_
+    const LinkProfile* findProfile(const LinkKey& key) const {
+        auto it = linkProfiles_.find(key);
+        if (it != linkProfiles_.end()) return &it->second;
+        return hasDefaultProfile_ ? &defaultProfile_ : nullptr;
+    }
+
+    // Caller holds mutex_
+    bool chance(uint16_t permille) {
+        return permille > 0 && std::uniform_int_distribution<int>(0, 999)(impairRng_) < permille;
+    }
+
+    // Caller holds mutex_
+    size_t maxFrameLen(const MacAddress& mac) const {
+        auto it = maxFrameLens_.find(mac);
+        return it != maxFrameLens_.end() ? it->second : PEER_COMMS_MAX_FRAME_LEN;
+    }
+
+    // Caller holds mutex_. False, and counted, if `mac` can't handle a frame
+    // of `frameLen` bytes.
+    bool fitsRadio(const MacAddress& mac, size_t frameLen) {
+        if (frameLen <= maxFrameLen(mac)) {
+            return true;
+        }
+        oversizeFrames_++;
+        return false;
+    }
+
+    // Caller holds mutex_. Queues the copies of `packet` its receivers will
+    // get. Returns false if a unicast was lost or too long for its receiver.
+    bool transmit(PeerPacket& packet) {
+        // Only v2 frames need checking; every radio takes the rest, and whole
+        // packets stand in for single small frames
+        size_t frameLen = packet.size();
+        bool oversize = packet.isFrame && frameLen > PEER_COMMS_MAX_FRAME_LEN;
+        if (!oversize && linkProfiles_.empty() && !hasDefaultProfile_) {
+            pendingPackets_.push_back(std::move(packet));
+            return true;
+        }
+        unsigned long now = nowMs();
+        if (!packet.isBroadcast) {
+            return (!oversize || fitsRadio(packet.dstMac, frameLen)) && impair(packet, packet.dstMac, now);
+        }
+        for (const MacAddress& mac : peers_->sorted) {
+            if (!macEquals(mac, packet.srcMac.data()) && (!oversize || fitsRadio(mac, frameLen))) {
+                impair(packet, mac, now);
+            }
+        }
+        return true;
+    }
+
+    // Caller holds mutex_. Runs one receiver's copy of `packet` through its
+    // link profile; false if it was lost.
+    bool impair(const PeerPacket& packet, const MacAddress& rxMac, unsigned long now) {
+        LinkKey key = linkKey(packet.srcMac.data(), rxMac.data());
+        PeerPacket copy = packet;
+        copy.hasReceiver = true;
+        copy.rxMac = rxMac;
+
+        const LinkProfile* profile = findProfile(key);
+        if (profile == nullptr) {
+            pendingPackets_.push_back(std::move(copy));
+            return true;
+        }
+        copy.hasRssi = true;
+        copy.rssiDbm = profile->rssiDbm;
+        LinkState& state = linkStates_[key];
+
+        // Airtime is spent whether or not the frame arrives
+        unsigned long readyMs = now;
+        if (profile->bandwidthBytesPerSec > 0) {
+            uint64_t startUs = std::max<uint64_t>(static_cast<uint64_t>(now) * 1000, state.busyUntilUs);
+            state.busyUntilUs = startUs + static_cast<uint64_t>(packet.size()) * 1000000 /
+                                          profile->bandwidthBytesPerSec;
+            readyMs = static_cast<unsigned long>((state.busyUntilUs + 999) / 1000);
+        }
+
+        if (chance(state.inBurst ? profile->burstExitPermille : profile->burstEnterPermille)) {
+            state.inBurst = !state.inBurst;
+        }
+        if (state.inBurst || chance(profile->lossPermille)) {
+            return false;
+        }
+
+        int copies = chance(profile->duplicatePermille) ? 2 : 1;
+        for (int i = 0; i < copies; i++) {
+            unsigned long dueMs = readyMs + profile->latencyMs;
+            if (profile->jitterMs > 0) {
+                dueMs += std::uniform_int_distribution<uint32_t>(0, profile->jitterMs)(impairRng_);
+            }
+            if (chance(profile->reorderPermille)) {
+                dueMs += profile->reorderHoldMs;
+            }
+            if (dueMs <= now) {
+                pendingPackets_.push_back(copy);
+            } else {
+                delayedPackets_.emplace(DelayKey(dueMs, nextDelaySeq_++), copy);
+            }
+        }
+        return true;
+    }
+
+    std::shared_ptr<const PeerTable> peers_;
+    std::vector<PeerPacket> pendingPackets_;
+    FrameFilter frameFilter_;
+    bool reorderFrames_ = false;
+    std::mt19937 reorderRng_;
+    std::map<DelayKey, PeerPacket> delayedPackets_;
+    uint64_t nextDelaySeq_ = 0;
+    std::unordered_map<LinkKey, LinkProfile, ByteArrayHash<12>> linkProfiles_;
+    LinkProfile defaultProfile_;
+    bool hasDefaultProfile_ = false;
+    std::unordered_map<LinkKey, LinkState, ByteArrayHash<12>> linkStates_;
+    std::mt19937 impairRng_;
+    PeerCaptureWriter capture_;
+    std::vector<CapturedFrame> replayFrames_;
+    size_t replayNext_ = 0;
+    unsigned long replayStartMs_ = 0;
+    std::unordered_map<MacAddress, MacAddress, ByteArrayHash<6>> replayMap_;
+    std::unordered_map<MacAddress, size_t, ByteArrayHash<6>> maxFrameLens_;
+    uint32_t oversizeFrames_ = 0;
     uint8_t broadcastAddress_[6];
     uint16_t nextMacId_;
-    std::mutex mutex_;
+    uint32_t framesSent_ = 0;
+    mutable std::mutex mutex_;
+    // Held across deliverPackets() so unregistered drivers aren't handed
+    // packets afterwards. Taken before mutex_, never after it.
+    std::mutex deliveryMutex_;
 };
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "device/drivers/peer-comms-types.hpp"
+
+// Capture files are classic pcap with LINKTYPE_IEEE802_11: each frame is
+// written as the ESP-NOW action frame the radio would send, FCS omitted,
+// so Wireshark shows source, destination and the vendor element holding
+// our DataPktHdr frame.
+constexpr uint32_t PCAP_MAGIC_MICROSECONDS = 0xA1B2C3D4;
+constexpr uint32_t PCAP_LINKTYPE_IEEE802_11 = 105;
+constexpr uint32_t PCAP_SNAPLEN = 65535;
+
+constexpr uint8_t ESP_NOW_OUI[3] = {0x18, 0xFE, 0x34};     // Espressif
+constexpr uint8_t ESP_NOW_ELEMENT_TYPE = 0x04;
+constexpr uint8_t ESP_NOW_ELEMENT_VERSION = 0x01;
+// A vendor element's length byte covers OUI, type, version and body
+constexpr size_t ESP_NOW_ELEMENT_MAX_BODY = 250;
+
+// One transmission read back from a capture
+struct CapturedFrame {
+    uint64_t timestampUs = 0;
+    std::array<uint8_t, 6> srcMac{};
+    std::array<uint8_t, 6> dstMac{};
+    std::vector<uint8_t> frame;     // DataPktHdr + payload
+};
+
+namespace peer_capture_detail {
+
+inline void putLe16(std::vector<uint8_t>& out, uint16_t v) {
+    out.push_back(static_cast<uint8_t>(v));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+inline void putLe32(std::vector<uint8_t>& out, uint32_t v) {
+    putLe16(out, static_cast<uint16_t>(v));
+    putLe16(out, static_cast<uint16_t>(v >> 16));
+}
+
+inline uint32_t getLe32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+}  // namespace peer_capture_detail
+
+/**
+ * Writes transmissions to a pcap file. Not thread safe; the broker calls it
+ * under its own lock.
+ */
+class PeerCaptureWriter {
+public:
+    PeerCaptureWriter() = default;
+    PeerCaptureWriter(const PeerCaptureWriter&) = delete;
+    PeerCaptureWriter& operator=(const PeerCaptureWriter&) = delete;
+
+    ~PeerCaptureWriter() {
+        close();
+    }
+
+    /**
+     * Create `path` and write the file header. Closes any capture in progress.
+     */
+    bool open(const char* path) {
+        using namespace peer_capture_detail;
+        close();
+        file_ = std::fopen(path, "wb");
+        if (file_ == nullptr) {
+            return false;
+        }
+        std::vector<uint8_t> header;
+        putLe32(header, PCAP_MAGIC_MICROSECONDS);
+        putLe16(header, 2);     // version 2.4
+        putLe16(header, 4);
+        putLe32(header, 0);     // timestamps are UTC
+        putLe32(header, 0);
+        putLe32(header, PCAP_SNAPLEN);
+        putLe32(header, PCAP_LINKTYPE_IEEE802_11);
+        std::fwrite(header.data(), 1, header.size(), file_);
+        sequence_ = 0;
+        framesWritten_ = 0;
+        return true;
+    }
+
+    bool isOpen() const {
+        return file_ != nullptr;
+    }
+
+    void close() {
+        if (file_ != nullptr) {
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+    }
+
+    /**
+     * Append one transmission. The frame is `head` followed by `body`, so a
+     * caller holding a bare payload can pass the DataPktHdr separately.
+     */
+    void write(uint64_t timestampUs, const uint8_t* srcMac, const uint8_t* dstMac,
+               const uint8_t* head, size_t headLen, const uint8_t* body, size_t bodyLen) {
+        using namespace peer_capture_detail;
+        if (file_ == nullptr) {
+            return;
+        }
+
+        // 802.11 action frame header: frame control, duration, receiver,
+        // transmitter, BSSID (ESP-NOW uses broadcast) and sequence control
+        record_.clear();
+        record_.push_back(0xD0);
+        record_.push_back(0x00);
+        putLe16(record_, 0);
+        record_.insert(record_.end(), dstMac, dstMac + 6);
+        record_.insert(record_.end(), srcMac, srcMac + 6);
+        record_.insert(record_.end(), 6, 0xFF);
+        putLe16(record_, static_cast<uint16_t>(sequence_++ << 4));
+
+        // Vendor-specific action: category, OUI and four bytes the radio
+        // fills with random data
+        record_.push_back(0x7F);
+        record_.insert(record_.end(), ESP_NOW_OUI, ESP_NOW_OUI + 3);
+        record_.insert(record_.end(), 4, 0x00);
+
+        frame_.assign(head, head + headLen);
+        frame_.insert(frame_.end(), body, body + bodyLen);
+        size_t offset = 0;
+        do {
+            size_t chunk = std::min(frame_.size() - offset, ESP_NOW_ELEMENT_MAX_BODY);
+            record_.push_back(0xDD);
+            record_.push_back(static_cast<uint8_t>(5 + chunk));
+            record_.insert(record_.end(), ESP_NOW_OUI, ESP_NOW_OUI + 3);
+            record_.push_back(ESP_NOW_ELEMENT_TYPE);
+            record_.push_back(ESP_NOW_ELEMENT_VERSION);
+            record_.insert(record_.end(), frame_.begin() + offset, frame_.begin() + offset + chunk);
+            offset += chunk;
+        } while (offset < frame_.size());
+
+        std::vector<uint8_t> header;
+        putLe32(header, static_cast<uint32_t>(timestampUs / 1000000));
+        putLe32(header, static_cast<uint32_t>(timestampUs % 1000000));
+        putLe32(header, static_cast<uint32_t>(record_.size()));
+        putLe32(header, static_cast<uint32_t>(record_.size()));
+        std::fwrite(header.data(), 1, header.size(), file_);
+        std::fwrite(record_.data(), 1, record_.size(), file_);
+        framesWritten_++;
+    }
+
+    uint32_t getFramesWritten() const {
+        return framesWritten_;
+    }
+
+private:
+    FILE* file_ = nullptr;
+    uint16_t sequence_ = 0;
+    uint32_t framesWritten_ = 0;
+    std::vector<uint8_t> record_;
+    std::vector<uint8_t> frame_;
+};
+
+/**
+ * Reads back a capture written by PeerCaptureWriter. Records that aren't
+ * ESP-NOW action frames (a capture merged with other traffic) are skipped.
+ */
+class PeerCaptureReader {
+public:
+    PeerCaptureReader() = default;
+    PeerCaptureReader(const PeerCaptureReader&) = delete;
+    PeerCaptureReader& operator=(const PeerCaptureReader&) = delete;
+
+    ~PeerCaptureReader() {
+        close();
+    }
+
+    /**
+     * Open `path`; false if it's missing or not a little-endian microsecond
+     * pcap of 802.11 frames.
+     */
+    bool open(const char* path) {
+        close();
+        file_ = std::fopen(path, "rb");
+        if (file_ == nullptr) {
+            return false;
+        }
+        uint8_t header[24];
+        if (std::fread(header, 1, sizeof(header), file_) != sizeof(header) ||
+            peer_capture_detail::getLe32(header) != PCAP_MAGIC_MICROSECONDS ||
+            peer_capture_detail::getLe32(header + 20) != PCAP_LINKTYPE_IEEE802_11) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (file_ != nullptr) {
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+    }
+
+    /**
+     * Read the next ESP-NOW frame into `out`. False at end of file or on a
+     * truncated record.
+     */
+    bool next(CapturedFrame& out) {
+        using peer_capture_detail::getLe32;
+        uint8_t header[16];
+        while (file_ != nullptr && std::fread(header, 1, sizeof(header), file_) == sizeof(header)) {
+            uint32_t length = getLe32(header + 8);
+            record_.resize(length);
+            if (std::fread(record_.data(), 1, length, file_) != length) {
+                return false;
+            }
+            out.timestampUs = static_cast<uint64_t>(getLe32(header)) * 1000000 + getLe32(header + 4);
+            if (parse(out)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static constexpr size_t kMacHeaderLen = 24;
+    static constexpr size_t kActionHeaderLen = 8;
+
+    bool parse(CapturedFrame& out) const {
+        if (record_.size() < kMacHeaderLen + kActionHeaderLen || record_[0] != 0xD0 ||
+            record_[kMacHeaderLen] != 0x7F ||
+            std::memcmp(&record_[kMacHeaderLen + 1], ESP_NOW_OUI, 3) != 0) {
+            return false;
+        }
+        std::memcpy(out.dstMac.data(), &record_[4], 6);
+        std::memcpy(out.srcMac.data(), &record_[10], 6);
+
+        // The frame may span several vendor elements; stitch them together
+        out.frame.clear();
+        size_t pos = kMacHeaderLen + kActionHeaderLen;
+        while (pos + 2 <= record_.size()) {
+            uint8_t id = record_[pos];
+            size_t len = record_[pos + 1];
+            if (pos + 2 + len > record_.size()) {
+                return false;
+            }
+            const uint8_t* element = &record_[pos + 2];
+            if (id == 0xDD && len >= 5 && std::memcmp(element, ESP_NOW_OUI, 3) == 0 &&
+                element[3] == ESP_NOW_ELEMENT_TYPE) {
+                out.frame.insert(out.frame.end(), element + 5, element + len);
+            }
+            pos += 2 + len;
+        }
+        return out.frame.size() >= sizeof(DataPktHdr);
+    }
+
+    FILE* file_ = nullptr;
+    std::vector<uint8_t> record_;
+};
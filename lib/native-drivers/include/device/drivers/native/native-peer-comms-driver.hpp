@@ -2,10 +2,25 @@
 
 #include "device/drivers/driver-interface.hpp"
 #include "device/drivers/native/native-peer-broker.hpp"
+#include "wireless/packet-ring.hpp"
+#include "wireless/frame-pool.hpp"
+#include "wireless/fragment-reassembly.hpp"
+#include "wireless/send-scheduler.hpp"
+#include "wireless/peer-table.hpp"
+#include "wireless/link-quality.hpp"
+#include "wireless/multicast-group.hpp"
+#include "wireless/duplicate-filter.hpp"
+#include "wireless/packet-coalescer.hpp"
+#include "wireless/bulk-transfer.hpp"
+#include "wireless/packet-registry.hpp"
+#include "wireless/traffic-stats.hpp"
+#include "utils/simple-timer.hpp"
+#include <algorithm>
+#include <array>
 #include <map>
 #include <deque>
+#include <iterator>
 #include <mutex>
-#include <queue>
 #include <vector>
 #include <cstring>
 
@@ -23,6 +38,11 @@ public:
     explicit NativePeerCommsDriver(const std::string& name) : PeerCommsDriverInterface(name) {
         // Get unique MAC from broker
         NativePeerBroker::getInstance().generateUniqueMac(macAddress_);
+        // Like the radio, the broadcast peer holds one table entry for good
+        peerTable_.admit(NativePeerBroker::getInstance().getBroadcastAddress(), true, nullptr);
+        bulkEmit_ = [this](const uint8_t* dst, const uint8_t* data, size_t length) {
+            return sendData(dst, PktType::kBulkTransfer, data, length);
+        };
     }
 
     ~NativePeerCommsDriver() override {
@@ -31,26 +51,47 @@ public:
 
     int initialize() override {
         // Register with the broker
-        NativePeerBroker::getInstance().registerPeer(this, macAddress_);
+        NativePeerBroker::getInstance().registerPeer(this, macAddress_, maxFrameLen_);
         return 0;
     }
 
     void exec() override {
-        std::queue<DeferredPacket> pending;
-        {
-            std::lock_guard<std::mutex> lock(recvMutex_);
-            std::swap(pending, recvQueue_);
-        }
+        serviceReassembly();
+        bulk_.service(nowMs(), bulkEmit_);
+        flushCoalesced();
+        flushSendQueue(txFramesPerExec_ > 0 ? txFramesPerExec_ : SendFramePool::capacity());
+
+        // Only drain what was queued on entry so a busy producer can't starve the loop
+        size_t pending = recvRing_.size();
+        while (pending-- > 0) {
+            const PacketRingSlot* slot = recvRing_.front();
+            if (!slot) {
+                break;
+            }
 
-        while (!pending.empty()) {
-            auto& pkt = pending.front();
-            auto it = handlers_.find(pkt.type);
-            if (it != handlers_.end()) {
-                it->second.callback(pkt.srcMac, pkt.data.data(),
-                                    pkt.data.size(), it->second.context);
+            // Same filter as EspNowManager: multicasts for groups we haven't
+            // joined are dropped before history and handlers see them
+            PktType type = slot->type;
+            const uint8_t* payload = slot->payload();
+            size_t len = slot->len;
+            if (type == PktType::kMulticast && !multicast_.accept(payload, len, type, payload, len)) {
+                recvRing_.pop();
+                continue;
             }
-            pending.pop();
+
+            const uint8_t* srcMac = slot->srcMac;
+            if (type == PktType::kBundle) {
+                forEachBundled(payload, len, [&](PktType inner, const uint8_t* data, size_t length) {
+                    dispatchPacket(srcMac, inner, data, length);
+                });
+            } else {
+                dispatchPacket(srcMac, type, payload, len);
+            }
+            recvRing_.pop();
         }
+
+        // Replies the handlers just sent share frames too
+        flushCoalesced();
     }
 
     void connect() override {
@@ -75,10 +116,28 @@ public:
     }
 
     int sendData(const uint8_t* dst, PktType packetType, const uint8_t* data, const size_t length) override {
+        return sendData(dst, packetType, data, length, defaultSendOptions(packetType));
+    }
+
+    int sendData(const uint8_t* dst, PktType packetType, const uint8_t* data, const size_t length,
+                 const SendOptions& options) override {
         if (peerCommsState_ != PeerCommsState::CONNECTED) {
             return -1;  // Cannot send when disconnected
         }
-        
+        if (length > MAX_SEND_PACKET_LEN) {
+            return -1;  // Could never be reserved; callers use sendBulk()
+        }
+
+        // Small control messages wait for the end of the tick to share a frame.
+        // Anything else to the same peer first flushes what is waiting for it.
+        unsigned long now = nowMs();
+        bool staged = coalescer_.stage(dst, packetType, data, length, options, now) ||
+                      (coalescer_.flush(dst, now, CoalescedEmitter{this}) &&
+                       coalescer_.stage(dst, packetType, data, length, options, now));
+        if (!staged && enqueuePacket(dst, packetType, data, length, options) != 0) {
+            return -1;
+        }
+
         // Track sent packet
         PacketHistoryEntry entry;
         entry.isSent = true;
@@ -87,17 +146,81 @@ public:
         entry.packetType = packetType;
         entry.length = length;
         addToHistory(entry);
-        
-        NativePeerBroker::getInstance().sendPacket(macAddress_, dst, packetType, data, length);
         return 0; // Success
     }
 
+    int sendMulticast(MulticastGroup group, PktType packetType, const uint8_t* data, const size_t length,
+                      const SendOptions& options) override {
+        buildMulticastPayload(group, packetType, data, length, multicastScratch_);
+        return sendData(getGlobalBroadcastAddress(), PktType::kMulticast,
+                        multicastScratch_.data(), multicastScratch_.size(), options);
+    }
+
+    int joinMulticastGroup(MulticastGroup group) override {
+        return multicast_.join(group) ? 0 : -1;
+    }
+
+    void leaveMulticastGroup(MulticastGroup group) override {
+        multicast_.leave(group);
+    }
+
     void setPacketHandler(PktType packetType, PacketCallback callback, void* ctx) override {
-        handlers_[packetType] = {callback, ctx};
+        handlers_.set(packetType, callback, ctx);
     }
 
     void clearPacketHandler(PktType packetType) override {
-        handlers_.erase(packetType);
+        handlers_.clear(packetType);
+    }
+
+    void setDuplicateSuppression(PktType packetType, uint8_t seqOffset,
+                                 PacketCallback onDuplicate, void* ctx) override {
+        duplicates_.setRule(packetType, seqOffset);
+        duplicateHandlers_.set(packetType, onDuplicate, ctx);
+    }
+
+    void clearDuplicateSuppression(PktType packetType) override {
+        duplicates_.clearRule(packetType);
+        duplicateHandlers_.clear(packetType);
+    }
+
+    int sendBulk(const uint8_t* dst, uint8_t channel, const uint8_t* data, const size_t length) override {
+        if (peerCommsState_ != PeerCommsState::CONNECTED) {
+            return -1;
+        }
+        int transferId = bulk_.start(dst, channel, data, length, nowMs());
+        if (transferId > 0) {
+            bulk_.service(nowMs(), bulkEmit_);
+        }
+        return transferId;
+    }
+
+    bool getBulkTransferStatus(int transferId, BulkTransferStatus& out) override {
+        return bulk_.getStatus(transferId, out);
+    }
+
+    void cancelBulkTransfer(int transferId) override {
+        bulk_.cancel(transferId, bulkEmit_);
+    }
+
+    void setBulkHandler(uint8_t channel, PacketCallback callback, void* ctx) override {
+        if (channel < BulkTransfer::kMaxChannels) {
+            bulkHandlers_[channel] = {callback, ctx};
+            bulk_.listen(channel, true);
+        }
+    }
+
+    void clearBulkHandler(uint8_t channel) override {
+        if (channel < BulkTransfer::kMaxChannels) {
+            bulkHandlers_[channel] = {};
+            bulk_.listen(channel, false);
+        }
+    }
+
+    void setCoalescingEnabled(bool enabled) override {
+        if (!enabled) {
+            flushCoalesced();
+        }
+        coalescer_.setEnabled(enabled);
     }
 
     const uint8_t* getGlobalBroadcastAddress() override {
@@ -109,23 +232,75 @@ public:
     }
 
     void removePeer(uint8_t* macAddr) override {
-        // In native simulation, peers are managed by broker
-        // This is a no-op but could track "known peers" if needed
+        removeEspNowPeer(macAddr);
     }
 
+    // The broker delivers to any MAC, but the peer table is kept to the same
+    // 20-entry cap and eviction policy as EspNowManager so chain and shootout
+    // peer churn can be exercised natively.
     int addEspNowPeer(const uint8_t* macAddr) override {
-        (void)macAddr;
-        return 0;
+        return ensurePeerRegistered(macAddr, false);
+    }
+
+    int pinEspNowPeer(const uint8_t* macAddr) override {
+        return ensurePeerRegistered(macAddr, true);
+    }
+
+    void unpinEspNowPeer(const uint8_t* macAddr) override {
+        peerTable_.unpin(macAddr);
     }
 
     int removeEspNowPeer(const uint8_t* macAddr) override {
-        (void)macAddr;
+        peerTable_.remove(macAddr);
         return 0;
     }
 
+    int getRssiForPeer(const uint8_t* macAddr) override {
+        LinkEstimate estimate;
+        if (getLinkEstimate(macAddr, estimate) && estimate.hasRssi) {
+            return estimate.rssiDbm;
+        }
+        return -1;
+    }
+
+    void reportAckRtt(const uint8_t* macAddr, unsigned long rttMs) override {
+        std::lock_guard<std::mutex> lock(linkMutex_);
+        linkQuality_.recordAckRtt(macAddr, rttMs, nowMs());
+    }
+
+    bool getLinkEstimate(const uint8_t* macAddr, LinkEstimate& out) override {
+        std::lock_guard<std::mutex> lock(linkMutex_);
+        return linkQuality_.get(macAddr, out);
+    }
+
+    // Counted at the same points as EspNowManager, so load tests can budget
+    // airtime from a simulation
+    bool getTrafficSnapshot(TrafficStats::Snapshot& out) override {
+        std::lock_guard<std::mutex> lock(linkMutex_);
+        traffic_.snapshot(nowMs(), out);
+        return true;
+    }
+
+    void resetTrafficStats() override {
+        std::lock_guard<std::mutex> lock(linkMutex_);
+        traffic_.reset(nowMs());
+    }
+
+    /**
+     * Called by the broker with the RSSI of a link that has a profile, as
+     * the radio's rx_ctrl would report it.
+     */
+    void recordLinkRssi(const uint8_t* srcMac, int rssiDbm) {
+        std::lock_guard<std::mutex> lock(linkMutex_);
+        linkQuality_.recordRssi(srcMac, rssiDbm, nowMs());
+    }
+
     /**
      * Called by the broker to deliver a packet to this peer.
-     * Enqueues the packet for processing on the next exec() call.
+     * Copies the packet into the receive ring for processing on the next
+     * exec() call. Allocation-free; single producer only. Only the traffic
+     * counters take a lock.
+     * RX history is recorded on the exec() side.
      */
     void receivePacket(const uint8_t* srcMac, PktType packetType, 
                        const uint8_t* data, size_t length) {
@@ -133,21 +308,153 @@ public:
             return;
         }
 
-        PacketHistoryEntry entry;
-        entry.isSent = false;
-        entry.srcMac = macToString(srcMac);
-        entry.dstMac = getMacString();
-        entry.packetType = packetType;
-        entry.length = length;
-        addToHistory(entry);
+        bool queued = recvRing_.push(packetType, srcMac, data, length);
+        std::lock_guard<std::mutex> lock(linkMutex_);
+        traffic_.recordRx(packetType, sizeof(DataPktHdr) + length, false);
+        if (!queued) {
+            traffic_.recordFailure(TrafficDirection::kRx, packetType);
+        }
+    }
+
+    /**
+     * Called by the broker to deliver one raw frame (DataPktHdr + payload).
+     * Mirrors EspNowRecvCallback: fragments are reassembled here and only
+     * complete payloads reach the receive ring; NACKs are answered directly.
+     */
+    void receiveFrame(const uint8_t* srcMac, const uint8_t* frame, size_t length) {
+        if (peerCommsState_ != PeerCommsState::CONNECTED || length < sizeof(DataPktHdr)) {
+            return;
+        }
+
+        const auto* hdr = reinterpret_cast<const DataPktHdr*>(frame);
+        {
+            std::lock_guard<std::mutex> lock(linkMutex_);
+            traffic_.recordRx(hdr->packetType, length, hdr->numPktsInCluster > 1);
+        }
+        if (hdr->packetType == PktType::kFragmentNack) {
+            if (hdr->pktLen >= sizeof(DataPktHdr) + sizeof(FragmentNackPayload) && hdr->pktLen <= length) {
+                FragmentNackPayload nack;
+                memcpy(&nack, frame + sizeof(DataPktHdr), sizeof(nack));
+                handleFragmentNack(srcMac, nack);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(fragMutex_);
+        if (reassembler_.onFragment(srcMac, frame, length, nowMs()) == FragmentReassembler::Result::kComplete) {
+            FragmentReassembler::Completed& done = reassembler_.completed();
+            recvRing_.pushLarge(done.packetType, done.srcMac, std::move(done.data));
+        }
+    }
+
+    /**
+     * Reassembly counters (completed, out-of-order, resend requests, ...).
+     */
+    FragmentReassembler::Stats getReassemblyStats() {
+        std::lock_guard<std::mutex> lock(fragMutex_);
+        return reassembler_.getStats();
+    }
+
+    /**
+     * Packets rejected because the receive ring was full.
+     */
+    uint32_t getRecvOverflowCount() const {
+        return recvRing_.getOverflowCount();
+    }
+
+    /**
+     * Packets rejected because they exceeded PACKET_RING_SLOT_SIZE.
+     */
+    uint32_t getRecvDropCount() const {
+        return recvRing_.getDropCount();
+    }
+
+    /**
+     * Repeats dropped before their handler ran, and first sightings passed.
+     */
+    const DuplicateFilter& getDuplicateFilter() const {
+        return duplicates_;
+    }
+
+    /**
+     * Bulk transfers started, completed, resumed and retransmitted.
+     */
+    const BulkTransfer& getBulkTransfer() const {
+        return bulk_;
+    }
+
+    /**
+     * Small control messages staged for bundling, and how many frames that saved.
+     */
+    const PacketCoalescer& getPacketCoalescer() const {
+        return coalescer_;
+    }
+
+    /**
+     * Multicast groups joined, with counts of accepted and filtered packets.
+     */
+    const MulticastMembership& getMulticastMembership() const {
+        return multicast_;
+    }
+
+    /**
+     * Registered peers, in the same 20-entry LRU table EspNowManager keeps.
+     */
+    const PeerTable& getPeerTable() const {
+        return peerTable_;
+    }
+
+    /**
+     * Send-side frame pool, exposed so tests can assert allocation counts.
+     */
+    const SendFramePool& getSendPool() const {
+        return sendPool_;
+    }
+
+    /**
+     * Blocks for v2 frames, used toward peers that advertised them.
+     */
+    const LargeSendFramePool& getLargeSendPool() const {
+        return largeSendPool_;
+    }
+
+    /**
+     * Largest frame this radio sends and receives: PEER_COMMS_MAX_FRAME_LEN_V2
+     * (default) models an IDF 5.4+ device, PEER_COMMS_MAX_FRAME_LEN an older
+     * one. Advertised to peers in LinkCapsPayload and enforced by the broker.
+     * Set it before initialize(), or before peers exchange caps.
+     */
+    void setMaxFrameLen(size_t maxFrameLen) {
+        maxFrameLen_ = std::min(std::max(maxFrameLen, PEER_COMMS_MAX_FRAME_LEN), PEER_COMMS_MAX_FRAME_LEN_V2);
+        NativePeerBroker::getInstance().setPeerMaxFrameLen(macAddress_, maxFrameLen_);
+    }
+
+    size_t getMaxFrameLen() const {
+        return maxFrameLen_;
+    }
 
-        DeferredPacket pkt;
-        pkt.type = packetType;
-        memcpy(pkt.srcMac, srcMac, 6);
-        pkt.data.assign(data, data + length);
+    /**
+     * Models a radio that can only put `frames` frames on air per exec().
+     * Frames beyond that wait in the scheduler, where deadlines, priority
+     * classes and per-destination round-robin take effect. 0 (default)
+     * transmits inside sendData().
+     */
+    void setTxFramesPerExec(size_t frames) {
+        txFramesPerExec_ = frames;
+    }
 
-        std::lock_guard<std::mutex> lock(recvMutex_);
-        recvQueue_.push(std::move(pkt));
+    /**
+     * Frames waiting for airtime, with per-destination depth and latency.
+     */
+    const SendScheduler& getSendScheduler() const {
+        return sendScheduler_;
+    }
+
+    /**
+     * Packets waiting for the next exec() call.
+     */
+    size_t getRecvQueueDepth() const {
+        return recvRing_.size();
     }
 
     /**
@@ -181,20 +488,300 @@ private:
         void* context;
     };
 
-    struct DeferredPacket {
-        PktType type;
-        uint8_t srcMac[6];
-        std::vector<uint8_t> data;
-    };
+    // Deeper than the device ring: the broker can deliver a whole tick's worth
+    // of fan-out traffic to one peer before its exec() runs.
+    static constexpr size_t RECV_RING_CAPACITY = 64;
+
+    PacketHandlerTable handlers_;
+    PacketHandlerTable duplicateHandlers_;
+    DuplicateFilter duplicates_;
+    PacketRing<RECV_RING_CAPACITY> recvRing_;
+    SendFramePool sendPool_;
+    LargeSendFramePool largeSendPool_;
+    SendScheduler sendScheduler_;
+    PeerTable peerTable_;
+    size_t txFramesPerExec_ = 0;
+    size_t maxFrameLen_ = PEER_COMMS_MAX_FRAME_LEN_V2;
 
-    std::map<PktType, HandlerEntry> handlers_;
-    std::mutex recvMutex_;
-    std::queue<DeferredPacket> recvQueue_;
+    // Written from the broker's delivery path as well as the loop
+    std::mutex linkMutex_;
+    LinkQualityTable linkQuality_;
+    TrafficStats traffic_;
+
+    MulticastMembership multicast_;
+    PacketCoalescer coalescer_;
+
+    BulkTransfer bulk_;
+    BulkTransfer::Emit bulkEmit_;
+    std::array<HandlerEntry, BulkTransfer::kMaxChannels> bulkHandlers_{};
+    std::vector<uint8_t> multicastScratch_;
+
+    // Guards the reassembler and retransmit cache: frames arrive on the
+    // broker's delivery thread while exec() services timeouts on the loop
+    std::mutex fragMutex_;
+    FragmentReassembler reassembler_;
+    FragmentRetransmitCache retransmitCache_;
+    std::vector<FragmentResendRequest> resendScratch_;
     uint8_t macAddress_[6];
     PeerCommsState peerCommsState_ = PeerCommsState::DISCONNECTED;
     std::deque<PacketHistoryEntry> packetHistory_;
     static const size_t MAX_HISTORY = 5;
     
+    static unsigned long nowMs() {
+        PlatformClock* clock = SimpleTimer::getPlatformClock();
+        return clock ? clock->milliseconds() : 0;
+    }
+
+    // Hands up to `maxFrames` queued frames to the broker in scheduler order.
+    // The broker answers synchronously, so each frame completes as soon as it
+    // is sent, and a unicast lost on a link profile fails like an unacked
+    // one. Single-frame packets go over as whole payloads; cluster frames
+    // travel individually and are reassembled by the receiver, as do v2
+    // frames, which are larger than a receive slot.
+    void flushSendQueue(size_t maxFrames) {
+        NativePeerBroker& broker = NativePeerBroker::getInstance();
+        unsigned long now = nowMs();
+        QueuedFrame frame;
+        auto release = [this](const QueuedFrame& dropped) { releaseFrame(dropped.ptr); };
+        while (maxFrames-- > 0 && sendScheduler_.next(now, frame, release)) {
+            QueuedFrame finished;
+            // Mirrors EspNowManager: unicast needs a peer-table entry, and a
+            // refusal backs the destination off like a failed esp_now_send
+            if (memcmp(frame.dstMac, broker.getBroadcastAddress(), 6) != 0 &&
+                ensurePeerRegistered(frame.dstMac, false) != 0) {
+                {
+                    std::lock_guard<std::mutex> lock(linkMutex_);
+                    traffic_.recordFailure(TrafficDirection::kTx, frame.packetType);
+                }
+                if (sendScheduler_.onSendDone(frame.dstMac, false, now, finished)) {
+                    releaseFrame(finished.ptr);
+                }
+                continue;
+            }
+            const auto* hdr = reinterpret_cast<const DataPktHdr*>(frame.ptr);
+            bool delivered;
+            if (hdr->numPktsInCluster == 1 && hdr->pktLen != DATA_PKT_LEN_LONG) {
+                delivered = broker.sendPacket(macAddress_, frame.dstMac, frame.packetType,
+                                              frame.ptr + sizeof(DataPktHdr), frame.len - sizeof(DataPktHdr));
+            } else {
+                delivered = broker.sendFrame(macAddress_, frame.dstMac, frame.ptr, frame.len);
+            }
+            {
+                std::lock_guard<std::mutex> lock(linkMutex_);
+                traffic_.recordTx(frame.packetType, frame.len, hdr->numPktsInCluster > 1, now - frame.enqueuedMs);
+                if (!delivered) {
+                    traffic_.recordFailure(TrafficDirection::kTx, frame.packetType);
+                }
+                if (memcmp(frame.dstMac, broker.getBroadcastAddress(), 6) != 0) {
+                    linkQuality_.recordSend(frame.dstMac, delivered, now);
+                }
+            }
+            if (sendScheduler_.onSendDone(frame.dstMac, delivered, now, finished)) {
+                releaseFrame(finished.ptr);
+            }
+        }
+    }
+
+    // Blocks come from either pool; each ignores the other's
+    void releaseFrame(uint8_t* frame) {
+        sendPool_.release(frame);
+        largeSendPool_.release(frame);
+    }
+
+    // Payload bytes per fragment toward `dst`. Unicast to a peer whose caps
+    // allow v2 frames uses them when the whole cluster fits the large pool;
+    // everything else, broadcasts included, goes in PEER_COMMS_MAX_FRAME_LEN
+    // frames.
+    size_t chooseFragmentLen(const uint8_t* dst, size_t length) {
+        if (length <= PEER_COMMS_MAX_FRAME_PAYLOAD ||
+            memcmp(dst, NativePeerBroker::getInstance().getBroadcastAddress(), 6) == 0) {
+            return PEER_COMMS_MAX_FRAME_PAYLOAD;
+        }
+        size_t fragmentLen = fragmentLenFor(std::min(maxFrameLen_, peerTable_.maxFrameLen(dst)));
+        if (fragmentLen > PEER_COMMS_MAX_FRAME_PAYLOAD &&
+            fragmentCount(length, fragmentLen) > largeSendPool_.available()) {
+            return PEER_COMMS_MAX_FRAME_PAYLOAD;
+        }
+        return fragmentLen;
+    }
+
+    // Queues `data` as one cluster of frames, in the same frame pool and
+    // scheduler EspNowManager uses so pool sizing, exhaustion and scheduling
+    // behave identically in simulation.
+    int enqueuePacket(const uint8_t* dst, PktType packetType, const uint8_t* data, size_t length,
+                      const SendOptions& options) {
+        size_t fragmentLen = chooseFragmentLen(dst, length);
+        bool large = fragmentLen > PEER_COMMS_MAX_FRAME_PAYLOAD;
+        size_t numInCluster = std::max<size_t>(fragmentCount(length, fragmentLen), 1);
+        if (!large && !sendPool_.reserve(numInCluster)) {
+            return -1;
+        }
+
+        unsigned long now = nowMs();
+        for (size_t i = 0; i < numInCluster; i++) {
+            QueuedFrame frame;
+            memcpy(frame.dstMac, dst, sizeof(frame.dstMac));
+            frame.ptr = large ? largeSendPool_.acquire() : sendPool_.acquire();
+            frame.len = buildFragment(frame.ptr, packetType, data, length,
+                                      static_cast<uint8_t>(i), static_cast<uint8_t>(numInCluster), fragmentLen);
+            frame.packetType = packetType;
+            frame.priority = options.priority;
+            frame.idxInCluster = static_cast<uint8_t>(i);
+            frame.enqueuedMs = now;
+            frame.hasDeadline = options.maxAgeMs > 0;
+            frame.deadlineMs = now + options.maxAgeMs;
+            sendScheduler_.push(frame);
+        }
+
+        if (numInCluster > 1) {
+            std::lock_guard<std::mutex> lock(fragMutex_);
+            retransmitCache_.store(dst, packetType, data, length, now, fragmentLen);
+        }
+
+        // With no airtime budget the "radio" drains instantly, as before
+        if (txFramesPerExec_ == 0) {
+            flushSendQueue(SendFramePool::capacity());
+        }
+        return 0;
+    }
+
+    // Queues what PacketCoalescer::flush() hands back
+    struct CoalescedEmitter {
+        NativePeerCommsDriver* driver;
+        void operator()(const uint8_t* dst, PktType packetType, const uint8_t* data, size_t length,
+                        const SendOptions& options) const {
+            driver->enqueuePacket(dst, packetType, data, length, options);
+        }
+    };
+
+    void flushCoalesced() {
+        coalescer_.flush(nowMs(), CoalescedEmitter{this});
+    }
+
+    // Records one logical packet and hands it to its handler, or to the
+    // duplicate hook if it repeats one already seen
+    void dispatchPacket(const uint8_t* srcMac, PktType type, const uint8_t* payload, size_t len) {
+        PacketHistoryEntry entry;
+        entry.isSent = false;
+        entry.srcMac = macToString(srcMac);
+        entry.dstMac = getMacString();
+        entry.packetType = type;
+        entry.length = len;
+        addToHistory(entry);
+
+        if (type == PktType::kLinkCaps) {
+            handleLinkCaps(srcMac, payload, len);
+            return;
+        }
+
+        if (type == PktType::kBulkTransfer) {
+            if (bulk_.onPacket(srcMac, payload, len, nowMs(), bulkEmit_) == BulkTransfer::Result::kComplete) {
+                BulkTransfer::Completed& done = bulk_.completed();
+                const HandlerEntry& handler = bulkHandlers_[done.channel];
+                if (handler.callback) {
+                    handler.callback(done.srcMac, done.data.data(), done.data.size(), handler.context);
+                }
+            }
+            return;
+        }
+
+        bool duplicate = duplicates_.isDuplicate(srcMac, type, payload, len, nowMs());
+        (duplicate ? duplicateHandlers_ : handlers_).dispatch(srcMac, type, payload, len);
+    }
+
+    // A peer never heard from is asked for its caps the first time it is
+    // admitted, not on every re-admission; until they arrive it gets
+    // PEER_COMMS_MAX_FRAME_LEN frames
+    int ensurePeerRegistered(const uint8_t* macAddr, bool pinned) {
+        PeerTable::Admit result = peerTable_.admit(macAddr, pinned, nullptr);
+        if (result == PeerTable::Admit::kFull) {
+            return -1;
+        }
+        if (result != PeerTable::Admit::kPresent && peerTable_.shouldRequestCaps(macAddr)) {
+            sendLinkCaps(macAddr, LINK_CAPS_REPLY_REQUESTED);
+        }
+        return 0;
+    }
+
+    // Straight to the broker, like a NACK: it is sent from inside
+    // flushSendQueue() and must not re-enter the scheduler
+    void sendLinkCaps(const uint8_t* dst, uint8_t flags) {
+        LinkCapsPayload caps;
+        caps.maxFrameLen = static_cast<uint16_t>(maxFrameLen_);
+        caps.flags = flags;
+        NativePeerBroker::getInstance().sendPacket(macAddress_, dst, PktType::kLinkCaps,
+                                                   reinterpret_cast<const uint8_t*>(&caps), sizeof(caps));
+        std::lock_guard<std::mutex> lock(linkMutex_);
+        traffic_.recordTx(PktType::kLinkCaps, sizeof(DataPktHdr) + sizeof(caps), false, 0);
+    }
+
+    // Records a peer's caps without admitting it, so hearing from a peer
+    // never evicts another. A request gets ours back; the peer only asks the
+    // first time it admits us.
+    void handleLinkCaps(const uint8_t* srcMac, const uint8_t* payload, size_t len) {
+        const LinkCapsPayload* caps = decodePacket<PktType::kLinkCaps>(payload, len);
+        if (!caps) {
+            return;
+        }
+        peerTable_.setMaxFrameLen(srcMac, caps->maxFrameLen);
+        if (caps->flags & LINK_CAPS_REPLY_REQUESTED) {
+            sendLinkCaps(srcMac, 0);
+        }
+    }
+
+    // Evict stale clusters and ask senders to repeat whatever is still missing
+    void serviceReassembly() {
+        {
+            std::lock_guard<std::mutex> lock(fragMutex_);
+            unsigned long now = nowMs();
+            reassembler_.expire(now);
+            reassembler_.collectResendRequests(now, resendScratch_);
+        }
+
+        for (const auto& request : resendScratch_) {
+            uint8_t frame[PEER_COMMS_MAX_FRAME_LEN];
+            size_t len = buildFragment(frame, PktType::kFragmentNack,
+                                       reinterpret_cast<const uint8_t*>(&request.nack),
+                                       sizeof(request.nack), 0, 1);
+            NativePeerBroker::getInstance().sendFrame(macAddress_, request.srcMac, frame, len);
+            std::lock_guard<std::mutex> lock(linkMutex_);
+            traffic_.recordTx(PktType::kFragmentNack, len, false, 0);
+        }
+        resendScratch_.clear();
+    }
+
+    // Re-send just the fragments the peer reported missing
+    void handleFragmentNack(const uint8_t* requesterMac, const FragmentNackPayload& nack) {
+        std::lock_guard<std::mutex> lock(fragMutex_);
+        const FragmentRetransmitCache::Cluster* cluster = retransmitCache_.find(requesterMac, nack, nowMs());
+        if (!cluster) {
+            // The cluster may have been broadcast; the cache is keyed by the original destination
+            cluster = retransmitCache_.find(getGlobalBroadcastAddress(), nack, nowMs());
+        }
+        if (!cluster) {
+            return;
+        }
+        bool large = cluster->fragmentLen > PEER_COMMS_MAX_FRAME_PAYLOAD;
+
+        FragmentBitmap missing;
+        memcpy(missing.bits, nack.missing, sizeof(missing.bits));
+        for (size_t i = 0; i < nack.numPktsInCluster; i++) {
+            if (!missing.test(static_cast<uint8_t>(i))) {
+                continue;
+            }
+            uint8_t* frame = large ? largeSendPool_.acquire() : sendPool_.acquire();
+            if (!frame) {
+                return;
+            }
+            size_t len = buildFragment(frame, nack.packetType, cluster->data.data(), cluster->data.size(),
+                                       static_cast<uint8_t>(i), nack.numPktsInCluster, cluster->fragmentLen);
+            NativePeerBroker::getInstance().sendFrame(macAddress_, requesterMac, frame, len);
+            releaseFrame(frame);
+            std::lock_guard<std::mutex> lock(linkMutex_);
+            traffic_.recordTx(nack.packetType, len, true, 0);
+        }
+    }
+
     void addToHistory(const PacketHistoryEntry& entry) {
         packetHistory_.push_back(entry);
         while (packetHistory_.size() > MAX_HISTORY) {
@@ -212,38 +799,82 @@ private:
 
 // Implementation of broker's deliverPackets that depends on NativePeerCommsDriver
 inline void NativePeerBroker::deliverPackets() {
-    // Copy pending packets and peer map while holding lock, then release
+    // Take the pending packets while holding the lock, then release it
     // before delivering. This prevents deadlock when a packet handler
     // tries to send a response packet (which would try to acquire mutex_).
+    std::lock_guard<std::mutex> delivering(deliveryMutex_);
     std::vector<PeerPacket> packetsToDeliver;
-    std::map<std::array<uint8_t, 6>, NativePeerCommsDriver*> peersCopy;
+    std::shared_ptr<const PeerTable> table;
     
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        while (!pendingPackets_.empty()) {
-            packetsToDeliver.push_back(std::move(pendingPackets_.front()));
-            pendingPackets_.pop();
+        table = peers_;
+
+        // Copies whose link latency has run out, in the order they fell due,
+        // then everything sent since the last call
+        unsigned long now = nowMs();
+        pumpReplay(now);
+        auto due = delayedPackets_.begin();
+        while (due != delayedPackets_.end() && due->first.first <= now) {
+            packetsToDeliver.push_back(std::move(due->second));
+            due = delayedPackets_.erase(due);
+        }
+        if (packetsToDeliver.empty()) {
+            packetsToDeliver.swap(pendingPackets_);
+        } else {
+            std::move(pendingPackets_.begin(), pendingPackets_.end(), std::back_inserter(packetsToDeliver));
+            pendingPackets_.clear();
+        }
+
+        if (frameFilter_) {
+            packetsToDeliver.erase(std::remove_if(packetsToDeliver.begin(), packetsToDeliver.end(),
+                [this](const PeerPacket& packet) { return packet.isFrame && !frameFilter_(packet); }),
+                packetsToDeliver.end());
+        }
+
+        if (reorderFrames_) {
+            std::vector<size_t> frameSlots;
+            std::vector<PeerPacket> frames;
+            for (size_t i = 0; i < packetsToDeliver.size(); i++) {
+                if (packetsToDeliver[i].isFrame) {
+                    frameSlots.push_back(i);
+                    frames.push_back(std::move(packetsToDeliver[i]));
+                }
+            }
+            std::shuffle(frames.begin(), frames.end(), reorderRng_);
+            for (size_t i = 0; i < frameSlots.size(); i++) {
+                packetsToDeliver[frameSlots[i]] = std::move(frames[i]);
+            }
         }
-        peersCopy = peers_;
     }
     
-    // Now deliver packets without holding the lock
-    for (auto& packet : packetsToDeliver) {
-        if (packet.isBroadcast) {
+    auto deliver = [](NativePeerCommsDriver* peer, const PeerPacket& packet) {
+        if (packet.hasRssi) {
+            peer->recordLinkRssi(packet.srcMac.data(), packet.rssiDbm);
+        }
+        if (packet.isFrame) {
+            peer->receiveFrame(packet.srcMac.data(), packet.bytes(), packet.size());
+        } else {
+            peer->receivePacket(packet.srcMac.data(), packet.packetType, packet.bytes(), packet.size());
+        }
+    };
+
+    // Now deliver packets without holding the lock. Peers registered from
+    // here on hear the next batch.
+    for (const PeerPacket& packet : packetsToDeliver) {
+        if (packet.hasReceiver || !packet.isBroadcast) {
+            // Deliver to specific peer
+            auto it = table->byMac.find(packet.hasReceiver ? packet.rxMac : packet.dstMac);
+            if (it != table->byMac.end()) {
+                deliver(it->second, packet);
+            }
+        } else {
             // Deliver to all peers except sender
-            for (auto& [mac, peer] : peersCopy) {
+            for (const MacAddress& mac : table->sorted) {
                 if (!macEquals(mac, packet.srcMac.data())) {
-                    peer->receivePacket(packet.srcMac.data(), packet.packetType,
-                                       packet.data.data(), packet.data.size());
+                    deliver(table->byMac.at(mac), packet);
                 }
             }
-        } else {
-            // Deliver to specific peer
-            auto it = peersCopy.find(packet.dstMac);
-            if (it != peersCopy.end()) {
-                it->second->receivePacket(packet.srcMac.data(), packet.packetType,
-                                         packet.data.data(), packet.data.size());
-            }
         }
     }
 }
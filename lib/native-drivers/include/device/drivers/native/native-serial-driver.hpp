@@ -1,6 +1,7 @@
 #pragma once
 
 #include "device/drivers/driver-interface.hpp"
+#include "utils/alloc-tracker.hpp"
 #include <queue>
 #include <deque>
 #include <string>
@@ -60,12 +61,17 @@ public:
         return result;
     }
 
+    // The buffers and history stand in for the UART, so allocation budgets
+    // don't count them
+
     void print(char msg) override {
+        ALLOC_UNCOUNTED();
         outputBuffer_ += msg;
         trimOutputBuffer();
     }
 
     void println(char* msg) override {
+        ALLOC_UNCOUNTED();
         outputBuffer_ += msg;
         outputBuffer_ += '\n';
         trimOutputBuffer();
@@ -74,6 +80,7 @@ public:
     }
 
     void println(const std::string& msg) override {
+        ALLOC_UNCOUNTED();
         outputBuffer_ += msg;
         outputBuffer_ += '\n';
         trimOutputBuffer();
@@ -94,12 +101,6 @@ public:
 
     // Test helper methods
     void injectInput(const std::string& input) {
-        // Enforce FIFO limit on input queue
-        while (inputBuffer_.size() >= MAX_INPUT_QUEUE_SIZE) {
-            inputBuffer_.pop();  // Drop oldest
-        }
-        inputBuffer_.push(input);
-        
         // Clean the message by stripping framing (if present)
         // Framing: STRING_START (*) at beginning, STRING_TERM (\r) at end
         std::string cleanMsg = input;
@@ -111,10 +112,19 @@ public:
         if (!cleanMsg.empty() && cleanMsg.back() == '\r') {
             cleanMsg.pop_back();
         }
-        
-        // Track the clean message in history for UI display
-        addToHistory(receivedHistory_, cleanMsg);
-        
+
+        {
+            ALLOC_UNCOUNTED();
+            // Enforce FIFO limit on input queue
+            while (inputBuffer_.size() >= MAX_INPUT_QUEUE_SIZE) {
+                inputBuffer_.pop();  // Drop oldest
+            }
+            inputBuffer_.push(input);
+
+            // Track the clean message in history for UI display
+            addToHistory(receivedHistory_, cleanMsg);
+        }
+
         // Invoke callback with clean message
         if (stringCallback_) {
             stringCallback_(cleanMsg);
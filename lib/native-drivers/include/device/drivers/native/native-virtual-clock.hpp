@@ -0,0 +1,113 @@
+#pragma once
+
+#include "device/drivers/driver-interface.hpp"
+#include "device/drivers/native/native-peer-broker.hpp"
+#include <set>
+
+/**
+ * Simulated clock for headless runs and tests. Time only moves when the
+ * owner advances it, so a run is deterministic and idle stretches cost
+ * nothing: advanceToNextEvent() jumps straight to the earliest deadline it
+ * knows of. SimpleTimer reports every timer it arms; anything else that
+ * waits (a script step, a delayed packet) can schedule() its own.
+ *
+ * Deadlines aren't withdrawn when a timer is invalidated or re-armed; a
+ * stale one only costs an extra step in which nothing is due.
+ */
+class NativeVirtualClock : public PlatformClockDriverInterface {
+public:
+    explicit NativeVirtualClock(const std::string& name, unsigned long startMs = 0)
+        : PlatformClockDriverInterface(name), now_(startMs) {
+    }
+
+    ~NativeVirtualClock() override = default;
+
+    int initialize() override {
+        return 0;
+    }
+
+    void exec() override {
+        // Advanced by the owner, not by the driver loop
+    }
+
+    unsigned long milliseconds() override {
+        return now_;
+    }
+
+    void onTimerArmed(unsigned long deadlineMs) override {
+        schedule(deadlineMs);
+    }
+
+    /**
+     * Have advanceToNextEvent() stop at `atMs`. Ignored if it has passed.
+     */
+    void schedule(unsigned long atMs) {
+        if (atMs > now_) {
+            deadlines_.insert(atMs);
+        }
+    }
+
+    void setTime(unsigned long ms) {
+        now_ = ms;
+        dropPassed();
+    }
+
+    void advance(unsigned long deltaMs) {
+        setTime(now_ + deltaMs);
+    }
+
+    /**
+     * Earliest scheduled time after now. False if nothing is scheduled.
+     */
+    bool getNextDeadline(unsigned long& out) const {
+        if (deadlines_.empty()) {
+            return false;
+        }
+        out = *deadlines_.begin();
+        return true;
+    }
+
+    size_t getScheduledCount() const {
+        return deadlines_.size();
+    }
+
+    /**
+     * Move to the next scheduled time, at least 1 ms on so a loop that
+     * re-arms a zero-length timer every pass still lets time move, and at
+     * most `maxStepMs` on (0 for no limit) so code that polls the clock
+     * instead of arming a timer is still run now and then. With nothing
+     * scheduled it steps `maxStepMs`, or 1 ms when unlimited. Returns the
+     * new time.
+     */
+    unsigned long advanceToNextEvent(unsigned long maxStepMs) {
+        unsigned long target = 0;
+        if (!getNextDeadline(target)) {
+            target = now_ + (maxStepMs > 0 ? maxStepMs : 1);
+        }
+        if (maxStepMs > 0 && target - now_ > maxStepMs) {
+            target = now_ + maxStepMs;
+        }
+        setTime(target > now_ ? target : now_ + 1);
+        return now_;
+    }
+
+    /**
+     * advanceToNextEvent(), also stopping when NativePeerBroker next has a
+     * packet to deliver.
+     */
+    unsigned long advanceWithBroker(unsigned long maxStepMs) {
+        unsigned long deliveryMs = 0;
+        if (NativePeerBroker::getInstance().getNextDeliveryMs(deliveryMs)) {
+            schedule(deliveryMs);
+        }
+        return advanceToNextEvent(maxStepMs);
+    }
+
+private:
+    void dropPassed() {
+        deadlines_.erase(deadlines_.begin(), deadlines_.upper_bound(now_));
+    }
+
+    unsigned long now_;
+    std::set<unsigned long> deadlines_;
+};
@@ -0,0 +1,248 @@
+#pragma once
+
+#ifdef NATIVE_BUILD
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ArduinoJson.h>
+
+namespace cli {
+
+/**
+ * Heap allocations made so far, as counted by whatever hooks operator new in
+ * the running binary.
+ */
+struct BenchAllocations {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+};
+
+using AllocationProbe = BenchAllocations (*)();
+
+/**
+ * One benchmark in the native_perf registry. The runner calls setUp() once,
+ * then runIteration() repeatedly, timing each call, with resetIteration()
+ * between them outside the timed region, and tearDown() at the end.
+ */
+class BenchScenario {
+public:
+    virtual ~BenchScenario() = default;
+
+    virtual const char* getName() const = 0;
+    virtual const char* getDescription() const = 0;
+
+    /**
+     * Free-form knobs the scenario ran with, e.g. "supporters=4", so results
+     * from different settings aren't compared by mistake.
+     */
+    virtual std::string getParams() const {
+        return "";
+    }
+
+    virtual size_t getDefaultIterations() const = 0;
+
+    /**
+     * Most heap allocations one iteration may make, or -1 for no budget.
+     * An iteration over it counts as a failure. Only checked when the runner
+     * has an allocation probe.
+     */
+    virtual long getAllocationBudget() const {
+        return -1;
+    }
+
+    /**
+     * False if the scenario can't run; the runner skips it.
+     */
+    virtual bool setUp() {
+        return true;
+    }
+
+    /**
+     * The measured unit of work. False if it didn't reach the outcome it
+     * should have (a duel without a winner, a chain that never converged).
+     */
+    virtual bool runIteration() = 0;
+
+    virtual void resetIteration() {}
+
+    virtual void tearDown() {}
+
+    /**
+     * Running total of bytes put on the wire; the runner takes differences.
+     */
+    virtual uint64_t getBytesSent() const = 0;
+};
+
+/**
+ * Nearest-rank percentile, 0 with no samples. `percent` of 100 is the max.
+ */
+inline uint64_t nearestRankPercentile(std::vector<uint64_t> samples, double percent) {
+    if (samples.empty()) return 0;
+    size_t rank = static_cast<size_t>(percent / 100.0 * (samples.size() - 1) + 0.5);
+    rank = std::min(rank, samples.size() - 1);
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return samples[rank];
+}
+
+struct BenchResult {
+    std::string name;
+    std::string params;
+    size_t iterations = 0;
+    size_t failures = 0;
+    size_t overAllocationBudget = 0;    // failures that allocated too much
+    long allocationBudget = -1;
+    uint64_t totalNs = 0;
+    uint64_t meanNs = 0;
+    uint64_t p50Ns = 0;
+    uint64_t p95Ns = 0;
+    uint64_t p99Ns = 0;
+    uint64_t maxNs = 0;
+    bool allocationsCounted = false;
+    double allocationsPerIteration = 0;
+    double allocatedBytesPerIteration = 0;
+    double bytesSentPerIteration = 0;
+};
+
+/**
+ * Run `iterations` of `scenario` (its default when 0) and summarize them.
+ * Allocations are only reported when `probe` is set. Returns false, leaving
+ * `result` empty, if the scenario failed to set up.
+ */
+inline bool runBenchScenario(BenchScenario& scenario, size_t iterations,
+                             AllocationProbe probe, BenchResult& result) {
+    result = BenchResult();
+    result.name = scenario.getName();
+    if (!scenario.setUp()) {
+        return false;
+    }
+    result.params = scenario.getParams();
+    const long budget = probe ? scenario.getAllocationBudget() : -1;
+    result.allocationBudget = budget;
+    if (iterations == 0) {
+        iterations = scenario.getDefaultIterations();
+    }
+
+    std::vector<uint64_t> samples;
+    samples.reserve(iterations);
+    BenchAllocations allocated;
+    uint64_t bytesSent = 0;
+
+    for (size_t i = 0; i < iterations; i++) {
+        if (i > 0) {
+            scenario.resetIteration();
+        }
+        BenchAllocations allocBefore = probe ? probe() : BenchAllocations();
+        uint64_t bytesBefore = scenario.getBytesSent();
+        auto start = std::chrono::steady_clock::now();
+
+        bool ok = scenario.runIteration();
+
+        auto end = std::chrono::steady_clock::now();
+        BenchAllocations allocAfter = probe ? probe() : BenchAllocations();
+        bytesSent += scenario.getBytesSent() - bytesBefore;
+        allocated.count += allocAfter.count - allocBefore.count;
+        allocated.bytes += allocAfter.bytes - allocBefore.bytes;
+        if (budget >= 0 && allocAfter.count - allocBefore.count > static_cast<uint64_t>(budget)) {
+            result.overAllocationBudget++;
+            ok = false;
+        }
+
+        uint64_t ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        samples.push_back(ns);
+        result.totalNs += ns;
+        if (!ok) result.failures++;
+    }
+    scenario.tearDown();
+
+    result.iterations = iterations;
+    if (iterations > 0) {
+        result.meanNs = result.totalNs / iterations;
+        result.p50Ns = nearestRankPercentile(samples, 50);
+        result.p95Ns = nearestRankPercentile(samples, 95);
+        result.p99Ns = nearestRankPercentile(samples, 99);
+        result.maxNs = nearestRankPercentile(samples, 100);
+        result.allocationsCounted = probe != nullptr;
+        result.allocationsPerIteration = static_cast<double>(allocated.count) / iterations;
+        result.allocatedBytesPerIteration = static_cast<double>(allocated.bytes) / iterations;
+        result.bytesSentPerIteration = static_cast<double>(bytesSent) / iterations;
+    }
+    return true;
+}
+
+/**
+ * Machine-readable report of a run, one object per scenario, for diffing a
+ * release against the stored baseline. Times are in nanoseconds; per-
+ * iteration counts are averages. `allocations_per_iteration` and
+ * `allocated_bytes_per_iteration` are null when nothing counted them,
+ * `allocation_budget` when the scenario has none.
+ */
+inline std::string formatBenchJson(const std::vector<BenchResult>& results) {
+    JsonDocument doc;
+    doc["schema"] = 1;
+    JsonArray scenarios = doc["scenarios"].to<JsonArray>();
+    for (const BenchResult& result : results) {
+        JsonObject entry = scenarios.add<JsonObject>();
+        entry["name"] = result.name;
+        entry["params"] = result.params;
+        entry["iterations"] = result.iterations;
+        entry["failures"] = result.failures;
+        JsonObject latency = entry["latency_ns"].to<JsonObject>();
+        latency["mean"] = result.meanNs;
+        latency["p50"] = result.p50Ns;
+        latency["p95"] = result.p95Ns;
+        latency["p99"] = result.p99Ns;
+        latency["max"] = result.maxNs;
+        if (result.allocationsCounted) {
+            entry["allocations_per_iteration"] = result.allocationsPerIteration;
+            entry["allocated_bytes_per_iteration"] = result.allocatedBytesPerIteration;
+        } else {
+            entry["allocations_per_iteration"] = nullptr;
+            entry["allocated_bytes_per_iteration"] = nullptr;
+        }
+        if (result.allocationBudget >= 0) {
+            entry["allocation_budget"] = result.allocationBudget;
+        } else {
+            entry["allocation_budget"] = nullptr;
+        }
+        entry["over_allocation_budget"] = result.overAllocationBudget;
+        entry["bytes_sent_per_iteration"] = result.bytesSentPerIteration;
+    }
+    std::string output;
+    serializeJsonPretty(doc, output);
+    return output;
+}
+
+/**
+ * The scenarios a binary offers, in the order they run by default.
+ */
+class BenchRegistry {
+public:
+    void add(std::unique_ptr<BenchScenario> scenario) {
+        scenarios_.push_back(std::move(scenario));
+    }
+
+    BenchScenario* find(const std::string& name) const {
+        for (const auto& scenario : scenarios_) {
+            if (name == scenario->getName()) {
+                return scenario.get();
+            }
+        }
+        return nullptr;
+    }
+
+    const std::vector<std::unique_ptr<BenchScenario>>& getScenarios() const {
+        return scenarios_;
+    }
+
+private:
+    std::vector<std::unique_ptr<BenchScenario>> scenarios_;
+};
+
+} // namespace cli
+
+#endif // NATIVE_BUILD
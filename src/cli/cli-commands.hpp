@@ -4,7 +4,9 @@
 
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 
 #include "cli/cli-device.hpp"
 #include "cli/cli-renderer.hpp"
@@ -107,6 +109,21 @@ public:
         if (command == "role" || command == "roles") {
             return cmdRole(tokens, devices, selectedDevice);
         }
+        if (command == "traffic" || command == "tr") {
+            return cmdTraffic(tokens, devices, selectedDevice);
+        }
+        if (command == "profile" || command == "prof") {
+            return cmdProfile(tokens, devices, selectedDevice);
+        }
+        if (command == "netem" || command == "impair") {
+            return cmdNetem(tokens, devices);
+        }
+        if (command == "capture" || command == "pcap") {
+            return cmdCapture(tokens);
+        }
+        if (command == "replay") {
+            return cmdReplay(tokens, devices);
+        }
 
         result.message = "Unknown command: " + command + " (try 'help')";
         return result;
@@ -117,7 +134,7 @@ private:
     
     static CommandResult cmdHelp(const std::vector<std::string>& /*tokens*/) {
         CommandResult result;
-        result.message = "Keys: LEFT/RIGHT=select, UP/DOWN=buttons | Cmds: help, quit, list, select, add, b/l, b2/l2, cable, peer, display, mirror, captions, reboot, role";
+        result.message = "Keys: LEFT/RIGHT=select, UP/DOWN=buttons | Cmds: help, quit, list, select, add, b/l, b2/l2, cable, peer, display, mirror, captions, reboot, role, traffic, profile, netem, capture, replay";
         return result;
     }
     
@@ -640,6 +657,254 @@ private:
         return result;
     }
 
+    static CommandResult cmdTraffic(const std::vector<std::string>& tokens,
+                                    const std::vector<DeviceInstance>& devices,
+                                    int selectedDevice) {
+        CommandResult result;
+
+        int targetDevice = selectedDevice;
+        bool reset = false;
+        for (size_t i = 1; i < tokens.size(); i++) {
+            if (tokens[i] == "reset") {
+                reset = true;
+            } else {
+                targetDevice = findDevice(tokens[i], devices, -1);
+            }
+        }
+        if (targetDevice < 0 || targetDevice >= static_cast<int>(devices.size())) {
+            result.message = "Invalid device";
+            return result;
+        }
+
+        NativePeerCommsDriver* driver = devices[targetDevice].peerCommsDriver;
+        if (reset) {
+            driver->resetTrafficStats();
+            result.message = "Traffic counters reset on " + devices[targetDevice].deviceId;
+            return result;
+        }
+
+        TrafficStats::Snapshot traffic;
+        driver->getTrafficSnapshot(traffic);
+
+        // Busiest types by estimated tx airtime first; the line is only so wide
+        std::vector<size_t> order;
+        for (size_t i = 0; i < TrafficStats::kNumTypes; i++) {
+            if (traffic.tx[i].frames > 0 || traffic.rx[i].frames > 0) order.push_back(i);
+        }
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return estimateAirtimeUs(traffic.tx[a]) > estimateAirtimeUs(traffic.tx[b]);
+        });
+
+        TrafficCounters tx = traffic.total(TrafficDirection::kTx);
+        TrafficCounters rx = traffic.total(TrafficDirection::kRx);
+        std::string msg = devices[targetDevice].deviceId + " tx " + std::to_string(tx.frames) + "f/" +
+                          std::to_string(tx.bytes) + "B air " +
+                          std::to_string(estimateAirtimeUs(tx) / 1000) + "ms, rx " +
+                          std::to_string(rx.frames) + "f/" + std::to_string(rx.bytes) + "B";
+        for (size_t n = 0; n < order.size() && n < 3; n++) {
+            const TrafficCounters& c = traffic.tx[order[n]];
+            msg += " | " + std::string(pktTypeName(static_cast<PktType>(order[n]))) + " " +
+                   std::to_string(c.frames) + "f " + std::to_string(estimateAirtimeUs(c) / 1000) + "ms";
+        }
+        result.message = msg;
+        return result;
+    }
+
+    /**
+     * Loop-tick timing for a device: the whole tick, then the three sections
+     * with the worst single call. Needs a LOOP_PROFILING build; the full
+     * histograms print at exit.
+     */
+    static CommandResult cmdProfile(const std::vector<std::string>& tokens,
+                                    const std::vector<DeviceInstance>& devices,
+                                    int selectedDevice) {
+        CommandResult result;
+
+        int targetDevice = selectedDevice;
+        bool reset = false;
+        for (size_t i = 1; i < tokens.size(); i++) {
+            if (tokens[i] == "reset") {
+                reset = true;
+            } else {
+                targetDevice = findDevice(tokens[i], devices, -1);
+            }
+        }
+        if (targetDevice < 0 || targetDevice >= static_cast<int>(devices.size())) {
+            result.message = "Invalid device";
+            return result;
+        }
+
+        LoopProfiler* profiler = devices[targetDevice].pdn->getLoopProfiler();
+        if (profiler == nullptr) {
+            result.message = "Loop profiling not built in (needs -DLOOP_PROFILING)";
+            return result;
+        }
+        if (reset) {
+            profiler->reset();
+            result.message = "Loop profile reset on " + devices[targetDevice].deviceId;
+            return result;
+        }
+
+        std::string msg = devices[targetDevice].deviceId;
+        std::vector<const LoopProfileSection*> sections;
+        for (size_t i = 0; i < profiler->getSectionCount(); i++) {
+            const LoopProfileSection& section = profiler->getSection(i);
+            if (section.kind == LoopProfileSection::Kind::kTick) {
+                char row[128];
+                formatLoopProfileRow(section, "tick", row, sizeof(row));
+                msg += std::string(" ") + row;
+            } else {
+                sections.push_back(&section);
+            }
+        }
+        std::sort(sections.begin(), sections.end(), [](const LoopProfileSection* a, const LoopProfileSection* b) {
+            return a->maxUs > b->maxUs;
+        });
+        for (size_t n = 0; n < sections.size() && n < 3; n++) {
+            const LoopProfileSection& section = *sections[n];
+            unsigned long mean = section.count ? static_cast<unsigned long>(section.totalUs / section.count) : 0;
+            msg += " | " + getLoopProfileLabel(section) + " " + std::to_string(mean) + "/" +
+                   std::to_string(section.maxUs) + "us";
+        }
+        result.message = msg;
+        return result;
+    }
+
+    /**
+     * Impair simulated ESP-NOW links. Settings apply to every link, or to
+     * the directed link <a> -> <b> when two devices are given.
+     *   netem [a b] loss=5 burst=2/25 lat=20 jitter=10 reorder=5 dup=1 bw=20000 rssi=-80
+     * Percentages are per transmission; burst is enter%/exit%. "netem off"
+     * clears everything, "netem seed <n>" makes a run repeatable.
+     */
+    static CommandResult cmdNetem(const std::vector<std::string>& tokens,
+                                  const std::vector<DeviceInstance>& devices) {
+        CommandResult result;
+        NativePeerBroker& broker = NativePeerBroker::getInstance();
+
+        if (tokens.size() >= 2 && tokens[1] == "off") {
+            broker.clearLinkProfiles();
+            result.message = "Link impairments cleared";
+            return result;
+        }
+        if (tokens.size() >= 3 && tokens[1] == "seed") {
+            broker.seedLinkImpairments(static_cast<uint32_t>(std::strtoul(tokens[2].c_str(), nullptr, 10)));
+            result.message = "Link impairments seeded with " + tokens[2];
+            return result;
+        }
+
+        LinkProfile profile;
+        std::vector<int> link;
+        for (size_t i = 1; i < tokens.size(); i++) {
+            size_t eq = tokens[i].find('=');
+            if (eq == std::string::npos) {
+                int device = findDevice(tokens[i], devices, -1);
+                if (device < 0) {
+                    result.message = "Invalid device: " + tokens[i];
+                    return result;
+                }
+                link.push_back(device);
+                continue;
+            }
+            std::string key = tokens[i].substr(0, eq);
+            const char* value = tokens[i].c_str() + eq + 1;
+            long number = std::strtol(value, nullptr, 10);
+            if (key == "loss") {
+                profile.lossPermille = static_cast<uint16_t>(number * 10);
+            } else if (key == "burst") {
+                const char* slash = std::strchr(value, '/');
+                profile.burstEnterPermille = static_cast<uint16_t>(number * 10);
+                profile.burstExitPermille = slash ? static_cast<uint16_t>(std::strtol(slash + 1, nullptr, 10) * 10) : 1000;
+            } else if (key == "lat") {
+                profile.latencyMs = static_cast<uint32_t>(number);
+            } else if (key == "jitter") {
+                profile.jitterMs = static_cast<uint32_t>(number);
+            } else if (key == "reorder") {
+                profile.reorderPermille = static_cast<uint16_t>(number * 10);
+            } else if (key == "dup") {
+                profile.duplicatePermille = static_cast<uint16_t>(number * 10);
+            } else if (key == "bw") {
+                profile.bandwidthBytesPerSec = static_cast<uint32_t>(number);
+            } else if (key == "rssi") {
+                profile.rssiDbm = static_cast<int>(number);
+            } else {
+                result.message = "Unknown setting: " + key + " (loss burst lat jitter reorder dup bw rssi)";
+                return result;
+            }
+        }
+
+        if (link.empty()) {
+            broker.setDefaultLinkProfile(profile);
+            result.message = "Impairing all links";
+        } else if (link.size() == 2) {
+            broker.setLinkProfile(devices[link[0]].peerCommsDriver->getMacAddress(),
+                                  devices[link[1]].peerCommsDriver->getMacAddress(), profile);
+            result.message = "Impairing " + devices[link[0]].deviceId + " -> " + devices[link[1]].deviceId;
+        } else {
+            result.message = "Usage: netem [<a> <b>] key=value... | netem off | netem seed <n>";
+        }
+        return result;
+    }
+
+    static CommandResult cmdCapture(const std::vector<std::string>& tokens) {
+        CommandResult result;
+        NativePeerBroker& broker = NativePeerBroker::getInstance();
+        if (tokens.size() < 2) {
+            result.message = "Usage: capture <file.pcap> | capture off";
+            return result;
+        }
+        if (tokens[1] == "off") {
+            uint32_t frames = broker.getCapturedFrameCount();
+            broker.stopCapture();
+            result.message = "Capture stopped after " + std::to_string(frames) + " frames";
+            return result;
+        }
+        if (!broker.startCapture(tokens[1].c_str())) {
+            result.message = "Cannot write " + tokens[1];
+            return result;
+        }
+        result.message = "Capturing ESP-NOW frames to " + tokens[1];
+        return result;
+    }
+
+    /**
+     * Replay a capture into the running devices. Captured MACs can be mapped
+     * onto devices: replay <file> 02:00:00:00:00:05=1
+     */
+    static CommandResult cmdReplay(const std::vector<std::string>& tokens,
+                                   const std::vector<DeviceInstance>& devices) {
+        CommandResult result;
+        NativePeerBroker& broker = NativePeerBroker::getInstance();
+        if (tokens.size() < 2) {
+            result.message = "Usage: replay <file.pcap> [mac=dev]... | replay off";
+            return result;
+        }
+        if (tokens[1] == "off") {
+            broker.stopReplay();
+            result.message = "Replay stopped";
+            return result;
+        }
+
+        broker.stopReplay();
+        for (size_t i = 2; i < tokens.size(); i++) {
+            size_t eq = tokens[i].find('=');
+            int device = eq == std::string::npos ? -1 : findDevice(tokens[i].substr(eq + 1), devices, -1);
+            if (device < 0) {
+                result.message = "Expected <mac>=<device>: " + tokens[i];
+                return result;
+            }
+            uint8_t captured[6];
+            parseMacString(tokens[i].substr(0, eq), captured);
+            broker.mapReplayAddress(captured, devices[device].peerCommsDriver->getMacAddress());
+        }
+        if (!broker.startReplay(tokens[1].c_str())) {
+            result.message = "Cannot read capture " + tokens[1];
+            return result;
+        }
+        result.message = "Replaying " + tokens[1];
+        return result;
+    }
+
     // ==================== UTILITY FUNCTIONS ====================
     
     /**
@@ -71,6 +71,19 @@ inline const char* getStateName(int stateId) {
     }
 }
 
+/**
+ * Loop-profiler section label with Quickdraw state names filled in, e.g.
+ * "state:Duel" rather than "state:1/14".
+ */
+inline std::string getLoopProfileLabel(const LoopProfileSection& section) {
+    if (section.kind == LoopProfileSection::Kind::kState && section.machineId == QUICKDRAW_APP_ID) {
+        return std::string("state:") + getStateName(section.stateId);
+    }
+    char label[48];
+    formatLoopProfileLabel(section, label, sizeof(label));
+    return label;
+}
+
 /**
  * Structure to hold all components for a single simulated PDN device.
  */
@@ -0,0 +1,296 @@
+#pragma once
+
+#ifdef NATIVE_BUILD
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "wireless/traffic-stats.hpp"
+
+namespace cli {
+
+/**
+ * One line of a fleet behavior script: a CLI command run once, or repeatedly
+ * every `periodMs`. A command naming {dev} is run for every device with
+ * {dev} replaced by its index; {mate} becomes the device it is paired with
+ * (0-1, 2-3, ...).
+ */
+struct FleetStep {
+    unsigned long startMs = 0;
+    unsigned long periodMs = 0;     // 0 runs once
+    std::string command;
+    bool perDevice = false;
+};
+
+/**
+ * Behavior script for the headless fleet simulator. Lines are
+ *
+ *   at <ms> <command>                 run once, <ms> after the start
+ *   every <ms> [from <ms>] <command>  run every <ms>, first at `from`
+ *
+ * where <command> is anything the CLI prompt accepts. Blank lines and lines
+ * starting with '#' are skipped. Repeating per-device steps are spread over
+ * their period, device i firing i/N of the way in, so a few hundred players
+ * don't all press a button on the same tick.
+ */
+class FleetScript {
+public:
+    using Runner = std::function<void(const std::string& command)>;
+
+    /**
+     * Parse and append one line. False, with `error` set, if it's malformed.
+     */
+    bool addLine(const std::string& line, std::string& error) {
+        std::istringstream in(line);
+        std::string keyword;
+        if (!(in >> keyword) || keyword[0] == '#') {
+            return true;
+        }
+
+        FleetStep step;
+        if (keyword == "at") {
+            if (!readMs(in, step.startMs)) {
+                error = "at: expected a time in ms";
+                return false;
+            }
+        } else if (keyword == "every") {
+            if (!readMs(in, step.periodMs) || step.periodMs == 0) {
+                error = "every: expected a period in ms";
+                return false;
+            }
+            std::streampos mark = in.tellg();
+            std::string word;
+            if (in >> word && word == "from") {
+                if (!readMs(in, step.startMs)) {
+                    error = "every: expected a time in ms after 'from'";
+                    return false;
+                }
+            } else {
+                in.clear();
+                in.seekg(mark);
+            }
+        } else {
+            error = "expected 'at' or 'every', got '" + keyword + "'";
+            return false;
+        }
+
+        std::getline(in, step.command);
+        size_t first = step.command.find_first_not_of(" \t");
+        if (first == std::string::npos) {
+            error = keyword + ": missing command";
+            return false;
+        }
+        step.command.erase(0, first);
+        step.perDevice = step.command.find("{dev}") != std::string::npos ||
+                         step.command.find("{mate}") != std::string::npos;
+        steps_.push_back(step);
+        return true;
+    }
+
+    /**
+     * Append every line of `path`. False, with `error` naming the line, on
+     * the first malformed one or if the file can't be read.
+     */
+    bool load(const std::string& path, std::string& error) {
+        std::ifstream file(path);
+        if (!file) {
+            error = "cannot read " + path;
+            return false;
+        }
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(file, line)) {
+            lineNumber++;
+            if (!addLine(line, error)) {
+                error = path + ":" + std::to_string(lineNumber) + ": " + error;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Schedule every step for `deviceCount` devices, with script times
+     * counted from `startMs`. Drops anything still pending.
+     */
+    void start(size_t deviceCount, unsigned long startMs) {
+        pending_ = Queue();
+        deviceCount_ = deviceCount;
+        for (size_t i = 0; i < steps_.size(); i++) {
+            const FleetStep& step = steps_[i];
+            unsigned long first = startMs + step.startMs;
+            if (!step.perDevice) {
+                pending_.push({first, i, -1});
+                continue;
+            }
+            for (size_t dev = 0; dev < deviceCount; dev++) {
+                unsigned long offset = step.periodMs * dev / deviceCount;
+                pending_.push({first + offset, i, static_cast<int>(dev)});
+            }
+        }
+    }
+
+    /**
+     * Hand `run` every command due at or before `nowMs`, earliest first, and
+     * reschedule repeating steps. Returns how many commands were run.
+     */
+    size_t runDue(unsigned long nowMs, const Runner& run) {
+        size_t count = 0;
+        while (!pending_.empty() && pending_.top().dueMs <= nowMs) {
+            Pending next = pending_.top();
+            pending_.pop();
+            const FleetStep& step = steps_[next.step];
+            std::string command;
+            if (expand(step, next.device, command)) {
+                run(command);
+                count++;
+            }
+            if (step.periodMs > 0) {
+                next.dueMs += step.periodMs;
+                pending_.push(next);
+            }
+        }
+        return count;
+    }
+
+    size_t getStepCount() const {
+        return steps_.size();
+    }
+
+    bool hasPending() const {
+        return !pending_.empty();
+    }
+
+    /**
+     * When the next command falls due. False once nothing is left to run.
+     */
+    bool getNextDueMs(unsigned long& out) const {
+        if (pending_.empty()) {
+            return false;
+        }
+        out = pending_.top().dueMs;
+        return true;
+    }
+
+private:
+    struct Pending {
+        unsigned long dueMs;
+        size_t step;
+        int device;     // -1 for steps not run per device
+
+        bool operator>(const Pending& other) const {
+            if (dueMs != other.dueMs) return dueMs > other.dueMs;
+            if (step != other.step) return step > other.step;
+            return device > other.device;
+        }
+    };
+    using Queue = std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>>;
+
+    static bool readMs(std::istringstream& in, unsigned long& out) {
+        std::string word;
+        if (!(in >> word)) return false;
+        char* end = nullptr;
+        out = std::strtoul(word.c_str(), &end, 10);
+        return end != word.c_str() && *end == '\0';
+    }
+
+    // False if the device has no mate (the odd one out of an odd fleet)
+    bool expand(const FleetStep& step, int device, std::string& out) const {
+        out = step.command;
+        if (device < 0) {
+            return true;
+        }
+        size_t mate = static_cast<size_t>(device) ^ 1u;
+        if (out.find("{mate}") != std::string::npos && mate >= deviceCount_) {
+            return false;
+        }
+        replaceAll(out, "{dev}", std::to_string(device));
+        replaceAll(out, "{mate}", std::to_string(mate));
+        return true;
+    }
+
+    static void replaceAll(std::string& text, const std::string& from, const std::string& to) {
+        for (size_t pos = text.find(from); pos != std::string::npos; pos = text.find(from, pos + to.size())) {
+            text.replace(pos, from.size(), to);
+        }
+    }
+
+    std::vector<FleetStep> steps_;
+    Queue pending_;
+    size_t deviceCount_ = 0;
+};
+
+/**
+ * Wall time spent per simulator tick, in microseconds. Keeps every sample so
+ * percentiles are exact; a ten minute run at 30 Hz is 18k of them.
+ */
+class FleetTickStats {
+public:
+    void record(uint32_t tickUs, bool overran) {
+        samples_.push_back(tickUs);
+        totalUs_ += tickUs;
+        if (overran) overruns_++;
+    }
+
+    size_t getTicks() const {
+        return samples_.size();
+    }
+
+    uint32_t getOverruns() const {
+        return overruns_;
+    }
+
+    uint64_t getTotalUs() const {
+        return totalUs_;
+    }
+
+    uint32_t meanUs() const {
+        return samples_.empty() ? 0 : static_cast<uint32_t>(totalUs_ / samples_.size());
+    }
+
+    /**
+     * Nearest-rank percentile, 0 with no samples. `percent` of 100 is the max.
+     */
+    uint32_t percentileUs(double percent) const {
+        if (samples_.empty()) return 0;
+        std::vector<uint32_t> sorted = samples_;
+        size_t rank = static_cast<size_t>(percent / 100.0 * (sorted.size() - 1) + 0.5);
+        rank = std::min(rank, sorted.size() - 1);
+        std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+        return sorted[rank];
+    }
+
+private:
+    std::vector<uint32_t> samples_;
+    uint64_t totalUs_ = 0;
+    uint32_t overruns_ = 0;
+};
+
+/**
+ * Add every counter of `from` into `into`, for fleet-wide totals.
+ */
+inline void addTrafficSnapshot(TrafficStats::Snapshot& into, const TrafficStats::Snapshot& from) {
+    auto add = [](TrafficCounters& a, const TrafficCounters& b) {
+        a.frames += b.frames;
+        a.bytes += b.bytes;
+        a.fragments += b.fragments;
+        a.failures += b.failures;
+        a.queueDelayMsSum += b.queueDelayMsSum;
+        a.queueDelayMsMax = std::max(a.queueDelayMsMax, b.queueDelayMsMax);
+    };
+    for (size_t i = 0; i < TrafficStats::kNumTypes; i++) {
+        add(into.tx[i], from.tx[i]);
+        add(into.rx[i], from.rx[i]);
+    }
+}
+
+} // namespace cli
+
+#endif // NATIVE_BUILD
@@ -284,6 +284,22 @@ int main(int argc, char** argv) {
     
     // Move cursor below the UI for clean shutdown message
     printf("\n\nShutting down...\n");
+
+    // Per-device tick timing, when built with LOOP_PROFILING
+    for (auto& device : devices) {
+        LoopProfiler* profiler = device.pdn->getLoopProfiler();
+        if (profiler == nullptr || profiler->getSectionCount() == 0) continue;
+        printf("\nLoop profile for %s (budget %luus):\n", device.deviceId.c_str(),
+               static_cast<unsigned long>(profiler->getTickBudgetUs()));
+        for (size_t i = 0; i < profiler->getSectionCount(); i++) {
+            const LoopProfileSection& section = profiler->getSection(i);
+            char row[160];
+            char histogram[256];
+            formatLoopProfileRow(section, cli::getLoopProfileLabel(section).c_str(), row, sizeof(row));
+            formatLoopProfileHistogram(section, histogram, sizeof(histogram));
+            printf("  %s\n    %s\n", row, histogram);
+        }
+    }
     
     for (auto& device : devices) {
         cli::DeviceFactory::destroyDevice(device);
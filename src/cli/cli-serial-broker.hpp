@@ -193,6 +193,22 @@ public:
         }
     }
     
+    /**
+     * Whether the next transferData() has anything to deliver.
+     */
+    bool hasPendingData() const {
+        for (const auto& conn : connections_) {
+            auto itA = devices_.find(conn.deviceA);
+            auto itB = devices_.find(conn.deviceB);
+            if (itA == devices_.end() || itB == devices_.end()) continue;
+            if (getJack(itA->second, conn.jackA)->getOutputBufferSize() > 0 ||
+                getJack(itB->second, conn.jackB)->getOutputBufferSize() > 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     /**
      * Check if a device is connected to another.
      * @return The index of the connected device, or -1 if not connected
@@ -244,7 +260,7 @@ private:
     std::map<int, DeviceSerial> devices_;
     std::vector<CableConnection> connections_;
     
-    NativeSerialDriver* getJack(const DeviceSerial& device, JackType type) {
+    NativeSerialDriver* getJack(const DeviceSerial& device, JackType type) const {
         return (type == JackType::OUTPUT_JACK) ? device.outputJack : device.inputJack;
     }
     
@@ -0,0 +1,516 @@
+#if defined(NATIVE_BUILD) && defined(CODEC_BENCH_BUILD)
+
+/**
+ * Codec Micro-Benchmarks
+ *
+ * Encode and decode throughput, encoded size and heap allocations for every
+ * format the firmware puts on the wire or in storage, each over the inputs
+ * it actually sees in play:
+ *
+ *   match.*             Match binary (NVS storage) and JSON (upload)
+ *   player.*            Player JSON (server sync)
+ *   quickdraw.*         Duel commands, compact v2 and legacy v1 layouts
+ *   handshake.*         kHandshakeCommand
+ *   chain-announce.*    RDC chain announcements for 1, 8 and 18 peers
+ *   shootout-bracket.*  BRACKET commands for 4, 16 and 32 players
+ *   fragment.*          DataPktHdr clusters split and reassembled, in v1
+ *                       and v2 frames
+ *
+ * Each timed iteration runs kOpsPerIteration operations back to back, so
+ * the timer's own cost disappears; the table reports per operation. Size
+ * is the encoded form in both directions, so MB/s compares encoders with
+ * their decoders. Decoders run through the same validation the receive
+ * path does (decodePacket<>, the reassembler's header checks).
+ *
+ * Build:  pio run -e native_codec_bench
+ * Run:    .pio/build/native_codec_bench/program [--scenario PREFIX] [--json FILE]
+ */
+
+#include <array>
+#include <cctype>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "device/drivers/logger.hpp"
+#include "device/drivers/peer-comms-types.hpp"
+#include "device/remote-device-coordinator.hpp"
+#include "game/match.hpp"
+#include "game/player.hpp"
+#include "game/shootout-manager.hpp"
+#include "utils/alloc-tracker.hpp"
+#include "wireless/fragment-reassembly.hpp"
+#include "wireless/frame-pool.hpp"
+#include "wireless/handshake-wireless-manager.hpp"
+#include "wireless/packet-registry.hpp"
+#include "wireless/quickdraw-wireless-manager.hpp"
+
+#include "cli/cli-bench.hpp"
+
+static constexpr size_t kOpsPerIteration = 100;
+
+static const char kMatchId[] = "123e4567-e89b-12d3-a456-426614174000";
+static const char kShootoutMatchId[] = "SHT-00000000000000000000000000000003";
+
+static cli::BenchAllocations readAllocations() {
+    AllocationCounts totals = AllocationTracker::getTotals();
+    cli::BenchAllocations allocations;
+    allocations.count = totals.allocations;
+    allocations.bytes = totals.bytes;
+    return allocations;
+}
+
+class NullLogger : public LoggerInterface {
+public:
+    void vlog(LogLevel, const char*, const char*, int,
+              const char*, va_list) override {}
+};
+
+// ============================================================
+// One codec operation, batched
+// ============================================================
+
+/**
+ * `Op` encodes or decodes one input and returns the size of its encoded
+ * form, or 0 if the result was wrong. Templated rather than a
+ * std::function so the call itself isn't part of what's measured.
+ */
+template <typename Op>
+class CodecScenario : public cli::BenchScenario {
+public:
+    CodecScenario(const char* name, const char* description, std::string params, Op op)
+        : name_(name), description_(description), params_(std::move(params)), op_(std::move(op)) {}
+
+    const char* getName() const override { return name_; }
+    const char* getDescription() const override { return description_; }
+    std::string getParams() const override { return params_; }
+    size_t getDefaultIterations() const override { return 2000; }
+
+    bool runIteration() override {
+        bool ok = true;
+        for (size_t i = 0; i < kOpsPerIteration; i++) {
+            size_t encoded = op_();
+            ok = ok && encoded > 0;
+            bytes_ += encoded;
+        }
+        return ok;
+    }
+
+    uint64_t getBytesSent() const override {
+        return bytes_;
+    }
+
+private:
+    const char* name_;
+    const char* description_;
+    std::string params_;
+    Op op_;
+    uint64_t bytes_ = 0;
+};
+
+template <typename Op>
+static void addCodec(cli::BenchRegistry& registry, const char* name, const char* description,
+                     std::string params, Op op) {
+    registry.add(std::make_unique<CodecScenario<Op>>(name, description, std::move(params), std::move(op)));
+}
+
+// ============================================================
+// Sample inputs
+// ============================================================
+
+static Match sampleMatch() {
+    Match match(kMatchId, "hunt", true);
+    match.setBountyId("bnty");
+    match.setHunterDrawTime(231);
+    match.setBountyDrawTime(287);
+    return match;
+}
+
+static Player samplePlayer() {
+    Player player("c0de", Allegiance::HELIX, true);
+    player.setName("Quickdraw McGraw");
+    player.setFaction("Night Owls");
+    return player;
+}
+
+static std::vector<std::array<uint8_t, 6>> sampleMacs(size_t count) {
+    std::vector<std::array<uint8_t, 6>> macs(count);
+    for (size_t i = 0; i < count; i++) {
+        macs[i] = {0x24, 0x6F, 0x28, 0x10, static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(i)};
+    }
+    return macs;
+}
+
+static std::vector<uint8_t> samplePayload(size_t length) {
+    std::vector<uint8_t> data(length);
+    for (size_t i = 0; i < length; i++) {
+        data[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+    return data;
+}
+
+// ============================================================
+// Formats
+// ============================================================
+
+static void addMatchCodecs(cli::BenchRegistry& registry) {
+    std::array<uint8_t, MATCH_BINARY_SIZE> binary;
+    sampleMatch().serialize(binary.data());
+    std::string json = sampleMatch().toJson();
+
+    addCodec(registry, "match.serialize", "Match to its NVS record", "",
+        [match = sampleMatch(), out = std::array<uint8_t, MATCH_BINARY_SIZE>()]() mutable {
+            return match.serialize(out.data());
+        });
+    addCodec(registry, "match.deserialize", "NVS record back to a Match", "",
+        [binary, match = Match()]() mutable {
+            size_t read = match.deserialize(binary.data());
+            return match.getBountyDrawTime() == 287 ? read : 0;
+        });
+    addCodec(registry, "match.to-json", "Match to its upload JSON", "",
+        [match = sampleMatch()]() {
+            return match.toJson().size();
+        });
+    addCodec(registry, "match.from-json", "Upload JSON back to a Match", "",
+        [json, match = Match()]() mutable {
+            match.fromJson(json);
+            return match.getBountyDrawTime() == 287 ? json.size() : 0;
+        });
+}
+
+static void addPlayerCodecs(cli::BenchRegistry& registry) {
+    std::string json = samplePlayer().toJson();
+
+    addCodec(registry, "player.to-json", "Player to its server JSON", "",
+        [player = samplePlayer()]() {
+            return player.toJson().size();
+        });
+    addCodec(registry, "player.from-json", "Server JSON back to a Player", "",
+        [json, player = Player()]() mutable {
+            player.fromJson(json);
+            return player.isHunter() ? json.size() : 0;
+        });
+}
+
+static void addQuickdrawCodecs(cli::BenchRegistry& registry) {
+    struct Layout {
+        const char* encodeName;
+        const char* decodeName;
+        const char* matchId;
+        const char* params;
+        bool compact;
+    };
+    static const Layout kLayouts[] = {
+        {"quickdraw.encode-v2", "quickdraw.decode-v2", kMatchId, "uuid", true},
+        {"quickdraw.encode-v1", "quickdraw.decode-v1", kShootoutMatchId, "shootout-id", false},
+    };
+    static const uint8_t kFromMac[6] = {0x24, 0x6F, 0x28, 0x10, 0x00, 0x01};
+
+    for (const Layout& layout : kLayouts) {
+        QuickdrawCommand command(nullptr, QDCommand::DRAW_RESULT, layout.matchId, "hunt", 231, true);
+        std::array<uint8_t, QUICKDRAW_PACKET_MAX_LEN> wire;
+        size_t wireLen = encodeQuickdrawPacket(command, wire.data(), layout.compact);
+
+        addCodec(registry, layout.encodeName, "Duel command to its wire packet", layout.params,
+            [command, compact = layout.compact, out = std::array<uint8_t, QUICKDRAW_PACKET_MAX_LEN>()]() mutable {
+                return encodeQuickdrawPacket(command, out.data(), compact);
+            });
+        addCodec(registry, layout.decodeName, "Wire packet back to a duel command", layout.params,
+            [wire, wireLen]() {
+                std::optional<QuickdrawCommand> decoded = decodeQuickdrawPacket(kFromMac, wire.data(), wireLen);
+                return decoded && decoded->playerDrawTime == 231 ? wireLen : 0;
+            });
+    }
+}
+
+static void addHandshakeCodecs(cli::BenchRegistry& registry) {
+    static const uint8_t kFromMac[6] = {0x24, 0x6F, 0x28, 0x10, 0x00, 0x01};
+
+    // What HandshakeWirelessManager::sendPacket puts on the wire
+    addCodec(registry, "handshake.encode", "Handshake command to its wire packet", "",
+        [out = std::array<uint8_t, sizeof(HandshakePacket)>(), command = 0]() mutable {
+            HandshakePacket packet;
+            packet.command = command++ % HS_COMMAND_COUNT;
+            packet.sendingJack = static_cast<int>(SerialIdentifier::OUTPUT_JACK);
+            packet.receicingJack = static_cast<int>(SerialIdentifier::INPUT_JACK);
+            packet.deviceType = 0;
+            memcpy(out.data(), &packet, sizeof(packet));
+            return sizeof(packet);
+        });
+
+    HandshakePacket packet;
+    packet.command = EXCHANGE_ID;
+    packet.sendingJack = static_cast<int>(SerialIdentifier::OUTPUT_JACK);
+    packet.receicingJack = static_cast<int>(SerialIdentifier::INPUT_JACK);
+    packet.deviceType = 0;
+    auto hwm = std::make_shared<HandshakeWirelessManager>();
+    auto received = std::make_shared<uint64_t>(0);
+    hwm->setPacketReceivedCallback([received](HandshakeCommand) { (*received)++; },
+                                   SerialIdentifier::INPUT_JACK);
+
+    addCodec(registry, "handshake.decode", "Wire packet through processHandshakeCommand", "",
+        [packet, hwm, received]() {
+            uint64_t before = *received;
+            hwm->processHandshakeCommand(kFromMac, reinterpret_cast<const uint8_t*>(&packet), sizeof(packet));
+            return *received == before + 1 ? sizeof(packet) : 0;
+        });
+}
+
+static void addChainAnnouncementCodecs(cli::BenchRegistry& registry) {
+    // A lone pair, a typical line, and the kMaxChainPeersPerPort ceiling
+    static const char* const kEncodeNames[] = {"chain-announce.encode-1", "chain-announce.encode-8",
+                                               "chain-announce.encode-18"};
+    static const char* const kDecodeNames[] = {"chain-announce.decode-1", "chain-announce.decode-8",
+                                               "chain-announce.decode-18"};
+    static const size_t kPeerCounts[] = {1, 8, 18};
+
+    for (size_t i = 0; i < 3; i++) {
+        std::vector<std::array<uint8_t, 6>> peers = sampleMacs(kPeerCounts[i]);
+        std::vector<uint8_t> wire;
+        encodeChainAnnouncement(7, peers, wire);
+        std::string params = "peers=" + std::to_string(kPeerCounts[i]);
+
+        addCodec(registry, kEncodeNames[i], "Peer list to a chain announcement", params,
+            [peers, out = std::vector<uint8_t>()]() mutable {
+                return encodeChainAnnouncement(7, peers, out);
+            });
+        addCodec(registry, kDecodeNames[i], "Chain announcement back to a peer list", params,
+            [wire, count = peers.size(), decoded = std::vector<std::array<uint8_t, 6>>()]() mutable {
+                const ChainAnnouncementHdr* hdr = decodePacket<PktType::kChainAnnouncement>(wire.data(), wire.size());
+                if (hdr == nullptr) return size_t(0);
+                decodeChainAnnouncement(*hdr, decoded);
+                return decoded.size() == count ? wire.size() : 0;
+            });
+    }
+}
+
+static void addShootoutBracketCodecs(cli::BenchRegistry& registry) {
+    // Smallest ring, a busy night, and kMaxBracketSize
+    static const char* const kEncodeNames[] = {"shootout-bracket.encode-4", "shootout-bracket.encode-16",
+                                               "shootout-bracket.encode-32"};
+    static const char* const kDecodeNames[] = {"shootout-bracket.decode-4", "shootout-bracket.decode-16",
+                                               "shootout-bracket.decode-32"};
+    static const size_t kPlayerCounts[] = {4, 16, ShootoutManager::kMaxBracketSize};
+
+    for (size_t i = 0; i < 3; i++) {
+        std::vector<std::array<uint8_t, 6>> bracket = sampleMacs(kPlayerCounts[i]);
+        std::vector<uint8_t> wire;
+        encodeShootoutBracket(3, bracket, wire);
+        std::string params = "players=" + std::to_string(kPlayerCounts[i]);
+
+        addCodec(registry, kEncodeNames[i], "Bracket to a BRACKET command", params,
+            [bracket, out = std::vector<uint8_t>()]() mutable {
+                return encodeShootoutBracket(3, bracket, out);
+            });
+        addCodec(registry, kDecodeNames[i], "BRACKET command back to a bracket", params,
+            [wire, count = bracket.size(), decoded = std::vector<std::array<uint8_t, 6>>()]() mutable {
+                const ShootoutPacket* packet = decodePacket<PktType::kShootoutCommand>(wire.data(), wire.size());
+                if (packet == nullptr ||
+                    !decodeShootoutBracket(packet->payload, wire.size() - sizeof(ShootoutPacket), decoded)) {
+                    return size_t(0);
+                }
+                return decoded.size() == count ? wire.size() : 0;
+            });
+    }
+}
+
+static void addFragmentCodecs(cli::BenchRegistry& registry) {
+    struct Shape {
+        const char* splitName;
+        const char* reassembleName;
+        size_t length;
+        size_t fragmentLen;
+    };
+    // A few frames, a match upload batch, and the largest packet sendData()
+    // takes, each as a v1 peer and a v2 peer would receive them
+    static const Shape kShapes[] = {
+        {"fragment.split-v1-600", "fragment.reassemble-v1-600", 600, PEER_COMMS_MAX_FRAME_PAYLOAD},
+        {"fragment.split-v1-4k", "fragment.reassemble-v1-4k", 4096, PEER_COMMS_MAX_FRAME_PAYLOAD},
+        {"fragment.split-v1-max", "fragment.reassemble-v1-max", MAX_SEND_PACKET_LEN, PEER_COMMS_MAX_FRAME_PAYLOAD},
+        {"fragment.split-v2-4k", "fragment.reassemble-v2-4k", 4096, PEER_COMMS_MAX_FRAME_PAYLOAD_V2},
+        {"fragment.split-v2-max", "fragment.reassemble-v2-max", MAX_SEND_PACKET_LEN, PEER_COMMS_MAX_FRAME_PAYLOAD_V2},
+    };
+    static const uint8_t kFromMac[6] = {0x24, 0x6F, 0x28, 0x10, 0x00, 0x01};
+
+    for (const Shape& shape : kShapes) {
+        std::vector<uint8_t> data = samplePayload(shape.length);
+        const uint8_t count = static_cast<uint8_t>(fragmentCount(shape.length, shape.fragmentLen));
+        std::vector<std::vector<uint8_t>> frames(count);
+        for (uint8_t idx = 0; idx < count; idx++) {
+            frames[idx].resize(sizeof(DataPktHdr) + shape.fragmentLen);
+            frames[idx].resize(buildFragment(frames[idx].data(), PktType::kBulkTransfer, data.data(), data.size(),
+                                             idx, count, shape.fragmentLen));
+        }
+        std::string params = "frames=" + std::to_string(count);
+
+        addCodec(registry, shape.splitName, "Payload to a DataPktHdr cluster", params,
+            [data, count, fragmentLen = shape.fragmentLen,
+             out = std::vector<uint8_t>(sizeof(DataPktHdr) + shape.fragmentLen)]() mutable {
+                size_t total = 0;
+                for (uint8_t idx = 0; idx < count; idx++) {
+                    total += buildFragment(out.data(), PktType::kBulkTransfer, data.data(), data.size(),
+                                           idx, count, fragmentLen);
+                }
+                return total;
+            });
+
+        auto reassembler = std::make_shared<FragmentReassembler>();
+        addCodec(registry, shape.reassembleName, "DataPktHdr cluster back to its payload", params,
+            [frames, reassembler, length = shape.length]() {
+                size_t total = 0;
+                FragmentReassembler::Result result = FragmentReassembler::Result::kRejected;
+                for (const std::vector<uint8_t>& frame : frames) {
+                    result = reassembler->onFragment(kFromMac, frame.data(), frame.size(), 0);
+                    total += frame.size();
+                }
+                bool complete = result == FragmentReassembler::Result::kComplete &&
+                                reassembler->completed().data.size() == length;
+                return complete ? total : 0;
+            });
+    }
+}
+
+// ============================================================
+// Main
+// ============================================================
+
+struct CodecOptions {
+    std::vector<std::string> prefixes;      // empty runs them all
+    size_t iterations = 0;                  // 0 for each scenario's default
+    std::string jsonPath;
+    bool list = false;
+};
+
+static void printUsage(const char* program) {
+    printf("PDN Codec Micro-Benchmarks\n");
+    printf("Usage: %s [options]\n\n", program);
+    printf("Options:\n");
+    printf("  -s, --scenario PREFIX Run scenarios whose name starts with PREFIX; repeat for more\n");
+    printf("  -i, --iterations N    Iterations per scenario, %zu operations each (default 2000)\n",
+           kOpsPerIteration);
+    printf("      --json FILE       Also write results as JSON, '-' for stdout\n");
+    printf("  -l, --list            List scenarios and exit\n");
+    printf("  -h, --help            Show this help message\n");
+}
+
+// False on a bad option; the caller exits
+static bool parseArgs(int argc, char** argv, CodecOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            exit(0);
+        } else if (arg == "-l" || arg == "--list") {
+            options.list = true;
+        } else if ((arg == "-s" || arg == "--scenario") && hasValue) {
+            options.prefixes.push_back(argv[++i]);
+        } else if ((arg == "-i" || arg == "--iterations") && hasValue) {
+            options.iterations = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--json" && hasValue) {
+            options.jsonPath = argv[++i];
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", arg.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool selected(const CodecOptions& options, const char* name) {
+    if (options.prefixes.empty()) return true;
+    for (const std::string& prefix : options.prefixes) {
+        if (strncmp(name, prefix.c_str(), prefix.size()) == 0) return true;
+    }
+    return false;
+}
+
+static void printResult(FILE* out, const cli::BenchResult& result) {
+    const double ops = static_cast<double>(kOpsPerIteration);
+    const double nsPerOp = result.p50Ns / ops;
+    const double size = result.bytesSentPerIteration / ops;
+    char allocs[32] = "-";
+    if (result.allocationsCounted) {
+        snprintf(allocs, sizeof(allocs), "%.1f", result.allocationsPerIteration / ops);
+    }
+    // Bytes per nanosecond is GB/s; report MB/s
+    double mbPerSecond = nsPerOp > 0 ? size / nsPerOp * 1000.0 : 0;
+    double mopsPerSecond = nsPerOp > 0 ? 1000.0 / nsPerOp : 0;
+    fprintf(out, "%-28s %-12s %5zu %9.1f %9.2f %9.1f %7.0f %9s\n",
+            result.name.c_str(), result.params.c_str(), result.failures,
+            nsPerOp, mopsPerSecond, mbPerSecond, size, allocs);
+}
+
+int main(int argc, char** argv) {
+    CodecOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        return 2;
+    }
+
+    NullLogger nullLogger;
+    g_logger = &nullLogger;
+
+    cli::BenchRegistry registry;
+    addMatchCodecs(registry);
+    addPlayerCodecs(registry);
+    addQuickdrawCodecs(registry);
+    addHandshakeCodecs(registry);
+    addChainAnnouncementCodecs(registry);
+    addShootoutBracketCodecs(registry);
+    addFragmentCodecs(registry);
+
+    if (options.list) {
+        for (const auto& scenario : registry.getScenarios()) {
+            printf("%-28s %-12s %s\n", scenario->getName(), scenario->getParams().c_str(),
+                   scenario->getDescription());
+        }
+        return 0;
+    }
+
+    // With the JSON on stdout, keep the table out of its way
+    FILE* table = options.jsonPath == "-" ? stderr : stdout;
+    std::vector<cli::BenchResult> results;
+    bool failed = false;
+    fprintf(table, "%-28s %-12s %5s %9s %9s %9s %7s %9s\n", "scenario", "params", "fail",
+            "p50 ns/op", "Mops/s", "MB/s", "bytes", "allocs/op");
+    for (const auto& scenario : registry.getScenarios()) {
+        if (!selected(options, scenario->getName())) continue;
+        cli::BenchResult result;
+        if (!cli::runBenchScenario(*scenario, options.iterations, readAllocations, result)) {
+            fprintf(stderr, "%s: setup failed\n", scenario->getName());
+            failed = true;
+            continue;
+        }
+        printResult(table, result);
+        fflush(table);
+        failed = failed || result.failures > 0;
+        results.push_back(result);
+    }
+    if (results.empty()) {
+        fprintf(stderr, "No scenario matches (see --list)\n");
+        return 2;
+    }
+
+    if (!options.jsonPath.empty()) {
+        std::string json = cli::formatBenchJson(results);
+        if (options.jsonPath == "-") {
+            printf("%s\n", json.c_str());
+        } else {
+            FILE* file = fopen(options.jsonPath.c_str(), "w");
+            if (file == nullptr) {
+                fprintf(stderr, "Cannot write %s\n", options.jsonPath.c_str());
+                return 2;
+            }
+            fprintf(file, "%s\n", json.c_str());
+            fclose(file);
+        }
+    }
+
+    return failed ? 1 : 0;
+}
+
+#endif // NATIVE_BUILD && CODEC_BENCH_BUILD
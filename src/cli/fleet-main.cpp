@@ -0,0 +1,343 @@
+#if defined(NATIVE_BUILD) && defined(FLEET_BUILD)
+
+/**
+ * Headless Fleet Simulator
+ *
+ * Runs hundreds of simulated PDNs against NativePeerBroker and
+ * SerialCableBroker with no terminal UI, driven by a behavior script, and
+ * reports what the fleet cost: wall time per tick, resident memory per
+ * device, and ESP-NOW traffic by packet type.
+ *
+ * Time is virtual unless --realtime is given: each tick jumps to the next
+ * timer deadline, packet delivery or script step, so a run takes as long as
+ * the CPU needs and the same seed gives the same run.
+ *
+ * Build:  pio run -e native_fleet
+ * Run:    .pio/build/native_fleet/program -n 300 --duration 120 --script duels.txt
+ */
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+
+#include "utils/simple-timer.hpp"
+#include "id-generator.hpp"
+
+#include "cli/cli-device.hpp"
+#include "cli/cli-commands.hpp"
+#include "cli/cli-fleet.hpp"
+#include "game/quickdraw-states.hpp"
+
+#include "device/drivers/native/native-logger-driver.hpp"
+#include "device/drivers/native/native-clock-driver.hpp"
+#include "device/drivers/native/native-peer-broker.hpp"
+#include "device/drivers/native/native-virtual-clock.hpp"
+
+static constexpr int MAX_FLEET_DEVICES = 4096;
+
+// Used when no --script is given: every hunter cables up to the bounty next
+// to it, everyone taps the primary button now and then, and the cables come
+// out and go back in every half minute so duels keep starting.
+static const char* const DEFAULT_SCRIPT[] = {
+    "at 1000 cable {dev} {mate}",
+    "every 700 from 2000 b {dev}",
+    "every 30000 from 25000 cable -d {dev} {mate}",
+    "every 30000 from 27000 cable {dev} {mate}",
+};
+
+std::atomic<bool> g_running{true};
+
+void signalHandler(int signal) {
+    (void)signal;
+    g_running = false;
+}
+
+struct FleetOptions {
+    int deviceCount = 300;
+    unsigned long durationMs = 60000;
+    unsigned long tickMs = 33;          // the interactive CLI's frame time
+    bool realtime = false;
+    unsigned long reportMs = 10000;
+    std::string scriptPath;
+    uint32_t seed = 1;
+};
+
+static void printUsage(const char* program) {
+    printf("PDN Fleet Simulator (headless)\n");
+    printf("Usage: %s [options]\n\n", program);
+    printf("Options:\n");
+    printf("  -n, --count N       Simulate N devices, alternating hunter/bounty (default 300, max %d)\n",
+           MAX_FLEET_DEVICES);
+    printf("  -d, --duration S    Run for S seconds (default 60)\n");
+    printf("  -t, --tick MS       Tick period in ms (default 33). In virtual time the longest\n");
+    printf("                      jump between ticks, 0 for none; in real time 0 runs flat out\n");
+    printf("      --realtime      Run on the wall clock instead of virtual time\n");
+    printf("  -s, --script FILE   Behavior script (see CLI_README.md)\n");
+    printf("  -r, --report S      Progress line every S seconds, 0 for none (default 10)\n");
+    printf("      --seed N        Seed for IDs and ESP-NOW impairments (default 1)\n");
+    printf("  -h, --help          Show this help message\n");
+}
+
+// False on a bad option; the caller exits
+static bool parseArgs(int argc, char** argv, FleetOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            exit(0);
+        } else if ((arg == "-n" || arg == "--count") && hasValue) {
+            options.deviceCount = std::atoi(argv[++i]);
+        } else if ((arg == "-d" || arg == "--duration") && hasValue) {
+            options.durationMs = std::strtoul(argv[++i], nullptr, 10) * 1000;
+        } else if ((arg == "-t" || arg == "--tick") && hasValue) {
+            options.tickMs = std::strtoul(argv[++i], nullptr, 10);
+        } else if ((arg == "-s" || arg == "--script") && hasValue) {
+            options.scriptPath = argv[++i];
+        } else if ((arg == "-r" || arg == "--report") && hasValue) {
+            options.reportMs = std::strtoul(argv[++i], nullptr, 10) * 1000;
+        } else if (arg == "--realtime") {
+            options.realtime = true;
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", arg.c_str());
+            return false;
+        }
+    }
+    if (options.deviceCount < 1 || options.deviceCount > MAX_FLEET_DEVICES) {
+        fprintf(stderr, "Device count must be 1-%d\n", MAX_FLEET_DEVICES);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Peak resident set size in KB. Growth across device creation is what the
+ * devices cost, since nothing is freed while they're built.
+ */
+static long peakResidentKb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;      // bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+static double processCpuMs() {
+    return 1000.0 * std::clock() / CLOCKS_PER_SEC;
+}
+
+static void printTraffic(const TrafficStats::Snapshot& traffic, int deviceCount, double seconds) {
+    TrafficCounters tx = traffic.total(TrafficDirection::kTx);
+    TrafficCounters rx = traffic.total(TrafficDirection::kRx);
+    printf("\n=== ESP-NOW Traffic (all devices) ===\n");
+    printf("Tx:           %lu frames, %lu bytes, %lu failed, est. air %llu ms\n",
+           (unsigned long)tx.frames, (unsigned long)tx.bytes, (unsigned long)tx.failures,
+           estimateAirtimeUs(tx) / 1000);
+    printf("Rx:           %lu frames, %lu bytes, %lu dropped\n",
+           (unsigned long)rx.frames, (unsigned long)rx.bytes, (unsigned long)rx.failures);
+    if (seconds > 0) {
+        // One shared channel: the whole fleet's airtime comes out of one budget
+        printf("Channel use:  %.1f%% (%.1f tx frames/s/device)\n",
+               100.0 * estimateAirtimeUs(tx) / (seconds * 1e6),
+               tx.frames / seconds / deviceCount);
+    }
+    char row[160];
+    for (size_t i = 0; i < TrafficStats::kNumTypes; i++) {
+        if (traffic.tx[i].frames == 0 && traffic.rx[i].frames == 0) continue;
+        formatTrafficRow(traffic, static_cast<PktType>(i), row, sizeof(row));
+        printf("  %s\n", row);
+    }
+}
+
+int main(int argc, char** argv) {
+    FleetOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        return 2;
+    }
+
+    cli::FleetScript script;
+    std::string error;
+    if (!options.scriptPath.empty()) {
+        if (!script.load(options.scriptPath, error)) {
+            fprintf(stderr, "%s\n", error.c_str());
+            return 2;
+        }
+    } else {
+        for (const char* line : DEFAULT_SCRIPT) {
+            script.addLine(line, error);
+        }
+    }
+
+    signal(SIGINT, signalHandler);
+    signal(SIGTERM, signalHandler);
+
+    // The virtual clock starts clear of zero, which some state reads as "never"
+    NativeVirtualClock* virtualClock = nullptr;
+    PlatformClockDriverInterface* globalClock = nullptr;
+    if (options.realtime) {
+        globalClock = new NativeClockDriver("global_clock");
+    } else {
+        virtualClock = new NativeVirtualClock("global_clock", 1000);
+        globalClock = virtualClock;
+    }
+    NativeLoggerDriver* globalLogger = new NativeLoggerDriver("global_logger");
+    globalLogger->setSuppressOutput(getenv("PDN_CLI_LOG_FILE") == nullptr);
+    g_logger = globalLogger;
+    SimpleTimer::setPlatformClock(globalClock);
+    IdGenerator::initialize(options.seed);
+    NativePeerBroker::getInstance().seedLinkImpairments(options.seed);
+
+    fprintf(stderr, "Creating %d devices...\n", options.deviceCount);
+    long rssBeforeKb = peakResidentKb();
+    auto createStart = std::chrono::steady_clock::now();
+    std::vector<cli::DeviceInstance> devices;
+    devices.reserve(options.deviceCount);
+    for (int i = 0; i < options.deviceCount; i++) {
+        // Even devices hunt, odd ones are bounties, so {dev} and {mate}
+        // cable PRIMARY to PRIMARY
+        devices.push_back(cli::DeviceFactory::createDevice(i, i % 2 == 0));
+    }
+    double createMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - createStart).count();
+    long rssAfterKb = peakResidentKb();
+
+    cli::CommandProcessor commandProcessor;
+    cli::Renderer renderer;     // never drawn; commands that tweak it are harmless
+    int selectedDevice = 0;
+    uint64_t commandsRun = 0;
+    uint64_t stateChanges = 0;
+    uint64_t duelsFinished = 0;
+    std::vector<int> lastState(devices.size(), -1);
+    cli::FleetTickStats ticks;
+
+    fprintf(stderr, "Running %lu s of %s time, %lu ms ticks, %zu script steps (Ctrl+C stops early)\n",
+            options.durationMs / 1000, options.realtime ? "real" : "virtual", options.tickMs,
+            script.getStepCount());
+
+    const auto runStart = std::chrono::steady_clock::now();
+    const double cpuStartMs = processCpuMs();
+    const unsigned long startMs = globalClock->milliseconds();
+    script.start(devices.size(), startMs);
+    unsigned long nextReportMs = options.reportMs;
+    unsigned long elapsedMs = 0;
+
+    while (g_running && elapsedMs < options.durationMs) {
+        const auto tickStart = std::chrono::steady_clock::now();
+
+        commandsRun += script.runDue(globalClock->milliseconds(), [&](const std::string& command) {
+            commandProcessor.execute(command, devices, selectedDevice, renderer);
+        });
+
+        NativePeerBroker::getInstance().deliverPackets();
+        cli::SerialCableBroker::getInstance().transferData();
+        for (size_t i = 0; i < devices.size(); i++) {
+            devices[i].pdn->loop();
+            State* state = devices[i].game->getCurrentState();
+            int stateId = state ? state->getStateId() : -1;
+            if (stateId != lastState[i]) {
+                stateChanges++;
+                if (stateId == WIN || stateId == LOSE) duelsFinished++;
+                lastState[i] = stateId;
+            }
+        }
+
+        const auto tickEnd = std::chrono::steady_clock::now();
+        uint32_t tickUs = static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(tickEnd - tickStart).count());
+        bool overran = options.realtime && options.tickMs > 0 && tickUs > options.tickMs * 1000;
+        ticks.record(tickUs, overran);
+
+        if (virtualClock != nullptr) {
+            unsigned long dueMs = 0;
+            if (script.getNextDueMs(dueMs)) {
+                virtualClock->schedule(dueMs);
+            }
+            virtualClock->advanceWithBroker(options.tickMs);
+        } else if (options.tickMs > 0 && !overran) {
+            std::this_thread::sleep_until(tickStart + std::chrono::milliseconds(options.tickMs));
+        }
+
+        elapsedMs = globalClock->milliseconds() - startMs;
+        if (options.reportMs > 0 && elapsedMs >= nextReportMs) {
+            fprintf(stderr, "[%5lus] ticks %zu mean %u us p99 %u us overruns %u, duels %llu\n",
+                    elapsedMs / 1000, ticks.getTicks(), ticks.meanUs(), ticks.percentileUs(99),
+                    ticks.getOverruns(), (unsigned long long)duelsFinished);
+            nextReportMs += options.reportMs;
+        }
+    }
+
+    const double cpuMs = processCpuMs() - cpuStartMs;
+    const double simSeconds = elapsedMs / 1000.0;
+    const double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+
+    TrafficStats::Snapshot traffic;
+    TrafficStats::Snapshot deviceTraffic;
+    for (auto& device : devices) {
+        device.peerCommsDriver->getTrafficSnapshot(deviceTraffic);
+        cli::addTrafficSnapshot(traffic, deviceTraffic);
+    }
+    std::map<std::string, int> stateCounts;
+    for (auto& device : devices) {
+        State* state = device.game->getCurrentState();
+        stateCounts[cli::getStateName(state ? state->getStateId() : -1)]++;
+    }
+
+    printf("=== Fleet Simulation Results ===\n");
+    printf("Devices:      %d (%zu cabled pairs at exit)\n", options.deviceCount,
+           cli::SerialCableBroker::getInstance().getConnectionCount());
+    printf("Run time:     %.1f s %s time in %.1f s wall, %zu ticks\n", simSeconds,
+           options.realtime ? "real" : "virtual", wallSeconds, ticks.getTicks());
+    printf("Setup:        %.1f ms (%.3f ms/device)\n", createMs, createMs / options.deviceCount);
+    printf("Memory:       %ld KB peak RSS, ~%.1f KB/device\n", rssAfterKb,
+           static_cast<double>(rssAfterKb - rssBeforeKb) / options.deviceCount);
+
+    printf("\n=== Tick Cost ===\n");
+    printf("Mean:         %u us (%.2f us/device)\n", ticks.meanUs(),
+           static_cast<double>(ticks.meanUs()) / options.deviceCount);
+    printf("p50/p99/max:  %u / %u / %u us\n", ticks.percentileUs(50), ticks.percentileUs(99),
+           ticks.percentileUs(100));
+    if (options.realtime && options.tickMs > 0) {
+        printf("Overruns:     %u of %zu ticks over %lu ms\n", ticks.getOverruns(), ticks.getTicks(),
+               options.tickMs);
+    }
+    if (wallSeconds > 0) {
+        printf("CPU:          %.0f ms (%.1f%% of one core)\n", cpuMs, 100.0 * cpuMs / (wallSeconds * 1000));
+    }
+
+    printf("\n=== Game ===\n");
+    printf("Commands run: %llu\n", (unsigned long long)commandsRun);
+    printf("State changes: %llu, duels finished: %llu\n", (unsigned long long)stateChanges,
+           (unsigned long long)duelsFinished);
+    for (const auto& [name, count] : stateCounts) {
+        printf("  %-22s %d\n", name.c_str(), count);
+    }
+
+    printTraffic(traffic, options.deviceCount, simSeconds);
+    printf("Broker:       %lu transmissions, %lu oversize refused, %zu pending\n",
+           (unsigned long)NativePeerBroker::getInstance().getFramesSent(),
+           (unsigned long)NativePeerBroker::getInstance().getOversizeFrameCount(),
+           NativePeerBroker::getInstance().getPendingPacketCount());
+
+    for (auto& device : devices) {
+        cli::DeviceFactory::destroyDevice(device);
+    }
+    SimpleTimer::setPlatformClock(nullptr);
+    delete globalLogger;
+    delete globalClock;
+
+    return 0;
+}
+
+#endif // NATIVE_BUILD && FLEET_BUILD
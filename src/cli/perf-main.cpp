@@ -1,42 +1,79 @@
 #if defined(NATIVE_BUILD) && defined(PERF_BUILD)
 
 /**
- * Duel Performance Harness
+ * Scenario Benchmark Harness
  *
- * Runs a large volume of complete hunter-vs-bounty duel cycles using only the
- * business logic layer. No GoogleTest, no GMock, no rendering, no I/O in the hot
- * path. Stubs satisfy every interface with no-op or minimal implementations.
+ * A registry of benchmarks over the business logic, each timed per
+ * iteration and summarized as p50/p95/p99 latency, heap allocations and
+ * bytes put on the wire. Results print as a table, and with --json as a
+ * machine-readable report to diff a release against the stored baseline.
+ *
+ *   duel              Two-device quickdraw match logic on no-op stubs
+ *   match-storage     Fill match storage, serialize it and upload it
+ *   duel-tick         One loop of a cabled pair waiting in DUEL; must not allocate
+ *   serial-handshake  Two PDNs cabled until both ports report CONNECTED
+ *   rdc-convergence   A hunter line cabled until every device reaches every other
+ *   chain-duel        A champion with N supporters duels a bounty to a result
+ *   shootout          A ring of N hunters plays a full tournament
+ *
+ * The multi-device scenarios run complete simulated PDNs on the native
+ * drivers and brokers, stepped on a fixed-step clock, so no logging and no
+ * sleeping ends up in the profile. Allocations come from utils/alloc-tracker;
+ * --regions breaks them down by ALLOC_REGION.
  *
  * Build:  pio run -e native_perf
- * Run:    .pio/build/native_perf/program [NUM_DUELS]
+ * Run:    .pio/build/native_perf/program [--scenario NAME] [--json FILE]
  * Profile:
  *   valgrind --tool=callgrind --callgrind-out-file=callgrind.out \
- *     .pio/build/native_perf/program 50000
+ *     .pio/build/native_perf/program --scenario duel -i 50000
  *   callgrind_annotate --auto=yes callgrind.out > callgrind_report.txt
  */
 
+#include <cctype>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <cstdarg>
-#include <chrono>
 #include <functional>
+#include <memory>
 #include <string>
 #include <random>
+#include <vector>
 
 #include "device/drivers/logger.hpp"
 #include "device/drivers/platform-clock.hpp"
 #include "device/drivers/peer-comms-interface.hpp"
 #include "device/drivers/storage-interface.hpp"
 #include "device/drivers/http-client-interface.hpp"
+#include "device/drivers/native/native-http-client-driver.hpp"
+#include "device/drivers/native/native-peer-broker.hpp"
+#include "device/drivers/native/native-prefs-driver.hpp"
 #include "device/wireless-manager.hpp"
+#include "utils/alloc-tracker.hpp"
 #include "utils/simple-timer.hpp"
 #include "id-generator.hpp"
 #include "game/player.hpp"
 #include "game/match-manager.hpp"
 #include "game/match.hpp"
+#include "game/quickdraw-requests.hpp"
+#include "game/quickdraw-states.hpp"
 #include "wireless/quickdraw-wireless-manager.hpp"
 
+#include "cli/cli-bench.hpp"
+#include "cli/cli-device.hpp"
+
+// ============================================================
+// Allocation counting — utils/alloc-tracker hooks operator new
+// ============================================================
+
+static cli::BenchAllocations readAllocations() {
+    AllocationCounts totals = AllocationTracker::getTotals();
+    cli::BenchAllocations allocations;
+    allocations.count = totals.allocations;
+    allocations.bytes = totals.bytes;
+    return allocations;
+}
+
 // ============================================================
 // Null logger — suppresses all LOG_* output in the hot path
 // ============================================================
@@ -66,21 +103,29 @@ public:
 class StubPeerComms : public PeerCommsInterface {
 public:
     int sendData(const uint8_t*, PktType,
-                 const uint8_t*, const size_t) override { return 1; }
+                 const uint8_t*, const size_t length) override {
+        bytesSent_ += length;
+        return 1;
+    }
     void setPacketHandler(PktType, PacketCallback, void*) override {}
     void clearPacketHandler(PktType) override {}
     const uint8_t* getGlobalBroadcastAddress() override { return broadcast_; }
     uint8_t* getMacAddress() override { return mac_; }
     void removePeer(uint8_t*) override {}
+    int addEspNowPeer(const uint8_t*) override { return 0; }
+    int removeEspNowPeer(const uint8_t*) override { return 0; }
     void setPeerCommsState(PeerCommsState) override {}
     PeerCommsState getPeerCommsState() override {
         return PeerCommsState::CONNECTED;
     }
     void connect() override {}
     void disconnect() override {}
+
+    uint64_t getBytesSent() const { return bytesSent_; }
 private:
     uint8_t mac_[6] = {0};
     uint8_t broadcast_[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    uint64_t bytesSent_ = 0;
 };
 
 class StubStorage : public StorageInterface {
@@ -112,27 +157,29 @@ private:
     uint8_t mac_[6] = {0};
 };
 
-// Build a QuickdrawPacket (the real wire format) carrying a player's draw result.
-static QuickdrawPacket makeDrawResultPacket(const std::optional<Match>& match,
-                                            bool senderIsHunter,
-                                            const char* senderId) {
-    QuickdrawPacket p = {};
-    strncpy(p.matchId,  match->getMatchId(), sizeof(p.matchId) - 1);
-    strncpy(p.playerId, senderId,            sizeof(p.playerId) - 1);
-    p.isHunter       = senderIsHunter;
-    p.playerDrawTime = senderIsHunter ? match->getHunterDrawTime()
-                                      : match->getBountyDrawTime();
-    p.command        = QDCommand::DRAW_RESULT;
-    return p;
+// Vouches for every sender, as if each were cabled straight to this device.
+class StubRdc : public RemoteDeviceCoordinator {
+public:
+    bool isDirectPeer(const uint8_t*) const override { return true; }
+};
+
+// Encode a player's draw result in the real wire format.
+static size_t makeDrawResultPacket(const std::optional<Match>& match,
+                                   bool senderIsHunter,
+                                   const char* senderId,
+                                   uint8_t* out) {
+    QuickdrawCommand command(nullptr, QDCommand::DRAW_RESULT, match->getMatchId(), senderId,
+                             senderIsHunter ? match->getHunterDrawTime()
+                                            : match->getBountyDrawTime(),
+                             senderIsHunter);
+    return encodeQuickdrawPacket(command, out);
 }
 
 static void deliver(QuickdrawWirelessManager* target,
                     const uint8_t mac[6],
-                    QuickdrawPacket& pkt) {
-    target->processQuickdrawCommand(
-        mac,
-        reinterpret_cast<const uint8_t*>(&pkt),
-        sizeof(pkt));
+                    const uint8_t* pkt,
+                    size_t pktLen) {
+    target->processQuickdrawCommand(mac, pkt, pktLen);
 }
 
 // ============================================================
@@ -141,26 +188,29 @@ static void deliver(QuickdrawWirelessManager* target,
 
 struct DeviceCtx {
     StubPeerComms    peerComms;
-    StubStorage      storage;
-    StubHttpClient   httpClient;
+    StubStorage      stubStorage;
+    StubHttpClient   stubHttpClient;
+    StubRdc          rdc;
+    StorageInterface*    storage    = &stubStorage;
+    HttpClientInterface* httpClient = &stubHttpClient;
     WirelessManager* wirelessMgr   = nullptr;
     QuickdrawWirelessManager* qdWireless = nullptr;
     MatchManager*    matchMgr       = nullptr;
     Player           player;
 
-    void init(const char* userId, bool isHunter, const char* opponentMac) {
+    void init(const char* userId, bool isHunter) {
         char id[5];
         strncpy(id, userId, 4); id[4] = '\0';
         player.setUserID(id);
         player.setIsHunter(isHunter);
-        player.setOpponentMacAddress(opponentMac);
 
-        wirelessMgr = new WirelessManager(&peerComms, &httpClient);
+        wirelessMgr = new WirelessManager(&peerComms, httpClient);
         qdWireless  = new QuickdrawWirelessManager();
         matchMgr    = new MatchManager();
 
         qdWireless->initialize(&player, wirelessMgr, /*broadcastCooldown=*/0);
-        matchMgr->initialize(&player, &storage, qdWireless);
+        matchMgr->initialize(&player, storage, qdWireless);
+        matchMgr->setRemoteDeviceCoordinator(&rdc);
     }
 
     void armCallback() {
@@ -173,130 +223,887 @@ struct DeviceCtx {
         delete matchMgr;
         delete qdWireless;
         delete wirelessMgr;
+        matchMgr = nullptr;
+        qdWireless = nullptr;
+        wirelessMgr = nullptr;
     }
 };
 
+static const uint8_t kHunterMac[6] = {0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA};
+static const uint8_t kBountyMac[6] = {0xBB, 0xBB, 0xBB, 0xBB, 0xBB, 0xBB};
+
 // ============================================================
-// Main
+// duel — hunter-vs-bounty match logic, one cycle per iteration
 // ============================================================
 
-int main(int argc, char** argv) {
-    long numDuels = 10000;
-    if (argc >= 2) {
-        numDuels = atol(argv[1]);
-        if (numDuels < 1) numDuels = 1;
-    }
-
-    // Silence all LOG_* calls — prevents printf/stream overhead from
-    // drowning out the business-logic signal in the profile.
-    NullLogger nullLogger;
-    g_logger = &nullLogger;
-
-    StepClock clock;
-    SimpleTimer::setPlatformClock(&clock);
-
-    // Initialize the ID generator singleton with a fixed seed for reproducibility
-    IdGenerator::initialize(42);
-
-    DeviceCtx hunter, bounty;
-    hunter.init("hunt", true,  "BB:BB:BB:BB:BB:BB");
-    bounty.init("boun", false, "AA:AA:AA:AA:AA:AA");
-
-    const uint8_t kHunterMac[6] = {0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA};
-    const uint8_t kBountyMac[6] = {0xBB, 0xBB, 0xBB, 0xBB, 0xBB, 0xBB};
-
-    // Wire each device's wireless manager to its own MatchManager callback
-    hunter.armCallback();
-    bounty.armCallback();
-
-    long hunterWins = 0, bountyWins = 0, errors = 0;
+class DuelScenario : public cli::BenchScenario {
+public:
+    explicit DuelScenario(StepClock& clock) : clock_(clock) {}
 
-    fprintf(stderr, "Running %ld duel cycles (no logging)...\n", numDuels);
-    const auto wallStart = std::chrono::steady_clock::now();
+    const char* getName() const override { return "duel"; }
+    const char* getDescription() const override {
+        return "Two-device quickdraw match logic on no-op stubs";
+    }
+    size_t getDefaultIterations() const override { return 10000; }
 
-    std::mt19937 gen(std::random_device{}());
-    std::uniform_int_distribution<> dist(100, 1500);
+    bool setUp() override {
+        hunter_.init("hunt", true);
+        bounty_.init("boun", false);
+        // Wire each device's wireless manager to its own MatchManager callback
+        hunter_.armCallback();
+        bounty_.armCallback();
+        // Fixed seed, so every release presses the same buttons
+        gen_.seed(42);
+        return true;
+    }
 
-    // --------------------------------------------------------
-    // Hot loop — this is what the profiler should see
-    // --------------------------------------------------------
-    for (long i = 0; i < numDuels; ++i) {
+    bool runIteration() override {
         // Advance simulated time so each duel starts from a fresh baseline
-        clock.set(10000 + i * 5000UL);
-        const unsigned long duelStart = clock.time_ms;
+        clock_.advance(5000);
+        const unsigned long duelStart = clock_.time_ms;
 
         // Hunter initiates the match via the production path.
-        hunter.matchMgr->initializeMatch(const_cast<uint8_t*>(kBountyMac));
+        hunter_.matchMgr->initializeMatch(const_cast<uint8_t*>(kBountyMac));
 
         // Deliver SEND_MATCH_ID to bounty via listenForMatchEvents directly
         // (we're benchmarking match logic, not serialization overhead).
-        const char* matchId = hunter.matchMgr->getCurrentMatch()->getMatchId();
-        QuickdrawCommand sendMatchCmd(kBountyMac, QDCommand::SEND_MATCH_ID,
+        const char* matchId = hunter_.matchMgr->getCurrentMatch()->getMatchId();
+        QuickdrawCommand sendMatchCmd(kHunterMac, QDCommand::SEND_MATCH_ID,
                                       matchId, "hunt", 0, true);
-        bounty.matchMgr->listenForMatchEvents(sendMatchCmd);
+        bounty_.matchMgr->listenForMatchEvents(sendMatchCmd);
 
         // Deliver MATCH_ID_ACK back to hunter
-        QuickdrawCommand ackCmd(kHunterMac, QDCommand::MATCH_ID_ACK,
+        QuickdrawCommand ackCmd(kBountyMac, QDCommand::MATCH_ID_ACK,
                                 matchId, "boun", 0, false);
-        hunter.matchMgr->listenForMatchEvents(ackCmd);
+        hunter_.matchMgr->listenForMatchEvents(ackCmd);
 
-        hunter.matchMgr->setDuelLocalStartTime(duelStart);
-        bounty.matchMgr->setDuelLocalStartTime(duelStart);
+        hunter_.matchMgr->setDuelLocalStartTime(duelStart);
+        bounty_.matchMgr->setDuelLocalStartTime(duelStart);
 
-        const long hunterPress = dist(gen);
-        const long bountyPress = dist(gen);
+        const long hunterPress = dist_(gen_);
+        long bountyPress = dist_(gen_);
+        if (bountyPress == hunterPress) {
+            // A tie loses for both, which the winner check below would flag
+            bountyPress++;
+        }
 
-        clock.set(duelStart + hunterPress);
-        hunter.matchMgr->getDuelButtonPush()(hunter.matchMgr);
+        clock_.set(duelStart + hunterPress);
+        hunter_.matchMgr->getDuelButtonPush()(hunter_.matchMgr);
 
-        clock.set(duelStart + bountyPress);
-        bounty.matchMgr->getDuelButtonPush()(bounty.matchMgr);
+        clock_.set(duelStart + bountyPress);
+        bounty_.matchMgr->getDuelButtonPush()(bounty_.matchMgr);
 
         // Exchange draw results via wire-format packets through processQuickdrawCommand.
-        QuickdrawPacket hunterPkt = makeDrawResultPacket(
-            hunter.matchMgr->getCurrentMatch(), true, "hunt");
-        QuickdrawPacket bountyPkt = makeDrawResultPacket(
-            bounty.matchMgr->getCurrentMatch(), false, "boun");
-
-        deliver(bounty.qdWireless, kHunterMac, hunterPkt);
-        deliver(hunter.qdWireless, kBountyMac, bountyPkt);
-
-        // Sanity check: both sides must agree on the winner
-        const bool hw = hunter.matchMgr->didWin();
-        const bool bw = bounty.matchMgr->didWin();
-        if (hw == bw) {
-            ++errors;
+        uint8_t hunterPkt[QUICKDRAW_PACKET_MAX_LEN];
+        uint8_t bountyPkt[QUICKDRAW_PACKET_MAX_LEN];
+        size_t hunterLen = makeDrawResultPacket(
+            hunter_.matchMgr->getCurrentMatch(), true, "hunt", hunterPkt);
+        size_t bountyLen = makeDrawResultPacket(
+            bounty_.matchMgr->getCurrentMatch(), false, "boun", bountyPkt);
+
+        deliver(bounty_.qdWireless, kHunterMac, hunterPkt, hunterLen);
+        deliver(hunter_.qdWireless, kBountyMac, bountyPkt, bountyLen);
+
+        // Both sides must agree on the winner
+        const bool agreed = hunter_.matchMgr->didWin() != bounty_.matchMgr->didWin();
+
+        hunter_.matchMgr->clearCurrentMatch();
+        bounty_.matchMgr->clearCurrentMatch();
+        return agreed;
+    }
+
+    void tearDown() override {
+        hunter_.destroy();
+        bounty_.destroy();
+    }
+
+    uint64_t getBytesSent() const override {
+        return hunter_.peerComms.getBytesSent() + bounty_.peerComms.getBytesSent();
+    }
+
+private:
+    StepClock& clock_;
+    DeviceCtx hunter_, bounty_;
+    std::mt19937 gen_;
+    std::uniform_int_distribution<> dist_{100, 1500};
+};
+
+// ============================================================
+// match-storage — append a batch of finished matches, then upload
+// ============================================================
+
+class MatchStorageScenario : public cli::BenchScenario {
+public:
+    // A long night at a venue between two uploads
+    static constexpr int kMatchesPerUpload = 20;
+
+    explicit MatchStorageScenario(StepClock& clock)
+        : clock_(clock), prefs_("bench_prefs"), http_("bench_http") {}
+
+    const char* getName() const override { return "match-storage"; }
+    const char* getDescription() const override {
+        return "Store finished matches, serialize them and upload the batch";
+    }
+    std::string getParams() const override {
+        return "matches=" + std::to_string(kMatchesPerUpload);
+    }
+    size_t getDefaultIterations() const override { return 200; }
+
+    bool setUp() override {
+        http_.setMockServerEnabled(true);
+        http_.setConnected(true);
+        hunter_.storage = &prefs_;
+        hunter_.httpClient = &http_;
+        hunter_.init("hunt", true);
+        return true;
+    }
+
+    bool runIteration() override {
+        for (int i = 0; i < kMatchesPerUpload; i++) {
+            clock_.advance(5000);
+            hunter_.matchMgr->initializeMatch(const_cast<uint8_t*>(kBountyMac));
+            hunter_.matchMgr->setHunterDrawTime(200 + i);
+            hunter_.matchMgr->setBountyDrawTime(300 + i);
+            if (!hunter_.matchMgr->finalizeMatch()) {
+                return false;
+            }
+        }
+
+        // What UploadMatchesState does, with the mock server answering
+        std::string matchesJson = hunter_.matchMgr->toJson();
+        uploadedBytes_ += matchesJson.size();
+        bool uploaded = false;
+        QuickdrawRequests::updateMatches(
+            hunter_.wirelessMgr, matchesJson,
+            [&](const std::string&) {
+                hunter_.matchMgr->clearStorage();
+                uploaded = true;
+            },
+            [](const WirelessErrorInfo&) {});
+        http_.exec();
+        return uploaded && hunter_.matchMgr->getStoredMatchCount() == 0;
+    }
+
+    void tearDown() override {
+        hunter_.destroy();
+    }
+
+    uint64_t getBytesSent() const override {
+        return uploadedBytes_ + hunter_.peerComms.getBytesSent();
+    }
+
+private:
+    StepClock& clock_;
+    NativePrefsDriver prefs_;
+    NativeHttpClientDriver http_;
+    DeviceCtx hunter_;
+    uint64_t uploadedBytes_ = 0;
+};
+
+// ============================================================
+// Simulated PDNs for the multi-device scenarios
+// ============================================================
+
+/**
+ * Complete PDNs from cli::DeviceFactory on the native peer and cable
+ * brokers, stepped together on the shared StepClock. A device presses its
+ * primary button a little after it enters a state waiting for one (a duel,
+ * a supporter or shootout confirm), each device at its own delay so no
+ * two draws tie.
+ */
+class SimFleet {
+public:
+    // Coarser than any game timer cares about, fine enough that a draw
+    // lands within a step of when it was meant to
+    static constexpr unsigned long kStepMs = 10;
+
+    explicit SimFleet(StepClock& clock) : clock_(clock) {}
+
+    void create(const std::vector<bool>& isHunter) {
+        for (size_t i = 0; i < isHunter.size(); i++) {
+            devices_.push_back(cli::DeviceFactory::createDevice(static_cast<int>(i), isHunter[i]));
+        }
+        lastState_.assign(devices_.size(), -1);
+        pressAtMs_.assign(devices_.size(), 0);
+        seenMask_.assign(devices_.size(), 0);
+    }
+
+    void destroy() {
+        for (auto& device : devices_) {
+            cli::DeviceFactory::destroyDevice(device);
+        }
+        devices_.clear();
+    }
+
+    size_t size() const { return devices_.size(); }
+
+    cli::DeviceInstance& device(size_t index) { return devices_[index]; }
+
+    RemoteDeviceCoordinator* rdc(size_t index) {
+        return devices_[index].pdn->getRemoteDeviceCoordinator();
+    }
+
+    const uint8_t* mac(size_t index) {
+        return devices_[index].peerCommsDriver->getMacAddress();
+    }
+
+    int getState(size_t index) {
+        State* state = devices_[index].game->getCurrentState();
+        return state ? state->getStateId() : -1;
+    }
+
+    bool allInState(int stateId) {
+        for (size_t i = 0; i < devices_.size(); i++) {
+            if (getState(i) != stateId) return false;
+        }
+        return true;
+    }
+
+    // Whether `index` has been in `stateId` since the last clearSeen()
+    bool hasSeen(size_t index, int stateId) const {
+        return (seenMask_[index] >> stateId) & 1u;
+    }
+
+    void clearSeen() {
+        std::fill(seenMask_.begin(), seenMask_.end(), 0);
+    }
+
+    // Off leaves a duel waiting for a press until it times out
+    void setAutoPress(bool autoPress) {
+        autoPress_ = autoPress;
+    }
+
+    // Device a's output-side cable into device b, routed by role
+    void cable(size_t a, size_t b) {
+        cli::SerialCableBroker::getInstance().connect(static_cast<int>(a), static_cast<int>(b));
+    }
+
+    void unplug(size_t a, size_t b) {
+        cli::SerialCableBroker::getInstance().disconnect(static_cast<int>(a), static_cast<int>(b));
+    }
+
+    void unplugAll() {
+        for (size_t i = 0; i < devices_.size(); i++) {
+            cli::SerialCableBroker::getInstance().disconnectDevice(static_cast<int>(i));
+        }
+    }
+
+    void step() {
+        NativePeerBroker::getInstance().deliverPackets();
+        cli::SerialCableBroker::getInstance().transferData();
+        for (size_t i = 0; i < devices_.size(); i++) {
+            devices_[i].pdn->loop();
+            int stateId = getState(i);
+            if (stateId >= 0 && stateId < 64) {
+                seenMask_[i] |= uint64_t(1) << stateId;
+            }
+            if (stateId != lastState_[i]) {
+                lastState_[i] = stateId;
+                pressAtMs_[i] = autoPress_ && waitsForPress(stateId)
+                    ? clock_.time_ms + pressDelayMs(i) : 0;
+            }
+            if (pressAtMs_[i] != 0 && clock_.time_ms >= pressAtMs_[i]) {
+                pressAtMs_[i] = 0;
+                devices_[i].primaryButtonDriver->execCallback(ButtonInteraction::CLICK);
+            }
+        }
+        clock_.advance(kStepMs);
+    }
+
+    /**
+     * Step until `done` holds. False if `timeoutMs` of simulated time
+     * passes first.
+     */
+    bool runUntil(const std::function<bool()>& done, unsigned long timeoutMs) {
+        const unsigned long deadline = clock_.time_ms + timeoutMs;
+        while (!done()) {
+            if (clock_.time_ms >= deadline) return false;
+            step();
+        }
+        return true;
+    }
+
+    void run(unsigned long durationMs) {
+        runUntil([] { return false; }, durationMs);
+    }
+
+    uint64_t getBytesSent() const {
+        uint64_t bytes = 0;
+        TrafficStats::Snapshot traffic;
+        for (const auto& device : devices_) {
+            if (device.peerCommsDriver->getTrafficSnapshot(traffic)) {
+                bytes += traffic.total(TrafficDirection::kTx).bytes;
+            }
+        }
+        return bytes;
+    }
+
+    uint32_t getFramesSent(PktType type) const {
+        uint32_t frames = 0;
+        TrafficStats::Snapshot traffic;
+        for (const auto& device : devices_) {
+            if (device.peerCommsDriver->getTrafficSnapshot(traffic)) {
+                frames += traffic.get(TrafficDirection::kTx, type).frames;
+            }
+        }
+        return frames;
+    }
+
+private:
+    static bool waitsForPress(int stateId) {
+        return stateId == DUEL || stateId == SUPPORTER_READY || stateId == SHOOTOUT_PROPOSAL;
+    }
+
+    // Spaced wider than a step so no two devices draw on the same one
+    static unsigned long pressDelayMs(size_t index) {
+        return 40 + 17 * index;
+    }
+
+    StepClock& clock_;
+    std::vector<cli::DeviceInstance> devices_;
+    std::vector<int> lastState_;
+    std::vector<unsigned long> pressAtMs_;
+    std::vector<uint64_t> seenMask_;
+    bool autoPress_ = true;
+};
+
+/**
+ * Shared plumbing of the SimFleet scenarios. Iterations that outlast their
+ * simulated-time budget count as failures.
+ */
+class FleetScenario : public cli::BenchScenario {
+public:
+    explicit FleetScenario(StepClock& clock) : fleet_(clock) {}
+
+    uint64_t getBytesSent() const override {
+        return fleet_.getBytesSent();
+    }
+
+    void tearDown() override {
+        fleet_.unplugAll();
+        fleet_.destroy();
+    }
+
+protected:
+    // Long enough for a device to sleep off a finished duel (a minute)
+    static constexpr unsigned long kSettleTimeoutMs = 120000;
+
+    // Build the fleet and wait out the boot animation
+    bool createIdle(const std::vector<bool>& isHunter) {
+        fleet_.create(isHunter);
+        return fleet_.runUntil([this] { return fleet_.allInState(IDLE); }, kSettleTimeoutMs);
+    }
+
+    // Pull every cable and wait until the whole fleet is idle again
+    bool unplugAndSettle() {
+        fleet_.unplugAll();
+        return fleet_.runUntil([this] { return fleet_.allInState(IDLE); }, kSettleTimeoutMs);
+    }
+
+    bool reachesAll(size_t from) {
+        for (size_t to = 0; to < fleet_.size(); to++) {
+            if (to != from && !fleet_.rdc(from)->canReachPeer(fleet_.mac(to))) return false;
+        }
+        return true;
+    }
+
+    bool reachesNone(size_t from) {
+        for (size_t to = 0; to < fleet_.size(); to++) {
+            if (to != from && fleet_.rdc(from)->canReachPeer(fleet_.mac(to))) return false;
+        }
+        return true;
+    }
+
+    SimFleet fleet_;
+};
+
+// ============================================================
+// serial-handshake — hunter and bounty cabled until both ports connect
+// ============================================================
+
+class SerialHandshakeScenario : public FleetScenario {
+public:
+    using FleetScenario::FleetScenario;
+
+    const char* getName() const override { return "serial-handshake"; }
+    const char* getDescription() const override {
+        return "Cable two PDNs until both primary ports report CONNECTED";
+    }
+    size_t getDefaultIterations() const override { return 200; }
+
+    bool setUp() override {
+        return createIdle({true, false});
+    }
+
+    bool runIteration() override {
+        fleet_.cable(0, 1);
+        return fleet_.runUntil([this] {
+            return fleet_.rdc(0)->getPortStatus(SerialIdentifier::OUTPUT_JACK) == PortStatus::CONNECTED &&
+                   fleet_.rdc(1)->getPortStatus(SerialIdentifier::INPUT_JACK) == PortStatus::CONNECTED;
+        }, 5000);
+    }
+
+    void resetIteration() override {
+        unplugAndSettle();
+        fleet_.runUntil([this] {
+            return fleet_.rdc(0)->getPortStatus(SerialIdentifier::OUTPUT_JACK) == PortStatus::DISCONNECTED &&
+                   fleet_.rdc(1)->getPortStatus(SerialIdentifier::INPUT_JACK) == PortStatus::DISCONNECTED;
+        }, kSettleTimeoutMs);
+    }
+};
+
+// ============================================================
+// duel-tick — one loop of two PDNs waiting in DUEL, allocation-free
+// ============================================================
+
+class DuelTickScenario : public FleetScenario {
+public:
+    using FleetScenario::FleetScenario;
+
+    const char* getName() const override { return "duel-tick"; }
+    const char* getDescription() const override {
+        return "One steady-state loop of a cabled pair waiting in DUEL";
+    }
+    size_t getDefaultIterations() const override { return 2000; }
+
+    // A tick in the middle of a duel must not touch the heap
+    long getAllocationBudget() const override { return 0; }
+
+    bool setUp() override {
+        if (!createIdle({true, false})) return false;
+        fleet_.setAutoPress(false);
+        return enterDuel();
+    }
+
+    bool runIteration() override {
+        fleet_.step();
+        ticks_++;
+        return inDuel();
+    }
+
+    // Start over well before the duel times out, so no timed tick leaves it
+    void resetIteration() override {
+        if (ticks_ >= kTicksPerDuel || !inDuel()) {
+            fleet_.unplug(0, 1);
+            if (unplugAndSettle()) {
+                enterDuel();
+            }
+        }
+        skipSerialTicks();
+    }
+
+    void tearDown() override {
+        fleet_.setAutoPress(true);
+        FleetScenario::tearDown();
+    }
+
+private:
+    // Duel::DUEL_TIMEOUT is 4 s, i.e. 400 steps
+    static constexpr size_t kTicksPerDuel = 300;
+
+    // Ticks run untimed after entering DUEL, so one-off setup isn't counted
+    static constexpr size_t kWarmUpTicks = 10;
+    static constexpr size_t kMaxSkippedTicks = 10;
+
+    bool inDuel() {
+        return fleet_.getState(0) == DUEL && fleet_.getState(1) == DUEL;
+    }
+
+    bool enterDuel() {
+        ticks_ = 0;
+        fleet_.cable(0, 1);
+        if (!fleet_.runUntil([this] { return inDuel(); }, 10000)) return false;
+        for (size_t i = 0; i < kWarmUpTicks; i++) {
+            fleet_.step();
+        }
+        skipSerialTicks();
+        return inDuel();
+    }
+
+    // A tick that receives a serial line (the cable heartbeat) allocates its
+    // string, on the device as here. That is the handshake's cost, not the
+    // duel's, so those ticks run untimed.
+    void skipSerialTicks() {
+        for (size_t i = 0; i < kMaxSkippedTicks && serialPending(); i++) {
+            fleet_.step();
+            ticks_++;
+        }
+    }
+
+    bool serialPending() {
+        return cli::SerialCableBroker::getInstance().hasPendingData();
+    }
+
+    size_t ticks_ = 0;
+};
+
+// ============================================================
+// rdc-convergence — a line of hunters until chain announcements settle
+// ============================================================
+
+class RdcConvergenceScenario : public FleetScenario {
+public:
+    RdcConvergenceScenario(StepClock& clock, size_t length)
+        : FleetScenario(clock), clock_(clock), length_(length) {}
+
+    const char* getName() const override { return "rdc-convergence"; }
+    const char* getDescription() const override {
+        return "Cable a line of hunters until every device reaches every other and announcements stop";
+    }
+    std::string getParams() const override {
+        return "devices=" + std::to_string(length_);
+    }
+    size_t getDefaultIterations() const override { return 50; }
+
+    bool setUp() override {
+        return length_ >= 2 && createIdle(std::vector<bool>(length_, true));
+    }
+
+    bool runIteration() override {
+        for (size_t i = 1; i < fleet_.size(); i++) {
+            fleet_.cable(i, i - 1);
+        }
+        bool reached = fleet_.runUntil([this] {
+            for (size_t i = 0; i < fleet_.size(); i++) {
+                if (!reachesAll(i)) return false;
+            }
+            return true;
+        }, 10000);
+        return reached && announcementsSettle();
+    }
+
+    void resetIteration() override {
+        unplugAndSettle();
+        fleet_.runUntil([this] {
+            for (size_t i = 0; i < fleet_.size(); i++) {
+                if (!reachesNone(i)) return false;
+            }
+            return true;
+        }, kSettleTimeoutMs);
+    }
+
+private:
+    // The longest retransmit timeout, so an unacked announcement shows up
+    static constexpr unsigned long kQuietMs = 2000;
+
+    // A line past the chain-peer cap reaches everyone but keeps announcing
+    // truncated peer lists forever; that counts as a failure, not a result.
+    bool announcementsSettle() {
+        uint32_t sent = fleet_.getFramesSent(PktType::kChainAnnouncement);
+        unsigned long quietSinceMs = clock_.time_ms;
+        return fleet_.runUntil([this, &sent, &quietSinceMs] {
+            uint32_t now = fleet_.getFramesSent(PktType::kChainAnnouncement);
+            if (now != sent) {
+                sent = now;
+                quietSinceMs = clock_.time_ms;
+            }
+            return clock_.time_ms - quietSinceMs >= kQuietMs;
+        }, 10000);
+    }
+
+    StepClock& clock_;
+    size_t length_;
+};
+
+// ============================================================
+// chain-duel — champion plus N supporters against one bounty
+// ============================================================
+
+class ChainDuelScenario : public FleetScenario {
+public:
+    ChainDuelScenario(StepClock& clock, size_t supporters)
+        : FleetScenario(clock), supporters_(supporters) {}
+
+    const char* getName() const override { return "chain-duel"; }
+    const char* getDescription() const override {
+        return "A champion and its supporters duel a bounty to a result";
+    }
+    std::string getParams() const override {
+        return "supporters=" + std::to_string(supporters_);
+    }
+    size_t getDefaultIterations() const override { return 50; }
+
+    // Device 0 is the champion, 1..N its supporters, the last the bounty.
+    // The supporter line stays cabled; each iteration plugs in the bounty.
+    bool setUp() override {
+        std::vector<bool> isHunter(supporters_ + 2, true);
+        isHunter.back() = false;
+        if (!createIdle(isHunter)) return false;
+        for (size_t i = 1; i <= supporters_; i++) {
+            fleet_.cable(i, i - 1);
+        }
+        return fleet_.runUntil([this] { return reachesHunters(); }, 10000);
+    }
+
+    bool runIteration() override {
+        const size_t bounty = fleet_.size() - 1;
+        fleet_.clearSeen();
+        fleet_.cable(0, bounty);
+        bool finished = fleet_.runUntil([this, bounty] {
+            return finishedDuel(0) && finishedDuel(bounty);
+        }, 30000);
+        // Exactly one side walks away the winner
+        return finished && fleet_.hasSeen(0, WIN) != fleet_.hasSeen(bounty, WIN);
+    }
+
+    void resetIteration() override {
+        const size_t bounty = fleet_.size() - 1;
+        fleet_.unplug(0, bounty);
+        fleet_.runUntil([this, bounty] {
+            return fleet_.getState(0) == IDLE && fleet_.getState(bounty) == IDLE;
+        }, kSettleTimeoutMs);
+    }
+
+private:
+    bool finishedDuel(size_t index) const {
+        return fleet_.hasSeen(index, WIN) || fleet_.hasSeen(index, LOSE);
+    }
+
+    // The bounty isn't cabled yet, so only the hunters need to see each other
+    bool reachesHunters() {
+        for (size_t to = 1; to + 1 < fleet_.size(); to++) {
+            if (!fleet_.rdc(0)->canReachPeer(fleet_.mac(to))) return false;
+        }
+        return true;
+    }
+
+    size_t supporters_;
+};
+
+// ============================================================
+// shootout — a ring of hunters plays a whole tournament
+// ============================================================
+
+class ShootoutScenario : public FleetScenario {
+public:
+    ShootoutScenario(StepClock& clock, size_t players)
+        : FleetScenario(clock), players_(players) {}
+
+    const char* getName() const override { return "shootout"; }
+    const char* getDescription() const override {
+        return "A ring of hunters plays a tournament to its final standings";
+    }
+    std::string getParams() const override {
+        return "players=" + std::to_string(players_);
+    }
+    size_t getDefaultIterations() const override { return 3; }
+
+    bool setUp() override {
+        return players_ >= 3 && players_ <= ShootoutManager::kMaxBracketSize &&
+               createIdle(std::vector<bool>(players_, true));
+    }
+
+    bool runIteration() override {
+        fleet_.clearSeen();
+        for (size_t i = 1; i < fleet_.size(); i++) {
+            fleet_.cable(i, i - 1);
+        }
+        fleet_.cable(0, fleet_.size() - 1);
+        return fleet_.runUntil([this] {
+            for (size_t i = 0; i < fleet_.size(); i++) {
+                if (!fleet_.hasSeen(i, SHOOTOUT_FINAL_STANDINGS)) return false;
+            }
+            return true;
+        }, 30 * 60 * 1000);
+    }
+
+    void resetIteration() override {
+        unplugAndSettle();
+    }
+
+private:
+    size_t players_;
+};
+
+// ============================================================
+// Main
+// ============================================================
+
+// Largest ring whose chain announcements settle. Past it, peer lists no longer
+// fit RemoteDeviceCoordinator's 18-peer cap per port and are re-announced
+// forever, a storm that hardware never gets to run into.
+constexpr size_t kMaxSettlingRing = 20;
+
+struct PerfOptions {
+    std::vector<std::string> scenarios;     // empty runs them all
+    size_t iterations = 0;                  // 0 for each scenario's default
+    size_t supporters = 3;
+    size_t players = kMaxSettlingRing;
+    size_t chainLength = 8;
+    std::string jsonPath;
+    bool list = false;
+    bool regions = false;
+};
+
+static void printUsage(const char* program) {
+    printf("PDN Scenario Benchmarks\n");
+    printf("Usage: %s [options] [ITERATIONS]\n\n", program);
+    printf("Options:\n");
+    printf("  -s, --scenario NAME   Run only NAME; repeat for more (default: all)\n");
+    printf("  -i, --iterations N    Iterations per scenario (default: per scenario)\n");
+    printf("      --supporters N    Supporters behind the chain-duel champion (default 3)\n");
+    printf("      --players N       Shootout ring size, 3-%d (default %zu; larger rings\n"
+           "                        never stop announcing chain peers)\n",
+           ShootoutManager::kMaxBracketSize, kMaxSettlingRing);
+    printf("      --chain N         rdc-convergence line length (default 8)\n");
+    printf("      --json FILE       Also write results as JSON, '-' for stdout\n");
+    printf("      --regions         Break each scenario's allocations down by ALLOC_REGION\n");
+    printf("  -l, --list            List scenarios and exit\n");
+    printf("  -h, --help            Show this help message\n");
+}
+
+// False on a bad option; the caller exits
+static bool parseArgs(int argc, char** argv, PerfOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            exit(0);
+        } else if (arg == "-l" || arg == "--list") {
+            options.list = true;
+        } else if (arg == "--regions") {
+            options.regions = true;
+        } else if ((arg == "-s" || arg == "--scenario") && hasValue) {
+            options.scenarios.push_back(argv[++i]);
+        } else if ((arg == "-i" || arg == "--iterations") && hasValue) {
+            options.iterations = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--supporters" && hasValue) {
+            options.supporters = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--players" && hasValue) {
+            options.players = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--chain" && hasValue) {
+            options.chainLength = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--json" && hasValue) {
+            options.jsonPath = argv[++i];
+        } else if (!arg.empty() && isdigit(static_cast<unsigned char>(arg[0]))) {
+            // Bare count, as the single-scenario harness took it
+            options.iterations = std::strtoul(arg.c_str(), nullptr, 10);
         } else {
-            hw ? ++hunterWins : ++bountyWins;
+            fprintf(stderr, "Unknown or incomplete option: %s\n", arg.c_str());
+            return false;
         }
+    }
+    return true;
+}
 
-        // Reset for next iteration
-        hunter.matchMgr->clearCurrentMatch();
-        bounty.matchMgr->clearCurrentMatch();
-    }
-    // --------------------------------------------------------
-
-    const auto wallEnd = std::chrono::steady_clock::now();
-    const double wallMs =
-        std::chrono::duration<double, std::milli>(wallEnd - wallStart).count();
-
-    fprintf(stderr, "\n=== Duel Simulation Results ===\n");
-    fprintf(stderr, "Duels run:    %ld\n",       numDuels);
-    fprintf(stderr, "Hunter wins:  %ld (%.1f%%)\n", hunterWins,
-            100.0 * hunterWins / numDuels);
-    fprintf(stderr, "Bounty wins:  %ld (%.1f%%)\n", bountyWins,
-            100.0 * bountyWins / numDuels);
-    fprintf(stderr, "Errors:       %ld\n",        errors);
-    fprintf(stderr, "Wall time:    %.2f ms\n",    wallMs);
-    fprintf(stderr, "Avg/duel:     %.4f ms\n",    wallMs / numDuels);
-    fprintf(stderr, "Throughput:   %.0f duels/s\n",
-            numDuels / (wallMs / 1000.0));
-
-    hunter.destroy();
-    bounty.destroy();
-    SimpleTimer::setPlatformClock(nullptr);
+static void printResult(FILE* out, const cli::BenchResult& result) {
+    char allocs[32] = "-";
+    if (result.allocationsCounted) {
+        snprintf(allocs, sizeof(allocs), "%.1f", result.allocationsPerIteration);
+    }
+    fprintf(out, "%-17s %-14s %7zu %5zu %11.1f %11.1f %11.1f %11s %11.1f\n",
+           result.name.c_str(), result.params.c_str(), result.iterations, result.failures,
+           result.p50Ns / 1000.0, result.p95Ns / 1000.0, result.p99Ns / 1000.0,
+           allocs, result.bytesSentPerIteration);
+}
+
+// Setup and resets included, since regions can't tell timed code from not
+static void printRegions(FILE* out) {
+    AllocationTracker::Region regions[AllocationTracker::kMaxRegions];
+    size_t count = AllocationTracker::getRegions(regions, AllocationTracker::kMaxRegions);
+    for (size_t i = 0; i < count; i++) {
+        const AllocationTracker::Region& region = regions[i];
+        double entries = region.entries ? static_cast<double>(region.entries) : 1.0;
+        fprintf(out, "  %-22s %10llu entries %9.2f allocs/entry %10.1f bytes/entry\n",
+                region.name, static_cast<unsigned long long>(region.entries),
+                region.counts.allocations / entries, region.counts.bytes / entries);
+    }
+}
+
+int main(int argc, char** argv) {
+    PerfOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        return 2;
+    }
+
+    // Silence all LOG_* calls — prevents printf/stream overhead from
+    // drowning out the business-logic signal in the profile.
+    NullLogger nullLogger;
+    g_logger = &nullLogger;
+
+    StepClock clock;
+    clock.set(10000);
+    SimpleTimer::setPlatformClock(&clock);
+
+    // Initialize the ID generator singleton with a fixed seed for reproducibility
+    IdGenerator::initialize(42);
+    NativePeerBroker::getInstance().seedLinkImpairments(42);
+
+    cli::BenchRegistry registry;
+    registry.add(std::make_unique<DuelScenario>(clock));
+    registry.add(std::make_unique<MatchStorageScenario>(clock));
+    registry.add(std::make_unique<DuelTickScenario>(clock));
+    registry.add(std::make_unique<SerialHandshakeScenario>(clock));
+    registry.add(std::make_unique<RdcConvergenceScenario>(clock, options.chainLength));
+    registry.add(std::make_unique<ChainDuelScenario>(clock, options.supporters));
+    registry.add(std::make_unique<ShootoutScenario>(clock, options.players));
+
+    if (options.list) {
+        for (const auto& scenario : registry.getScenarios()) {
+            printf("%-17s %s (%zu iterations)\n", scenario->getName(),
+                   scenario->getDescription(), scenario->getDefaultIterations());
+        }
+        return 0;
+    }
+
+    std::vector<cli::BenchScenario*> selected;
+    if (options.scenarios.empty()) {
+        for (const auto& scenario : registry.getScenarios()) {
+            selected.push_back(scenario.get());
+        }
+    }
+    for (const std::string& name : options.scenarios) {
+        cli::BenchScenario* scenario = registry.find(name);
+        if (scenario == nullptr) {
+            fprintf(stderr, "Unknown scenario: %s (see --list)\n", name.c_str());
+            return 2;
+        }
+        selected.push_back(scenario);
+    }
 
-    return errors > 0 ? 1 : 0;
+    // With the JSON on stdout, keep the table out of its way
+    FILE* table = options.jsonPath == "-" ? stderr : stdout;
+    std::vector<cli::BenchResult> results;
+    bool failed = false;
+    fprintf(table, "%-17s %-14s %7s %5s %11s %11s %11s %11s %11s\n", "scenario", "params", "iters",
+           "fail", "p50 us", "p95 us", "p99 us", "allocs/it", "bytes/it");
+    for (cli::BenchScenario* scenario : selected) {
+        fprintf(stderr, "Running %s...\n", scenario->getName());
+        cli::BenchResult result;
+        AllocationTracker::resetRegions();
+        if (!cli::runBenchScenario(*scenario, options.iterations, readAllocations, result)) {
+            fprintf(stderr, "%s: setup failed\n", scenario->getName());
+            scenario->tearDown();
+            failed = true;
+            continue;
+        }
+        printResult(table, result);
+        if (options.regions) {
+            printRegions(table);
+        }
+        fflush(table);
+        failed = failed || result.failures > 0;
+        results.push_back(result);
+    }
+
+    if (!options.jsonPath.empty()) {
+        std::string json = cli::formatBenchJson(results);
+        if (options.jsonPath == "-") {
+            printf("%s\n", json.c_str());
+        } else {
+            FILE* file = fopen(options.jsonPath.c_str(), "w");
+            if (file == nullptr) {
+                fprintf(stderr, "Cannot write %s\n", options.jsonPath.c_str());
+                return 2;
+            }
+            fprintf(file, "%s\n", json.c_str());
+            fclose(file);
+        }
+    }
+
+    SimpleTimer::setPlatformClock(nullptr);
+    return failed ? 1 : 0;
 }
 
 #endif // NATIVE_BUILD && PERF_BUILD
@@ -7,6 +7,17 @@ ChainDuelManager::ChainDuelManager(Player* player, WirelessManager* wirelessMana
     this->player_ = player;
     this->wirelessManager_ = wirelessManager;
     this->rdc_ = rdc;
+    channel_.setRetransmitCallback(
+        [this](const uint8_t* peer, uint8_t seqId, uint8_t tag, uint32_t context) {
+            return retransmit(peer, seqId, tag, context);
+        });
+    channel_.setAbandonCallback(
+        [this](const uint8_t* peer, uint8_t seqId, uint8_t tag, uint32_t context) {
+            logAbandon(peer, seqId, tag, context);
+        });
+    if (wirelessManager_ != nullptr) {
+        wirelessManager_->bindLinkQuality(channel_);
+    }
 }
 
 SerialIdentifier ChainDuelManager::opponentJack() const {
@@ -22,14 +33,9 @@ std::optional<bool> ChainDuelManager::peerIsHunter(SerialIdentifier port) const
 }
 
 bool ChainDuelManager::isLoop() const {
-    PortState oState = rdc_->getPortState(opponentJack());
-    PortState sState = rdc_->getPortState(supporterJack());
-    for (const auto& oPeer : oState.peerMacAddresses) {
-        for (const auto& sPeer : sState.peerMacAddresses) {
-            if (memcmp(oPeer.data(), sPeer.data(), 6) == 0) return true;
-        }
-    }
-    return false;
+    // Runs every Quickdraw tick; asks the RDC rather than copying both
+    // ports' peer lists out of it
+    return rdc_->portsSharePeer(opponentJack(), supporterJack());
 }
 
 bool ChainDuelManager::isSupporter() const {
@@ -60,11 +66,7 @@ std::vector<std::array<uint8_t, 6>> ChainDuelManager::getSupporterChainPeers() c
 }
 
 bool ChainDuelManager::isKnownGameEventSender(const uint8_t* fromMac) const {
-    PortState oState = rdc_->getPortState(opponentJack());
-    for (const auto& peer : oState.peerMacAddresses) {
-        if (memcmp(peer.data(), fromMac, 6) == 0) return true;
-    }
-    return false;
+    return rdc_->portHasPeer(opponentJack(), fromMac);
 }
 
 void ChainDuelManager::sendGameEventToSupporters(ChainGameEventType eventType) {
@@ -86,38 +88,50 @@ void ChainDuelManager::sendGameEventToSupporters(ChainGameEventType eventType) {
                      eventType == ChainGameEventType::LOSS);
 
     auto peers = getSupporterChainPeers();
+    if (peers.empty()) return;
+
+    // Untracked events are worthless once stale; let the driver drop them
+    // rather than deliver them late. With no ACKs to collect they go out
+    // as one multicast frame however long the chain is.
+    if (!wantsAck) {
+        ChainGameEventPayload payload{};
+        payload.event_type = static_cast<uint8_t>(eventType);
+        payload.seqId = 0;
+        SendOptions options = defaultSendOptions(PktType::kChainGameEvent);
+        options.maxAgeMs = kTransientEventMaxAgeMs;
+        const uint8_t* selfMac = wirelessManager_->getMacAddress();
+        if (selfMac != nullptr &&
+            wirelessManager_->sendEspNowMulticast(
+                supporterGroupFor(selfMac),
+                PktType::kChainGameEvent,
+                reinterpret_cast<const uint8_t*>(&payload),
+                sizeof(payload),
+                options) == 0) {
+            return;
+        }
+    }
+
     for (const auto& peerMac : peers) {
         ChainGameEventPayload payload{};
         payload.event_type = static_cast<uint8_t>(eventType);
         payload.seqId = 0;
 
         if (wantsAck) {
-            uint8_t seqId = nextGameEventSeqId_++;
-            if (nextGameEventSeqId_ == 0) nextGameEventSeqId_ = 1;
-            payload.seqId = seqId;
-
             // One pending per supporter; newest supersedes any prior.
-            for (auto it = pendingGameEvents_.begin(); it != pendingGameEvents_.end(); ++it) {
-                if (memcmp(it->targetMac.data(), peerMac.data(), 6) == 0) {
-                    pendingGameEvents_.erase(it);
-                    break;
-                }
-            }
-            PendingGameEvent pending;
-            pending.targetMac = peerMac;
-            pending.seqId = seqId;
-            pending.eventType = static_cast<uint8_t>(eventType);
-            pending.retries = 0;
-            pending.timer.setTimer(kAckTimeoutMs);
-            pendingGameEvents_.push_back(pending);
-            retryStats_.sends++;
+            payload.seqId = channel_.track(peerMac.data(), kGameEventTag,
+                                           static_cast<uint32_t>(eventType));
         }
 
+        SendOptions options = defaultSendOptions(PktType::kChainGameEvent);
+        if (!wantsAck) {
+            options.maxAgeMs = kTransientEventMaxAgeMs;
+        }
         wirelessManager_->sendEspNowData(
             peerMac.data(),
             PktType::kChainGameEvent,
             reinterpret_cast<const uint8_t*>(&payload),
-            sizeof(payload));
+            sizeof(payload),
+            options);
     }
 }
 
@@ -132,14 +146,7 @@ void ChainDuelManager::sendGameEventAck(const uint8_t* toMac, uint8_t seqId) {
 
 void ChainDuelManager::onChainGameEventAckReceived(const uint8_t* fromMac, uint8_t seqId) {
     if (fromMac == nullptr || seqId == 0) return;
-    for (auto it = pendingGameEvents_.begin(); it != pendingGameEvents_.end(); ++it) {
-        if (it->seqId == seqId && memcmp(it->targetMac.data(), fromMac, 6) == 0) {
-            retryStats_.ackLatencyMsSum += it->timer.getElapsedTime();
-            retryStats_.ackCount++;
-            pendingGameEvents_.erase(it);
-            return;
-        }
-    }
+    channel_.ack(fromMac, seqId, kGameEventTag);
 }
 
 void ChainDuelManager::sendConfirm() {
@@ -206,6 +213,7 @@ void ChainDuelManager::onChainStateChanged() {
             memcpy(selfArr.data(), selfMac, 6);
             if (!championMac_.has_value() || *championMac_ != selfArr) {
                 championMac_ = selfArr;
+                refreshSupporterGroup();
                 broadcastRoleAndChampion();
                 // Track that we just announced to our current supporter-jack peer.
                 const uint8_t* supporterPeer = rdc_->getPeerMac(supporterJack());
@@ -236,6 +244,7 @@ void ChainDuelManager::onChainStateChanged() {
         const uint8_t* selfMac = wirelessManager_->getMacAddress();
         if (selfMac != nullptr && memcmp(championMac_->data(), selfMac, 6) == 0) {
             championMac_.reset();
+            refreshSupporterGroup();
         }
     }
 
@@ -329,12 +338,13 @@ void ChainDuelManager::onRoleAnnounceReceived(
     if (!fromOpponentJack) return;
     if (role != (player_->isHunter() ? 1u : 0u)) return;
 
-    // 3. Register champion as ESP-NOW peer (only if it's not our own MAC).
+    // 3. Register champion as ESP-NOW peer (only if it's not our own MAC),
+    // pinned so a busy chain can't evict it from the peer table.
     const uint8_t* selfMac = wirelessManager_->getMacAddress();
     bool championIsSelf = (selfMac != nullptr &&
                            memcmp(selfMac, championMac, 6) == 0);
     if (!championIsSelf) {
-        rdc_->registerPeer(championMac);
+        rdc_->pinPeer(championMac);
     }
 
     // 4. Update championMac_ and cascade if changed. On change, release the
@@ -362,37 +372,51 @@ void ChainDuelManager::onRoleAnnounceReceived(
             }
             if (!oldStillInChain) {
                 rdc_->unregisterPeer(oldMac.data());
+            } else {
+                rdc_->unpinPeer(oldMac.data());
             }
         }
     }
     championMac_ = newMac;
     if (changed) {
+        refreshSupporterGroup();
         broadcastRoleAndChampion();
     }
 }
 
+void ChainDuelManager::refreshSupporterGroup() {
+    const uint8_t* selfMac = wirelessManager_->getMacAddress();
+    MulticastGroup wanted = NO_MULTICAST_GROUP;
+    if (championMac_.has_value() &&
+        (selfMac == nullptr || memcmp(championMac_->data(), selfMac, 6) != 0)) {
+        wanted = supporterGroupFor(championMac_->data());
+    }
+    if (wanted == joinedSupporterGroup_) return;
+    if (joinedSupporterGroup_ != NO_MULTICAST_GROUP) {
+        wirelessManager_->leaveMulticastGroup(joinedSupporterGroup_);
+    }
+    if (wanted != NO_MULTICAST_GROUP) {
+        wirelessManager_->joinMulticastGroup(wanted);
+    }
+    joinedSupporterGroup_ = wanted;
+}
+
 void ChainDuelManager::broadcastRoleAndChampion() {
     if (!championMac_.has_value()) return;
 
     const uint8_t* supporterPeer = rdc_->getPeerMac(supporterJack());
     if (supporterPeer == nullptr) return;
 
-    uint8_t seqId = nextRoleAnnounceSeqId_++;
-    if (nextRoleAnnounceSeqId_ == 0) nextRoleAnnounceSeqId_ = 1;
-
     RoleAnnouncePayload payload{};
     payload.role = player_->isHunter() ? 1 : 0;
     memcpy(payload.championMac, championMac_->data(), 6);
-    payload.seqId = seqId;
 
-    memcpy(pending_.targetMac.data(), supporterPeer, 6);
-    pending_.championMac = *championMac_;
-    pending_.role = payload.role;
-    pending_.seqId = seqId;
-    pending_.retries = 0;
-    pending_.active = true;
-    pending_.timer.setTimer(kAckTimeoutMs);
-    retryStats_.sends++;
+    // Single slot: a newer announce replaces the old one even if the
+    // supporter-jack peer changed in between.
+    channel_.cancelTag(kRoleAnnounceTag);
+    pendingRole_ = payload.role;
+    pendingRoleChampionMac_ = *championMac_;
+    payload.seqId = channel_.track(supporterPeer, kRoleAnnounceTag);
 
     wirelessManager_->sendEspNowData(
         supporterPeer, PktType::kRoleAnnounce,
@@ -411,8 +435,7 @@ void ChainDuelManager::sendRoleToOpponentJack() {
     const uint8_t* opponentPeer = rdc_->getPeerMac(opponentJack());
     if (opponentPeer == nullptr) return;
 
-    uint8_t seqId = nextRoleAnnounceSeqId_++;
-    if (nextRoleAnnounceSeqId_ == 0) nextRoleAnnounceSeqId_ = 1;
+    uint8_t seqId = channel_.nextSeq(opponentPeer);
 
     RoleAnnouncePayload payload{};
     payload.role = player_->isHunter() ? 1 : 0;
@@ -428,69 +451,51 @@ void ChainDuelManager::sendRoleToOpponentJack() {
 }
 
 void ChainDuelManager::onRoleAnnounceAckReceived(const uint8_t* fromMac, uint8_t seqId) {
-    if (!pending_.active || pending_.seqId != seqId) return;
-    if (memcmp(fromMac, pending_.targetMac.data(), 6) != 0) return;
-    retryStats_.ackLatencyMsSum += pending_.timer.getElapsedTime();
-    retryStats_.ackCount++;
-    pending_.active = false;
+    channel_.ack(fromMac, seqId, kRoleAnnounceTag);
 }
 
 void ChainDuelManager::sync() {
-    // 1) Role-announce retry (single-slot, supporter-jack direction).
-    if (pending_.active && pending_.timer.expired()) {
-        if (pending_.retries >= kMaxRetries) {
-            const uint8_t* t = pending_.targetMac.data();
-            LOG_W(TAG,
-                "kRoleAnnounce abandoned after %u retries: target=%02X:%02X:%02X:%02X:%02X:%02X seqId=%u",
-                (unsigned)kMaxRetries,
-                t[0], t[1], t[2], t[3], t[4], t[5],
-                (unsigned)pending_.seqId);
-            retryStats_.abandons++;
-            pending_.active = false;
-        } else {
-            pending_.retries++;
-            retryStats_.retries++;
-            RoleAnnouncePayload payload{};
-            payload.role = pending_.role;
-            memcpy(payload.championMac, pending_.championMac.data(), 6);
-            payload.seqId = pending_.seqId;
-            wirelessManager_->sendEspNowData(
-                pending_.targetMac.data(), PktType::kRoleAnnounce,
-                reinterpret_cast<const uint8_t*>(&payload), sizeof(payload));
-            // Exponential backoff between retransmits: 200, 400, 800ms
-            // (kMaxRetries=3). See RDC sync() for rationale (async driver
-            // queue needs drain time between retries).
-            pending_.timer.setTimer(kAckTimeoutMs << pending_.retries);
-        }
-    }
-
-    // 2) Per-supporter WIN/LOSS game-event retries. Champion-side only.
-    for (size_t i = 0; i < pendingGameEvents_.size(); ) {
-        PendingGameEvent& pending = pendingGameEvents_[i];
-        if (!pending.timer.expired()) { ++i; continue; }
-
-        if (pending.retries >= kMaxRetries) {
-            const uint8_t* t = pending.targetMac.data();
-            LOG_W(TAG,
-                "kChainGameEvent abandoned after %u retries: target=%02X:%02X:%02X:%02X:%02X:%02X seqId=%u event=%u",
-                (unsigned)kMaxRetries,
-                t[0], t[1], t[2], t[3], t[4], t[5],
-                (unsigned)pending.seqId,
-                (unsigned)pending.eventType);
-            retryStats_.abandons++;
-            pendingGameEvents_.erase(pendingGameEvents_.begin() + i);
-            continue;  // do not increment i; vector shifted
-        }
+    // Role-announce retries (single-slot, supporter-jack direction) and
+    // per-supporter WIN/LOSS game-event retries (champion-side only).
+    // Backoff between retransmits doubles from the channel RTO, giving
+    // the async driver queue drain time between retries.
+    channel_.poll();
+}
 
-        pending.retries++;
-        retryStats_.retries++;
+bool ChainDuelManager::retransmit(const uint8_t* peer, uint8_t seqId, uint8_t tag, uint32_t context) {
+    if (tag == kRoleAnnounceTag) {
+        RoleAnnouncePayload payload{};
+        payload.role = pendingRole_;
+        memcpy(payload.championMac, pendingRoleChampionMac_.data(), 6);
+        payload.seqId = seqId;
+        wirelessManager_->sendEspNowData(
+            peer, PktType::kRoleAnnounce,
+            reinterpret_cast<const uint8_t*>(&payload), sizeof(payload));
+    } else {
         ChainGameEventPayload payload{};
-        payload.event_type = pending.eventType;
-        payload.seqId = pending.seqId;
+        payload.event_type = static_cast<uint8_t>(context);
+        payload.seqId = seqId;
         wirelessManager_->sendEspNowData(
-            pending.targetMac.data(), PktType::kChainGameEvent,
+            peer, PktType::kChainGameEvent,
             reinterpret_cast<const uint8_t*>(&payload), sizeof(payload));
-        pending.timer.setTimer(kAckTimeoutMs << pending.retries);
-        ++i;
+    }
+    return true;
+}
+
+void ChainDuelManager::logAbandon(const uint8_t* t, uint8_t seqId, uint8_t tag, uint32_t context) const {
+    unsigned maxRetries = channel_.getConfig().maxRetries;
+    if (tag == kRoleAnnounceTag) {
+        LOG_W(TAG,
+            "kRoleAnnounce abandoned after %u retries: target=%02X:%02X:%02X:%02X:%02X:%02X seqId=%u",
+            maxRetries,
+            t[0], t[1], t[2], t[3], t[4], t[5],
+            (unsigned)seqId);
+    } else {
+        LOG_W(TAG,
+            "kChainGameEvent abandoned after %u retries: target=%02X:%02X:%02X:%02X:%02X:%02X seqId=%u event=%u",
+            maxRetries,
+            t[0], t[1], t[2], t[3], t[4], t[5],
+            (unsigned)seqId,
+            (unsigned)context);
     }
 }
@@ -10,6 +10,9 @@
 #include "device/wireless-manager.hpp"
 #include "device/drivers/peer-comms-types.hpp"
 #include "device/drivers/serial-wrapper.hpp"
+#include "wireless/reliable-channel.hpp"
+#include "wireless/multicast-group.hpp"
+#include "wireless/packet-registry.hpp"
 
 enum class ChainGameEventType : uint8_t {
     COUNTDOWN = 0,
@@ -27,6 +30,8 @@ struct ChainGameEventPayload {
     uint8_t seqId;
 } __attribute__((packed));
 
+template <> struct PacketLayout<PktType::kChainGameEvent> : FixedPacketLayout<ChainGameEventPayload> {};
+
 class ChainDuelManager {
 public:
     ChainDuelManager(Player* player, WirelessManager* wirelessManager, RemoteDeviceCoordinator* rdc);
@@ -77,19 +82,22 @@ public:
 
     static constexpr unsigned long BOOST_PER_SUPPORTER_MS = 15;
 
-    // Retry observability for the role-announce channel. Mirrors
-    // RemoteDeviceCoordinator::RetryStats semantics.
-    struct RetryStats {
-        uint32_t sends = 0;
-        uint32_t retries = 0;
-        uint32_t abandons = 0;
-        uint32_t ackLatencyMsSum = 0;
-        uint32_t ackCount = 0;
-    };
-    RetryStats getRetryStats() const { return retryStats_; }
+    // COUNTDOWN/DRAW still waiting in the send queue after this long are
+    // dropped instead of transmitted.
+    static constexpr unsigned long kTransientEventMaxAgeMs = 300;
+
+    // Multicast group a champion's untracked game events go to. Supporters
+    // join the group of the champion they follow.
+    static MulticastGroup supporterGroupFor(const uint8_t* championMac) {
+        return multicastGroupFor("chain", championMac);
+    }
+
+    // Retry observability for the role-announce and game-event channel.
+    // Same semantics as RemoteDeviceCoordinator::RetryStats.
+    using RetryStats = ReliableChannel::Stats;
+    RetryStats getRetryStats() const { return channel_.getStats(); }
 
 private:
-    RetryStats retryStats_;
     Player* player_;
     WirelessManager* wirelessManager_;
     RemoteDeviceCoordinator* rdc_;
@@ -111,35 +119,26 @@ private:
     std::array<std::optional<bool>, 2> peerRoleByPort_;
 
     std::optional<std::array<uint8_t, 6>> championMac_;
+
+    // Group joined as a supporter of championMac_; none while champion.
+    MulticastGroup joinedSupporterGroup_ = NO_MULTICAST_GROUP;
+    void refreshSupporterGroup();
     std::optional<std::array<uint8_t, 6>> lastAnnouncedSupporterJackMac_;
     std::optional<std::array<uint8_t, 6>> lastAnnouncedOpponentJackMac_;
 
-    struct PendingRoleAnnounce {
-        bool active = false;
-        uint8_t seqId = 0;
-        uint8_t retries = 0;
-        std::array<uint8_t, 6> championMac;
-        uint8_t role;
-        std::array<uint8_t, 6> targetMac;
-        SimpleTimer timer;
-    };
-    PendingRoleAnnounce pending_;
-    static constexpr unsigned long kAckTimeoutMs = 100;
-    static constexpr uint8_t kMaxRetries = 3;
-
-    uint8_t nextRoleAnnounceSeqId_ = 1;
-
-    // Champion-side pending WIN/LOSS game events awaiting per-supporter
-    // ACKs. Keyed by target MAC; one pending entry per supporter at a
-    // time. Size bounded by chain length (kMaxChainPeersPerPort = 18 in
-    // RDC, so ≤18 entries in practice).
-    struct PendingGameEvent {
-        std::array<uint8_t, 6> targetMac;
-        uint8_t seqId;
-        uint8_t eventType;
-        uint8_t retries;
-        SimpleTimer timer;
-    };
-    std::vector<PendingGameEvent> pendingGameEvents_;
-    uint8_t nextGameEventSeqId_ = 1;
+    // Tags for the two tracked message kinds on channel_.
+    static constexpr uint8_t kRoleAnnounceTag = 0;
+    static constexpr uint8_t kGameEventTag = 1;
+
+    // Supporter-jack role announces (single outstanding, newest wins) and
+    // champion-side WIN/LOSS game events (one outstanding per supporter,
+    // event type carried as the entry context). Sequence ids are per peer.
+    ReliableChannel channel_;
+
+    // Content of the outstanding role announce, for retransmits.
+    uint8_t pendingRole_ = 0;
+    std::array<uint8_t, 6> pendingRoleChampionMac_{};
+
+    bool retransmit(const uint8_t* peer, uint8_t seqId, uint8_t tag, uint32_t context);
+    void logAbandon(const uint8_t* peer, uint8_t seqId, uint8_t tag, uint32_t context) const;
 };
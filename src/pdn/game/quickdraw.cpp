@@ -3,6 +3,7 @@
 #include "wireless/symbol-wireless-manager.hpp"
 #include "device/drivers/logger.hpp"
 #include <array>
+#include <cstddef>
 #include <cstring>
 
 Quickdraw::Quickdraw(Player* player, Device* PDN, QuickdrawWirelessManager* quickdrawWirelessManager, RemoteDebugManager* remoteDebugManager, SymbolWirelessManager* symbolWirelessManager): StateMachine(QUICKDRAW_APP_ID) {
@@ -34,51 +35,53 @@ Quickdraw::Quickdraw(Player* player, Device* PDN, QuickdrawWirelessManager* quic
     // Chain game event + confirm wireless packet handlers.
     wirelessManager->setEspNowPacketHandler(
         PktType::kChainGameEvent,
-        [](const uint8_t* macAddress, const uint8_t* data, const size_t dataLen, void* ctx) {
-            static_cast<Quickdraw*>(ctx)->onChainGameEventPacket(macAddress, data, dataLen);
-        },
+        packetHandler<PktType::kChainGameEvent, &Quickdraw::onChainGameEventPacket>,
         this
     );
     wirelessManager->setEspNowPacketHandler(
         PktType::kChainGameEventAck,
-        [](const uint8_t* macAddress, const uint8_t* data, const size_t dataLen, void* ctx) {
-            static_cast<Quickdraw*>(ctx)->onChainGameEventAckPacket(macAddress, data, dataLen);
-        },
+        packetHandler<PktType::kChainGameEventAck, &Quickdraw::onChainGameEventAckPacket>,
         this
     );
     wirelessManager->setEspNowPacketHandler(
         PktType::kChainConfirm,
-        [](const uint8_t* macAddress, const uint8_t* data, const size_t dataLen, void* ctx) {
-            static_cast<Quickdraw*>(ctx)->onChainConfirmPacket(macAddress, data, dataLen);
-        },
+        packetHandler<PktType::kChainConfirm, &Quickdraw::onChainConfirmPacket>,
         this
     );
     wirelessManager->setEspNowPacketHandler(
         PktType::kRoleAnnounce,
-        [](const uint8_t* macAddress, const uint8_t* data, const size_t dataLen, void* ctx) {
-            static_cast<Quickdraw*>(ctx)->onRoleAnnouncePacket(macAddress, data, dataLen);
-        },
+        packetHandler<PktType::kRoleAnnounce, &Quickdraw::onRoleAnnouncePacket>,
         this
     );
     wirelessManager->setEspNowPacketHandler(
         PktType::kRoleAnnounceAck,
-        [](const uint8_t* macAddress, const uint8_t* data, const size_t dataLen, void* ctx) {
-            static_cast<Quickdraw*>(ctx)->onRoleAnnounceAckPacket(macAddress, data, dataLen);
-        },
+        packetHandler<PktType::kRoleAnnounceAck, &Quickdraw::onRoleAnnounceAckPacket>,
         this
     );
     wirelessManager->setEspNowPacketHandler(
         PktType::kShootoutCommand,
-        [](const uint8_t* macAddress, const uint8_t* data, const size_t dataLen, void* ctx) {
-            static_cast<Quickdraw*>(ctx)->onShootoutCommandPacket(macAddress, data, dataLen);
-        },
+        packetHandler<PktType::kShootoutCommand, &Quickdraw::onShootoutCommandPacket>,
         this
     );
     wirelessManager->setEspNowPacketHandler(
         PktType::kShootoutCommandAck,
-        [](const uint8_t* macAddress, const uint8_t* data, const size_t dataLen, void* ctx) {
-            static_cast<Quickdraw*>(ctx)->onShootoutCommandAckPacket(macAddress, data, dataLen);
-        },
+        packetHandler<PktType::kShootoutCommandAck, &Quickdraw::onShootoutCommandAckPacket>,
+        this
+    );
+
+    // Link-layer repeats and our own retransmits of tracked packets are
+    // dropped in the driver; the managers' seqId checks stay as the fallback
+    // for drivers that don't filter.
+    wirelessManager->setEspNowDuplicateSuppression(
+        PktType::kChainGameEvent,
+        offsetof(ChainGameEventPayload, seqId),
+        packetHandler<PktType::kChainGameEvent, &Quickdraw::onChainGameEventDuplicate>,
+        this
+    );
+    wirelessManager->setEspNowDuplicateSuppression(
+        PktType::kShootoutCommand,
+        offsetof(ShootoutPacket, seqId),
+        packetHandler<PktType::kShootoutCommand, &Quickdraw::onShootoutCommandDuplicate>,
         this
     );
 
@@ -107,6 +110,42 @@ Quickdraw::Quickdraw(Player* player, Device* PDN, QuickdrawWirelessManager* quic
     });
 }
 
+void Quickdraw::logTrafficStats() {
+    TrafficStats::Snapshot traffic;
+    if (peerComms == nullptr || !peerComms->getTrafficSnapshot(traffic)) return;
+
+    // Share of the window this device kept the channel busy transmitting
+    unsigned long long airUs = estimateAirtimeUs(traffic.total(TrafficDirection::kTx));
+    unsigned long windowMs = traffic.takenMs - traffic.sinceMs;
+    unsigned long permille = windowMs ? (unsigned long)(airUs / windowMs) : 0;
+    LOG_W("TRAFFIC", "tx air %llums over %lums (%lu.%lu%%)",
+          airUs / 1000, windowMs, permille / 10, permille % 10);
+
+    char row[160];
+    for (size_t i = 0; i < TrafficStats::kNumTypes; i++) {
+        PktType type = static_cast<PktType>(i);
+        if (traffic.tx[i].frames == 0 && traffic.rx[i].frames == 0) continue;
+        formatTrafficRow(traffic, type, row, sizeof(row));
+        LOG_W("TRAFFIC", "%s", row);
+    }
+}
+
+void Quickdraw::logLoopProfile(Device* PDN) {
+    LoopProfiler* profiler = PDN ? PDN->getLoopProfiler() : nullptr;
+    if (profiler == nullptr) return;
+
+    char label[48];
+    char row[128];
+    char histogram[256];
+    for (size_t i = 0; i < profiler->getSectionCount(); i++) {
+        const LoopProfileSection& section = profiler->getSection(i);
+        formatLoopProfileLabel(section, label, sizeof(label));
+        formatLoopProfileRow(section, label, row, sizeof(row));
+        formatLoopProfileHistogram(section, histogram, sizeof(histogram));
+        LOG_W("LOOP", "%s | %s", row, histogram);
+    }
+}
+
 void Quickdraw::onChainStateChanged() {
     if (chainDuelManager) {
         chainDuelManager->onChainStateChanged();
@@ -115,17 +154,15 @@ void Quickdraw::onChainStateChanged() {
     // diffs — daisy chain announcements bounce in normal operation.
 }
 
-void Quickdraw::onRoleAnnouncePacket(const uint8_t* fromMac, const uint8_t* data, size_t dataLen) {
-    if (dataLen != sizeof(RoleAnnouncePayload) || !chainDuelManager) return;
-    const RoleAnnouncePayload* payload = reinterpret_cast<const RoleAnnouncePayload*>(data);
+void Quickdraw::onRoleAnnouncePacket(const uint8_t* fromMac, const RoleAnnouncePayload& payload, size_t) {
+    if (!chainDuelManager) return;
     chainDuelManager->onRoleAnnounceReceived(
-        fromMac, payload->role, payload->championMac, payload->seqId);
+        fromMac, payload.role, payload.championMac, payload.seqId);
 }
 
-void Quickdraw::onRoleAnnounceAckPacket(const uint8_t* fromMac, const uint8_t* data, size_t dataLen) {
-    if (dataLen != sizeof(RoleAnnounceAckPayload) || !chainDuelManager) return;
-    const RoleAnnounceAckPayload* payload = reinterpret_cast<const RoleAnnounceAckPayload*>(data);
-    chainDuelManager->onRoleAnnounceAckReceived(fromMac, payload->seqId);
+void Quickdraw::onRoleAnnounceAckPacket(const uint8_t* fromMac, const RoleAnnounceAckPayload& payload, size_t) {
+    if (!chainDuelManager) return;
+    chainDuelManager->onRoleAnnounceAckReceived(fromMac, payload.seqId);
 }
 
 void Quickdraw::onStateLoop(Device *PDN) {
@@ -156,53 +193,53 @@ void Quickdraw::onStateLoop(Device *PDN) {
                 (unsigned)c.sends, (unsigned)c.retries, (unsigned)c.abandons,
                 (unsigned)c.ackCount, cMean);
         }
+        logTrafficStats();
+        logLoopProfile(PDN);
         statsLogTimer_.setTimer(kStatsLogIntervalMs);
     }
 
     StateMachine::onStateLoop(PDN);
 }
 
-void Quickdraw::onChainGameEventPacket(const uint8_t* fromMac, const uint8_t* data, size_t dataLen) {
-    if (dataLen != sizeof(ChainGameEventPayload)) return;
+void Quickdraw::onChainGameEventPacket(const uint8_t* fromMac, const ChainGameEventPayload& payload, size_t) {
     if (!chainDuelManager || !chainDuelManager->isKnownGameEventSender(fromMac)) return;
 
-    const ChainGameEventPayload* payload = reinterpret_cast<const ChainGameEventPayload*>(data);
-
     // Out-of-state events dropped silently; champion's retry machine bounds traffic cost.
     if (supporterReadyState != nullptr && currentState != nullptr
         && currentState->getStateId() == SUPPORTER_READY) {
-        supporterReadyState->onChainGameEventReceived(payload->event_type, fromMac);
+        supporterReadyState->onChainGameEventReceived(payload.event_type, fromMac);
     }
 
     // ACK regardless of whether we were in SupporterReady. Not ACKing after
     // leaving the state would let the champion keep retrying a WIN/LOSS we
     // already received and can't act on. seqId=0 is the sentinel for
     // fire-and-forget events (COUNTDOWN/DRAW) and must not be ACKed.
-    if (payload->seqId != 0) {
-        chainDuelManager->sendGameEventAck(fromMac, payload->seqId);
+    if (payload.seqId != 0) {
+        chainDuelManager->sendGameEventAck(fromMac, payload.seqId);
     }
 }
 
-void Quickdraw::onChainGameEventAckPacket(const uint8_t* fromMac, const uint8_t* data, size_t dataLen) {
-    if (dataLen != sizeof(ChainGameEventAckPayload) || !chainDuelManager) return;
-    const ChainGameEventAckPayload* payload = reinterpret_cast<const ChainGameEventAckPayload*>(data);
-    chainDuelManager->onChainGameEventAckReceived(fromMac, payload->seqId);
+void Quickdraw::onChainGameEventDuplicate(const uint8_t* fromMac, const ChainGameEventPayload& payload, size_t) {
+    if (!chainDuelManager || !chainDuelManager->isKnownGameEventSender(fromMac)) return;
+    chainDuelManager->sendGameEventAck(fromMac, payload.seqId);
 }
 
-void Quickdraw::onChainConfirmPacket(const uint8_t* fromMac, const uint8_t* data, size_t dataLen) {
-    if (dataLen != sizeof(ChainConfirmPayload)) return;
+void Quickdraw::onChainGameEventAckPacket(const uint8_t* fromMac, const ChainGameEventAckPayload& payload, size_t) {
     if (!chainDuelManager) return;
-    const ChainConfirmPayload* payload = reinterpret_cast<const ChainConfirmPayload*>(data);
-    chainDuelManager->onConfirmReceived(fromMac, payload->originatorMac, payload->seqId);
+    chainDuelManager->onChainGameEventAckReceived(fromMac, payload.seqId);
 }
 
-void Quickdraw::onShootoutCommandPacket(const uint8_t* fromMac, const uint8_t* data, size_t dataLen) {
-    if (!shootoutManager_ || dataLen < 2) return;
-    if (data[0] > static_cast<uint8_t>(ShootoutCmd::ABORT)) return;
-    ShootoutCmd cmd = static_cast<ShootoutCmd>(data[0]);
-    uint8_t seqId = data[1];
-    const uint8_t* payload = data + 2;
-    size_t payloadLen = dataLen - 2;
+void Quickdraw::onChainConfirmPacket(const uint8_t* fromMac, const ChainConfirmPayload& payload, size_t) {
+    if (!chainDuelManager) return;
+    chainDuelManager->onConfirmReceived(fromMac, payload.originatorMac, payload.seqId);
+}
+
+void Quickdraw::onShootoutCommandPacket(const uint8_t* fromMac, const ShootoutPacket& packet, size_t dataLen) {
+    if (!shootoutManager_ || packet.cmd > ShootoutCmd::ABORT) return;
+    ShootoutCmd cmd = packet.cmd;
+    uint8_t seqId = packet.seqId;
+    const uint8_t* payload = packet.payload;
+    size_t payloadLen = dataLen - sizeof(ShootoutPacket);
     switch (cmd) {
         case ShootoutCmd::CONFIRM: {
             if (payloadLen < 6) break;
@@ -212,17 +249,8 @@ void Quickdraw::onShootoutCommandPacket(const uint8_t* fromMac, const uint8_t* d
             break;
         }
         case ShootoutCmd::BRACKET: {
-            if (payloadLen < 1) break;
-            uint8_t count = payload[0];
-            if (count > ShootoutManager::kMaxBracketSize) break;
-            if (payloadLen < 1 + 6 * static_cast<size_t>(count)) break;
             std::vector<std::array<uint8_t, 6>> bracket;
-            bracket.reserve(count);
-            for (uint8_t i = 0; i < count; i++) {
-                std::array<uint8_t, 6> mac;
-                memcpy(mac.data(), payload + 1 + 6 * i, 6);
-                bracket.push_back(mac);
-            }
+            if (!decodeShootoutBracket(payload, payloadLen, bracket)) break;
             shootoutManager_->onBracketReceived(bracket, seqId);
             break;
         }
@@ -246,12 +274,15 @@ void Quickdraw::onShootoutCommandPacket(const uint8_t* fromMac, const uint8_t* d
     }
 }
 
-void Quickdraw::onShootoutCommandAckPacket(const uint8_t* fromMac, const uint8_t* data, size_t dataLen) {
-    if (!shootoutManager_ || dataLen < 2) return;
-    if (data[0] > static_cast<uint8_t>(ShootoutCmd::ABORT)) return;
-    ShootoutCmd cmd = static_cast<ShootoutCmd>(data[0]);
-    uint8_t seqId = data[1];
-    switch (cmd) {
+void Quickdraw::onShootoutCommandDuplicate(const uint8_t* fromMac, const ShootoutPacket& packet, size_t) {
+    if (!shootoutManager_ || packet.cmd > ShootoutCmd::ABORT) return;
+    shootoutManager_->onDuplicateCommand(fromMac, packet.cmd, packet.seqId);
+}
+
+void Quickdraw::onShootoutCommandAckPacket(const uint8_t* fromMac, const ShootoutAckPayload& payload, size_t) {
+    if (!shootoutManager_ || payload.cmd > ShootoutCmd::ABORT) return;
+    uint8_t seqId = payload.seqId;
+    switch (payload.cmd) {
         case ShootoutCmd::BRACKET:
             shootoutManager_->onBracketAckReceived(fromMac, seqId);
             break;
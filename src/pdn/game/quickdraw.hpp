@@ -28,13 +28,20 @@ public:
     // Static entry points for ESP-NOW packet handlers. Route to the
     // current state if it's SupporterReady (for game events) or to the
     // MatchManager/champion-side confirm tracker (for confirms).
-    void onChainGameEventPacket(const uint8_t* fromMac, const uint8_t* data, size_t dataLen);
-    void onChainGameEventAckPacket(const uint8_t* fromMac, const uint8_t* data, size_t dataLen);
-    void onChainConfirmPacket(const uint8_t* fromMac, const uint8_t* data, size_t dataLen);
-    void onRoleAnnouncePacket(const uint8_t* fromMac, const uint8_t* data, size_t dataLen);
-    void onRoleAnnounceAckPacket(const uint8_t* fromMac, const uint8_t* data, size_t dataLen);
-    void onShootoutCommandPacket(const uint8_t* fromMac, const uint8_t* data, size_t dataLen);
-    void onShootoutCommandAckPacket(const uint8_t* fromMac, const uint8_t* data, size_t dataLen);
+    // Registered through packetHandler<>, so each payload has already been
+    // checked against its PacketLayout.
+    void onChainGameEventPacket(const uint8_t* fromMac, const ChainGameEventPayload& payload, size_t dataLen);
+    void onChainGameEventAckPacket(const uint8_t* fromMac, const ChainGameEventAckPayload& payload, size_t dataLen);
+    void onChainConfirmPacket(const uint8_t* fromMac, const ChainConfirmPayload& payload, size_t dataLen);
+    void onRoleAnnouncePacket(const uint8_t* fromMac, const RoleAnnouncePayload& payload, size_t dataLen);
+    void onRoleAnnounceAckPacket(const uint8_t* fromMac, const RoleAnnounceAckPayload& payload, size_t dataLen);
+    void onShootoutCommandPacket(const uint8_t* fromMac, const ShootoutPacket& packet, size_t dataLen);
+    void onShootoutCommandAckPacket(const uint8_t* fromMac, const ShootoutAckPayload& payload, size_t dataLen);
+
+    // Repeats the driver dropped as duplicates. Only re-ACK, so a sender
+    // whose first ACK was lost stops retrying.
+    void onChainGameEventDuplicate(const uint8_t* fromMac, const ChainGameEventPayload& payload, size_t dataLen);
+    void onShootoutCommandDuplicate(const uint8_t* fromMac, const ShootoutPacket& packet, size_t dataLen);
     void onStateLoop(Device *PDN) override;
 
 private:
@@ -62,6 +69,14 @@ private:
     SimpleTimer statsLogTimer_;
     static constexpr unsigned long kStatsLogIntervalMs = 5000;
 
+    // Per-PktType frames, bytes and estimated airtime from the driver, one
+    // "TRAFFIC" line per type that saw any, after each STATS line.
+    void logTrafficStats();
+
+    // With LOOP_PROFILING, one "LOOP" line per tick, driver and state
+    // section the device's profiler has timed, after the TRAFFIC lines.
+    void logLoopProfile(Device* PDN);
+
     // Diagnostic: track isLoop() transitions to expose ring re-formation timing.
     bool lastIsLoop_ = false;
 };
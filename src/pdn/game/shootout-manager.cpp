@@ -12,8 +12,13 @@
 #define TAG "SHT"
 
 namespace {
-// Indexed by retry count. Table length matches kMaxShootoutAckRetries.
-constexpr unsigned long kAckBackoffMs[] = {100, 200, 400};
+// Retry timeouts of 100, 200, 400, 400ms on a quiet link: backoff stops
+// doubling after two retries.
+ReliableChannel::Config shootoutAckConfig() {
+    ReliableChannel::Config config;
+    config.maxBackoffShift = 2;
+    return config;
+}
 
 void deriveShootoutMatchId(int matchIndex, char* out, size_t outSize) {
     // Deterministic ID so both duelists prime MatchManager with the same
@@ -26,7 +31,20 @@ ShootoutManager::ShootoutManager(Player* player,
                                  WirelessManager* wirelessManager,
                                  RemoteDeviceCoordinator* rdc,
                                  ChainDuelManager* cdm)
-    : player_(player), wirelessManager_(wirelessManager), rdc_(rdc), cdm_(cdm) {}
+    : player_(player), wirelessManager_(wirelessManager), rdc_(rdc), cdm_(cdm),
+      acks_(shootoutAckConfig()) {
+    acks_.setRetransmitCallback(
+        [this](const uint8_t* peer, uint8_t, uint8_t tag, uint32_t) {
+            return retransmitToPeer(peer, static_cast<ShootoutCmd>(tag));
+        });
+    acks_.setAbandonCallback(
+        [this](const uint8_t* peer, uint8_t, uint8_t tag, uint32_t) {
+            onRetriesExhausted(peer, static_cast<ShootoutCmd>(tag));
+        });
+    if (wirelessManager_ != nullptr) {
+        wirelessManager_->bindLinkQuality(acks_);
+    }
+}
 
 bool ShootoutManager::active() const {
     return phase_ != Phase::IDLE;
@@ -53,7 +71,7 @@ uint8_t ShootoutManager::getLastBracketSeqId() const {
 }
 
 size_t ShootoutManager::getBracketPendingAckCount() const {
-    return bracketPendingAcks_.size();
+    return acks_.pendingCount(static_cast<uint8_t>(ShootoutCmd::BRACKET));
 }
 
 int ShootoutManager::getCurrentMatchIndex() const {
@@ -82,29 +100,95 @@ void ShootoutManager::sendToPeers(const std::vector<std::array<uint8_t, 6>>& pee
     }
 }
 
-void ShootoutManager::sendReliablyToPeers(std::vector<BracketPending>& pending,
+void ShootoutManager::multicastToPeers(const std::vector<std::array<uint8_t, 6>>& peers,
+                                      const uint8_t* packet, size_t len) {
+    if (loopGroup_ != NO_MULTICAST_GROUP &&
+        wirelessManager_->sendEspNowMulticast(loopGroup_, PktType::kShootoutCommand, packet, len,
+                                              defaultSendOptions(PktType::kShootoutCommand)) == 0) {
+        return;
+    }
+    sendToPeers(peers, packet, len);
+}
+
+void ShootoutManager::joinLoopGroup(const std::vector<std::array<uint8_t, 6>>& members) {
+    if (members.empty()) return;
+    MulticastGroup group = multicastGroupFor("shootout", lowestMacIn(members).data());
+    if (group == loopGroup_) return;
+    leaveLoopGroup();
+    wirelessManager_->joinMulticastGroup(group);
+    loopGroup_ = group;
+}
+
+void ShootoutManager::leaveLoopGroup() {
+    if (loopGroup_ == NO_MULTICAST_GROUP) return;
+    wirelessManager_->leaveMulticastGroup(loopGroup_);
+    loopGroup_ = NO_MULTICAST_GROUP;
+}
+
+void ShootoutManager::sendReliablyToPeers(ShootoutCmd cmd, uint8_t seqId,
                                           const std::vector<std::array<uint8_t, 6>>& peers,
                                           const uint8_t* packet, size_t len) {
     sendToPeers(peers, packet, len);
     const uint8_t* selfMac = wirelessManager_->getMacAddress();
-    pending.clear();
+    uint8_t tag = static_cast<uint8_t>(cmd);
+    acks_.cancelTag(tag);
     for (const auto& m : peers) {
         if (selfMac != nullptr && memcmp(m.data(), selfMac, 6) == 0) continue;
-        BracketPending p;
-        p.peer = m;
-        p.timer.setTimer(ackTimeoutForRetry(0));
-        pending.push_back(p);
+        acks_.trackWithSeq(m.data(), seqId, tag);
     }
 }
 
-void ShootoutManager::eraseFromPending(std::vector<BracketPending>& pending,
-                                       const uint8_t* fromMac) {
-    for (auto it = pending.begin(); it != pending.end(); ) {
-        if (memcmp(it->peer.data(), fromMac, 6) == 0) {
-            it = pending.erase(it);
-        } else {
-            ++it;
-        }
+bool ShootoutManager::retransmitToPeer(const uint8_t* peer, ShootoutCmd cmd) {
+    std::vector<uint8_t> packet;
+    switch (cmd) {
+        case ShootoutCmd::BRACKET:
+            packet = buildBracketPacket();
+            break;
+        case ShootoutCmd::MATCH_START:
+            if (currentMatchIndex_ < 0 ||
+                static_cast<size_t>(currentMatchIndex_ * 2 + 1) >= currentRound_.size()) {
+                return false;
+            }
+            packet = buildMatchStartPacket(currentMatchIndex_);
+            break;
+        case ShootoutCmd::MATCH_RESULT:
+            packet = buildMatchResultPacket(
+                lastMatchResult_.winner.data(), lastMatchResult_.loser.data(),
+                lastMatchResult_.matchIndex);
+            break;
+        case ShootoutCmd::TOURNAMENT_END:
+            if (phase_ != Phase::ENDED) return false;
+            packet.push_back(static_cast<uint8_t>(ShootoutCmd::TOURNAMENT_END));
+            packet.push_back(lastTournamentEndSeqId_);
+            packet.insert(packet.end(), tournamentWinner_.begin(), tournamentWinner_.end());
+            break;
+        default:
+            return false;
+    }
+    wirelessManager_->sendEspNowData(peer, PktType::kShootoutCommand,
+                                     packet.data(), packet.size());
+    return true;
+}
+
+void ShootoutManager::onRetriesExhausted(const uint8_t* peer, ShootoutCmd cmd) {
+    switch (cmd) {
+        case ShootoutCmd::BRACKET:
+            // A bracket member that never acks can't be scheduled into a
+            // match. abortTournament() clears acks_, which poll() tolerates.
+            abortTournament();
+            break;
+        case ShootoutCmd::MATCH_START:
+            // The match watchdog re-broadcasts once no acks are outstanding.
+            LOG_W(TAG, "MATCH_START retries exhausted for %s", MacToString(peer));
+            break;
+        case ShootoutCmd::MATCH_RESULT:
+            LOG_W(TAG, "MATCH_RESULT retries exhausted for %s", MacToString(peer));
+            break;
+        case ShootoutCmd::TOURNAMENT_END:
+            LOG_W(TAG, "TOURNAMENT_END retries exhausted for %s", MacToString(peer));
+            break;
+        default:
+            break;
     }
 }
 
@@ -117,7 +201,7 @@ uint8_t ShootoutManager::getLastMatchStartSeqId() const {
 }
 
 size_t ShootoutManager::getTournamentEndPendingAckCount() const {
-    return tournamentEndPendingAcks_.size();
+    return acks_.pendingCount(static_cast<uint8_t>(ShootoutCmd::TOURNAMENT_END));
 }
 
 std::array<uint8_t, 6> ShootoutManager::getTournamentWinner() const {
@@ -140,10 +224,7 @@ void ShootoutManager::resetToIdle() {
     confirmedSet_.clear();
     bracket_.clear();
     currentRound_.clear();
-    bracketPendingAcks_.clear();
-    matchStartPendingAcks_.clear();
-    tournamentEndPendingAcks_.clear();
-    matchResultPendingAcks_.clear();
+    acks_.clear();
     eliminated_.clear();
     reportedLocalWin_ = false;
     names_.clear();
@@ -156,6 +237,7 @@ void ShootoutManager::resetToIdle() {
     memset(currentDuelistA_.data(), 0, 6);
     memset(currentDuelistB_.data(), 0, 6);
     memset(coordinatorMac_.data(), 0, 6);
+    leaveLoopGroup();
     if (originalIsHunter_ && player_) {
         player_->setIsHunter(*originalIsHunter_);
     }
@@ -168,6 +250,7 @@ void ShootoutManager::startProposal() {
     if (player_) {
         originalIsHunter_ = player_->isHunter();
     }
+    joinLoopGroup(getLoopMembers());
     phase_ = Phase::PROPOSAL;
 }
 
@@ -326,20 +409,9 @@ void ShootoutManager::advanceToBracketReveal() {
     }
 }
 
-unsigned long ShootoutManager::ackTimeoutForRetry(uint8_t retries) {
-    constexpr size_t kTableSize = sizeof(kAckBackoffMs) / sizeof(kAckBackoffMs[0]);
-    if (retries >= kTableSize) return kAckBackoffMs[kTableSize - 1];
-    return kAckBackoffMs[retries];
-}
-
 std::vector<uint8_t> ShootoutManager::buildBracketPacket() const {
     std::vector<uint8_t> packet;
-    packet.push_back(static_cast<uint8_t>(ShootoutCmd::BRACKET));
-    packet.push_back(lastBracketSeqId_);
-    packet.push_back(static_cast<uint8_t>(bracket_.size()));
-    for (const auto& m : bracket_) {
-        packet.insert(packet.end(), m.begin(), m.end());
-    }
+    encodeShootoutBracket(lastBracketSeqId_, bracket_, packet);
     return packet;
 }
 
@@ -347,27 +419,12 @@ void ShootoutManager::sendBracketToPeers() {
     if (bracket_.empty()) return;
     lastBracketSeqId_ = nextSeqId();
     auto packet = buildBracketPacket();
-    sendReliablyToPeers(bracketPendingAcks_, bracket_, packet.data(), packet.size());
+    sendReliablyToPeers(ShootoutCmd::BRACKET, lastBracketSeqId_, bracket_, packet.data(), packet.size());
 }
 
 void ShootoutManager::onBracketAckReceived(const uint8_t* fromMac, uint8_t seqId) {
     if (seqId != lastBracketSeqId_) return;
-    eraseFromPending(bracketPendingAcks_, fromMac);
-}
-
-bool ShootoutManager::retryBracketForPeer(BracketPending& p) {
-    if (p.retries >= kMaxShootoutAckRetries) {
-        // Caller is iterating bracketPendingAcks_; don't abort here (that
-        // clears the vector and invalidates the iterator). Signal and let
-        // the caller abort after exiting the loop.
-        return true;
-    }
-    auto packet = buildBracketPacket();
-    wirelessManager_->sendEspNowData(p.peer.data(), PktType::kShootoutCommand,
-                                     packet.data(), packet.size());
-    p.retries++;
-    p.timer.setTimer(ackTimeoutForRetry(p.retries));
-    return false;
+    acks_.ack(fromMac, seqId, static_cast<uint8_t>(ShootoutCmd::BRACKET));
 }
 
 void ShootoutManager::abortTournament() {
@@ -379,7 +436,7 @@ void ShootoutManager::abortTournament() {
     packet[0] = static_cast<uint8_t>(ShootoutCmd::ABORT);
     packet[1] = 0;
     const auto& targets = bracket_.empty() ? confirmedSet_ : bracket_;
-    sendToPeers(targets, packet, sizeof(packet));
+    multicastToPeers(targets, packet, sizeof(packet));
 
     resetToIdle();
     phase_ = Phase::ABORTED;
@@ -399,7 +456,10 @@ void ShootoutManager::sendLocalConfirm() {
         memcpy(&payload[8], n.data(), copyLen);
     }
 
-    sendToPeers(getLoopMembers(), payload, sizeof(payload));
+    // Rejoin in case the ring changed shape since the proposal started
+    auto members = getLoopMembers();
+    joinLoopGroup(members);
+    multicastToPeers(members, payload, sizeof(payload));
     confirmRebroadcastTimer_.setTimer(kConfirmRebroadcastMs);
 }
 
@@ -413,69 +473,17 @@ void ShootoutManager::sync() {
         }
     }
 
-    bool shouldAbort = false;
-    for (auto& p : bracketPendingAcks_) {
-        if (p.timer.expired()) {
-            if (retryBracketForPeer(p)) {
-                shouldAbort = true;
-                break;
-            }
-        }
-    }
-    if (shouldAbort) abortTournament();
+    // Retransmits every unacked command whose timer lapsed. Running out of
+    // bracket retries aborts the tournament from inside the poll.
+    acks_.poll();
 
     maybeStartNextMatch();
 
     if (isCoordinator() && phase_ == Phase::MATCH_IN_PROGRESS &&
-        matchStartPendingAcks_.empty() &&
+        acks_.pendingCount(static_cast<uint8_t>(ShootoutCmd::MATCH_START)) == 0 &&
         matchStartWatchdog_.expired()) {
         sendMatchStartToPeers(currentMatchIndex_);
     }
-
-    if (phase_ == Phase::ENDED && !tournamentEndPendingAcks_.empty()) {
-        uint8_t packet[8];
-        packet[0] = static_cast<uint8_t>(ShootoutCmd::TOURNAMENT_END);
-        packet[1] = lastTournamentEndSeqId_;
-        memcpy(&packet[2], tournamentWinner_.data(), 6);
-        for (auto it = tournamentEndPendingAcks_.begin();
-             it != tournamentEndPendingAcks_.end(); ) {
-            if (!it->timer.expired()) { ++it; continue; }
-            if (it->retries >= kMaxShootoutAckRetries) {
-                LOG_W(TAG, "TOURNAMENT_END retries exhausted for %s",
-                      MacToString(it->peer.data()));
-                it = tournamentEndPendingAcks_.erase(it);
-                continue;
-            }
-            wirelessManager_->sendEspNowData(it->peer.data(),
-                                             PktType::kShootoutCommand,
-                                             packet, sizeof(packet));
-            it->retries++;
-            it->timer.setTimer(ackTimeoutForRetry(it->retries));
-            ++it;
-        }
-    }
-
-    if (!matchResultPendingAcks_.empty()) {
-        auto packet = buildMatchResultPacket(
-            lastMatchResult_.winner.data(), lastMatchResult_.loser.data(),
-            lastMatchResult_.matchIndex);
-        for (auto it = matchResultPendingAcks_.begin();
-             it != matchResultPendingAcks_.end(); ) {
-            if (!it->timer.expired()) { ++it; continue; }
-            if (it->retries >= kMaxShootoutAckRetries) {
-                LOG_W(TAG, "MATCH_RESULT retries exhausted for %s",
-                      MacToString(it->peer.data()));
-                it = matchResultPendingAcks_.erase(it);
-                continue;
-            }
-            wirelessManager_->sendEspNowData(it->peer.data(),
-                                             PktType::kShootoutCommand,
-                                             packet.data(), packet.size());
-            it->retries++;
-            it->timer.setTimer(ackTimeoutForRetry(it->retries));
-            ++it;
-        }
-    }
 }
 
 std::pair<std::array<uint8_t,6>, std::array<uint8_t,6>>
@@ -513,13 +521,14 @@ void ShootoutManager::sendMatchStartToPeers(int matchIndex) {
         memcpy(opponentMac_.data(), opp, 6);
         primeMatchManagerForMatch();
     }
-    sendReliablyToPeers(matchStartPendingAcks_, bracket_, packet.data(), packet.size());
+    sendReliablyToPeers(ShootoutCmd::MATCH_START, lastMatchStartSeqId_, bracket_,
+                        packet.data(), packet.size());
     matchStartWatchdog_.setTimer(kMatchWatchdogMs);
 }
 
 void ShootoutManager::onMatchStartAckReceived(const uint8_t* fromMac, uint8_t seqId) {
     if (seqId != lastMatchStartSeqId_) return;
-    eraseFromPending(matchStartPendingAcks_, fromMac);
+    acks_.ack(fromMac, seqId, static_cast<uint8_t>(ShootoutCmd::MATCH_START));
 }
 
 bool ShootoutManager::isSameMatch(int matchIndex, const uint8_t* a, const uint8_t* b) const {
@@ -546,7 +555,7 @@ void ShootoutManager::onLocalRDCDisconnect(const uint8_t* lostMac) {
     packet[1] = 0;
     memcpy(&packet[2], lostMac, 6);
     const auto& targets = bracket_.empty() ? confirmedSet_ : bracket_;
-    sendToPeers(targets, packet, sizeof(packet));
+    multicastToPeers(targets, packet, sizeof(packet));
     onPeerLostReceived(lostMac);
 }
 
@@ -560,7 +569,7 @@ void ShootoutManager::onPeerLostReceived(const uint8_t* lostMac) {
 
 void ShootoutManager::maybeStartNextMatch() {
     if (!isCoordinator()) return;
-    if (!bracketPendingAcks_.empty()) return;
+    if (acks_.pendingCount(static_cast<uint8_t>(ShootoutCmd::BRACKET)) > 0) return;
     if (phase_ != Phase::BRACKET_REVEAL && phase_ != Phase::BETWEEN_MATCHES) return;
     if (phase_ == Phase::BRACKET_REVEAL && !bracketRevealTimer_.expired()) return;
     // Re-entrancy guard: this function mutates currentMatchIndex_, bracket_,
@@ -695,7 +704,8 @@ void ShootoutManager::sendMatchResultToPeers(
     lastMatchResult_.matchIndex = matchIndex;
     auto packet = buildMatchResultPacket(winner, loser, matchIndex);
     // Targets confirmedSet_ to reach already-eliminated players too.
-    sendReliablyToPeers(matchResultPendingAcks_, confirmedSet_, packet.data(), packet.size());
+    sendReliablyToPeers(ShootoutCmd::MATCH_RESULT, lastMatchResultSeqId_, confirmedSet_,
+                        packet.data(), packet.size());
 }
 
 void ShootoutManager::reportLocalWin() {
@@ -726,11 +736,11 @@ void ShootoutManager::onMatchResultReceived(
 
 void ShootoutManager::onMatchResultAckReceived(const uint8_t* fromMac, uint8_t seqId) {
     if (seqId != lastMatchResultSeqId_) return;
-    eraseFromPending(matchResultPendingAcks_, fromMac);
+    acks_.ack(fromMac, seqId, static_cast<uint8_t>(ShootoutCmd::MATCH_RESULT));
 }
 
 size_t ShootoutManager::getMatchResultPendingAckCount() const {
-    return matchResultPendingAcks_.size();
+    return acks_.pendingCount(static_cast<uint8_t>(ShootoutCmd::MATCH_RESULT));
 }
 
 std::array<uint8_t, 6> ShootoutManager::findLastRemaining() const {
@@ -749,14 +759,15 @@ void ShootoutManager::sendTournamentEndToPeers(const uint8_t* winner) {
     memcpy(&packet[2], winner, 6);
     // Targets confirmedSet_ rather than bracket_: eliminated players need the
     // tournament-end transition or they stall in BETWEEN_MATCHES.
-    sendReliablyToPeers(tournamentEndPendingAcks_, confirmedSet_, packet, sizeof(packet));
+    sendReliablyToPeers(ShootoutCmd::TOURNAMENT_END, lastTournamentEndSeqId_, confirmedSet_,
+                        packet, sizeof(packet));
     memcpy(tournamentWinner_.data(), winner, 6);
     phase_ = Phase::ENDED;
 }
 
 void ShootoutManager::onTournamentEndAckReceived(const uint8_t* fromMac, uint8_t seqId) {
     if (seqId != lastTournamentEndSeqId_) return;
-    eraseFromPending(tournamentEndPendingAcks_, fromMac);
+    acks_.ack(fromMac, seqId, static_cast<uint8_t>(ShootoutCmd::TOURNAMENT_END));
 }
 
 void ShootoutManager::onTournamentEndReceived(const uint8_t* winner, uint8_t seqId) {
@@ -772,6 +783,23 @@ void ShootoutManager::onTournamentEndReceived(const uint8_t* winner, uint8_t seq
     sendShootoutAck(ShootoutCmd::TOURNAMENT_END, seqId, coord.data());
 }
 
+void ShootoutManager::onDuplicateCommand(const uint8_t* fromMac, ShootoutCmd cmd, uint8_t seqId) {
+    switch (cmd) {
+        case ShootoutCmd::BRACKET:
+        case ShootoutCmd::MATCH_START:
+            // Same rule as the first copy: the coordinator never acks these
+            if (isCoordinator()) return;
+            sendShootoutAck(cmd, seqId, fromMac);
+            break;
+        case ShootoutCmd::MATCH_RESULT:
+        case ShootoutCmd::TOURNAMENT_END:
+            sendShootoutAck(cmd, seqId, fromMac);
+            break;
+        default:
+            break;
+    }
+}
+
 void ShootoutManager::onAbortReceived() {
     if (phase_ == Phase::ABORTED || phase_ == Phase::IDLE) return;
     resetToIdle();
@@ -805,3 +833,29 @@ std::vector<std::array<uint8_t, 6>> ShootoutManager::buildLoopMemberSet() const
 
     return out;
 }
+
+size_t encodeShootoutBracket(uint8_t seqId, const std::vector<std::array<uint8_t, 6>>& bracket,
+                             std::vector<uint8_t>& out) {
+    out.resize(sizeof(ShootoutPacket) + 1 + bracket.size() * 6);
+    out[0] = static_cast<uint8_t>(ShootoutCmd::BRACKET);
+    out[1] = seqId;
+    out[2] = static_cast<uint8_t>(bracket.size());
+    uint8_t* macs = out.data() + sizeof(ShootoutPacket) + 1;
+    for (size_t i = 0; i < bracket.size(); i++) {
+        memcpy(macs + i * 6, bracket[i].data(), 6);
+    }
+    return out.size();
+}
+
+bool decodeShootoutBracket(const uint8_t* payload, size_t payloadLen,
+                           std::vector<std::array<uint8_t, 6>>& bracket) {
+    if (payloadLen < 1) return false;
+    uint8_t count = payload[0];
+    if (count > ShootoutManager::kMaxBracketSize) return false;
+    if (payloadLen < 1 + 6 * static_cast<size_t>(count)) return false;
+    bracket.resize(count);
+    for (uint8_t i = 0; i < count; i++) {
+        memcpy(bracket[i].data(), payload + 1 + 6 * i, 6);
+    }
+    return true;
+}
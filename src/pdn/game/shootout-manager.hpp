@@ -9,6 +9,8 @@
 #include "device/remote-device-coordinator.hpp"
 #include "device/wireless-manager.hpp"
 #include "utils/simple-timer.hpp"
+#include "wireless/reliable-channel.hpp"
+#include "wireless/multicast-group.hpp"
 
 class MatchManager;
 
@@ -98,6 +100,10 @@ public:
     size_t getTournamentEndPendingAckCount() const;
     uint8_t getLastTournamentEndSeqId() const { return lastTournamentEndSeqId_; }
     void onAbortReceived();
+
+    // A tracked command the driver recognised as a repeat. Re-ACKs it to the
+    // sender without acting on it again.
+    void onDuplicateCommand(const uint8_t* fromMac, ShootoutCmd cmd, uint8_t seqId);
     std::array<uint8_t, 6> getTournamentWinner() const;
 
     // Reset all tournament state back to IDLE phase so a subsequent loop
@@ -114,12 +120,6 @@ public:
     static constexpr uint8_t kMaxBracketSize = 32;
 
 private:
-    struct BracketPending {
-        std::array<uint8_t, 6> peer;
-        uint8_t retries = 0;
-        SimpleTimer timer;
-    };
-
     struct NameEntry {
         std::array<uint8_t, 6> mac;
         std::string name;
@@ -137,11 +137,25 @@ private:
     uint8_t nextSeqId();
     void sendToPeers(const std::vector<std::array<uint8_t, 6>>& peers,
                      const uint8_t* packet, size_t len);
-    void sendReliablyToPeers(std::vector<BracketPending>& pending,
+    void multicastToPeers(const std::vector<std::array<uint8_t, 6>>& peers,
+                          const uint8_t* packet, size_t len);
+    void sendReliablyToPeers(ShootoutCmd cmd, uint8_t seqId,
                              const std::vector<std::array<uint8_t, 6>>& peers,
                              const uint8_t* packet, size_t len);
-    static void eraseFromPending(std::vector<BracketPending>& pending,
-                                 const uint8_t* fromMac);
+    bool retransmitToPeer(const uint8_t* peer, ShootoutCmd cmd);
+    void onRetriesExhausted(const uint8_t* peer, ShootoutCmd cmd);
+
+    // Outstanding BRACKET / MATCH_START / MATCH_RESULT / TOURNAMENT_END
+    // acks, tagged by ShootoutCmd. One packet goes to every peer under a
+    // single seqId, so ids come from nextSeqId() rather than the channel.
+    ReliableChannel acks_;
+
+    // Every ring member joins the group named after the ring's lowest MAC,
+    // which is also the coordinator once the bracket forms. Unacked
+    // commands (CONFIRM, PEER_LOST, ABORT) go out as one frame to it.
+    MulticastGroup loopGroup_ = NO_MULTICAST_GROUP;
+    void joinLoopGroup(const std::vector<std::array<uint8_t, 6>>& members);
+    void leaveLoopGroup();
 
     std::vector<std::array<uint8_t, 6>> testLoopMembers_;
     bool testLoopMembersOverride_ = false;
@@ -164,15 +178,10 @@ private:
 
     SimpleTimer confirmRebroadcastTimer_;
 
-    std::vector<BracketPending> bracketPendingAcks_;
     uint8_t lastBracketSeqId_ = 0;
     uint8_t nextShootoutSeqId_ = 1;
-    static constexpr uint8_t kMaxShootoutAckRetries = 3;
 
     void sendBracketToPeers();
-    // Returns true iff the retry budget is exhausted for this peer and the
-    // caller should abort the tournament after exiting its iteration.
-    bool retryBracketForPeer(BracketPending& p);
     void abortTournament();
     std::vector<uint8_t> buildBracketPacket() const;
     static std::array<uint8_t, 6> lowestMacIn(
@@ -192,7 +201,6 @@ private:
     std::array<uint8_t, 6> currentDuelistB_{};
     uint8_t lastMatchStartSeqId_ = 0;
     SimpleTimer bracketRevealTimer_;
-    std::vector<BracketPending> matchStartPendingAcks_;
     void maybeStartNextMatch();
     bool inMaybeStartNextMatch_ = false;
     void sendMatchStartToPeers(int matchIndex);
@@ -210,7 +218,6 @@ private:
     SimpleTimer matchStartWatchdog_;
     void sendMatchResultToPeers(const uint8_t* winner, const uint8_t* loser,
                               uint8_t matchIndex);
-    std::vector<BracketPending> matchResultPendingAcks_;
     // Cached so sync() can rebuild the packet for retry. Senders aren't
     // always the coordinator, so a per-sender cache is required.
     struct LastMatchResult {
@@ -224,8 +231,6 @@ private:
                                                 const uint8_t* loser,
                                                 uint8_t matchIndex) const;
 
-    static unsigned long ackTimeoutForRetry(uint8_t retries);
-
     std::array<uint8_t, 6> tournamentWinner_{};
     uint8_t lastTournamentEndSeqId_ = 0;
 
@@ -234,6 +239,15 @@ private:
     // into the post-tournament duel.
     std::optional<bool> originalIsHunter_;
     void sendTournamentEndToPeers(const uint8_t* winner);
-    std::vector<BracketPending> tournamentEndPendingAcks_;
     std::array<uint8_t, 6> findLastRemaining() const;
 };
+
+// BRACKET command: ShootoutPacket{BRACKET, seqId} then [count(1)][mac(6)]*count.
+// Replaces `out` with the whole packet and returns its length.
+size_t encodeShootoutBracket(uint8_t seqId, const std::vector<std::array<uint8_t, 6>>& bracket,
+                             std::vector<uint8_t>& out);
+
+// `payload` is what follows the ShootoutPacket header. Returns false, leaving
+// `bracket` untouched, if it's truncated or over kMaxBracketSize.
+bool decodeShootoutBracket(const uint8_t* payload, size_t payloadLen,
+                           std::vector<std::array<uint8_t, 6>>& bracket);
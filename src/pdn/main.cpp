@@ -170,6 +170,15 @@ void setup() {
     
     // Register ESP-NOW packet handlers
     setupEspNow(quickdrawWirelessManager, remoteDebugManager, symbolWirelessManager, peerCommsDriver);
+#ifdef ESPNOW_FLEET_UPGRADED
+    // Chain and shootout acks to the same peer share a frame per loop tick,
+    // countdowns and brackets go out as one multicast, and duel commands use
+    // the compact layout. Older firmware drops all three, so only once every
+    // device understands them.
+    pdn->getWirelessManager()->setEspNowCoalescing(true);
+    pdn->getWirelessManager()->setEspNowMulticast(true);
+    quickdrawWirelessManager->setCompactWireFormat(true);
+#endif
     
     game = new Quickdraw(player, pdn, quickdrawWirelessManager, remoteDebugManager, symbolWirelessManager);
     
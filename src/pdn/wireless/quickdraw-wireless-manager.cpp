@@ -3,6 +3,123 @@
 //
 #include "wireless/quickdraw-wireless-manager.hpp"
 #include "device/drivers/peer-comms-interface.hpp"
+#include "utils/alloc-tracker.hpp"
+#include <climits>
+
+namespace {
+
+// Legacy field offsets; only the width of playerDrawTime differs by build
+constexpr size_t kLegacyPlayerIdOffset = 37;
+constexpr size_t kLegacyIsHunterOffset = 42;
+constexpr size_t kLegacyDrawTimeOffset = 43;
+constexpr size_t kLegacyLen32 = kLegacyDrawTimeOffset + 4 + 4;
+constexpr size_t kLegacyLen64 = kLegacyDrawTimeOffset + 8 + 4;
+
+static_assert(sizeof(QuickdrawPacket) == kLegacyLen32 || sizeof(QuickdrawPacket) == kLegacyLen64,
+              "legacy QuickdrawPacket layout changed");
+static_assert(sizeof(QuickdrawPacketV2) == 27, "v2 QuickdrawPacket layout changed");
+
+void writeLe32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint64_t readLe(const uint8_t* in, size_t width) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < width; i++) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+// Only ids uuidBytesToString() reproduces exactly survive the binary form
+bool isCanonicalUuid(const char* id) {
+    for (size_t i = 0; i < IdGenerator::UUID_STRING_LENGTH; i++) {
+        char c = id[i];
+        if (i == 8 || i == 13 || i == 18 || i == 23) {
+            if (c != '-') return false;
+        } else if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) {
+            return false;
+        }
+    }
+    return id[IdGenerator::UUID_STRING_LENGTH] == '\0';
+}
+
+size_t encodeLegacy(const QuickdrawCommand& command, uint8_t* out) {
+    QuickdrawPacket qdPacket = QuickdrawPacket();
+
+    qdPacket.command = command.command;
+    qdPacket.playerDrawTime = command.playerDrawTime;
+    qdPacket.isHunter = command.isHunter;
+
+    memcpy(qdPacket.matchId, command.matchId, IdGenerator::UUID_BUFFER_SIZE);
+    memcpy(qdPacket.playerId, command.playerId, 5);
+
+    memcpy(out, &qdPacket, sizeof(qdPacket));
+    return sizeof(qdPacket);
+}
+
+std::optional<QuickdrawCommand> decodeLegacy(const uint8_t* macAddress, const uint8_t* data, size_t dataLen) {
+    size_t timeWidth = dataLen - kLegacyDrawTimeOffset - 4;
+
+    char matchId[IdGenerator::UUID_BUFFER_SIZE];
+    char playerId[5];
+    memcpy(matchId, data, sizeof(matchId));
+    matchId[sizeof(matchId) - 1] = '\0';
+    memcpy(playerId, data + kLegacyPlayerIdOffset, sizeof(playerId));
+    playerId[sizeof(playerId) - 1] = '\0';
+
+    // Sign-extend from the sender's width, whatever ours is
+    uint64_t rawTime = readLe(data + kLegacyDrawTimeOffset, timeWidth);
+    long drawTime = timeWidth == 4
+        ? static_cast<long>(static_cast<int32_t>(rawTime))
+        : static_cast<long>(static_cast<int64_t>(rawTime));
+    int command = static_cast<int>(static_cast<int32_t>(readLe(data + kLegacyDrawTimeOffset + timeWidth, 4)));
+
+    return QuickdrawCommand(macAddress, command, matchId, playerId, drawTime,
+                            data[kLegacyIsHunterOffset] != 0);
+}
+
+}  // namespace
+
+size_t encodeQuickdrawPacket(const QuickdrawCommand& command, uint8_t* out, bool compact) {
+    compact = compact && isCanonicalUuid(command.matchId)
+        && command.command >= 0 && command.command <= UINT8_MAX
+        && command.playerDrawTime >= INT32_MIN && command.playerDrawTime <= INT32_MAX;
+    if (!compact) {
+        return encodeLegacy(command, out);
+    }
+
+    QuickdrawPacketV2 packet = {};
+    packet.version = QUICKDRAW_WIRE_VERSION;
+    packet.command = static_cast<uint8_t>(command.command);
+    packet.flags = command.isHunter ? QUICKDRAW_FLAG_HUNTER : 0;
+    IdGenerator::uuidStringToBytes(std::string(command.matchId, IdGenerator::UUID_STRING_LENGTH), packet.matchId);
+    memcpy(packet.playerId, command.playerId, sizeof(packet.playerId));
+    writeLe32(packet.playerDrawTime, static_cast<uint32_t>(static_cast<int32_t>(command.playerDrawTime)));
+
+    memcpy(out, &packet, sizeof(packet));
+    return sizeof(packet);
+}
+
+std::optional<QuickdrawCommand> decodeQuickdrawPacket(const uint8_t* macAddress, const uint8_t* data, size_t dataLen) {
+    const QuickdrawPacketV2* packet = decodePacket<PktType::kQuickdrawCommand>(data, dataLen);
+    if (packet != nullptr) {
+        std::string matchId = IdGenerator::uuidBytesToString(packet->matchId);
+        char playerId[5];
+        memcpy(playerId, packet->playerId, sizeof(packet->playerId));
+        playerId[4] = '\0';
+        long drawTime = static_cast<int32_t>(static_cast<uint32_t>(readLe(packet->playerDrawTime, 4)));
+        return QuickdrawCommand(macAddress, packet->command, matchId.c_str(), playerId, drawTime,
+                                (packet->flags & QUICKDRAW_FLAG_HUNTER) != 0);
+    }
+
+    if (data != nullptr && (dataLen == kLegacyLen32 || dataLen == kLegacyLen64)) {
+        return decodeLegacy(macAddress, data, dataLen);
+    }
+    return std::nullopt;
+}
 
 
 QuickdrawWirelessManager::QuickdrawWirelessManager() : broadcastTimer() {}
@@ -22,50 +139,64 @@ void QuickdrawWirelessManager::clearCallbacks() {
     packetReceivedCallback = nullptr;
 }
 
+void QuickdrawWirelessManager::setCompactWireFormat(bool enabled) {
+    compactWireFormat = enabled;
+}
+
+bool QuickdrawWirelessManager::isCompactPeer(const uint8_t* macAddress) const {
+    for (size_t i = 0; i < compactPeerCount; i++) {
+        if (memcmp(compactPeers[i], macAddress, 6) == 0) return true;
+    }
+    return false;
+}
+
+void QuickdrawWirelessManager::rememberCompactPeer(const uint8_t* macAddress) {
+    if (macAddress == nullptr || isCompactPeer(macAddress)) return;
+    memcpy(compactPeers[nextCompactPeer], macAddress, 6);
+    nextCompactPeer = (nextCompactPeer + 1) % kCompactPeerCapacity;
+    if (compactPeerCount < kCompactPeerCapacity) compactPeerCount++;
+}
+
 void QuickdrawWirelessManager::setPacketReceivedCallback(const std::function<void(const QuickdrawCommand&)>& callback) {
     packetReceivedCallback = callback;
 }
 
 int QuickdrawWirelessManager::broadcastPacket(const uint8_t macAddress[6],
                                              QuickdrawCommand& command) {
-    QuickdrawPacket qdPacket = QuickdrawPacket();
-
-    qdPacket.command = command.command;
-    qdPacket.playerDrawTime = command.playerDrawTime;
-    qdPacket.isHunter = command.isHunter;
-
-    memcpy(qdPacket.matchId, command.matchId, IdGenerator::UUID_BUFFER_SIZE);
-    memcpy(qdPacket.playerId, command.playerId, 5);
+    uint8_t wire[QUICKDRAW_PACKET_MAX_LEN];
+    size_t wireLen = encodeQuickdrawPacket(command, wire, compactWireFormat || isCompactPeer(macAddress));
 
     LOG_I("QWM", "Sending command %i to %s", command.command, MacToString(macAddress));
-    LOG_I("QWM", "Match ID: %s", qdPacket.matchId);
-    LOG_I("QWM", "Player Draw Time: %ld", qdPacket.playerDrawTime);
+    LOG_I("QWM", "Match ID: %s", command.matchId);
+    LOG_I("QWM", "Player Draw Time: %ld", command.playerDrawTime);
 
     return wirelessManager->sendEspNowData(
         macAddress,
         PktType::kQuickdrawCommand,
-        reinterpret_cast<const uint8_t*>(&qdPacket),
-        sizeof(qdPacket));
+        wire,
+        wireLen);
 }
 
 
 int QuickdrawWirelessManager::processQuickdrawCommand(const uint8_t *macAddress, const uint8_t *data,
     const size_t dataLen) {
+    ALLOC_REGION("quickdraw.rx");
 
-    if(dataLen != sizeof(QuickdrawPacket)) {
-        LOG_E("RPM", "Unexpected packet len for PlayerInfoPkt. Got %lu but expected %lu\n",
-                      dataLen, sizeof(QuickdrawPacket));
+    std::optional<QuickdrawCommand> command = decodeQuickdrawPacket(macAddress, data, dataLen);
+    if(!command) {
+        LOG_E("RPM", "Unexpected packet len for PlayerInfoPkt. Got %lu but expected %lu or %lu\n",
+                      dataLen, sizeof(QuickdrawPacketV2), sizeof(QuickdrawPacket));
 
         return -1;
     }
 
-    const QuickdrawPacket* packet = reinterpret_cast<const QuickdrawPacket*>(data);
-
-    QuickdrawCommand command(reinterpret_cast<const uint8_t*>(macAddress), packet->command,
-                             packet->matchId, packet->playerId, packet->playerDrawTime, packet->isHunter);
+    // The peer runs firmware that reads v2, so answer it in kind
+    if (dataLen == sizeof(QuickdrawPacketV2)) {
+        rememberCompactPeer(macAddress);
+    }
 
     if(packetReceivedCallback) {
-        packetReceivedCallback(command);
+        packetReceivedCallback(*command);
     }
 
     return 1;
@@ -8,14 +8,19 @@
 #include <functional>
 #include <map>
 #include <cstdint>
+#include <optional>
 #include "utils/simple-timer.hpp"
 #include "game/player.hpp"
 #include "game/match.hpp"
 #include "id-generator.hpp"
 #include "wireless/mac-functions.hpp"
 #include "device/wireless-manager.hpp"
+#include "wireless/packet-registry.hpp"
 
-// Wire format transmitted over ESP-NOW for every quickdraw command.
+// Legacy (v1) wire format for quickdraw commands. Its size follows the
+// build's `long`: 51 bytes on the ESP32-S3, 55 on 64-bit native. Older
+// firmware accepts nothing else, so it is still what we send unless the peer
+// is known to take v2, and always for match ids that aren't UUIDs (shootout ids).
 // Defined here so tests can construct and inspect packets without duplicating the layout.
 struct QuickdrawPacket {
     char matchId[37];  // IdGenerator::UUID_BUFFER_SIZE
@@ -25,6 +30,27 @@ struct QuickdrawPacket {
     int  command;
 } __attribute__((packed));
 
+constexpr uint8_t QUICKDRAW_WIRE_VERSION = 2;
+constexpr uint8_t QUICKDRAW_FLAG_HUNTER = 0x01;
+
+// Compact wire format: the same size on every build. Multi-byte fields are
+// little-endian byte arrays so the layout never depends on the host.
+struct QuickdrawPacketV2 {
+    uint8_t version;            // QUICKDRAW_WIRE_VERSION; never a UUID character
+    uint8_t command;            // QDCommand
+    uint8_t flags;              // QUICKDRAW_FLAG_*
+    uint8_t matchId[16];        // IdGenerator::uuidStringToBytes
+    char    playerId[4];        // not null-terminated
+    uint8_t playerDrawTime[4];  // int32
+} __attribute__((packed));
+
+template <>
+struct PacketLayout<PktType::kQuickdrawCommand> : FixedPacketLayout<QuickdrawPacketV2> {
+    static bool validLength(const QuickdrawPacketV2& packet, size_t length) {
+        return length == sizeof(QuickdrawPacketV2) && packet.version == QUICKDRAW_WIRE_VERSION;
+    }
+};
+
 enum QDCommand {
     // Game Commands
     // HACK = 6,
@@ -62,6 +88,17 @@ struct QuickdrawCommand {
 
 using QDCommandTracker = std::map<int, QuickdrawCommand>;
 
+// Largest encoded command; size buffers passed to encodeQuickdrawPacket with it
+constexpr size_t QUICKDRAW_PACKET_MAX_LEN = sizeof(QuickdrawPacket);
+
+// Writes `command` as v2 when `compact` is set and its match id is a canonical
+// lowercase UUID, and in the legacy layout otherwise. Returns the number of
+// bytes written.
+size_t encodeQuickdrawPacket(const QuickdrawCommand& command, uint8_t* out, bool compact = false);
+
+// Accepts v2 and both legacy sizes. Returns nullopt for anything else.
+std::optional<QuickdrawCommand> decodeQuickdrawPacket(const uint8_t* macAddress, const uint8_t* data, size_t dataLen);
+
 class QuickdrawWirelessManager {
 public:
     QuickdrawWirelessManager();
@@ -78,7 +115,16 @@ public:
 
     void clearCallbacks();
 
+    // Send v2 to every peer. Off by default: older firmware drops v2, so
+    // until then only peers that have sent us v2 get it back.
+    void setCompactWireFormat(bool enabled);
+
 private:
+    static constexpr size_t kCompactPeerCapacity = 16;
+
+    bool isCompactPeer(const uint8_t* macAddress) const;
+    void rememberCompactPeer(const uint8_t* macAddress);
+
     WirelessManager* wirelessManager;
 
     std::function<void(const QuickdrawCommand&)> packetReceivedCallback;
@@ -90,4 +136,11 @@ private:
     SimpleTimer broadcastTimer;
 
     long broadcastDelay;
+
+    bool compactWireFormat = false;
+
+    // Peers seen sending v2, oldest overwritten first
+    uint8_t compactPeers[kCompactPeerCapacity][6] = {};
+    size_t compactPeerCount = 0;
+    size_t nextCompactPeer = 0;
 };
@@ -0,0 +1,148 @@
+//
+// Benchmark Runner Tests - Tests for cli::runBenchScenario and its JSON report
+//
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "cli/cli-bench.hpp"
+
+// ============================================
+// BENCH RUNNER TEST SUITE
+// ============================================
+
+// Sends ten bytes per iteration and fails every third one
+class CountingBenchScenario : public cli::BenchScenario {
+public:
+    const char* getName() const override { return "counting"; }
+    const char* getDescription() const override { return "test scenario"; }
+    std::string getParams() const override { return "step=10"; }
+    size_t getDefaultIterations() const override { return 6; }
+
+    bool setUp() override {
+        setUps++;
+        return setUpSucceeds;
+    }
+
+    bool runIteration() override {
+        iterations++;
+        bytesSent += 10;
+        return iterations % 3 != 0;
+    }
+
+    void resetIteration() override { resets++; }
+    void tearDown() override { tearDowns++; }
+    uint64_t getBytesSent() const override { return bytesSent; }
+    long getAllocationBudget() const override { return allocationBudget; }
+
+    bool setUpSucceeds = true;
+    long allocationBudget = -1;
+    int setUps = 0;
+    int iterations = 0;
+    int resets = 0;
+    int tearDowns = 0;
+    uint64_t bytesSent = 0;
+};
+
+class BenchRunnerTestSuite : public testing::Test {
+public:  // Public for test function access
+    // Every probe call looks like two more 8-byte allocations
+    static cli::BenchAllocations fakeProbe() {
+        static cli::BenchAllocations allocations;
+        allocations.count += 2;
+        allocations.bytes += 16;
+        return allocations;
+    }
+
+    CountingBenchScenario scenario_;
+    cli::BenchResult result_;
+};
+
+// Test: Iterations default per scenario, reset runs between them, and the
+// per-iteration averages come from counter differences
+void benchRunnerRunsScenario(BenchRunnerTestSuite* suite) {
+    ASSERT_TRUE(cli::runBenchScenario(suite->scenario_, 0, BenchRunnerTestSuite::fakeProbe,
+                                      suite->result_));
+    EXPECT_EQ(suite->scenario_.setUps, 1);
+    EXPECT_EQ(suite->scenario_.iterations, 6);
+    EXPECT_EQ(suite->scenario_.resets, 5);
+    EXPECT_EQ(suite->scenario_.tearDowns, 1);
+
+    EXPECT_EQ(suite->result_.name, "counting");
+    EXPECT_EQ(suite->result_.params, "step=10");
+    EXPECT_EQ(suite->result_.iterations, 6u);
+    EXPECT_EQ(suite->result_.failures, 2u);
+    EXPECT_TRUE(suite->result_.allocationsCounted);
+    EXPECT_DOUBLE_EQ(suite->result_.allocationsPerIteration, 2.0);
+    EXPECT_DOUBLE_EQ(suite->result_.allocatedBytesPerIteration, 16.0);
+    EXPECT_DOUBLE_EQ(suite->result_.bytesSentPerIteration, 10.0);
+    EXPECT_LE(suite->result_.p50Ns, suite->result_.p99Ns);
+    EXPECT_LE(suite->result_.p99Ns, suite->result_.maxNs);
+}
+
+// Test: A scenario that can't set up isn't run or torn down
+void benchRunnerSkipsFailedSetUp(BenchRunnerTestSuite* suite) {
+    suite->scenario_.setUpSucceeds = false;
+    EXPECT_FALSE(cli::runBenchScenario(suite->scenario_, 4, nullptr, suite->result_));
+    EXPECT_EQ(suite->scenario_.iterations, 0);
+    EXPECT_EQ(suite->scenario_.tearDowns, 0);
+    EXPECT_EQ(suite->result_.iterations, 0u);
+}
+
+// Test: Iterations allocating past the scenario's budget fail, and only
+// when a probe is counting
+void benchRunnerEnforcesAllocationBudget(BenchRunnerTestSuite* suite) {
+    // fakeProbe sees two allocations per iteration
+    suite->scenario_.allocationBudget = 2;
+    cli::runBenchScenario(suite->scenario_, 3, BenchRunnerTestSuite::fakeProbe, suite->result_);
+    EXPECT_EQ(suite->result_.overAllocationBudget, 0u);
+    EXPECT_EQ(suite->result_.failures, 1u);
+
+    suite->scenario_.allocationBudget = 1;
+    cli::runBenchScenario(suite->scenario_, 3, BenchRunnerTestSuite::fakeProbe, suite->result_);
+    EXPECT_EQ(suite->result_.allocationBudget, 1);
+    EXPECT_EQ(suite->result_.overAllocationBudget, 3u);
+    EXPECT_EQ(suite->result_.failures, 3u);
+
+    cli::runBenchScenario(suite->scenario_, 3, nullptr, suite->result_);
+    EXPECT_EQ(suite->result_.allocationBudget, -1);
+    EXPECT_EQ(suite->result_.overAllocationBudget, 0u);
+}
+
+// Test: Nearest-rank percentiles over unsorted samples
+void benchPercentilesAreNearestRank(BenchRunnerTestSuite* suite) {
+    (void)suite;
+    std::vector<uint64_t> samples;
+    EXPECT_EQ(cli::nearestRankPercentile(samples, 50), 0u);
+    for (uint64_t ns = 100; ns >= 1; ns--) {
+        samples.push_back(ns);
+    }
+    EXPECT_EQ(cli::nearestRankPercentile(samples, 0), 1u);
+    EXPECT_EQ(cli::nearestRankPercentile(samples, 50), 51u);
+    EXPECT_EQ(cli::nearestRankPercentile(samples, 95), 95u);
+    EXPECT_EQ(cli::nearestRankPercentile(samples, 99), 99u);
+    EXPECT_EQ(cli::nearestRankPercentile(samples, 100), 100u);
+}
+
+// Test: The JSON report carries every scenario's numbers, with null
+// allocations when nothing counted them
+void benchJsonReport(BenchRunnerTestSuite* suite) {
+    cli::runBenchScenario(suite->scenario_, 3, nullptr, suite->result_);
+    std::string json = cli::formatBenchJson({suite->result_});
+
+    JsonDocument doc;
+    ASSERT_FALSE(deserializeJson(doc, json));
+    EXPECT_EQ(doc["schema"].as<int>(), 1);
+    JsonObject entry = doc["scenarios"][0];
+    EXPECT_STREQ(entry["name"].as<const char*>(), "counting");
+    EXPECT_STREQ(entry["params"].as<const char*>(), "step=10");
+    EXPECT_EQ(entry["iterations"].as<int>(), 3);
+    EXPECT_EQ(entry["failures"].as<int>(), 1);
+    EXPECT_TRUE(entry["latency_ns"]["p99"].is<unsigned long>());
+    EXPECT_TRUE(entry["allocations_per_iteration"].isNull());
+    EXPECT_TRUE(entry["allocation_budget"].isNull());
+    EXPECT_EQ(entry["over_allocation_budget"].as<int>(), 0);
+    EXPECT_EQ(entry["bytes_sent_per_iteration"].as<int>(), 10);
+}
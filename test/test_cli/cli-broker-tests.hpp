@@ -9,7 +9,13 @@
 #include "device/drivers/native/native-peer-broker.hpp"
 #include "device/drivers/native/native-serial-driver.hpp"
 #include "device/drivers/native/native-peer-comms-driver.hpp"
+#include "device/drivers/native/native-virtual-clock.hpp"
 #include "device/drivers/peer-comms-types.hpp"
+#include "device/drivers/platform-clock.hpp"
+#include "utils/simple-timer.hpp"
+#include <atomic>
+#include <memory>
+#include <thread>
 
 // ============================================
 // SERIAL CABLE BROKER TEST SUITE
@@ -115,6 +121,18 @@ public:  // Public for test function access
         auto* suite = static_cast<NativePeerBrokerTestSuite*>(context);
         suite->receivedPackets_++;
     }
+
+    // A adds B as a peer and both learn each other's frame size, so a test
+    // that counts frames only sees its own
+    void exchangeLinkCaps() {
+        peerA_->addEspNowPeer(peerB_->getMacAddress());
+        broker_->deliverPackets();
+        peerB_->exec();
+        broker_->deliverPackets();
+        peerA_->exec();
+        broker_->deliverPackets();
+        peerB_->exec();
+    }
     
     NativePeerBroker* broker_;
     NativePeerCommsDriver* peerA_;
@@ -207,3 +225,792 @@ void peerBrokerDisconnectedPeerNoReceive(NativePeerBrokerTestSuite* suite) {
     
     suite->peerB_->connect();  // Reconnect for teardown
 }
+
+class BrokerTestClock : public PlatformClock {
+public:
+    unsigned long milliseconds() override { return now; }
+    unsigned long now = 0;
+};
+
+// Test: Multi-frame cluster survives frame loss and reordering via selective repeat
+void peerBrokerReassemblesClusterWithLossAndReordering(NativePeerBrokerTestSuite* suite) {
+    BrokerTestClock clock;
+    SimpleTimer::setPlatformClock(&clock);
+    suite->broker_->deliverPackets();  // flush anything left by earlier tests
+
+    std::vector<uint8_t> received;
+    suite->peerB_->setPacketHandler(PktType::kDebugPacket,
+        [](const uint8_t* srcMac, const uint8_t* data, size_t length, void* ctx) {
+            static_cast<std::vector<uint8_t>*>(ctx)->assign(data, data + length);
+        }, &received);
+
+    std::vector<uint8_t> payload(PEER_COMMS_MAX_FRAME_PAYLOAD * 3 + 40);
+    for (size_t i = 0; i < payload.size(); i++) {
+        payload[i] = static_cast<uint8_t>(i ^ 0x5A);
+    }
+
+    // Lose the first transmission of fragments 1 and 3
+    bool lost[4] = {false, false, false, false};
+    suite->broker_->setFrameFilter([&lost](const PeerPacket& packet) {
+        const auto* hdr = reinterpret_cast<const DataPktHdr*>(packet.bytes());
+        if (hdr->packetType != PktType::kDebugPacket) return true;
+        uint8_t idx = hdr->idxInCluster;
+        if ((idx == 1 || idx == 3) && !lost[idx]) {
+            lost[idx] = true;
+            return false;
+        }
+        return true;
+    });
+    suite->broker_->enableFrameReordering(7);
+
+    ASSERT_EQ(suite->peerA_->sendData(suite->peerB_->getMacAddress(), PktType::kDebugPacket,
+                                      payload.data(), payload.size()), 0);
+    suite->broker_->deliverPackets();
+    suite->peerB_->exec();
+    ASSERT_TRUE(received.empty());
+
+    // Receiver goes quiet long enough to NACK; sender repeats only what was lost
+    clock.now += 100;
+    suite->peerB_->exec();
+    suite->broker_->deliverPackets();   // NACK -> A
+    suite->broker_->deliverPackets();   // fragments 1 and 3 -> B
+    suite->peerB_->exec();
+
+    ASSERT_EQ(received, payload);
+    FragmentReassembler::Stats stats = suite->peerB_->getReassemblyStats();
+    ASSERT_EQ(stats.resendRequests, 1u);
+    ASSERT_EQ(stats.completed, 1u);
+
+    suite->broker_->setFrameFilter(nullptr);
+    suite->broker_->disableFrameReordering();
+    SimpleTimer::setPlatformClock(nullptr);
+}
+
+// Test: With limited airtime, duel traffic jumps queued bulk and stale events are dropped
+void peerBrokerTxBudgetPrioritizesDuelTraffic(NativePeerBrokerTestSuite* suite) {
+    BrokerTestClock clock;
+    SimpleTimer::setPlatformClock(&clock);
+    suite->broker_->deliverPackets();
+    suite->peerA_->setTxFramesPerExec(1);
+
+    std::vector<PktType> received;
+    auto record = [](const uint8_t* srcMac, const uint8_t* data, size_t length, void* ctx) {
+        static_cast<std::vector<PktType>*>(ctx)->push_back(static_cast<PktType>(data[0]));
+    };
+    suite->peerB_->setPacketHandler(PktType::kPlayerInfoBroadcast, record, &received);
+    suite->peerB_->setPacketHandler(PktType::kQuickdrawCommand, record, &received);
+    suite->peerB_->setPacketHandler(PktType::kChainGameEvent, record, &received);
+
+    const uint8_t* dst = suite->peerB_->getMacAddress();
+    uint8_t bulk[] = {static_cast<uint8_t>(PktType::kPlayerInfoBroadcast)};
+    uint8_t duel[] = {static_cast<uint8_t>(PktType::kQuickdrawCommand)};
+    uint8_t event[] = {static_cast<uint8_t>(PktType::kChainGameEvent)};
+    SendOptions transient = defaultSendOptions(PktType::kChainGameEvent);
+    transient.maxAgeMs = 50;
+
+    ASSERT_EQ(suite->peerA_->sendData(dst, PktType::kPlayerInfoBroadcast, bulk, 1), 0);
+    ASSERT_EQ(suite->peerA_->sendData(dst, PktType::kChainGameEvent, event, 1, transient), 0);
+    ASSERT_EQ(suite->peerA_->sendData(dst, PktType::kQuickdrawCommand, duel, 1), 0);
+    ASSERT_EQ(suite->peerA_->getSendScheduler().size(), 3u);
+
+    // First slot: the event is still fresh and goes ahead of the broadcast
+    suite->peerA_->exec();
+    // Second slot: the duel command; the broadcast still waits
+    suite->peerA_->exec();
+    suite->broker_->deliverPackets();
+    suite->peerB_->exec();
+    ASSERT_EQ(received, (std::vector<PktType>{PktType::kChainGameEvent, PktType::kQuickdrawCommand}));
+
+    // A second event queued behind the broadcast goes stale and is dropped
+    received.clear();
+    ASSERT_EQ(suite->peerA_->sendData(dst, PktType::kChainGameEvent, event, 1, transient), 0);
+    clock.now += 100;
+    suite->peerA_->exec();
+    suite->peerA_->exec();
+    suite->broker_->deliverPackets();
+    suite->peerB_->exec();
+    ASSERT_EQ(received, (std::vector<PktType>{PktType::kPlayerInfoBroadcast}));
+    ASSERT_EQ(suite->peerA_->getSendScheduler().getStats().expired[static_cast<size_t>(SendPriority::kDuel)], 1u);
+    ASSERT_EQ(suite->peerA_->getSendPool().inUse(), 0u);
+
+    suite->peerA_->setTxFramesPerExec(0);
+    SimpleTimer::setPlatformClock(nullptr);
+}
+
+// Test: A long cluster to one peer doesn't hold up a short packet to another
+void peerBrokerTxBudgetRoundRobinsDestinations(NativePeerBrokerTestSuite* suite) {
+    BrokerTestClock clock;
+    SimpleTimer::setPlatformClock(&clock);
+    suite->broker_->deliverPackets();
+    suite->peerA_->setTxFramesPerExec(2);
+
+    NativePeerCommsDriver peerC("PeerC");
+    peerC.initialize();
+    peerC.connect();
+
+    int receivedB = 0;
+    int receivedC = 0;
+    auto count = [](const uint8_t* srcMac, const uint8_t* data, size_t length, void* ctx) {
+        (*static_cast<int*>(ctx))++;
+    };
+    suite->peerB_->setPacketHandler(PktType::kShootoutCommand, count, &receivedB);
+    peerC.setPacketHandler(PktType::kShootoutCommand, count, &receivedC);
+
+    std::vector<uint8_t> bracket(PEER_COMMS_MAX_FRAME_PAYLOAD * 4);
+    uint8_t start[] = {0x01};
+    ASSERT_EQ(suite->peerA_->sendData(suite->peerB_->getMacAddress(), PktType::kShootoutCommand,
+                                      bracket.data(), bracket.size()), 0);
+    ASSERT_EQ(suite->peerA_->sendData(peerC.getMacAddress(), PktType::kShootoutCommand, start, 1), 0);
+
+    // First exec: one frame of B's cluster, then C's packet
+    suite->peerA_->exec();
+    suite->broker_->deliverPackets();
+    suite->peerB_->exec();
+    peerC.exec();
+    ASSERT_EQ(receivedC, 1);
+    ASSERT_EQ(receivedB, 0);
+
+    suite->peerA_->exec();
+    suite->peerA_->exec();
+    suite->broker_->deliverPackets();
+    suite->peerB_->exec();
+    ASSERT_EQ(receivedB, 1);
+
+    SendScheduler::DestinationStats stats;
+    ASSERT_TRUE(suite->peerA_->getSendScheduler().getDestinationStats(suite->peerB_->getMacAddress(), stats));
+    ASSERT_EQ(stats.delivered, 4u);
+    ASSERT_EQ(stats.maxDepth, 4u);
+    ASSERT_EQ(suite->peerA_->getSendPool().inUse(), 0u);
+
+    peerC.disconnect();
+    suite->peerA_->setTxFramesPerExec(0);
+    SimpleTimer::setPlatformClock(nullptr);
+}
+
+// Test: A lossy link profile is retried by the scheduler and shows up in both ends' estimates
+void peerBrokerLinkProfileFeedsLinkQuality(NativePeerBrokerTestSuite* suite) {
+    BrokerTestClock clock;
+    SimpleTimer::setPlatformClock(&clock);
+    suite->broker_->deliverPackets();
+
+    LinkProfile lossy;
+    lossy.rssiDbm = -78;
+    lossy.lossPermille = 400;
+    suite->broker_->seedLinkImpairments(7);
+    suite->broker_->setLinkProfile(suite->peerA_->getMacAddress(), suite->peerB_->getMacAddress(), lossy);
+
+    suite->peerB_->setPacketHandler(PktType::kQuickdrawCommand,
+        NativePeerBrokerTestSuite::packetCallback, suite);
+    uint8_t data[] = {0x01};
+    for (int i = 0; i < 10; i++) {
+        ASSERT_EQ(suite->peerA_->sendData(suite->peerB_->getMacAddress(), PktType::kQuickdrawCommand,
+                                          data, sizeof(data)), 0);
+    }
+    for (int i = 0; i < 50; i++) {
+        clock.now += 100;
+        suite->peerA_->exec();
+        suite->broker_->deliverPackets();
+        suite->peerB_->exec();
+    }
+
+    SendScheduler::DestinationStats stats;
+    ASSERT_TRUE(suite->peerA_->getSendScheduler().getDestinationStats(suite->peerB_->getMacAddress(), stats));
+    ASSERT_GT(stats.retries, 0u);
+    ASSERT_EQ(suite->receivedPackets_, static_cast<int>(stats.delivered));
+
+    LinkEstimate estimate;
+    ASSERT_TRUE(suite->peerA_->getLinkEstimate(suite->peerB_->getMacAddress(), estimate));
+    ASSERT_EQ(estimate.txFailed, stats.retries + stats.failed);
+    ASSERT_EQ(estimate.txDelivered, stats.delivered);
+    ASSERT_LT(estimate.deliveryPermille, 1000);
+
+    // The receiver hears the profile's RSSI; the reverse link has no profile
+    ASSERT_EQ(suite->peerB_->getRssiForPeer(suite->peerA_->getMacAddress()), -78);
+    ASSERT_EQ(suite->peerA_->getRssiForPeer(suite->peerB_->getMacAddress()), -1);
+
+    suite->broker_->clearLinkProfiles();
+    SimpleTimer::setPlatformClock(nullptr);
+}
+
+// Test: A multicast is one broadcast frame that only group members hand to their handlers
+void peerBrokerMulticastReachesOnlyMembers(NativePeerBrokerTestSuite* suite) {
+    suite->broker_->deliverPackets();
+
+    NativePeerCommsDriver peerC("PeerC");
+    peerC.initialize();
+    peerC.connect();
+
+    MulticastGroup group = multicastGroupFor("chain", suite->peerA_->getMacAddress());
+    ASSERT_EQ(suite->peerB_->joinMulticastGroup(group), 0);
+
+    int receivedC = 0;
+    suite->peerB_->setPacketHandler(PktType::kChainGameEvent,
+        NativePeerBrokerTestSuite::packetCallback, suite);
+    peerC.setPacketHandler(PktType::kChainGameEvent,
+        [](const uint8_t* srcMac, const uint8_t* data, size_t length, void* ctx) {
+            (*static_cast<int*>(ctx))++;
+        }, &receivedC);
+
+    uint8_t event[] = {0x00, 0x00};
+    ASSERT_EQ(suite->peerA_->sendMulticast(group, PktType::kChainGameEvent, event, sizeof(event),
+                                           defaultSendOptions(PktType::kChainGameEvent)), 0);
+    ASSERT_EQ(suite->broker_->getPendingPacketCount(), 1u);
+    suite->broker_->deliverPackets();
+    suite->peerB_->exec();
+    peerC.exec();
+
+    ASSERT_EQ(suite->receivedPackets_, 1);
+    ASSERT_EQ(receivedC, 0);
+    ASSERT_EQ(suite->peerB_->getPacketHistory().back().packetType, PktType::kChainGameEvent);
+    ASSERT_EQ(peerC.getMulticastMembership().getStats().filtered, 1u);
+
+    suite->peerB_->leaveMulticastGroup(group);
+    ASSERT_EQ(suite->peerA_->sendMulticast(group, PktType::kChainGameEvent, event, sizeof(event),
+                                           defaultSendOptions(PktType::kChainGameEvent)), 0);
+    suite->broker_->deliverPackets();
+    suite->peerB_->exec();
+    ASSERT_EQ(suite->receivedPackets_, 1);
+
+    peerC.disconnect();
+}
+
+void peerBrokerDuplicatesReachOnlyDuplicateHook(NativePeerBrokerTestSuite* suite) {
+    suite->broker_->deliverPackets();
+
+    int duplicates = 0;
+    suite->peerB_->setPacketHandler(PktType::kShootoutCommand,
+        NativePeerBrokerTestSuite::packetCallback, suite);
+    suite->peerB_->setDuplicateSuppression(PktType::kShootoutCommand, 1,
+        [](const uint8_t* srcMac, const uint8_t* data, size_t length, void* ctx) {
+            (*static_cast<int*>(ctx))++;
+        }, &duplicates);
+
+    // [cmd, seqId]: the retransmit repeats the sequence number
+    uint8_t command[] = {0x01, 0x07};
+    for (int i = 0; i < 2; i++) {
+        ASSERT_EQ(suite->peerA_->sendData(suite->peerB_->getMacAddress(), PktType::kShootoutCommand,
+                                          command, sizeof(command)), 0);
+        suite->broker_->deliverPackets();
+        suite->peerB_->exec();
+    }
+    ASSERT_EQ(suite->receivedPackets_, 1);
+    ASSERT_EQ(duplicates, 1);
+
+    // A fresh sequence number is a new packet
+    command[1] = 0x08;
+    ASSERT_EQ(suite->peerA_->sendData(suite->peerB_->getMacAddress(), PktType::kShootoutCommand,
+                                      command, sizeof(command)), 0);
+    suite->broker_->deliverPackets();
+    suite->peerB_->exec();
+    ASSERT_EQ(suite->receivedPackets_, 2);
+    ASSERT_EQ(suite->peerB_->getDuplicateFilter().getStats().hits, 1u);
+
+    // Without a rule every copy reaches the handler again
+    suite->peerB_->clearDuplicateSuppression(PktType::kShootoutCommand);
+    ASSERT_EQ(suite->peerA_->sendData(suite->peerB_->getMacAddress(), PktType::kShootoutCommand,
+                                      command, sizeof(command)), 0);
+    suite->broker_->deliverPackets();
+    suite->peerB_->exec();
+    ASSERT_EQ(suite->receivedPackets_, 3);
+}
+
+void peerBrokerCoalescedAcksShareOneFrame(NativePeerBrokerTestSuite* suite) {
+    suite->broker_->deliverPackets();
+    suite->exchangeLinkCaps();
+    suite->peerA_->setCoalescingEnabled(true);
+    suite->peerB_->setPacketHandler(PktType::kShootoutCommandAck,
+        NativePeerBrokerTestSuite::packetCallback, suite);
+    suite->peerB_->setPacketHandler(PktType::kRoleAnnounceAck,
+        NativePeerBrokerTestSuite::packetCallback, suite);
+
+    suite->broker_->resetFramesSent();
+    uint8_t shootoutAck[] = {0x01, 0x05};
+    uint8_t roleAck[] = {0x06};
+    const uint8_t* dst = suite->peerB_->getMacAddress();
+    ASSERT_EQ(suite->peerA_->sendData(dst, PktType::kShootoutCommandAck, shootoutAck, sizeof(shootoutAck)), 0);
+    ASSERT_EQ(suite->peerA_->sendData(dst, PktType::kRoleAnnounceAck, roleAck, sizeof(roleAck)), 0);
+    ASSERT_EQ(suite->peerA_->sendData(dst, PktType::kShootoutCommandAck, shootoutAck, sizeof(shootoutAck)), 0);
+    ASSERT_EQ(suite->broker_->getFramesSent(), 0u);
+
+    // Staged messages leave together on the sender's next tick
+    suite->peerA_->exec();
+    ASSERT_EQ(suite->broker_->getFramesSent(), 1u);
+    suite->broker_->deliverPackets();
+    suite->peerB_->exec();
+    ASSERT_EQ(suite->receivedPackets_, 3);
+    ASSERT_EQ(suite->peerB_->getPacketHistory().back().packetType, PktType::kShootoutCommandAck);
+    ASSERT_EQ(suite->peerA_->getPacketCoalescer().getStats().framesSaved, 2u);
+
+    // Anything else to the same peer flushes the waiting acks ahead of it
+    ASSERT_EQ(suite->peerA_->sendData(dst, PktType::kRoleAnnounceAck, roleAck, sizeof(roleAck)), 0);
+    uint8_t command[] = {0x00};
+    ASSERT_EQ(suite->peerA_->sendData(dst, PktType::kQuickdrawCommand, command, sizeof(command)), 0);
+    ASSERT_EQ(suite->broker_->getFramesSent(), 3u);
+
+    suite->peerA_->setCoalescingEnabled(false);
+}
+
+// Test: A bulk message larger than the fragment layer allows crosses a lossy link intact
+void peerBrokerBulkTransferSurvivesLossyLink(NativePeerBrokerTestSuite* suite) {
+    BrokerTestClock clock;
+    SimpleTimer::setPlatformClock(&clock);
+    suite->broker_->deliverPackets();
+
+    LinkProfile lossy;
+    lossy.lossPermille = 300;
+    suite->broker_->seedLinkImpairments(11);
+    suite->broker_->setLinkProfile(suite->peerA_->getMacAddress(), suite->peerB_->getMacAddress(), lossy);
+    suite->broker_->setLinkProfile(suite->peerB_->getMacAddress(), suite->peerA_->getMacAddress(), lossy);
+
+    std::vector<uint8_t> received;
+    suite->peerB_->setBulkHandler(1,
+        [](const uint8_t* srcMac, const uint8_t* data, size_t length, void* ctx) {
+            static_cast<std::vector<uint8_t>*>(ctx)->assign(data, data + length);
+        }, &received);
+
+    std::vector<uint8_t> history(255 * PEER_COMMS_MAX_FRAME_PAYLOAD + 1000);
+    for (size_t i = 0; i < history.size(); i++) {
+        history[i] = static_cast<uint8_t>(i * 13 + (i >> 8));
+    }
+    ASSERT_EQ(suite->peerA_->sendData(suite->peerB_->getMacAddress(), PktType::kDebugPacket,
+                                      history.data(), history.size()), -1);
+    int transferId = suite->peerA_->sendBulk(suite->peerB_->getMacAddress(), 1, history.data(), history.size());
+    ASSERT_GT(transferId, 0);
+
+    BulkTransferStatus status;
+    for (int i = 0; i < 5000; i++) {
+        clock.now += 5;
+        suite->peerA_->exec();
+        suite->broker_->deliverPackets();
+        suite->peerB_->exec();
+        suite->broker_->deliverPackets();
+        ASSERT_TRUE(suite->peerA_->getBulkTransferStatus(transferId, status));
+        if (status.state == BulkTransferState::kComplete) {
+            break;
+        }
+    }
+
+    ASSERT_EQ(status.state, BulkTransferState::kComplete);
+    ASSERT_EQ(received, history);
+    ASSERT_EQ(suite->peerB_->getBulkTransfer().getStats().completedIn, 1u);
+
+    SendScheduler::DestinationStats sendStats;
+    ASSERT_TRUE(suite->peerA_->getSendScheduler().getDestinationStats(suite->peerB_->getMacAddress(), sendStats));
+    ASSERT_GT(sendStats.retries, 0u);
+
+    suite->peerB_->clearBulkHandler(1);
+    suite->broker_->clearLinkProfiles();
+    SimpleTimer::setPlatformClock(nullptr);
+}
+
+// Test: Both ends count the same frames per packet type, fragments included
+void peerBrokerTrafficCountersTrackFramesPerType(NativePeerBrokerTestSuite* suite) {
+    suite->broker_->deliverPackets();
+    suite->peerA_->resetTrafficStats();
+    suite->peerB_->resetTrafficStats();
+    suite->peerB_->setPacketHandler(PktType::kDebugPacket,
+        NativePeerBrokerTestSuite::packetCallback, suite);
+
+    const uint8_t* dst = suite->peerB_->getMacAddress();
+    uint8_t small[10] = {};
+    std::vector<uint8_t> large(PEER_COMMS_MAX_FRAME_PAYLOAD * 2 + 1, 0x5A);
+    ASSERT_EQ(suite->peerA_->sendData(dst, PktType::kDebugPacket, small, sizeof(small)), 0);
+    ASSERT_EQ(suite->peerA_->sendData(dst, PktType::kDebugPacket, large.data(), large.size()), 0);
+    suite->peerA_->exec();
+    suite->broker_->deliverPackets();
+    suite->peerB_->exec();
+    ASSERT_EQ(suite->receivedPackets_, 2);
+
+    TrafficStats::Snapshot sent;
+    TrafficStats::Snapshot received;
+    ASSERT_TRUE(suite->peerA_->getTrafficSnapshot(sent));
+    ASSERT_TRUE(suite->peerB_->getTrafficSnapshot(received));
+
+    const TrafficCounters& tx = sent.get(TrafficDirection::kTx, PktType::kDebugPacket);
+    const TrafficCounters& rx = received.get(TrafficDirection::kRx, PktType::kDebugPacket);
+    size_t expectedBytes = 4 * sizeof(DataPktHdr) + sizeof(small) + large.size();
+    ASSERT_EQ(tx.frames, 4u);
+    ASSERT_EQ(tx.fragments, 3u);
+    ASSERT_EQ(tx.bytes, expectedBytes);
+    ASSERT_EQ(tx.failures, 0u);
+    ASSERT_EQ(rx.frames, tx.frames);
+    ASSERT_EQ(rx.fragments, tx.fragments);
+    ASSERT_EQ(rx.bytes, tx.bytes);
+
+    // Nothing else went on air but the caps each side asked for on first contact
+    ASSERT_EQ(sent.get(TrafficDirection::kTx, PktType::kLinkCaps).frames, 1u);
+    ASSERT_EQ(sent.total(TrafficDirection::kTx).frames, 5u);
+    ASSERT_EQ(received.total(TrafficDirection::kTx).frames, 1u);
+    ASSERT_GT(estimateAirtimeUs(tx), 4 * ESP_NOW_PREAMBLE_US);
+
+    suite->peerA_->resetTrafficStats();
+    ASSERT_TRUE(suite->peerA_->getTrafficSnapshot(sent));
+    ASSERT_EQ(sent.total(TrafficDirection::kTx).frames, 0u);
+}
+
+// Test: Link latency, bandwidth and duplication hold frames back on the platform clock
+void peerBrokerImpairedLinkDelaysDelivery(NativePeerBrokerTestSuite* suite) {
+    BrokerTestClock clock;
+    SimpleTimer::setPlatformClock(&clock);
+    suite->broker_->deliverPackets();
+    suite->peerB_->setPacketHandler(PktType::kDebugPacket,
+        NativePeerBrokerTestSuite::packetCallback, suite);
+
+    const uint8_t* a = suite->peerA_->getMacAddress();
+    const uint8_t* b = suite->peerB_->getMacAddress();
+    LinkProfile slow;
+    slow.latencyMs = 30;
+    slow.duplicatePermille = 1000;
+    suite->broker_->setLinkProfile(a, b, slow);
+
+    uint8_t data[100] = {1};
+    ASSERT_TRUE(suite->broker_->sendPacket(a, b, PktType::kDebugPacket, data, sizeof(data)));
+    ASSERT_EQ(suite->broker_->getPendingPacketCount(), 2u);
+    clock.now = 29;
+    suite->broker_->deliverPackets();
+    suite->peerB_->exec();
+    ASSERT_EQ(suite->receivedPackets_, 0);
+    clock.now = 30;
+    suite->broker_->deliverPackets();
+    suite->peerB_->exec();
+    ASSERT_EQ(suite->broker_->getPendingPacketCount(), 0u);
+    ASSERT_EQ(suite->receivedPackets_, 2);  // debug packets have no duplicate rule
+
+    // 100 B at 1000 B/s is 100 ms each, so three frames arrive 100 ms apart
+    LinkProfile narrow;
+    narrow.bandwidthBytesPerSec = 1000;
+    suite->broker_->setLinkProfile(a, b, narrow);
+    for (uint8_t i = 0; i < 3; i++) {
+        data[0] = 10 + i;
+        ASSERT_TRUE(suite->broker_->sendPacket(a, b, PktType::kDebugPacket, data, sizeof(data)));
+    }
+    clock.now += 150;
+    suite->broker_->deliverPackets();
+    ASSERT_EQ(suite->broker_->getPendingPacketCount(), 2u);
+    clock.now += 100;
+    suite->broker_->deliverPackets();
+    ASSERT_EQ(suite->broker_->getPendingPacketCount(), 1u);
+
+    // Clearing the profiles releases whatever is still in flight
+    suite->broker_->clearLinkProfiles();
+    suite->broker_->deliverPackets();
+    ASSERT_EQ(suite->broker_->getPendingPacketCount(), 0u);
+
+    suite->peerB_->clearPacketHandler(PktType::kDebugPacket);
+    SimpleTimer::setPlatformClock(nullptr);
+}
+
+// Test: Burst loss and jitter replay identically from the same seed
+void peerBrokerImpairmentsRepeatFromSeed(NativePeerBrokerTestSuite* suite) {
+    BrokerTestClock clock;
+    SimpleTimer::setPlatformClock(&clock);
+    suite->broker_->deliverPackets();
+
+    const uint8_t* a = suite->peerA_->getMacAddress();
+    const uint8_t* b = suite->peerB_->getMacAddress();
+    LinkProfile bursty;
+    bursty.burstEnterPermille = 50;
+    bursty.burstExitPermille = 250;
+    bursty.latencyMs = 5;
+    bursty.jitterMs = 20;
+    bursty.reorderPermille = 100;
+    suite->broker_->setDefaultLinkProfile(bursty);
+
+    struct Run {
+        std::vector<bool> sent;
+        std::vector<size_t> pending;
+    };
+    auto run = [&](uint32_t seed) {
+        Run result;
+        suite->broker_->seedLinkImpairments(seed);
+        suite->broker_->setDefaultLinkProfile(bursty);
+        uint8_t data[4] = {};
+        for (int i = 0; i < 400; i++) {
+            data[0] = static_cast<uint8_t>(i);
+            result.sent.push_back(suite->broker_->sendFrame(a, b, data, sizeof(data)));
+            clock.now += 2;
+            suite->broker_->deliverPackets();
+            result.pending.push_back(suite->broker_->getPendingPacketCount());
+        }
+        clock.now += 100;
+        suite->broker_->deliverPackets();
+        return result;
+    };
+
+    Run first = run(42);
+    Run second = run(42);
+    Run other = run(43);
+    ASSERT_EQ(first.sent, second.sent);
+    ASSERT_EQ(first.pending, second.pending);
+    ASSERT_NE(first.sent, other.sent);
+
+    // Losses come in runs, not one at a time
+    size_t lost = 0;
+    size_t longestBurst = 0;
+    size_t burst = 0;
+    for (bool delivered : first.sent) {
+        burst = delivered ? 0 : burst + 1;
+        lost += delivered ? 0 : 1;
+        longestBurst = std::max(longestBurst, burst);
+    }
+    ASSERT_GT(lost, 0u);
+    ASSERT_LT(lost, first.sent.size());
+    ASSERT_GE(longestBurst, 3u);
+
+    suite->broker_->clearLinkProfiles();
+    suite->broker_->deliverPackets();
+    SimpleTimer::setPlatformClock(nullptr);
+}
+
+// Test: Every receiver's copy of an impaired broadcast shares one payload, and
+// peers can come and go while another thread delivers
+void peerBrokerBroadcastSharesPayloadAcrossReceivers(NativePeerBrokerTestSuite* suite) {
+    suite->broker_->deliverPackets();
+
+    std::vector<std::unique_ptr<NativePeerCommsDriver>> crowd;
+    for (int i = 0; i < 30; i++) {
+        crowd.emplace_back(new NativePeerCommsDriver("Crowd" + std::to_string(i)));
+        crowd.back()->initialize();
+        crowd.back()->connect();
+    }
+
+    // A default profile fans each broadcast out into one copy per receiver
+    suite->broker_->setDefaultLinkProfile(LinkProfile());
+    std::vector<const void*> payloads;
+    suite->broker_->setFrameFilter([&payloads](const PeerPacket& packet) {
+        payloads.push_back(packet.payload.get());
+        return true;
+    });
+
+    uint8_t broadcastMac[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    uint8_t frame[sizeof(DataPktHdr) + 4] = {};
+    ASSERT_TRUE(suite->broker_->sendFrame(suite->peerA_->getMacAddress(), broadcastMac, frame, sizeof(frame)));
+    ASSERT_EQ(suite->broker_->getPendingPacketCount(), crowd.size() + 1);
+    suite->broker_->deliverPackets();
+
+    ASSERT_EQ(payloads.size(), crowd.size() + 1);
+    for (const void* payload : payloads) {
+        ASSERT_EQ(payload, payloads[0]);
+    }
+    suite->broker_->setFrameFilter(nullptr);
+    suite->broker_->clearLinkProfiles();
+
+    // Register and unregister from another thread while broadcasts fan out
+    std::atomic<bool> done(false);
+    std::thread churn([&]() {
+        for (int i = 0; i < 100; i++) {
+            NativePeerCommsDriver visitor("Visitor");
+            visitor.initialize();
+            visitor.connect();
+        }
+        done = true;
+    });
+    while (!done) {
+        suite->broker_->sendFrame(suite->peerA_->getMacAddress(), broadcastMac, frame, sizeof(frame));
+        suite->broker_->deliverPackets();
+    }
+    churn.join();
+    suite->broker_->deliverPackets();
+    ASSERT_EQ(suite->broker_->getPeerCount(), crowd.size() + 2);
+
+    for (auto& peer : crowd) {
+        peer->disconnect();
+    }
+}
+
+// Test: A capture holds every transmission as an 802.11 frame and replays with its timing
+void peerBrokerCaptureReplaysTraffic(NativePeerBrokerTestSuite* suite) {
+    BrokerTestClock clock;
+    clock.now = 5000;
+    SimpleTimer::setPlatformClock(&clock);
+    suite->broker_->deliverPackets();
+    std::string path = testing::TempDir() + "peer-broker-capture.pcap";
+    suite->exchangeLinkCaps();
+
+    const uint8_t* a = suite->peerA_->getMacAddress();
+    const uint8_t* b = suite->peerB_->getMacAddress();
+    ASSERT_TRUE(suite->broker_->startCapture(path.c_str()));
+    uint8_t small[] = {0xC0, 0xFF, 0xEE};
+    std::vector<uint8_t> large(PEER_COMMS_MAX_FRAME_PAYLOAD + 20, 0x42);
+    ASSERT_EQ(suite->peerA_->sendData(b, PktType::kDebugPacket, small, sizeof(small)), 0);
+    suite->peerA_->exec();
+    clock.now += 100;
+    ASSERT_EQ(suite->peerA_->sendData(b, PktType::kDebugPacket, large.data(), large.size()), 0);
+    suite->peerA_->exec();
+    suite->broker_->deliverPackets();
+    ASSERT_EQ(suite->broker_->getCapturedFrameCount(), 2u);
+    suite->broker_->stopCapture();
+    suite->peerB_->exec();  // live copies, before B listens
+
+    PeerCaptureReader reader;
+    ASSERT_TRUE(reader.open(path.c_str()));
+    std::vector<CapturedFrame> frames;
+    CapturedFrame frame;
+    while (reader.next(frame)) {
+        frames.push_back(frame);
+    }
+    ASSERT_EQ(frames.size(), 2u);
+    ASSERT_EQ(frames[0].timestampUs, 5000000u);
+    ASSERT_EQ(frames[1].timestampUs, 5100000u);
+    ASSERT_EQ(memcmp(frames[0].srcMac.data(), a, 6), 0);
+    ASSERT_EQ(memcmp(frames[0].dstMac.data(), b, 6), 0);
+    // The single-frame packet carries the header the radio would have sent
+    ASSERT_EQ(frames[0].frame.size(), sizeof(DataPktHdr) + sizeof(small));
+    const auto* hdr = reinterpret_cast<const DataPktHdr*>(frames[0].frame.data());
+    ASSERT_EQ(hdr->packetType, PktType::kDebugPacket);
+    ASSERT_EQ(hdr->numPktsInCluster, 1);
+    ASSERT_EQ(memcmp(frames[0].frame.data() + sizeof(DataPktHdr), small, sizeof(small)), 0);
+    // B takes v2 frames, so the larger packet went as one, across two vendor elements
+    ASSERT_EQ(frames[1].frame.size(), sizeof(DataPktHdr) + large.size());
+    ASSERT_EQ(reinterpret_cast<const DataPktHdr*>(frames[1].frame.data())->pktLen, DATA_PKT_LEN_LONG);
+    reader.close();
+
+    // Replay A's side of the conversation from a stand-in address
+    suite->peerB_->setPacketHandler(PktType::kDebugPacket,
+        NativePeerBrokerTestSuite::packetCallback, suite);
+    uint8_t standIn[6] = {0x02, 0x00, 0x00, 0x00, 0xEE, 0x01};
+    suite->broker_->mapReplayAddress(a, standIn);
+    ASSERT_TRUE(suite->broker_->startReplay(path.c_str()));
+    suite->broker_->deliverPackets();
+    suite->peerB_->exec();
+    ASSERT_EQ(suite->receivedPackets_, 1);
+    ASSERT_TRUE(suite->broker_->isReplaying());
+
+    clock.now += 99;
+    suite->broker_->deliverPackets();
+    suite->peerB_->exec();
+    ASSERT_EQ(suite->receivedPackets_, 1);
+    clock.now += 1;
+    suite->broker_->deliverPackets();
+    suite->peerB_->exec();
+    ASSERT_EQ(suite->receivedPackets_, 2);
+    ASSERT_FALSE(suite->broker_->isReplaying());
+
+    suite->broker_->stopReplay();
+    suite->peerB_->clearPacketHandler(PktType::kDebugPacket);
+    std::remove(path.c_str());
+    SimpleTimer::setPlatformClock(nullptr);
+}
+
+// Test: Peers that both take v2 frames send large packets in far fewer frames;
+// an older radio keeps getting small ones, and the broker holds v2 frames back from it
+void peerBrokerLargeFramesNegotiatedPerPeer(NativePeerBrokerTestSuite* suite) {
+    suite->broker_->deliverPackets();
+    NativePeerCommsDriver legacy("PeerC");
+    legacy.setMaxFrameLen(PEER_COMMS_MAX_FRAME_LEN);
+    legacy.initialize();
+    legacy.connect();
+
+    std::vector<uint8_t> received;
+    auto keep = [](const uint8_t*, const uint8_t* data, size_t length, void* ctx) {
+        static_cast<std::vector<uint8_t>*>(ctx)->assign(data, data + length);
+    };
+    suite->peerB_->setPacketHandler(PktType::kDebugPacket, keep, &received);
+    legacy.setPacketHandler(PktType::kDebugPacket, keep, &received);
+
+    const uint8_t* a = suite->peerA_->getMacAddress();
+    const uint8_t* b = suite->peerB_->getMacAddress();
+    const uint8_t* c = legacy.getMacAddress();
+    std::vector<uint8_t> bracket(1200);
+    for (size_t i = 0; i < bracket.size(); i++) {
+        bracket[i] = static_cast<uint8_t>(i * 31);
+    }
+
+    // Until B's caps arrive it gets small frames, behind A's caps request
+    suite->broker_->resetFramesSent();
+    ASSERT_EQ(suite->peerA_->sendData(b, PktType::kDebugPacket, bracket.data(), bracket.size()), 0);
+    ASSERT_EQ(suite->broker_->getFramesSent(), 1u + fragmentCount(bracket.size()));
+    suite->broker_->deliverPackets();
+    suite->peerB_->exec();
+    suite->broker_->deliverPackets();
+    suite->peerA_->exec();
+    suite->broker_->deliverPackets();
+    suite->peerB_->exec();
+    ASSERT_EQ(received, bracket);
+    ASSERT_EQ(suite->peerA_->getPeerTable().maxFrameLen(b), PEER_COMMS_MAX_FRAME_LEN_V2);
+    ASSERT_EQ(suite->peerB_->getPeerTable().maxFrameLen(a), PEER_COMMS_MAX_FRAME_LEN_V2);
+
+    received.clear();
+    suite->broker_->resetFramesSent();
+    ASSERT_EQ(suite->peerA_->sendData(b, PktType::kDebugPacket, bracket.data(), bracket.size()), 0);
+    ASSERT_EQ(suite->broker_->getFramesSent(), 1u);
+    suite->broker_->deliverPackets();
+    suite->peerB_->exec();
+    ASSERT_EQ(received, bracket);
+    ASSERT_EQ(suite->peerA_->getLargeSendPool().available(), LARGE_SEND_FRAME_POOL_BLOCKS);
+
+    // The older radio says it takes PEER_COMMS_MAX_FRAME_LEN and is held to it
+    suite->peerA_->addEspNowPeer(c);
+    suite->broker_->deliverPackets();
+    legacy.exec();
+    suite->broker_->deliverPackets();
+    suite->peerA_->exec();
+    ASSERT_EQ(suite->peerA_->getPeerTable().maxFrameLen(c), PEER_COMMS_MAX_FRAME_LEN);
+
+    received.clear();
+    suite->broker_->resetFramesSent();
+    ASSERT_EQ(suite->peerA_->sendData(c, PktType::kDebugPacket, bracket.data(), bracket.size()), 0);
+    ASSERT_EQ(suite->broker_->getFramesSent(), fragmentCount(bracket.size()));
+    suite->broker_->deliverPackets();
+    legacy.exec();
+    ASSERT_EQ(received, bracket);
+
+    // A v2 frame never reaches the older radio, nor leaves it
+    std::vector<uint8_t> frame(PEER_COMMS_MAX_FRAME_LEN_V2);
+    size_t len = buildFragment(frame.data(), PktType::kDebugPacket, bracket.data(), bracket.size(), 0, 1,
+                               PEER_COMMS_MAX_FRAME_PAYLOAD_V2);
+    uint32_t oversize = suite->broker_->getOversizeFrameCount();
+    ASSERT_FALSE(suite->broker_->sendFrame(a, c, frame.data(), len));
+    ASSERT_FALSE(suite->broker_->sendFrame(c, b, frame.data(), len));
+    ASSERT_TRUE(suite->broker_->sendFrame(a, b, frame.data(), len));
+    ASSERT_EQ(suite->broker_->getOversizeFrameCount(), oversize + 2);
+    suite->broker_->deliverPackets();
+
+    suite->peerB_->clearPacketHandler(PktType::kDebugPacket);
+    legacy.disconnect();
+}
+
+// Test: The virtual clock jumps to the next timer deadline or delayed
+// delivery instead of stepping through idle time
+void peerBrokerVirtualClockSkipsIdleTime(NativePeerBrokerTestSuite* suite) {
+    NativeVirtualClock clock("virtual_clock", 1000);
+    SimpleTimer::setPlatformClock(&clock);
+    suite->broker_->deliverPackets();
+    suite->peerB_->setPacketHandler(PktType::kDebugPacket,
+        NativePeerBrokerTestSuite::packetCallback, suite);
+
+    // SimpleTimer reports its deadline; a timer reads expired one ms after it
+    SimpleTimer timer;
+    timer.setTimer(250);
+    ASSERT_EQ(clock.advanceToNextEvent(0), 1251u);
+    ASSERT_TRUE(timer.expired());
+
+    // The step limit still applies, and time always moves
+    timer.setTimer(500);
+    ASSERT_EQ(clock.advanceToNextEvent(100), 1351u);
+    ASSERT_FALSE(timer.expired());
+    clock.setTime(2000);
+    ASSERT_EQ(clock.getScheduledCount(), 0u);
+    ASSERT_EQ(clock.advanceToNextEvent(0), 2001u);
+
+    // Latency holds the packet back; the clock lands on its delivery time
+    const uint8_t* a = suite->peerA_->getMacAddress();
+    const uint8_t* b = suite->peerB_->getMacAddress();
+    LinkProfile slow;
+    slow.latencyMs = 40;
+    suite->broker_->setLinkProfile(a, b, slow);
+    uint8_t data[8] = {1};
+    ASSERT_TRUE(suite->broker_->sendPacket(a, b, PktType::kDebugPacket, data, sizeof(data)));
+    unsigned long dueMs = 0;
+    ASSERT_TRUE(suite->broker_->getNextDeliveryMs(dueMs));
+    ASSERT_EQ(dueMs, 2041u);
+    ASSERT_EQ(clock.advanceWithBroker(0), 2041u);
+    suite->broker_->deliverPackets();
+    suite->peerB_->exec();
+    ASSERT_EQ(suite->receivedPackets_, 1);
+    ASSERT_FALSE(suite->broker_->getNextDeliveryMs(dueMs));
+
+    suite->broker_->clearLinkProfiles();
+    suite->peerB_->clearPacketHandler(PktType::kDebugPacket);
+    SimpleTimer::setPlatformClock(nullptr);
+}
@@ -0,0 +1,89 @@
+//
+// Fleet Simulator Tests - Tests for cli::FleetScript and cli::FleetTickStats
+//
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "cli/cli-fleet.hpp"
+
+// ============================================
+// FLEET SCRIPT TEST SUITE
+// ============================================
+
+class FleetScriptTestSuite : public testing::Test {
+public:  // Public for test function access
+    // Run everything due at `nowMs`, collecting the commands
+    std::vector<std::string> runAt(unsigned long nowMs) {
+        std::vector<std::string> ran;
+        script_.runDue(nowMs, [&](const std::string& command) { ran.push_back(command); });
+        return ran;
+    }
+
+    cli::FleetScript script_;
+    std::string error_;
+};
+
+// Test: Malformed lines are rejected with a reason; comments are skipped
+void fleetScriptParsesLines(FleetScriptTestSuite* suite) {
+    EXPECT_TRUE(suite->script_.addLine("", suite->error_));
+    EXPECT_TRUE(suite->script_.addLine("  # cable everyone up", suite->error_));
+    EXPECT_TRUE(suite->script_.addLine("at 100 cable 0 1", suite->error_));
+    EXPECT_TRUE(suite->script_.addLine("every 50 from 20 b {dev}", suite->error_));
+    EXPECT_TRUE(suite->script_.addLine("every 50 state", suite->error_));
+    EXPECT_EQ(suite->script_.getStepCount(), 3u);
+
+    EXPECT_FALSE(suite->script_.addLine("at soon b 0", suite->error_));
+    EXPECT_FALSE(suite->script_.addLine("every 0 b 0", suite->error_));
+    EXPECT_FALSE(suite->script_.addLine("every 10 from x b 0", suite->error_));
+    EXPECT_FALSE(suite->script_.addLine("at 10", suite->error_));
+    EXPECT_FALSE(suite->script_.addLine("press 0", suite->error_));
+    EXPECT_NE(suite->error_.find("press"), std::string::npos);
+    EXPECT_EQ(suite->script_.getStepCount(), 3u);
+}
+
+// Test: One-shot steps run once, at their time, relative to the start
+void fleetScriptRunsOnceAndRepeats(FleetScriptTestSuite* suite) {
+    suite->script_.addLine("at 100 cable 0 1", suite->error_);
+    suite->script_.addLine("every 40 from 20 state", suite->error_);
+    suite->script_.start(2, 1000);
+
+    EXPECT_TRUE(suite->runAt(1019).empty());
+    EXPECT_EQ(suite->runAt(1020), std::vector<std::string>{"state"});
+    // A late tick catches up on everything it missed, in order
+    EXPECT_EQ(suite->runAt(1100), (std::vector<std::string>{"state", "cable 0 1", "state"}));
+    EXPECT_TRUE(suite->runAt(1139).empty());
+    EXPECT_EQ(suite->runAt(1140), std::vector<std::string>{"state"});
+    EXPECT_TRUE(suite->script_.hasPending());
+}
+
+// Test: {dev} fans out over the fleet, spread across the period; {mate}
+// skips the odd one out
+void fleetScriptFansOutPerDevice(FleetScriptTestSuite* suite) {
+    suite->script_.addLine("every 30 b {dev}", suite->error_);
+    suite->script_.addLine("at 0 cable {dev} {mate}", suite->error_);
+    suite->script_.start(3, 0);
+
+    EXPECT_EQ(suite->runAt(0), (std::vector<std::string>{"b 0", "cable 0 1", "cable 1 0"}));
+    EXPECT_EQ(suite->runAt(10), std::vector<std::string>{"b 1"});
+    EXPECT_EQ(suite->runAt(20), std::vector<std::string>{"b 2"});
+    EXPECT_EQ(suite->runAt(30), std::vector<std::string>{"b 0"});
+}
+
+// Test: Percentiles are nearest-rank over every tick recorded
+void fleetTickStatsPercentiles(FleetScriptTestSuite* suite) {
+    cli::FleetTickStats stats;
+    EXPECT_EQ(stats.percentileUs(99), 0u);
+    for (uint32_t us = 100; us >= 1; us--) {
+        stats.record(us, us > 95);
+    }
+    EXPECT_EQ(stats.getTicks(), 100u);
+    EXPECT_EQ(stats.getOverruns(), 5u);
+    EXPECT_EQ(stats.meanUs(), 50u);
+    EXPECT_EQ(stats.percentileUs(0), 1u);
+    EXPECT_EQ(stats.percentileUs(50), 51u);
+    EXPECT_EQ(stats.percentileUs(99), 99u);
+    EXPECT_EQ(stats.percentileUs(100), 100u);
+}
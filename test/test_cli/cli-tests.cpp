@@ -7,7 +7,9 @@
 #include <gmock/gmock.h>
 
 // CLI-specific test headers
+#include "cli-bench-tests.hpp"
 #include "cli-broker-tests.hpp"
+#include "cli-fleet-tests.hpp"
 #include "cli-http-server-tests.hpp"
 #include "native-driver-tests.hpp"
 
@@ -55,6 +57,66 @@ TEST_F(NativePeerBrokerTestSuite, DisconnectedPeerNoReceive) {
     peerBrokerDisconnectedPeerNoReceive(this);
 }
 
+TEST_F(NativePeerBrokerTestSuite, ReassemblesClusterWithLossAndReordering) {
+    peerBrokerReassemblesClusterWithLossAndReordering(this);
+}
+
+TEST_F(NativePeerBrokerTestSuite, TxBudgetPrioritizesDuelTraffic) {
+    peerBrokerTxBudgetPrioritizesDuelTraffic(this);
+}
+
+TEST_F(NativePeerBrokerTestSuite, TxBudgetRoundRobinsDestinations) {
+    peerBrokerTxBudgetRoundRobinsDestinations(this);
+}
+
+TEST_F(NativePeerBrokerTestSuite, LinkProfileFeedsLinkQuality) {
+    peerBrokerLinkProfileFeedsLinkQuality(this);
+}
+
+TEST_F(NativePeerBrokerTestSuite, MulticastReachesOnlyMembers) {
+    peerBrokerMulticastReachesOnlyMembers(this);
+}
+
+TEST_F(NativePeerBrokerTestSuite, DuplicatesReachOnlyDuplicateHook) {
+    peerBrokerDuplicatesReachOnlyDuplicateHook(this);
+}
+
+TEST_F(NativePeerBrokerTestSuite, CoalescedAcksShareOneFrame) {
+    peerBrokerCoalescedAcksShareOneFrame(this);
+}
+
+TEST_F(NativePeerBrokerTestSuite, BulkTransferSurvivesLossyLink) {
+    peerBrokerBulkTransferSurvivesLossyLink(this);
+}
+
+TEST_F(NativePeerBrokerTestSuite, TrafficCountersTrackFramesPerType) {
+    peerBrokerTrafficCountersTrackFramesPerType(this);
+}
+
+TEST_F(NativePeerBrokerTestSuite, ImpairedLinkDelaysDelivery) {
+    peerBrokerImpairedLinkDelaysDelivery(this);
+}
+
+TEST_F(NativePeerBrokerTestSuite, ImpairmentsRepeatFromSeed) {
+    peerBrokerImpairmentsRepeatFromSeed(this);
+}
+
+TEST_F(NativePeerBrokerTestSuite, BroadcastSharesPayloadAcrossReceivers) {
+    peerBrokerBroadcastSharesPayloadAcrossReceivers(this);
+}
+
+TEST_F(NativePeerBrokerTestSuite, CaptureReplaysTraffic) {
+    peerBrokerCaptureReplaysTraffic(this);
+}
+
+TEST_F(NativePeerBrokerTestSuite, LargeFramesNegotiatedPerPeer) {
+    peerBrokerLargeFramesNegotiatedPerPeer(this);
+}
+
+TEST_F(NativePeerBrokerTestSuite, VirtualClockSkipsIdleTime) {
+    peerBrokerVirtualClockSkipsIdleTime(this);
+}
+
 // ============================================
 // MOCK HTTP SERVER TESTS
 // ============================================
@@ -163,6 +225,26 @@ TEST_F(NativePeerCommsDriverTestSuite, HandlerRegistration) {
     peerCommsHandlerRegistration(this);
 }
 
+TEST_F(NativePeerCommsDriverTestSuite, RecvRingOverflowCounted) {
+    peerCommsRecvRingOverflowCounted(this);
+}
+
+TEST_F(NativePeerCommsDriverTestSuite, SendUsesFramePool) {
+    peerCommsSendUsesFramePool(this);
+}
+
+TEST_F(NativePeerCommsDriverTestSuite, SendFailsWhenPoolExhausted) {
+    peerCommsSendFailsWhenPoolExhausted(this);
+}
+
+TEST_F(NativePeerCommsDriverTestSuite, PeerTableEvictsLruButKeepsPinned) {
+    peerCommsPeerTableEvictsLruButKeepsPinned(this);
+}
+
+TEST_F(NativePeerCommsDriverTestSuite, CapsSurviveEviction) {
+    peerCommsCapsSurviveEviction(this);
+}
+
 // ============================================
 // NATIVE BUTTON DRIVER TESTS
 // ============================================
@@ -411,6 +493,58 @@ TEST_F(CliCommandTestSuite, RebootClearsHistory) {
     cliCommandRebootClearsHistory(this);
 }
 
+// ============================================
+// CLI VIRTUAL TIME TESTS
+// ============================================
+
+TEST_F(CliVirtualTimeTestSuite, DuelRunsToResult) {
+    cliVirtualTimeDuelRunsToResult(this);
+}
+
+// ============================================
+// FLEET SIMULATOR TESTS
+// ============================================
+
+TEST_F(FleetScriptTestSuite, ParsesLines) {
+    fleetScriptParsesLines(this);
+}
+
+TEST_F(FleetScriptTestSuite, RunsOnceAndRepeats) {
+    fleetScriptRunsOnceAndRepeats(this);
+}
+
+TEST_F(FleetScriptTestSuite, FansOutPerDevice) {
+    fleetScriptFansOutPerDevice(this);
+}
+
+TEST_F(FleetScriptTestSuite, TickStatsPercentiles) {
+    fleetTickStatsPercentiles(this);
+}
+
+// ============================================
+// BENCH RUNNER TESTS
+// ============================================
+
+TEST_F(BenchRunnerTestSuite, RunsScenario) {
+    benchRunnerRunsScenario(this);
+}
+
+TEST_F(BenchRunnerTestSuite, SkipsFailedSetUp) {
+    benchRunnerSkipsFailedSetUp(this);
+}
+
+TEST_F(BenchRunnerTestSuite, EnforcesAllocationBudget) {
+    benchRunnerEnforcesAllocationBudget(this);
+}
+
+TEST_F(BenchRunnerTestSuite, PercentilesAreNearestRank) {
+    benchPercentilesAreNearestRank(this);
+}
+
+TEST_F(BenchRunnerTestSuite, JsonReport) {
+    benchJsonReport(this);
+}
+
 // ============================================
 // MAIN
 // ============================================
@@ -10,6 +10,8 @@
 #include "device/drivers/native/native-peer-comms-driver.hpp"
 #include "device/drivers/native/native-button-driver.hpp"
 #include "device/drivers/native/native-light-strip-driver.hpp"
+#include "device/drivers/native/native-virtual-clock.hpp"
+#include "id-generator.hpp"
 #include "cli/cli-device.hpp"
 #include "cli/cli-commands.hpp"
 #include "game/quickdraw-states.hpp"
@@ -214,6 +216,139 @@ void peerCommsHandlerRegistration(NativePeerCommsDriverTestSuite* suite) {
     ASSERT_FALSE(handlerCalled);  // Should not be called after clear
 }
 
+// Test: Receive ring overflows are counted, not grown, and exec() recovers
+void peerCommsRecvRingOverflowCounted(NativePeerCommsDriverTestSuite* suite) {
+    int handled = 0;
+    auto handler = [](const uint8_t* srcMac, const uint8_t* data, size_t length, void* ctx) {
+        (*static_cast<int*>(ctx))++;
+    };
+    suite->driver_->setPacketHandler(PktType::kQuickdrawCommand, handler, &handled);
+
+    uint8_t srcMac[6] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06};
+    uint8_t data[] = {0x01};
+    for (int i = 0; i < 100; i++) {
+        suite->driver_->receivePacket(srcMac, PktType::kQuickdrawCommand, data, 1);
+    }
+    ASSERT_EQ(suite->driver_->getRecvQueueDepth(), 64u);
+    ASSERT_EQ(suite->driver_->getRecvOverflowCount(), 36u);
+
+    suite->driver_->exec();
+    ASSERT_EQ(handled, 64);
+    ASSERT_EQ(suite->driver_->getRecvQueueDepth(), 0u);
+
+    // Oversized payloads are rejected up front
+    std::vector<uint8_t> big(PACKET_RING_SLOT_SIZE + 1, 0xAB);
+    suite->driver_->receivePacket(srcMac, PktType::kQuickdrawCommand, big.data(), big.size());
+    ASSERT_EQ(suite->driver_->getRecvDropCount(), 1u);
+    suite->driver_->exec();
+    ASSERT_EQ(handled, 64);
+}
+
+// Test: Sends stage one pool block per frame and return them all
+void peerCommsSendUsesFramePool(NativePeerCommsDriverTestSuite* suite) {
+    uint8_t dstMac[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    const SendFramePool& pool = suite->driver_->getSendPool();
+    uint32_t acquiresBefore = pool.getAcquireCount();
+
+    uint8_t small[10] = {};
+    ASSERT_EQ(suite->driver_->sendData(dstMac, PktType::kQuickdrawCommand, small, sizeof(small)), 0);
+    ASSERT_EQ(pool.getAcquireCount() - acquiresBefore, 1u);
+
+    // Three frames' worth of payload
+    std::vector<uint8_t> large(PEER_COMMS_MAX_FRAME_PAYLOAD * 2 + 1, 0x5A);
+    ASSERT_EQ(suite->driver_->sendData(dstMac, PktType::kQuickdrawCommand, large.data(), large.size()), 0);
+    ASSERT_EQ(pool.getAcquireCount() - acquiresBefore, 4u);
+    ASSERT_EQ(pool.inUse(), 0u);
+    ASSERT_EQ(pool.getExhaustedCount(), 0u);
+}
+
+// Test: A cluster larger than the pool is refused up front, and one that
+// doesn't fit the blocks still queued is rejected without queuing anything
+void peerCommsSendFailsWhenPoolExhausted(NativePeerCommsDriverTestSuite* suite) {
+    uint8_t dstMac[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    size_t pendingBefore = NativePeerBroker::getInstance().getPendingPacketCount();
+
+    std::vector<uint8_t> tooLarge(MAX_SEND_PACKET_LEN + 1, 0);
+    ASSERT_EQ(suite->driver_->sendData(dstMac, PktType::kQuickdrawCommand, tooLarge.data(), tooLarge.size()), -1);
+    ASSERT_EQ(suite->driver_->getSendPool().getExhaustedCount(), 0u);
+    ASSERT_EQ(NativePeerBroker::getInstance().getPendingPacketCount(), pendingBefore);
+
+    // The largest packet fills the pool while the radio drains a frame per exec
+    suite->driver_->setTxFramesPerExec(1);
+    std::vector<uint8_t> largest(MAX_SEND_PACKET_LEN, 0);
+    ASSERT_EQ(suite->driver_->sendData(dstMac, PktType::kQuickdrawCommand, largest.data(), largest.size()), 0);
+    ASSERT_EQ(suite->driver_->getSendPool().inUse(), SendFramePool::capacity());
+
+    uint8_t small[10] = {};
+    ASSERT_EQ(suite->driver_->sendData(dstMac, PktType::kDebugPacket, small, sizeof(small)), -1);
+    ASSERT_EQ(suite->driver_->getSendPool().getExhaustedCount(), 1u);
+    ASSERT_EQ(suite->driver_->getSendPool().inUse(), SendFramePool::capacity());
+}
+
+// Test: Unicast fan-out past 20 peers evicts LRU entries but keeps pinned ones
+void peerCommsPeerTableEvictsLruButKeepsPinned(NativePeerCommsDriverTestSuite* suite) {
+    uint8_t directPeer[6] = {0x02, 0xD1, 0x00, 0x00, 0x00, 0x01};
+    ASSERT_EQ(suite->driver_->pinEspNowPeer(directPeer), 0);
+
+    // A 25-player shootout: every opponent gets a unicast
+    uint8_t payload[4] = {};
+    for (uint8_t i = 0; i < 25; i++) {
+        uint8_t mac[6] = {0x02, 0x5E, 0x00, 0x00, 0x00, i};
+        ASSERT_EQ(suite->driver_->sendData(mac, PktType::kShootoutCommand, payload, sizeof(payload)), 0);
+    }
+
+    const PeerTable& table = suite->driver_->getPeerTable();
+    ASSERT_EQ(table.size(), PEER_TABLE_CAPACITY);
+    ASSERT_TRUE(table.isPinned(directPeer));
+    ASSERT_TRUE(table.isPinned(NativePeerBroker::getInstance().getBroadcastAddress()));
+    // Broadcast and the direct peer leave 18 entries for the 25 opponents
+    ASSERT_EQ(table.getStats().evictions, 7u);
+    uint8_t oldest[6] = {0x02, 0x5E, 0x00, 0x00, 0x00, 0x00};
+    uint8_t newest[6] = {0x02, 0x5E, 0x00, 0x00, 0x00, 24};
+    ASSERT_FALSE(table.contains(oldest));
+    ASSERT_TRUE(table.contains(newest));
+
+    suite->driver_->unpinEspNowPeer(directPeer);
+    ASSERT_FALSE(table.isPinned(directPeer));
+    ASSERT_EQ(suite->driver_->removeEspNowPeer(directPeer), 0);
+    ASSERT_FALSE(table.contains(directPeer));
+}
+
+// Test: Peers churning through the table are asked for caps once, and a
+// caps frame is recorded without admitting its sender
+void peerCommsCapsSurviveEviction(NativePeerCommsDriverTestSuite* suite) {
+    uint8_t payload[4] = {};
+    for (int round = 0; round < 3; round++) {
+        for (uint8_t i = 0; i < 25; i++) {
+            uint8_t mac[6] = {0x02, 0x5E, 0x00, 0x00, 0x00, i};
+            ASSERT_EQ(suite->driver_->sendData(mac, PktType::kShootoutCommand, payload, sizeof(payload)), 0);
+        }
+    }
+    const PeerTable& table = suite->driver_->getPeerTable();
+    ASSERT_GT(table.getStats().evictions, 25u);
+
+    TrafficStats::Snapshot traffic;
+    ASSERT_TRUE(suite->driver_->getTrafficSnapshot(traffic));
+    ASSERT_EQ(traffic.get(TrafficDirection::kTx, PktType::kLinkCaps).frames, 25u);
+
+    uint8_t stranger[6] = {0x02, 0x5F, 0x00, 0x00, 0x00, 0x01};
+    LinkCapsPayload caps;
+    caps.maxFrameLen = PEER_COMMS_MAX_FRAME_LEN_V2;
+    caps.flags = LINK_CAPS_REPLY_REQUESTED;
+    size_t sizeBefore = table.size();
+    uint32_t evictionsBefore = table.getStats().evictions;
+    suite->driver_->receivePacket(stranger, PktType::kLinkCaps, reinterpret_cast<const uint8_t*>(&caps), sizeof(caps));
+    suite->driver_->exec();
+
+    ASSERT_FALSE(table.contains(stranger));
+    ASSERT_EQ(table.size(), sizeBefore);
+    ASSERT_EQ(table.getStats().evictions, evictionsBefore);
+    ASSERT_EQ(table.maxFrameLen(stranger), PEER_COMMS_MAX_FRAME_LEN_V2);
+    // It asked, so it gets our caps back
+    ASSERT_TRUE(suite->driver_->getTrafficSnapshot(traffic));
+    ASSERT_EQ(traffic.get(TrafficDirection::kTx, PktType::kLinkCaps).frames, 26u);
+}
+
 // ============================================
 // NATIVE BUTTON DRIVER TEST SUITE
 // ============================================
@@ -1196,3 +1331,89 @@ void cliCommandRebootClearsHistory(CliCommandTestSuite* suite) {
     PlayerRegistrationApp* prApp = static_cast<PlayerRegistrationApp*>(state);
     ASSERT_EQ(prApp->getCurrentState()->getStateId(), FETCH_USER_DATA);
 }
+
+// ============================================
+// CLI VIRTUAL TIME TEST SUITE
+// ============================================
+
+class CliVirtualTimeTestSuite : public testing::Test {
+public:
+    void SetUp() override {
+        clock_ = new NativeVirtualClock("test_virtual_clock", 1000);
+        logger_ = new NativeLoggerDriver("test_virtual_logger");
+        logger_->setSuppressOutput(true);
+        g_logger = logger_;
+        SimpleTimer::setPlatformClock(clock_);
+        IdGenerator::initialize(42);
+        NativePeerBroker::getInstance().deliverPackets();
+
+        devices_.push_back(cli::DeviceFactory::createDevice(0, true));   // Hunter
+        devices_.push_back(cli::DeviceFactory::createDevice(1, false));  // Bounty
+    }
+
+    void TearDown() override {
+        for (auto& dev : devices_) {
+            cli::DeviceFactory::destroyDevice(dev);
+        }
+        devices_.clear();
+
+        SimpleTimer::setPlatformClock(nullptr);
+        g_logger = nullptr;
+        delete logger_;
+        delete clock_;
+    }
+
+    int stateOf(size_t index) {
+        State* state = devices_[index].game->getCurrentState();
+        return state ? state->getStateId() : -1;
+    }
+
+    // One simulator tick, then a jump to whatever is next due
+    void tick() {
+        NativePeerBroker::getInstance().deliverPackets();
+        cli::SerialCableBroker::getInstance().transferData();
+        for (auto& dev : devices_) {
+            dev.pdn->loop();
+        }
+        clock_->advanceWithBroker(33);
+    }
+
+    std::vector<cli::DeviceInstance> devices_;
+    NativeVirtualClock* clock_;
+    NativeLoggerDriver* logger_;
+};
+
+// Test: A cabled pair duels to a result in virtual time, without waiting
+// out the handshake, countdown and result timers on the wall clock. The
+// hunter draws 150 ms faster, so it wins, every run.
+void cliVirtualTimeDuelRunsToResult(CliVirtualTimeTestSuite* suite) {
+    ASSERT_TRUE(cli::SerialCableBroker::getInstance().connect(0, 1));
+
+    const unsigned long deadline = suite->clock_->milliseconds() + 60000;
+    unsigned long hunterDrawMs = 0;
+    bool bountyDrew = false;
+    auto finished = [suite](size_t i) {
+        return suite->stateOf(i) == WIN || suite->stateOf(i) == LOSE;
+    };
+    while (suite->clock_->milliseconds() < deadline && !(finished(0) && finished(1))) {
+        unsigned long now = suite->clock_->milliseconds();
+        if (hunterDrawMs == 0 && suite->stateOf(0) == DUEL) {
+            suite->devices_[0].primaryButtonDriver->execCallback(ButtonInteraction::CLICK);
+            hunterDrawMs = now;
+            suite->clock_->schedule(now + 150);
+        }
+        if (hunterDrawMs != 0 && !bountyDrew && now >= hunterDrawMs + 150 &&
+            (suite->stateOf(1) == DUEL || suite->stateOf(1) == DUEL_RECEIVED_RESULT)) {
+            suite->devices_[1].primaryButtonDriver->execCallback(ButtonInteraction::CLICK);
+            bountyDrew = true;
+        }
+        suite->tick();
+    }
+
+    ASSERT_NE(hunterDrawMs, 0u);
+    ASSERT_TRUE(bountyDrew);
+    ASSERT_EQ(suite->stateOf(0), WIN);
+    ASSERT_EQ(suite->stateOf(1), LOSE);
+
+    cli::SerialCableBroker::getInstance().disconnect(0, 1);
+}
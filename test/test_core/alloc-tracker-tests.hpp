@@ -0,0 +1,163 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include "utils/alloc-tracker.hpp"
+#include "quickdraw-integration-tests.hpp"
+
+// ============================================
+// AllocationTracker Tests
+// ============================================
+
+// Budgets mean nothing without the hooks (ASan/TSan builds), so skip there
+#define SKIP_WITHOUT_ALLOC_TRACKING() \
+    if (!AllocationTracker::isInstalled()) GTEST_SKIP() << "built without ALLOC_TRACKING"
+
+class AllocationTrackerTests : public testing::Test {
+public:
+    void SetUp() override {
+        AllocationTracker::resetRegions();
+    }
+
+    void TearDown() override {
+        AllocationTracker::resetRegions();
+    }
+
+    // Held by the suite so the compiler can't pair up and drop the new/delete
+    char* held = nullptr;
+    char* scratch = nullptr;
+};
+
+inline void allocTrackerScopeCountsNewAndDelete(AllocationTrackerTests* suite) {
+    SKIP_WITHOUT_ALLOC_TRACKING();
+    AllocationScope scope;
+    EXPECT_EQ(scope.getCounts().allocations, 0u);
+
+    suite->held = new char[40];
+    AllocationCounts afterNew = scope.getCounts();
+    EXPECT_EQ(afterNew.allocations, 1u);
+    EXPECT_EQ(afterNew.bytes, 40u);
+    EXPECT_EQ(afterNew.frees, 0u);
+
+    delete[] suite->held;
+    suite->held = nullptr;
+    EXPECT_EQ(scope.getCounts().frees, 1u);
+
+    // Process-wide totals count it too
+    AllocationCounts before = AllocationTracker::getTotals();
+    suite->held = new char[8];
+    delete[] suite->held;
+    EXPECT_GE((AllocationTracker::getTotals() - before).allocations, 1u);
+}
+
+inline void allocTrackerRegionsNestAndAccumulate(AllocationTrackerTests* suite) {
+    SKIP_WITHOUT_ALLOC_TRACKING();
+    for (int i = 0; i < 3; i++) {
+        AllocationScope outer("test.outer");
+        suite->held = new char[100];
+        {
+            AllocationScope inner("test.inner");
+            suite->scratch = new char[64];
+            EXPECT_EQ(inner.getCounts().allocations, 1u);
+            delete[] suite->scratch;
+            suite->scratch = nullptr;
+        }
+        delete[] suite->held;
+        // The outer region includes the inner one's buffer
+        EXPECT_EQ(outer.getCounts().allocations, 2u);
+    }
+
+    AllocationTracker::Region regions[AllocationTracker::kMaxRegions];
+    size_t count = AllocationTracker::getRegions(regions, AllocationTracker::kMaxRegions);
+    ASSERT_EQ(count, 2u);
+    EXPECT_STREQ(regions[0].name, "test.outer");
+    EXPECT_EQ(regions[0].entries, 3u);
+    EXPECT_EQ(regions[0].counts.allocations, 6u);
+    EXPECT_EQ(regions[0].counts.frees, 6u);
+    EXPECT_STREQ(regions[1].name, "test.inner");
+    EXPECT_EQ(regions[1].entries, 3u);
+    EXPECT_EQ(regions[1].counts.allocations, 3u);
+    EXPECT_EQ(regions[1].counts.bytes, 3u * 64u);
+
+    AllocationTracker::resetRegions();
+    EXPECT_EQ(AllocationTracker::getRegions(regions, AllocationTracker::kMaxRegions), 0u);
+}
+
+inline void allocTrackerRegionsOverflowIntoOther(AllocationTrackerTests* suite) {
+    (void)suite;
+    static char names[AllocationTracker::kMaxRegions + 4][16];
+    for (size_t i = 0; i < AllocationTracker::kMaxRegions + 4; i++) {
+        snprintf(names[i], sizeof(names[i]), "region-%zu", i);
+        AllocationScope scope(names[i]);
+    }
+    AllocationTracker::Region regions[AllocationTracker::kMaxRegions];
+    size_t count = AllocationTracker::getRegions(regions, AllocationTracker::kMaxRegions);
+    ASSERT_EQ(count, AllocationTracker::kMaxRegions);
+    EXPECT_STREQ(regions[0].name, "region-0");
+    EXPECT_STREQ(regions[count - 1].name, "(other)");
+    EXPECT_EQ(regions[count - 1].entries, 5u);
+}
+
+inline void allocTrackerUncountedIsIgnored(AllocationTrackerTests* suite) {
+    SKIP_WITHOUT_ALLOC_TRACKING();
+    AllocationScope scope;
+    {
+        UncountedAllocations uncounted;
+        suite->held = new char[32];
+        delete[] suite->held;
+    }
+    EXPECT_EQ(scope.getCounts().allocations, 0u);
+    EXPECT_EQ(scope.getCounts().frees, 0u);
+
+    suite->held = new char[32];
+    delete[] suite->held;
+    EXPECT_EQ(scope.getCounts().allocations, 1u);
+}
+
+// ============================================
+// Allocation budgets
+// ============================================
+
+class DuelAllocationBudgetTests : public StateFlowIntegrationTests {
+public:
+    void SetUp() override {
+        StateFlowIntegrationTests::SetUp();
+        device.fakeRemoteDeviceCoordinator.setPortStatus(SerialIdentifier::OUTPUT_JACK, PortStatus::CONNECTED);
+        device.fakeRemoteDeviceCoordinator.setPortStatus(SerialIdentifier::INPUT_JACK, PortStatus::CONNECTED);
+    }
+};
+
+// A duel waiting on the draw loops every tick for up to four seconds; none
+// of those ticks may touch the heap.
+inline void duelTickAllocatesNothing(DuelAllocationBudgetTests* suite) {
+    SKIP_WITHOUT_ALLOC_TRACKING();
+    EXPECT_CALL(*suite->device.mockPrimaryButton, setButtonPress(_, _, _)).Times(testing::AnyNumber());
+    EXPECT_CALL(*suite->device.mockSecondaryButton, setButtonPress(_, _, _)).Times(testing::AnyNumber());
+    EXPECT_CALL(*suite->device.mockHaptics, setIntensity(_)).Times(testing::AnyNumber());
+
+    Duel duelState(suite->player, suite->matchManager, &suite->device.fakeRemoteDeviceCoordinator,
+                   suite->chainDuelManager, nullptr);
+    duelState.onStateMounted(&suite->device);
+    duelState.onStateLoop(&suite->device);
+
+    AllocationScope scope;
+    for (int tick = 0; tick < 200; tick++) {
+        suite->fakeClock->advance(10);
+        duelState.onStateLoop(&suite->device);
+    }
+    AllocationCounts counts = scope.getCounts();
+
+    EXPECT_FALSE(duelState.transitionToIdle());
+    EXPECT_FALSE(duelState.transitionToDuelPushed());
+    EXPECT_EQ(counts.allocations, 0u) << counts.bytes << " bytes over 200 ticks";
+}
+
+// The per-tick ring check asks the RDC instead of copying peer lists
+inline void chainLoopCheckAllocatesNothing(DuelAllocationBudgetTests* suite) {
+    SKIP_WITHOUT_ALLOC_TRACKING();
+    AllocationScope scope;
+    for (int tick = 0; tick < 100; tick++) {
+        EXPECT_FALSE(suite->chainDuelManager->isLoop());
+    }
+    EXPECT_EQ(scope.getCounts().allocations, 0u);
+}
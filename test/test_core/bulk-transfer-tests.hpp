@@ -0,0 +1,185 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <vector>
+#include "wireless/bulk-transfer.hpp"
+
+// ============================================
+// BulkTransfer Tests
+// ============================================
+
+// Two engines wired back to back. `dropToB` / `dropToA` can lose or corrupt
+// packets in flight.
+class BulkTransferTests : public testing::Test {
+public:
+    struct InFlight {
+        std::vector<uint8_t> data;
+    };
+
+    void SetUp() override {
+        BulkTransfer::Config config;
+        config.retransmitMs = 50;
+        config.maxTimeouts = 4;
+        config.holdMs = 10000;
+        sender = BulkTransfer(config);
+        receiver = BulkTransfer(config);
+        receiver.listen(1, true);
+
+        emitToB = [this](const uint8_t* dst, const uint8_t* data, size_t length) {
+            toB.push_back({std::vector<uint8_t>(data, data + length)});
+            return 0;
+        };
+        emitToA = [this](const uint8_t* dst, const uint8_t* data, size_t length) {
+            toA.push_back({std::vector<uint8_t>(data, data + length)});
+            return 0;
+        };
+
+        message.resize(5000);
+        for (size_t i = 0; i < message.size(); i++) {
+            message[i] = static_cast<uint8_t>(i * 7 + 3);
+        }
+    }
+
+    // Runs until the transfer leaves the sending states or `rounds` pass
+    void run(int transferId, int rounds = 400) {
+        BulkTransferStatus status;
+        for (int i = 0; i < rounds; i++) {
+            now += 10;
+            while (!toB.empty()) {
+                InFlight packet = std::move(toB.front());
+                toB.pop_front();
+                packetsToB++;
+                if (dropToB && dropToB(packet)) {
+                    continue;
+                }
+                if (receiver.onPacket(macA, packet.data.data(), packet.data.size(), now, emitToA) ==
+                    BulkTransfer::Result::kComplete) {
+                    delivered = std::move(receiver.completed().data);
+                }
+            }
+            while (!toA.empty()) {
+                InFlight packet = std::move(toA.front());
+                toA.pop_front();
+                packetsToA++;
+                if (dropToA && dropToA(packet)) {
+                    continue;
+                }
+                sender.onPacket(macB, packet.data.data(), packet.data.size(), now, emitToB);
+            }
+            sender.service(now, emitToB);
+            receiver.service(now, emitToA);
+            ASSERT_TRUE(sender.getStatus(transferId, status));
+            if (status.state != BulkTransferState::kOpening && status.state != BulkTransferState::kSending) {
+                return;
+            }
+        }
+    }
+
+    BulkTransfer sender;
+    BulkTransfer receiver;
+    BulkTransfer::Emit emitToB;
+    BulkTransfer::Emit emitToA;
+    std::deque<InFlight> toB;
+    std::deque<InFlight> toA;
+    std::function<bool(InFlight&)> dropToB;
+    std::function<bool(InFlight&)> dropToA;
+    int packetsToB = 0;
+    int packetsToA = 0;
+    unsigned long now = 0;
+    std::vector<uint8_t> message;
+    std::vector<uint8_t> delivered;
+    uint8_t macA[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0A};
+    uint8_t macB[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0B};
+};
+
+inline void bulkTransferDeliversThroughLoss(BulkTransferTests* suite) {
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    EXPECT_EQ(crc32(check, sizeof(check)), 0xCBF43926u);
+
+    // Lose every 4th packet toward the receiver and every 3rd credit back
+    suite->dropToB = [suite](BulkTransferTests::InFlight&) { return suite->packetsToB % 4 == 0; };
+    suite->dropToA = [suite](BulkTransferTests::InFlight&) { return suite->packetsToA % 3 == 0; };
+
+    int id = suite->sender.start(suite->macB, 1, suite->message.data(), suite->message.size(), suite->now);
+    ASSERT_GT(id, 0);
+    suite->run(id);
+
+    BulkTransferStatus status;
+    ASSERT_TRUE(suite->sender.getStatus(id, status));
+    EXPECT_EQ(status.state, BulkTransferState::kComplete);
+    EXPECT_EQ(status.ackedOffset, suite->message.size());
+    EXPECT_GT(status.retransmits, 0u);
+    EXPECT_EQ(suite->delivered, suite->message);
+    EXPECT_EQ(suite->receiver.getStats().completedIn, 1u);
+    EXPECT_EQ(suite->sender.activeOutgoing(), 0u);
+}
+
+inline void bulkTransferResumesFromReceivedOffset(BulkTransferTests* suite) {
+    // The link dies after the receiver holds the first few chunks
+    size_t chunksLet = 0;
+    suite->dropToB = [&chunksLet](BulkTransferTests::InFlight& packet) {
+        if (packet.data[0] != static_cast<uint8_t>(BulkOp::DATA)) {
+            return false;
+        }
+        return ++chunksLet > 6;
+    };
+    int first = suite->sender.start(suite->macB, 1, suite->message.data(), suite->message.size(), suite->now);
+    suite->run(first);
+    BulkTransferStatus status;
+    ASSERT_TRUE(suite->sender.getStatus(first, status));
+    ASSERT_EQ(status.state, BulkTransferState::kFailed);
+    uint32_t held = status.ackedOffset;
+    ASSERT_GT(held, 0u);
+    EXPECT_EQ(suite->receiver.activeIncoming(), 1u);
+
+    // Sending the same bytes again picks up at the receiver's offset
+    suite->dropToB = nullptr;
+    uint32_t sentBefore = suite->sender.getStats().chunksSent;
+    int second = suite->sender.start(suite->macB, 1, suite->message.data(), suite->message.size(), suite->now);
+    ASSERT_NE(second, first);
+    suite->run(second);
+    ASSERT_TRUE(suite->sender.getStatus(second, status));
+    EXPECT_EQ(status.state, BulkTransferState::kComplete);
+    EXPECT_EQ(suite->receiver.getStats().resumed, 1u);
+    EXPECT_EQ(suite->delivered, suite->message);
+    size_t chunksTotal = (suite->message.size() + BulkTransfer::kChunkLen - 1) / BulkTransfer::kChunkLen;
+    EXPECT_LE(suite->sender.getStats().chunksSent - sentBefore, chunksTotal - held / BulkTransfer::kChunkLen);
+}
+
+inline void bulkTransferRefusesBadTransfers(BulkTransferTests* suite) {
+    BulkTransferStatus status;
+
+    // Nobody listens on channel 2
+    int unheard = suite->sender.start(suite->macB, 2, suite->message.data(), suite->message.size(), suite->now);
+    suite->run(unheard);
+    ASSERT_TRUE(suite->sender.getStatus(unheard, status));
+    EXPECT_EQ(status.state, BulkTransferState::kFailed);
+    EXPECT_TRUE(status.refused);
+    EXPECT_EQ(status.refuseReason, BulkRefuseReason::NO_HANDLER);
+
+    // A flipped byte fails the checksum and the partial copy is dropped
+    bool flipped = false;
+    suite->dropToB = [&flipped](BulkTransferTests::InFlight& packet) {
+        if (!flipped && packet.data[0] == static_cast<uint8_t>(BulkOp::DATA)) {
+            packet.data.back() ^= 0xFF;
+            flipped = true;
+        }
+        return false;
+    };
+    int corrupt = suite->sender.start(suite->macB, 1, suite->message.data(), suite->message.size(), suite->now);
+    suite->run(corrupt);
+    ASSERT_TRUE(suite->sender.getStatus(corrupt, status));
+    EXPECT_EQ(status.state, BulkTransferState::kFailed);
+    EXPECT_EQ(status.refuseReason, BulkRefuseReason::CORRUPT);
+    EXPECT_EQ(suite->receiver.getStats().corrupt, 1u);
+    EXPECT_TRUE(suite->delivered.empty());
+    EXPECT_EQ(suite->receiver.activeIncoming(), 0u);
+
+    std::vector<uint8_t> huge(suite->sender.getConfig().maxTransferBytes + 1);
+    EXPECT_EQ(suite->sender.start(suite->macB, 1, huge.data(), huge.size(), suite->now), -1);
+    EXPECT_EQ(suite->sender.start(suite->macB, BulkTransfer::kMaxChannels, huge.data(), 1, suite->now), -1);
+    EXPECT_FALSE(suite->sender.getStatus(999, status));
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "wireless/duplicate-filter.hpp"
+
+// ============================================
+// DuplicateFilter Tests
+// ============================================
+
+class DuplicateFilterTests : public testing::Test {
+public:
+    void SetUp() override {
+        filter.setRule(PktType::kShootoutCommand, 1);
+    }
+
+    // [cmd, seq] like a ShootoutPacket
+    bool offer(const uint8_t* src, uint8_t seq, unsigned long nowMs = 0,
+               PktType type = PktType::kShootoutCommand) {
+        uint8_t packet[2] = {0x01, seq};
+        return filter.isDuplicate(src, type, packet, sizeof(packet), nowMs);
+    }
+
+    DuplicateFilter filter;
+    uint8_t peerA[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0A};
+    uint8_t peerB[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0B};
+};
+
+inline void duplicateFilterDropsRepeatsPerSource(DuplicateFilterTests* suite) {
+    EXPECT_FALSE(suite->offer(suite->peerA, 5));
+    EXPECT_TRUE(suite->offer(suite->peerA, 5));
+    // Same sequence from another sender is its own stream
+    EXPECT_FALSE(suite->offer(suite->peerB, 5));
+    EXPECT_FALSE(suite->offer(suite->peerA, 6));
+    EXPECT_TRUE(suite->offer(suite->peerA, 5));
+
+    // Sequence 0 and types without a rule always pass
+    EXPECT_FALSE(suite->offer(suite->peerA, 0));
+    EXPECT_FALSE(suite->offer(suite->peerA, 0));
+    EXPECT_FALSE(suite->offer(suite->peerA, 5, 0, PktType::kChainGameEvent));
+    EXPECT_FALSE(suite->offer(suite->peerA, 5, 0, PktType::kChainGameEvent));
+
+    const DuplicateFilter::Stats& stats = suite->filter.getStats();
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.misses, 3u);
+    EXPECT_EQ(stats.untracked, 4u);
+    EXPECT_EQ(suite->filter.streamCount(), 2u);
+}
+
+inline void duplicateFilterWindowAndHoldExpire(DuplicateFilterTests* suite) {
+    size_t window = suite->filter.getConfig().window;
+    for (uint8_t seq = 1; seq <= window; seq++) {
+        EXPECT_FALSE(suite->offer(suite->peerA, seq));
+    }
+    EXPECT_TRUE(suite->offer(suite->peerA, 1));
+    // One more pushes the oldest out of the window
+    EXPECT_FALSE(suite->offer(suite->peerA, static_cast<uint8_t>(window + 1)));
+    EXPECT_FALSE(suite->offer(suite->peerA, 1));
+
+    // A rebooted sender reusing sequence numbers gets through after holdMs
+    unsigned long later = suite->filter.getConfig().holdMs + 1;
+    EXPECT_FALSE(suite->offer(suite->peerA, 3, later));
+    EXPECT_TRUE(suite->offer(suite->peerA, 3, later));
+}
+
+inline void duplicateFilterBoundsStreams(DuplicateFilterTests* suite) {
+    DuplicateFilter::Config config;
+    config.maxStreams = 2;
+    config.window = 100;
+    DuplicateFilter small(config);
+    EXPECT_EQ(small.getConfig().window, DuplicateFilter::kMaxWindow);
+    small.setRule(PktType::kShootoutCommand, 1);
+
+    uint8_t packet[2] = {0x01, 9};
+    uint8_t peerC[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0C};
+    small.isDuplicate(suite->peerA, PktType::kShootoutCommand, packet, sizeof(packet), 0);
+    small.isDuplicate(suite->peerB, PktType::kShootoutCommand, packet, sizeof(packet), 0);
+    EXPECT_TRUE(small.isDuplicate(suite->peerA, PktType::kShootoutCommand, packet, sizeof(packet), 0));
+    // peerB is least recently used and makes way for peerC
+    small.isDuplicate(peerC, PktType::kShootoutCommand, packet, sizeof(packet), 0);
+    EXPECT_EQ(small.getStats().evictions, 1u);
+    EXPECT_EQ(small.streamCount(), 2u);
+    EXPECT_FALSE(small.isDuplicate(suite->peerB, PktType::kShootoutCommand, packet, sizeof(packet), 0));
+
+    small.forget(suite->peerB);
+    EXPECT_EQ(small.streamCount(), 1u);
+    small.clearRule(PktType::kShootoutCommand);
+    EXPECT_FALSE(small.hasRule(PktType::kShootoutCommand));
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "wireless/fragment-reassembly.hpp"
+
+// ============================================
+// FragmentReassembler Tests
+// ============================================
+
+class FragmentReassemblyTests : public testing::Test {
+public:
+    void SetUp() override {
+        payload.resize(PEER_COMMS_MAX_FRAME_PAYLOAD * 3 + 17);
+        for (size_t i = 0; i < payload.size(); i++) {
+            payload[i] = static_cast<uint8_t>(i * 7);
+        }
+        numFrags = static_cast<uint8_t>(fragmentCount(payload.size()));
+    }
+
+    // Builds fragment `idx` of `payload` and feeds it to the reassembler
+    FragmentReassembler::Result feed(uint8_t idx, unsigned long nowMs) {
+        uint8_t frame[PEER_COMMS_MAX_FRAME_LEN];
+        size_t len = buildFragment(frame, PktType::kDebugPacket, payload.data(), payload.size(), idx, numFrags);
+        return reassembler.onFragment(srcMac, frame, len, nowMs);
+    }
+
+    FragmentReassembler reassembler;
+    std::vector<uint8_t> payload;
+    uint8_t numFrags = 0;
+    uint8_t srcMac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x07};
+};
+
+inline void reassemblyInOrderClusterCompletes(FragmentReassemblyTests* suite) {
+    ASSERT_EQ(suite->numFrags, 4);
+    for (uint8_t i = 0; i + 1 < suite->numFrags; i++) {
+        EXPECT_EQ(suite->feed(i, 0), FragmentReassembler::Result::kIncomplete);
+    }
+    ASSERT_EQ(suite->feed(suite->numFrags - 1, 0), FragmentReassembler::Result::kComplete);
+
+    auto& done = suite->reassembler.completed();
+    EXPECT_EQ(done.packetType, PktType::kDebugPacket);
+    EXPECT_EQ(memcmp(done.srcMac, suite->srcMac, 6), 0);
+    EXPECT_EQ(done.data, suite->payload);
+    EXPECT_EQ(suite->reassembler.activeClusters(), 0u);
+    EXPECT_EQ(suite->reassembler.getStats().outOfOrder, 0u);
+}
+
+inline void reassemblyAcceptsOutOfOrderFragments(FragmentReassemblyTests* suite) {
+    EXPECT_EQ(suite->feed(3, 0), FragmentReassembler::Result::kIncomplete);
+    EXPECT_EQ(suite->feed(1, 1), FragmentReassembler::Result::kIncomplete);
+    EXPECT_EQ(suite->feed(0, 2), FragmentReassembler::Result::kIncomplete);
+    ASSERT_EQ(suite->feed(2, 3), FragmentReassembler::Result::kComplete);
+
+    EXPECT_EQ(suite->reassembler.completed().data, suite->payload);
+    EXPECT_GT(suite->reassembler.getStats().outOfOrder, 0u);
+}
+
+inline void reassemblyIgnoresDuplicateFragments(FragmentReassemblyTests* suite) {
+    EXPECT_EQ(suite->feed(0, 0), FragmentReassembler::Result::kIncomplete);
+    EXPECT_EQ(suite->feed(2, 0), FragmentReassembler::Result::kIncomplete);
+    EXPECT_EQ(suite->feed(2, 0), FragmentReassembler::Result::kDuplicate);
+    EXPECT_EQ(suite->reassembler.getStats().duplicates, 1u);
+
+    EXPECT_EQ(suite->feed(1, 0), FragmentReassembler::Result::kIncomplete);
+    EXPECT_EQ(suite->feed(3, 0), FragmentReassembler::Result::kComplete);
+    EXPECT_EQ(suite->reassembler.completed().data, suite->payload);
+}
+
+inline void reassemblyEvictsStaleClusters(FragmentReassemblyTests* suite) {
+    const auto& config = suite->reassembler.getConfig();
+    suite->feed(0, 1000);
+    suite->feed(1, 1000);
+    EXPECT_EQ(suite->reassembler.expire(1000 + config.staleTimeoutMs - 1), 0u);
+    EXPECT_EQ(suite->reassembler.expire(1000 + config.staleTimeoutMs), 1u);
+    EXPECT_EQ(suite->reassembler.activeClusters(), 0u);
+    EXPECT_EQ(suite->reassembler.getStats().evicted, 1u);
+
+    // Remaining fragments now start a fresh cluster instead of completing the old one
+    EXPECT_EQ(suite->feed(2, 2000), FragmentReassembler::Result::kIncomplete);
+    EXPECT_EQ(suite->feed(3, 2000), FragmentReassembler::Result::kIncomplete);
+}
+
+inline void reassemblyRequestsOnlyMissingIndices(FragmentReassemblyTests* suite) {
+    const auto& config = suite->reassembler.getConfig();
+    suite->feed(0, 100);
+    suite->feed(2, 100);
+
+    std::vector<FragmentResendRequest> requests;
+    EXPECT_EQ(suite->reassembler.collectResendRequests(100 + config.resendAfterMs - 1, requests), 0u);
+    ASSERT_EQ(suite->reassembler.collectResendRequests(100 + config.resendAfterMs, requests), 1u);
+
+    const FragmentResendRequest& req = requests[0];
+    EXPECT_EQ(memcmp(req.srcMac, suite->srcMac, 6), 0);
+    EXPECT_EQ(req.nack.packetType, PktType::kDebugPacket);
+    EXPECT_EQ(req.nack.numPktsInCluster, 4);
+    FragmentBitmap missing;
+    memcpy(missing.bits, req.nack.missing, sizeof(missing.bits));
+    EXPECT_FALSE(missing.test(0));
+    EXPECT_TRUE(missing.test(1));
+    EXPECT_FALSE(missing.test(2));
+    EXPECT_TRUE(missing.test(3));
+    EXPECT_EQ(missing.count(), 2u);
+
+    // Requests are capped per cluster
+    unsigned long now = 100 + config.resendAfterMs;
+    for (int i = 0; i < 10; i++) {
+        now += config.resendAfterMs;
+        suite->reassembler.collectResendRequests(now, requests);
+    }
+    EXPECT_EQ(requests.size(), config.maxResendRequests);
+}
+
+inline void reassemblyRejectsMalformedFragments(FragmentReassemblyTests* suite) {
+    uint8_t frame[PEER_COMMS_MAX_FRAME_LEN] = {};
+    auto* hdr = reinterpret_cast<DataPktHdr*>(frame);
+
+    // Index past the end of the cluster
+    hdr->pktLen = sizeof(DataPktHdr) + 4;
+    hdr->packetType = PktType::kDebugPacket;
+    hdr->numPktsInCluster = 2;
+    hdr->idxInCluster = 2;
+    EXPECT_EQ(suite->reassembler.onFragment(suite->srcMac, frame, hdr->pktLen, 0),
+              FragmentReassembler::Result::kRejected);
+
+    // Short non-final fragment can't be placed by index
+    hdr->idxInCluster = 0;
+    EXPECT_EQ(suite->reassembler.onFragment(suite->srcMac, frame, hdr->pktLen, 0),
+              FragmentReassembler::Result::kRejected);
+
+    // Truncated frame
+    EXPECT_EQ(suite->reassembler.onFragment(suite->srcMac, frame, 2, 0),
+              FragmentReassembler::Result::kRejected);
+    EXPECT_EQ(suite->reassembler.getStats().rejected, 3u);
+}
+
+inline void retransmitCacheMatchesClusterShape(FragmentReassemblyTests* suite) {
+    FragmentRetransmitCache cache(2, 1000);
+    uint8_t dst[6] = {0x02, 0, 0, 0, 0, 0x09};
+    cache.store(dst, PktType::kDebugPacket, suite->payload.data(), suite->payload.size(), 0);
+
+    FragmentNackPayload nack = {};
+    nack.packetType = PktType::kDebugPacket;
+    nack.numPktsInCluster = suite->numFrags;
+    const FragmentRetransmitCache::Cluster* found = cache.find(dst, nack, 10);
+    ASSERT_NE(found, nullptr);
+    EXPECT_EQ(found->data, suite->payload);
+    EXPECT_EQ(found->fragmentLen, PEER_COMMS_MAX_FRAME_PAYLOAD);
+
+    nack.numPktsInCluster = 2;
+    EXPECT_EQ(cache.find(dst, nack, 10), nullptr);
+    nack.numPktsInCluster = suite->numFrags;
+    EXPECT_EQ(cache.find(dst, nack, 2000), nullptr);
+
+    // Newer cluster to the same key replaces the older one
+    cache.store(dst, PktType::kDebugPacket, suite->payload.data(), 10, 20);
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+inline void reassemblyPlacesV2Fragments(FragmentReassemblyTests* suite) {
+    std::vector<uint8_t> payload(PEER_COMMS_MAX_FRAME_PAYLOAD_V2 + 300);
+    for (size_t i = 0; i < payload.size(); i++) {
+        payload[i] = static_cast<uint8_t>(i * 13);
+    }
+    size_t fragmentLen = fragmentLenFor(PEER_COMMS_MAX_FRAME_LEN_V2);
+    ASSERT_EQ(fragmentLen, PEER_COMMS_MAX_FRAME_PAYLOAD_V2);
+    ASSERT_EQ(fragmentCount(payload.size(), fragmentLen), 2u);
+    EXPECT_EQ(fragmentCount(payload.size()), 8u);
+
+    // Neither frame's length fits pktLen; the receiver takes it from the radio
+    std::vector<uint8_t> frames[2];
+    for (uint8_t idx = 0; idx < 2; idx++) {
+        frames[idx].resize(PEER_COMMS_MAX_FRAME_LEN_V2);
+        size_t len = buildFragment(frames[idx].data(), PktType::kDebugPacket, payload.data(), payload.size(),
+                                   idx, 2, fragmentLen);
+        frames[idx].resize(len);
+        EXPECT_EQ(reinterpret_cast<const DataPktHdr*>(frames[idx].data())->pktLen, DATA_PKT_LEN_LONG);
+    }
+    EXPECT_EQ(frames[0].size(), PEER_COMMS_MAX_FRAME_LEN_V2);
+    EXPECT_EQ(frames[1].size(), sizeof(DataPktHdr) + 300);
+
+    EXPECT_EQ(suite->reassembler.onFragment(suite->srcMac, frames[1].data(), frames[1].size(), 0),
+              FragmentReassembler::Result::kIncomplete);
+    ASSERT_EQ(suite->reassembler.onFragment(suite->srcMac, frames[0].data(), frames[0].size(), 0),
+              FragmentReassembler::Result::kComplete);
+    EXPECT_EQ(suite->reassembler.completed().data, payload);
+
+    // A short fragment that isn't last can't be placed, whatever its size
+    EXPECT_EQ(suite->reassembler.onFragment(suite->srcMac, frames[0].data(), frames[0].size() - 1, 0),
+              FragmentReassembler::Result::kRejected);
+
+    // So the sender can answer a NACK, the cache keeps the fragment size
+    FragmentRetransmitCache cache(2, 1000);
+    uint8_t dst[6] = {0x02, 0, 0, 0, 0, 0x09};
+    cache.store(dst, PktType::kDebugPacket, payload.data(), payload.size(), 0, fragmentLen);
+    FragmentNackPayload nack = {};
+    nack.packetType = PktType::kDebugPacket;
+    nack.numPktsInCluster = 2;
+    const FragmentRetransmitCache::Cluster* found = cache.find(dst, nack, 10);
+    ASSERT_NE(found, nullptr);
+    EXPECT_EQ(found->fragmentLen, PEER_COMMS_MAX_FRAME_PAYLOAD_V2);
+}
+
+inline void reassemblyRestartsOnFragmentSizeChange(FragmentReassemblyTests* suite) {
+    // Half a small-frame cluster, then the sender retries the packet in v2 frames
+    EXPECT_EQ(suite->feed(0, 0), FragmentReassembler::Result::kIncomplete);
+    EXPECT_EQ(suite->feed(1, 0), FragmentReassembler::Result::kIncomplete);
+
+    size_t fragmentLen = PEER_COMMS_MAX_FRAME_PAYLOAD_V2;
+    ASSERT_EQ(fragmentCount(suite->payload.size(), fragmentLen), 1u);
+    std::vector<uint8_t> frame(PEER_COMMS_MAX_FRAME_LEN_V2);
+    size_t len = buildFragment(frame.data(), PktType::kDebugPacket, suite->payload.data(), suite->payload.size(),
+                               0, 1, fragmentLen);
+    ASSERT_EQ(suite->reassembler.onFragment(suite->srcMac, frame.data(), len, 0),
+              FragmentReassembler::Result::kComplete);
+    EXPECT_EQ(suite->reassembler.completed().data, suite->payload);
+
+    // A two-frame v2 cluster doesn't complete the small-frame one it lands in
+    std::vector<uint8_t> large(PEER_COMMS_MAX_FRAME_PAYLOAD_V2 + 1, 0x33);
+    len = buildFragment(frame.data(), PktType::kDebugPacket, large.data(), large.size(), 1, 2, fragmentLen);
+    EXPECT_EQ(suite->feed(2, 1), FragmentReassembler::Result::kIncomplete);
+    EXPECT_EQ(suite->reassembler.onFragment(suite->srcMac, frame.data(), len, 1),
+              FragmentReassembler::Result::kIncomplete);
+    len = buildFragment(frame.data(), PktType::kDebugPacket, large.data(), large.size(), 0, 2, fragmentLen);
+    ASSERT_EQ(suite->reassembler.onFragment(suite->srcMac, frame.data(), len, 1),
+              FragmentReassembler::Result::kComplete);
+    EXPECT_EQ(suite->reassembler.completed().data, large);
+}
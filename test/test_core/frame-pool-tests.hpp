@@ -0,0 +1,65 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "wireless/frame-pool.hpp"
+
+// ============================================
+// FramePool Tests
+// ============================================
+
+class FramePoolTests : public testing::Test {
+public:
+    FramePool<16, 4> pool;
+};
+
+inline void framePoolAcquireReleaseTracksCounts(FramePoolTests* suite) {
+    uint8_t* a = suite->pool.acquire();
+    uint8_t* b = suite->pool.acquire();
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(suite->pool.inUse(), 2u);
+    EXPECT_EQ(suite->pool.available(), 2u);
+    EXPECT_EQ(suite->pool.getAcquireCount(), 2u);
+
+    suite->pool.release(a);
+    suite->pool.release(b);
+    EXPECT_EQ(suite->pool.inUse(), 0u);
+    EXPECT_EQ(suite->pool.getReleaseCount(), 2u);
+    EXPECT_EQ(suite->pool.getHighWater(), 2u);
+}
+
+inline void framePoolExhaustionReturnsNull(FramePoolTests* suite) {
+    uint8_t* blocks[4];
+    for (auto& block : blocks) {
+        block = suite->pool.acquire();
+        ASSERT_NE(block, nullptr);
+    }
+    EXPECT_EQ(suite->pool.acquire(), nullptr);
+    EXPECT_EQ(suite->pool.getExhaustedCount(), 1u);
+
+    // A released block is immediately reusable
+    suite->pool.release(blocks[2]);
+    EXPECT_EQ(suite->pool.acquire(), blocks[2]);
+}
+
+inline void framePoolReserveChecksWholeCluster(FramePoolTests* suite) {
+    EXPECT_TRUE(suite->pool.reserve(4));
+    uint8_t* block = suite->pool.acquire();
+    EXPECT_FALSE(suite->pool.reserve(4));
+    EXPECT_EQ(suite->pool.getExhaustedCount(), 1u);
+    EXPECT_TRUE(suite->pool.reserve(3));
+    suite->pool.release(block);
+}
+
+inline void framePoolIgnoresForeignPointers(FramePoolTests* suite) {
+    uint8_t local[16];
+    uint8_t* block = suite->pool.acquire();
+    EXPECT_FALSE(suite->pool.owns(local));
+    EXPECT_FALSE(suite->pool.owns(block + 1));
+    suite->pool.release(local);
+    suite->pool.release(block + 1);
+    EXPECT_EQ(suite->pool.inUse(), 1u);
+    suite->pool.release(block);
+    EXPECT_EQ(suite->pool.inUse(), 0u);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "wireless/link-quality.hpp"
+
+// ============================================
+// LinkQualityTable Tests
+// ============================================
+
+class LinkQualityTests : public testing::Test {
+public:
+    LinkQualityTable table;
+    LinkEstimate estimate;
+    uint8_t peerA[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0A};
+    uint8_t peerB[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0B};
+};
+
+inline void linkQualitySmoothsDeliveryRatio(LinkQualityTests* suite) {
+    EXPECT_FALSE(suite->table.get(suite->peerA, suite->estimate));
+
+    suite->table.recordSend(suite->peerA, true, 10);
+    ASSERT_TRUE(suite->table.get(suite->peerA, suite->estimate));
+    EXPECT_EQ(suite->estimate.deliveryPermille, 1000);
+
+    // Each failure moves the estimate an eighth of the way to zero
+    suite->table.recordSend(suite->peerA, false, 20);
+    suite->table.get(suite->peerA, suite->estimate);
+    EXPECT_EQ(suite->estimate.deliveryPermille, 875);
+    suite->table.recordSend(suite->peerA, false, 30);
+    suite->table.get(suite->peerA, suite->estimate);
+    EXPECT_EQ(suite->estimate.deliveryPermille, 766);
+    EXPECT_EQ(suite->estimate.txDelivered, 1u);
+    EXPECT_EQ(suite->estimate.txFailed, 2u);
+    EXPECT_EQ(suite->estimate.lastUpdateMs, 30u);
+
+    // A link that starts bad starts at zero
+    suite->table.recordSend(suite->peerB, false, 40);
+    suite->table.get(suite->peerB, suite->estimate);
+    EXPECT_EQ(suite->estimate.deliveryPermille, 0);
+}
+
+inline void linkQualitySmoothsRttAndRssi(LinkQualityTests* suite) {
+    suite->table.recordAckRtt(suite->peerA, 40, 0);
+    suite->table.get(suite->peerA, suite->estimate);
+    ASSERT_TRUE(suite->estimate.hasRtt);
+    EXPECT_EQ(suite->estimate.srttMs, 40u);
+    EXPECT_EQ(suite->estimate.rttvarMs, 20u);
+    EXPECT_FALSE(suite->estimate.hasRssi);
+
+    suite->table.recordAckRtt(suite->peerA, 80, 0);
+    suite->table.get(suite->peerA, suite->estimate);
+    EXPECT_EQ(suite->estimate.srttMs, 45u);
+    EXPECT_EQ(suite->estimate.rttvarMs, 25u);
+    EXPECT_EQ(suite->estimate.rttSamples, 2u);
+
+    suite->table.recordRssi(suite->peerA, -60, 0);
+    suite->table.recordRssi(suite->peerA, -80, 0);
+    suite->table.get(suite->peerA, suite->estimate);
+    ASSERT_TRUE(suite->estimate.hasRssi);
+    EXPECT_EQ(suite->estimate.rssiDbm, -65);
+    // Untouched by RTT and RSSI samples
+    EXPECT_EQ(suite->estimate.deliveryPermille, 1000);
+}
+
+inline void linkQualityReplacesLeastRecentlyUpdated(LinkQualityTests* suite) {
+    uint8_t mac[6] = {0x02, 0x01, 0x00, 0x00, 0x00, 0x00};
+    for (size_t i = 0; i < LinkQualityTable::kMaxPeers; i++) {
+        mac[5] = static_cast<uint8_t>(i);
+        suite->table.recordSend(mac, true, i);
+    }
+    EXPECT_EQ(suite->table.size(), LinkQualityTable::kMaxPeers);
+
+    // Refresh the oldest so the second oldest is replaced instead
+    mac[5] = 0;
+    suite->table.recordRssi(mac, -50, 100);
+    suite->table.recordSend(suite->peerA, true, 101);
+
+    EXPECT_EQ(suite->table.size(), LinkQualityTable::kMaxPeers);
+    EXPECT_TRUE(suite->table.get(mac, suite->estimate));
+    mac[5] = 1;
+    EXPECT_FALSE(suite->table.get(mac, suite->estimate));
+    EXPECT_TRUE(suite->table.get(suite->peerA, suite->estimate));
+
+    EXPECT_TRUE(suite->table.remove(suite->peerA));
+    EXPECT_FALSE(suite->table.remove(suite->peerA));
+    suite->table.clear();
+    EXPECT_EQ(suite->table.size(), 0u);
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include "utils/loop-profiler.hpp"
+#include "device/drivers/driver-manager.hpp"
+#include "utility-tests.hpp"
+#include "state-machine-tests.hpp"
+
+// ============================================
+// LoopProfiler Tests
+// ============================================
+
+class LoopProfilerTests : public testing::Test {
+public:
+    void SetUp() override {
+        profiler.setClock(&clock);
+    }
+
+    FakePlatformClock clock;
+    LoopProfiler profiler;
+};
+
+inline void loopProfilerBucketEdges(LoopProfilerTests* suite) {
+    (void)suite;
+    EXPECT_EQ(LoopProfiler::bucketFor(0), 0u);
+    EXPECT_EQ(LoopProfiler::bucketFor(1), 1u);
+    EXPECT_EQ(LoopProfiler::bucketFor(2), 2u);
+    EXPECT_EQ(LoopProfiler::bucketFor(3), 2u);
+    EXPECT_EQ(LoopProfiler::bucketFor(1023), 10u);
+    EXPECT_EQ(LoopProfiler::bucketFor(1024), 11u);
+    EXPECT_EQ(LoopProfiler::bucketFor(16383), 14u);
+    EXPECT_EQ(LoopProfiler::bucketFor(16384), LOOP_PROFILE_BUCKETS - 1);
+    EXPECT_EQ(LoopProfiler::bucketFor(UINT32_MAX), LOOP_PROFILE_BUCKETS - 1);
+
+    // Every value lands below its bucket's upper bound
+    for (uint32_t us : {0u, 1u, 7u, 8u, 999u, 16383u}) {
+        EXPECT_LT(us, LoopProfiler::bucketUpperUs(LoopProfiler::bucketFor(us))) << us;
+    }
+    EXPECT_EQ(LoopProfiler::bucketUpperUs(LOOP_PROFILE_BUCKETS - 1), UINT32_MAX);
+}
+
+inline void loopProfilerRecordsCountsAndPercentiles(LoopProfilerTests* suite) {
+    LoopProfiler& profiler = suite->profiler;
+    profiler.setTickBudgetUs(1000);
+    size_t tick = profiler.tickSection();
+    EXPECT_EQ(profiler.tickSection(), tick);
+
+    for (int i = 0; i < 98; i++) {
+        profiler.record(tick, 40);
+    }
+    profiler.record(tick, 900);
+    profiler.record(tick, 5000);
+
+    const LoopProfileSection& section = profiler.getSection(tick);
+    EXPECT_EQ(section.count, 100u);
+    EXPECT_EQ(section.totalUs, 98u * 40u + 900u + 5000u);
+    EXPECT_EQ(section.maxUs, 5000u);
+    EXPECT_EQ(section.overBudget, 1u);
+    EXPECT_EQ(section.buckets[LoopProfiler::bucketFor(40)], 98u);
+    EXPECT_EQ(section.percentileUs(50), 64u);
+    EXPECT_EQ(section.percentileUs(99), 1024u);
+    EXPECT_EQ(section.percentileUs(100), 8192u);
+
+    profiler.reset();
+    EXPECT_EQ(profiler.getSectionCount(), 0u);
+    EXPECT_EQ(LoopProfileSection().percentileUs(99), 0u);
+}
+
+inline void loopProfilerScopeTimesWithClock(LoopProfilerTests* suite) {
+    size_t section = suite->profiler.stateSection(1, 4);
+    {
+        LoopProfileScope scope(suite->profiler, section);
+        suite->clock.advance(3);
+    }
+    const LoopProfileSection& entry = suite->profiler.getSection(section);
+    EXPECT_EQ(entry.kind, LoopProfileSection::Kind::kState);
+    EXPECT_EQ(entry.count, 1u);
+    EXPECT_EQ(entry.maxUs, 3000u);
+}
+
+inline void loopProfilerSectionsOverflowIntoOther(LoopProfilerTests* suite) {
+    LoopProfiler& profiler = suite->profiler;
+    static char names[LoopProfiler::kMaxSections + 4][16];
+    for (size_t i = 0; i < LoopProfiler::kMaxSections + 4; i++) {
+        snprintf(names[i], sizeof(names[i]), "driver-%zu", i);
+        profiler.record(profiler.driverSection(names[i]), 1);
+    }
+    ASSERT_EQ(profiler.getSectionCount(), LoopProfiler::kMaxSections);
+    EXPECT_STREQ(profiler.getSection(0).name, "driver-0");
+    const LoopProfileSection& other = profiler.getSection(LoopProfiler::kMaxSections - 1);
+    EXPECT_STREQ(other.name, "(other)");
+    EXPECT_EQ(other.count, 5u);
+
+    // Names compare by content, not pointer
+    char copy[16];
+    strcpy(copy, names[3]);
+    EXPECT_EQ(profiler.driverSection(copy), 3u);
+}
+
+inline void loopProfilerFormatsRowsAndHistograms(LoopProfilerTests* suite) {
+    LoopProfiler& profiler = suite->profiler;
+    size_t light = profiler.driverSection("light");
+    profiler.record(light, 40);
+    profiler.record(light, 50);
+    profiler.record(light, 20000);
+
+    const LoopProfileSection& section = profiler.getSection(light);
+    char label[32];
+    formatLoopProfileLabel(section, label, sizeof(label));
+    EXPECT_STREQ(label, "driver:light");
+
+    char row[128];
+    formatLoopProfileRow(section, label, row, sizeof(row));
+    EXPECT_STREQ(row, "driver:light n=3 mean 6696us p50<64 p99>=16ms max 20000us over 1");
+
+    char histogram[128];
+    formatLoopProfileHistogram(section, histogram, sizeof(histogram));
+    EXPECT_STREQ(histogram, "<64us:2 >=16ms:1");
+
+    // Truncates like snprintf and still reports the full length
+    char small[8];
+    int needed = formatLoopProfileHistogram(section, small, sizeof(small));
+    EXPECT_EQ(needed, static_cast<int>(strlen("<64us:2 >=16ms:1")));
+
+    formatLoopProfileLabel(profiler.getSection(profiler.stateSection(1, 7)), label, sizeof(label));
+    EXPECT_STREQ(label, "state:1/7");
+}
+
+// ============================================
+// Loop profiling through Device and StateMachine
+// ============================================
+
+class ClockAdvancingDriver : public DriverInterface {
+public:
+    ClockAdvancingDriver(FakePlatformClock& clock, unsigned long stepMs)
+        : DriverInterface(DriverType::HAPTICS, "slow"), clock_(clock), stepMs_(stepMs) {}
+
+    int initialize() override { return 0; }
+    void exec() override { clock_.advance(stepMs_); }
+    void* abstractSelf() override { return nullptr; }
+
+private:
+    FakePlatformClock& clock_;
+    unsigned long stepMs_;
+};
+
+inline void loopProfilerTimesEachDriver(LoopProfilerTests* suite) {
+#ifndef LOOP_PROFILING
+    GTEST_SKIP() << "built without LOOP_PROFILING";
+#else
+    ClockAdvancingDriver fast(suite->clock, 1);
+    ClockAdvancingDriver slow(suite->clock, 12);
+    DriverManager drivers({{"fast", &fast}, {"slow", &slow}});
+    for (int tick = 0; tick < 4; tick++) {
+        drivers.execDrivers(suite->profiler);
+    }
+
+    ASSERT_EQ(suite->profiler.getSectionCount(), 2u);
+    const LoopProfileSection& fastSection = suite->profiler.getSection(suite->profiler.driverSection("fast"));
+    const LoopProfileSection& slowSection = suite->profiler.getSection(suite->profiler.driverSection("slow"));
+    EXPECT_EQ(fastSection.count, 4u);
+    EXPECT_EQ(fastSection.maxUs, 1000u);
+    EXPECT_EQ(fastSection.overBudget, 0u);
+    EXPECT_EQ(slowSection.maxUs, 12000u);
+    EXPECT_EQ(slowSection.overBudget, 4u);
+#endif
+}
+
+class LoopProfilerDeviceTests : public testing::Test {
+public:
+    MockDevice device;
+    TestStateMachine stateMachine;
+};
+
+inline void loopProfilerTimesTicksAndStates(LoopProfilerDeviceTests* suite) {
+    LoopProfiler* profiler = suite->device.getLoopProfiler();
+#ifndef LOOP_PROFILING
+    EXPECT_EQ(profiler, nullptr);
+    GTEST_SKIP() << "built without LOOP_PROFILING";
+#else
+    ASSERT_NE(profiler, nullptr);
+    suite->stateMachine.onStateMounted(&suite->device);
+    for (int i = 0; i < 3; i++) {
+        suite->stateMachine.onStateLoop(&suite->device);
+    }
+    suite->device.loop();
+
+    // The initial state hands over to the second after one loop
+    int machineId = suite->stateMachine.getStateId();
+    EXPECT_EQ(profiler->getSection(profiler->stateSection(machineId, INITIAL_STATE)).count, 1u);
+    EXPECT_EQ(profiler->getSection(profiler->stateSection(machineId, SECOND_STATE)).count, 2u);
+    EXPECT_EQ(profiler->getSection(profiler->tickSection()).count, 1u);
+#endif
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+#include "wireless/multicast-group.hpp"
+#include "device-mock.hpp"
+
+// ============================================
+// MulticastGroup Tests
+// ============================================
+
+class MulticastGroupTests : public testing::Test {
+public:
+    MulticastMembership membership;
+    uint8_t championA[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0A};
+    uint8_t championB[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0B};
+};
+
+inline void multicastGroupTagsAreScoped(MulticastGroupTests* suite) {
+    MulticastGroup chainA = multicastGroupFor("chain", suite->championA);
+    EXPECT_NE(chainA, NO_MULTICAST_GROUP);
+    EXPECT_EQ(chainA, multicastGroupFor("chain", suite->championA));
+    EXPECT_NE(chainA, multicastGroupFor("chain", suite->championB));
+    EXPECT_NE(chainA, multicastGroupFor("shootout", suite->championA));
+    EXPECT_NE(multicastGroupFor("chain"), NO_MULTICAST_GROUP);
+}
+
+inline void multicastGroupFiltersByMembership(MulticastGroupTests* suite) {
+    MulticastGroup joined = multicastGroupFor("chain", suite->championA);
+    MulticastGroup other = multicastGroupFor("chain", suite->championB);
+    ASSERT_TRUE(suite->membership.join(joined));
+    ASSERT_TRUE(suite->membership.join(joined));
+    EXPECT_EQ(suite->membership.size(), 1u);
+
+    uint8_t data[] = {0x01, 0x00};
+    std::vector<uint8_t> framed;
+    buildMulticastPayload(joined, PktType::kChainGameEvent, data, sizeof(data), framed);
+    ASSERT_EQ(framed.size(), sizeof(MulticastHdr) + sizeof(data));
+
+    PktType type = PktType::kNumPacketTypes;
+    const uint8_t* payload = nullptr;
+    size_t len = 0;
+    ASSERT_TRUE(suite->membership.accept(framed.data(), framed.size(), type, payload, len));
+    EXPECT_EQ(type, PktType::kChainGameEvent);
+    ASSERT_EQ(len, sizeof(data));
+    EXPECT_EQ(memcmp(payload, data, len), 0);
+
+    buildMulticastPayload(other, PktType::kChainGameEvent, data, sizeof(data), framed);
+    EXPECT_FALSE(suite->membership.accept(framed.data(), framed.size(), type, payload, len));
+
+    // Transport-level types can't be smuggled inside a multicast
+    buildMulticastPayload(joined, PktType::kFragmentNack, data, sizeof(data), framed);
+    EXPECT_FALSE(suite->membership.accept(framed.data(), framed.size(), type, payload, len));
+    EXPECT_FALSE(suite->membership.accept(framed.data(), 1, type, payload, len));
+
+    EXPECT_EQ(suite->membership.getStats().accepted, 1u);
+    EXPECT_EQ(suite->membership.getStats().filtered, 1u);
+    EXPECT_EQ(suite->membership.getStats().malformed, 2u);
+
+    EXPECT_TRUE(suite->membership.leave(joined));
+    EXPECT_FALSE(suite->membership.isMember(joined));
+}
+
+inline void multicastGroupJoinIsBounded(MulticastGroupTests* suite) {
+    EXPECT_FALSE(suite->membership.join(NO_MULTICAST_GROUP));
+    for (MulticastGroup g = 1; g <= MulticastMembership::kMaxGroups; g++) {
+        ASSERT_TRUE(suite->membership.join(g));
+    }
+    EXPECT_FALSE(suite->membership.join(100));
+    EXPECT_TRUE(suite->membership.leave(3));
+    EXPECT_TRUE(suite->membership.join(100));
+    EXPECT_TRUE(suite->membership.isMember(8));
+    EXPECT_FALSE(suite->membership.isMember(3));
+    suite->membership.clear();
+    EXPECT_EQ(suite->membership.size(), 0u);
+}
+
+// ============================================
+// Multicast sends through WirelessManager
+// ============================================
+
+class MulticastCountingPeerComms : public MockPeerComms {
+public:
+    int sendMulticast(MulticastGroup group, PktType packetType, const uint8_t* data, const size_t length,
+                      const SendOptions& options) override {
+        (void)group; (void)packetType; (void)data; (void)length; (void)options;
+        multicasts++;
+        return 0;
+    }
+
+    int multicasts = 0;
+};
+
+class MulticastSendTests : public testing::Test {
+public:
+    void SetUp() override {
+        ON_CALL(peerComms, getPeerCommsState()).WillByDefault(testing::Return(PeerCommsState::CONNECTED));
+        wirelessManager = new WirelessManager(&peerComms, &httpClient);
+    }
+
+    void TearDown() override {
+        delete wirelessManager;
+    }
+
+    testing::NiceMock<MulticastCountingPeerComms> peerComms;
+    testing::NiceMock<MockHttpClient> httpClient;
+    WirelessManager* wirelessManager = nullptr;
+};
+
+// Older firmware drops kMulticast, so callers get -1 and fall back to unicast
+// until the fleet has been upgraded
+inline void multicastSendIsOffByDefault(MulticastSendTests* suite) {
+    MulticastGroup group = multicastGroupFor("chain");
+    uint8_t event[2] = {};
+    SendOptions options = defaultSendOptions(PktType::kChainGameEvent);
+    EXPECT_EQ(suite->wirelessManager->sendEspNowMulticast(group, PktType::kChainGameEvent, event,
+                                                          sizeof(event), options), -1);
+    EXPECT_EQ(suite->peerComms.multicasts, 0);
+
+    suite->wirelessManager->setEspNowMulticast(true);
+    EXPECT_EQ(suite->wirelessManager->sendEspNowMulticast(group, PktType::kChainGameEvent, event,
+                                                          sizeof(event), options), 0);
+    EXPECT_EQ(suite->peerComms.multicasts, 1);
+}
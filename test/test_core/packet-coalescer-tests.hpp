@@ -0,0 +1,136 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+#include "wireless/packet-coalescer.hpp"
+
+// ============================================
+// PacketCoalescer Tests
+// ============================================
+
+class PacketCoalescerTests : public testing::Test {
+public:
+    struct Emitted {
+        uint8_t dst[6];
+        PktType type;
+        std::vector<uint8_t> data;
+        SendOptions options;
+    };
+
+    void SetUp() override {
+        coalescer.setEnabled(true);
+    }
+
+    void flushAll(unsigned long nowMs) {
+        coalescer.flush(nowMs, [this](const uint8_t* dst, PktType type, const uint8_t* data, size_t length,
+                                      const SendOptions& options) {
+            Emitted out;
+            memcpy(out.dst, dst, sizeof(out.dst));
+            out.type = type;
+            out.data.assign(data, data + length);
+            out.options = options;
+            emitted.push_back(out);
+        });
+    }
+
+    PacketCoalescer coalescer;
+    std::vector<Emitted> emitted;
+    uint8_t peerA[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0A};
+    uint8_t peerB[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0B};
+};
+
+inline void packetCoalescerBundlesPerDestination(PacketCoalescerTests* suite) {
+    uint8_t ack[] = {0x03};
+    uint8_t shootoutAck[] = {0x01, 0x04};
+    SendOptions control = defaultSendOptions(PktType::kShootoutCommandAck);
+    SendOptions urgent = defaultSendOptions(PktType::kChainGameEventAck);
+    urgent.maxAgeMs = 50;
+
+    ASSERT_TRUE(suite->coalescer.stage(suite->peerA, PktType::kShootoutCommandAck,
+                                       shootoutAck, sizeof(shootoutAck), control, 100));
+    ASSERT_TRUE(suite->coalescer.stage(suite->peerA, PktType::kChainGameEventAck,
+                                       ack, sizeof(ack), urgent, 110));
+    ASSERT_TRUE(suite->coalescer.stage(suite->peerB, PktType::kRoleAnnounceAck,
+                                       ack, sizeof(ack), control, 110));
+    EXPECT_TRUE(suite->coalescer.hasPending());
+
+    suite->flushAll(120);
+    EXPECT_FALSE(suite->coalescer.hasPending());
+    ASSERT_EQ(suite->emitted.size(), 2u);
+
+    // peerA: one bundle at the most urgent class with the earliest deadline
+    const auto& bundle = suite->emitted[0];
+    EXPECT_EQ(memcmp(bundle.dst, suite->peerA, 6), 0);
+    EXPECT_EQ(bundle.type, PktType::kBundle);
+    EXPECT_EQ(bundle.options.priority, SendPriority::kDuel);
+    EXPECT_EQ(bundle.options.maxAgeMs, 40u);
+    std::vector<PktType> types;
+    ASSERT_TRUE(forEachBundled(bundle.data.data(), bundle.data.size(),
+                               [&](PktType type, const uint8_t* data, size_t length) {
+        types.push_back(type);
+        if (type == PktType::kShootoutCommandAck) {
+            EXPECT_EQ(length, sizeof(shootoutAck));
+            EXPECT_EQ(memcmp(data, shootoutAck, length), 0);
+        }
+    }));
+    ASSERT_EQ(types.size(), 2u);
+    EXPECT_EQ(types[0], PktType::kShootoutCommandAck);
+    EXPECT_EQ(types[1], PktType::kChainGameEventAck);
+
+    // peerB: a lone message goes out as itself
+    EXPECT_EQ(suite->emitted[1].type, PktType::kRoleAnnounceAck);
+    EXPECT_EQ(suite->emitted[1].data.size(), sizeof(ack));
+
+    const PacketCoalescer::Stats& stats = suite->coalescer.getStats();
+    EXPECT_EQ(stats.staged, 3u);
+    EXPECT_EQ(stats.bundles, 1u);
+    EXPECT_EQ(stats.singles, 1u);
+    EXPECT_EQ(stats.framesSaved, 1u);
+}
+
+inline void packetCoalescerRefusesWhatItCannotBundle(PacketCoalescerTests* suite) {
+    uint8_t ack[] = {0x03};
+    uint8_t big[PacketCoalescer::kMaxMessageLen + 1] = {};
+    SendOptions options;
+
+    EXPECT_FALSE(suite->coalescer.stage(suite->peerA, PktType::kChainGameEvent, ack, sizeof(ack), options, 0));
+    EXPECT_FALSE(suite->coalescer.stage(suite->peerA, PktType::kRoleAnnounceAck, big, sizeof(big), options, 0));
+
+    // A full bundle refuses until its destination is flushed
+    uint8_t max[PacketCoalescer::kMaxMessageLen] = {};
+    size_t fits = PacketCoalescer::kMaxBundleLen / (sizeof(BundleEntryHdr) + sizeof(max));
+    for (size_t i = 0; i < fits; i++) {
+        ASSERT_TRUE(suite->coalescer.stage(suite->peerA, PktType::kRoleAnnounce, max, sizeof(max), options, 0));
+    }
+    EXPECT_FALSE(suite->coalescer.stage(suite->peerA, PktType::kRoleAnnounce, max, sizeof(max), options, 0));
+    size_t flushed = 0;
+    EXPECT_TRUE(suite->coalescer.flush(suite->peerA, 0,
+        [&](const uint8_t*, PktType, const uint8_t*, size_t, const SendOptions&) { flushed++; }));
+    EXPECT_EQ(flushed, 1u);
+    EXPECT_FALSE(suite->coalescer.flush(suite->peerA, 0,
+        [&](const uint8_t*, PktType, const uint8_t*, size_t, const SendOptions&) { flushed++; }));
+
+    suite->coalescer.setEnabled(false);
+    EXPECT_FALSE(suite->coalescer.stage(suite->peerA, PktType::kRoleAnnounceAck, ack, sizeof(ack), options, 0));
+}
+
+inline void packetCoalescerRejectsMalformedBundles(PacketCoalescerTests* suite) {
+    int calls = 0;
+    auto count = [&](PktType, const uint8_t*, size_t) { calls++; };
+
+    // Second entry claims more bytes than remain
+    uint8_t truncated[] = {(uint8_t)PktType::kRoleAnnounceAck, 1, 0x07,
+                           (uint8_t)PktType::kRoleAnnounceAck, 4, 0x08};
+    EXPECT_FALSE(forEachBundled(truncated, sizeof(truncated), count));
+
+    // Transport-level types never travel inside a bundle
+    uint8_t nested[] = {(uint8_t)PktType::kBundle, 0};
+    EXPECT_FALSE(forEachBundled(nested, sizeof(nested), count));
+    EXPECT_FALSE(forEachBundled(nested, 0, count));
+    EXPECT_EQ(calls, 0);
+
+    uint8_t empty[] = {(uint8_t)PktType::kChainConfirm, 0};
+    EXPECT_TRUE(forEachBundled(empty, sizeof(empty), count));
+    EXPECT_EQ(calls, 1);
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+#include "wireless/packet-registry.hpp"
+
+// ============================================
+// Packet Registry Tests
+// ============================================
+
+class PacketRegistryTests : public testing::Test {
+public:
+    struct Receiver {
+        void onRoleAnnounce(const uint8_t* src, const RoleAnnouncePayload& payload, size_t) {
+            memcpy(lastSrc, src, sizeof(lastSrc));
+            roles.push_back(payload.role);
+            seqIds.push_back(payload.seqId);
+        }
+
+        void onAnnouncement(const uint8_t*, const ChainAnnouncementHdr& hdr, size_t length) {
+            peerCounts.push_back(hdr.peerCount);
+            lengths.push_back(length);
+        }
+
+        uint8_t lastSrc[6] = {};
+        std::vector<uint8_t> roles;
+        std::vector<uint8_t> seqIds;
+        std::vector<uint8_t> peerCounts;
+        std::vector<size_t> lengths;
+    };
+
+    static void countCall(const uint8_t*, const uint8_t*, const size_t length, void* ctx) {
+        static_cast<std::vector<size_t>*>(ctx)->push_back(length);
+    }
+
+    Receiver receiver;
+    uint8_t peer[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0A};
+};
+
+inline void packetRegistryDecodeChecksLength(PacketRegistryTests* suite) {
+    RoleAnnouncePayload role{1, {1, 2, 3, 4, 5, 6}, 9};
+    const uint8_t* raw = reinterpret_cast<const uint8_t*>(&role);
+
+    const RoleAnnouncePayload* decoded = decodePacket<PktType::kRoleAnnounce>(raw, sizeof(role));
+    ASSERT_NE(decoded, nullptr);
+    EXPECT_EQ(decoded->seqId, 9);
+    EXPECT_EQ(decodePacket<PktType::kRoleAnnounce>(raw, sizeof(role) - 1), nullptr);
+    EXPECT_EQ(decodePacket<PktType::kRoleAnnounce>(raw, sizeof(role) + 1), nullptr);
+    EXPECT_EQ(decodePacket<PktType::kRoleAnnounce>(nullptr, sizeof(role)), nullptr);
+
+    // Prefix layouts accept any tail; the shootout command body is parsed later
+    uint8_t shootout[] = {static_cast<uint8_t>(ShootoutCmd::ABORT), 4, 0xAA, 0xBB};
+    const ShootoutPacket* command = decodePacket<PktType::kShootoutCommand>(shootout, sizeof(shootout));
+    ASSERT_NE(command, nullptr);
+    EXPECT_EQ(command->cmd, ShootoutCmd::ABORT);
+    EXPECT_EQ(command->payload[1], 0xBB);
+    EXPECT_EQ(decodePacket<PktType::kShootoutCommand>(shootout, 1), nullptr);
+
+    // Chain announcements must carry exactly peerCount MACs
+    uint8_t announcement[2 + 12] = {7, 2};
+    EXPECT_NE(decodePacket<PktType::kChainAnnouncement>(announcement, sizeof(announcement)), nullptr);
+    EXPECT_EQ(decodePacket<PktType::kChainAnnouncement>(announcement, sizeof(announcement) - 6), nullptr);
+    announcement[1] = 0;
+    EXPECT_NE(decodePacket<PktType::kChainAnnouncement>(announcement, 2), nullptr);
+}
+
+inline void packetRegistryHandlerDropsMalformed(PacketRegistryTests* suite) {
+    PacketHandlerTable::Callback roleHandler =
+        packetHandler<PktType::kRoleAnnounce, &PacketRegistryTests::Receiver::onRoleAnnounce>;
+    PacketHandlerTable::Callback announceHandler =
+        packetHandler<PktType::kChainAnnouncement, &PacketRegistryTests::Receiver::onAnnouncement>;
+
+    RoleAnnouncePayload role{1, {1, 2, 3, 4, 5, 6}, 3};
+    const uint8_t* raw = reinterpret_cast<const uint8_t*>(&role);
+    roleHandler(suite->peer, raw, sizeof(role), &suite->receiver);
+    roleHandler(suite->peer, raw, 2, &suite->receiver);
+    roleHandler(suite->peer, raw, sizeof(role), nullptr);
+
+    ASSERT_EQ(suite->receiver.roles.size(), 1u);
+    EXPECT_EQ(suite->receiver.roles[0], 1);
+    EXPECT_EQ(suite->receiver.seqIds[0], 3);
+    EXPECT_EQ(memcmp(suite->receiver.lastSrc, suite->peer, 6), 0);
+
+    uint8_t announcement[2 + 6] = {1, 1, 0x02, 0, 0, 0, 0, 0x0B};
+    announceHandler(suite->peer, announcement, sizeof(announcement), &suite->receiver);
+    announcement[1] = 3;
+    announceHandler(suite->peer, announcement, sizeof(announcement), &suite->receiver);
+
+    ASSERT_EQ(suite->receiver.peerCounts.size(), 1u);
+    EXPECT_EQ(suite->receiver.peerCounts[0], 1);
+    EXPECT_EQ(suite->receiver.lengths[0], sizeof(announcement));
+}
+
+inline void packetRegistryTableDispatchesByType(PacketRegistryTests* suite) {
+    PacketHandlerTable table;
+    std::vector<size_t> calls;
+    uint8_t data[4] = {};
+
+    EXPECT_FALSE(table.dispatch(suite->peer, PktType::kRoleAnnounce, data, sizeof(data)));
+
+    table.set(PktType::kRoleAnnounce, PacketRegistryTests::countCall, &calls);
+    EXPECT_TRUE(table.has(PktType::kRoleAnnounce));
+    EXPECT_FALSE(table.has(PktType::kRoleAnnounceAck));
+    EXPECT_TRUE(table.dispatch(suite->peer, PktType::kRoleAnnounce, data, 3));
+    EXPECT_FALSE(table.dispatch(suite->peer, PktType::kRoleAnnounceAck, data, 3));
+    ASSERT_EQ(calls.size(), 1u);
+    EXPECT_EQ(calls[0], 3u);
+
+    // A corrupt type byte from the radio must not index past the table
+    PktType bogus = static_cast<PktType>(0xFE);
+    table.set(bogus, PacketRegistryTests::countCall, &calls);
+    EXPECT_FALSE(table.has(bogus));
+    EXPECT_FALSE(table.dispatch(suite->peer, bogus, data, 1));
+    EXPECT_FALSE(table.dispatch(suite->peer, PktType::kNumPacketTypes, data, 1));
+
+    table.clear(PktType::kRoleAnnounce);
+    EXPECT_FALSE(table.dispatch(suite->peer, PktType::kRoleAnnounce, data, 3));
+    EXPECT_EQ(calls.size(), 1u);
+}
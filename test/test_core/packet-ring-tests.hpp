@@ -0,0 +1,116 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <thread>
+#include "wireless/packet-ring.hpp"
+
+// ============================================
+// PacketRing Tests
+// ============================================
+
+class PacketRingTests : public testing::Test {
+public:
+    PacketRing<4> ring;
+    uint8_t mac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+};
+
+inline void packetRingPreservesOrderAndPayload(PacketRingTests* suite) {
+    uint8_t a[] = {1, 2, 3};
+    uint8_t b[] = {9};
+    ASSERT_TRUE(suite->ring.push(PktType::kQuickdrawCommand, suite->mac, a, sizeof(a)));
+    ASSERT_TRUE(suite->ring.push(PktType::kChainGameEvent, suite->mac, b, sizeof(b)));
+    EXPECT_EQ(suite->ring.size(), 2u);
+
+    const PacketRingSlot* slot = suite->ring.front();
+    ASSERT_NE(slot, nullptr);
+    EXPECT_EQ(slot->type, PktType::kQuickdrawCommand);
+    EXPECT_EQ(slot->len, sizeof(a));
+    EXPECT_EQ(memcmp(slot->data, a, sizeof(a)), 0);
+    EXPECT_EQ(memcmp(slot->srcMac, suite->mac, 6), 0);
+    suite->ring.pop();
+
+    slot = suite->ring.front();
+    ASSERT_NE(slot, nullptr);
+    EXPECT_EQ(slot->type, PktType::kChainGameEvent);
+    EXPECT_EQ(slot->data[0], 9);
+    suite->ring.pop();
+
+    EXPECT_EQ(suite->ring.front(), nullptr);
+    EXPECT_TRUE(suite->ring.empty());
+}
+
+inline void packetRingFullCountsOverflow(PacketRingTests* suite) {
+    uint8_t data[] = {0};
+    for (size_t i = 0; i < suite->ring.capacity(); i++) {
+        ASSERT_TRUE(suite->ring.push(PktType::kDebugPacket, suite->mac, data, 1));
+    }
+    EXPECT_FALSE(suite->ring.push(PktType::kDebugPacket, suite->mac, data, 1));
+    EXPECT_FALSE(suite->ring.push(PktType::kDebugPacket, suite->mac, data, 1));
+    EXPECT_EQ(suite->ring.getOverflowCount(), 2u);
+    EXPECT_EQ(suite->ring.getDropCount(), 0u);
+    EXPECT_EQ(suite->ring.size(), suite->ring.capacity());
+
+    // Freeing one slot makes room again
+    suite->ring.pop();
+    EXPECT_TRUE(suite->ring.push(PktType::kDebugPacket, suite->mac, data, 1));
+}
+
+inline void packetRingOversizedPayloadCountsDrop(PacketRingTests* suite) {
+    uint8_t big[PACKET_RING_SLOT_SIZE + 1] = {};
+    EXPECT_FALSE(suite->ring.push(PktType::kDebugPacket, suite->mac, big, sizeof(big)));
+    EXPECT_EQ(suite->ring.getDropCount(), 1u);
+    EXPECT_EQ(suite->ring.getOverflowCount(), 0u);
+    EXPECT_TRUE(suite->ring.empty());
+
+    EXPECT_TRUE(suite->ring.push(PktType::kDebugPacket, suite->mac, big, PACKET_RING_SLOT_SIZE));
+    EXPECT_EQ(suite->ring.front()->len, PACKET_RING_SLOT_SIZE);
+
+    suite->ring.resetCounters();
+    EXPECT_EQ(suite->ring.getDropCount(), 0u);
+}
+
+inline void packetRingWrapsAroundCapacity(PacketRingTests* suite) {
+    for (uint8_t i = 0; i < 3 * suite->ring.capacity(); i++) {
+        ASSERT_TRUE(suite->ring.push(PktType::kDebugPacket, suite->mac, &i, 1));
+        const PacketRingSlot* slot = suite->ring.front();
+        ASSERT_NE(slot, nullptr);
+        EXPECT_EQ(slot->data[0], i);
+        suite->ring.pop();
+    }
+    EXPECT_TRUE(suite->ring.empty());
+    EXPECT_EQ(suite->ring.getOverflowCount(), 0u);
+}
+
+// Producer thread stands in for the WiFi task; every packet it manages to
+// queue must come out on the consumer side, in order.
+inline void packetRingConcurrentProducerConsumer(PacketRingTests* suite) {
+    PacketRing<16> ring;
+    constexpr uint32_t kCount = 20000;
+    const uint8_t* mac = suite->mac;
+
+    std::thread producer([&]() {
+        for (uint32_t i = 0; i < kCount; i++) {
+            while (!ring.push(PktType::kDebugPacket, mac,
+                              reinterpret_cast<const uint8_t*>(&i), sizeof(i))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    while (expected < kCount) {
+        const PacketRingSlot* slot = ring.front();
+        if (!slot) {
+            std::this_thread::yield();
+            continue;
+        }
+        uint32_t value;
+        memcpy(&value, slot->data, sizeof(value));
+        ASSERT_EQ(value, expected);
+        ring.pop();
+        expected++;
+    }
+    producer.join();
+
+    EXPECT_TRUE(ring.empty());
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include "wireless/peer-table.hpp"
+
+// ============================================
+// PeerTable Tests
+// ============================================
+
+class PeerTableTests : public testing::Test {
+public:
+    // Distinct MAC per index
+    static void macFor(uint8_t i, uint8_t* mac) {
+        const uint8_t base[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x00};
+        memcpy(mac, base, 6);
+        mac[5] = i;
+    }
+
+    PeerTable table{4};
+    uint8_t mac[8][6];
+
+    void SetUp() override {
+        for (uint8_t i = 0; i < 8; i++) {
+            macFor(i, mac[i]);
+        }
+    }
+};
+
+inline void peerTableEvictsLeastRecentlyUsed(PeerTableTests* suite) {
+    for (uint8_t i = 0; i < 4; i++) {
+        EXPECT_EQ(suite->table.admit(suite->mac[i], false, nullptr), PeerTable::Admit::kAdded);
+    }
+    // Sending to peer 0 again makes peer 1 the oldest
+    EXPECT_EQ(suite->table.admit(suite->mac[0], false, nullptr), PeerTable::Admit::kPresent);
+
+    uint8_t evicted[6] = {};
+    EXPECT_EQ(suite->table.admit(suite->mac[4], false, evicted), PeerTable::Admit::kEvicted);
+    EXPECT_EQ(memcmp(evicted, suite->mac[1], 6), 0);
+    EXPECT_FALSE(suite->table.contains(suite->mac[1]));
+    EXPECT_TRUE(suite->table.contains(suite->mac[0]));
+    EXPECT_EQ(suite->table.size(), 4u);
+
+    const PeerTable::Stats& stats = suite->table.getStats();
+    EXPECT_EQ(stats.adds, 5u);
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.evictions, 1u);
+}
+
+inline void peerTablePinnedPeersSurvive(PeerTableTests* suite) {
+    suite->table.admit(suite->mac[0], true, nullptr);
+    for (uint8_t i = 1; i < 8; i++) {
+        EXPECT_NE(suite->table.admit(suite->mac[i], false, nullptr), PeerTable::Admit::kFull);
+    }
+    EXPECT_TRUE(suite->table.contains(suite->mac[0]));
+    EXPECT_TRUE(suite->table.isPinned(suite->mac[0]));
+
+    // A later unpinned registration doesn't drop the pin
+    suite->table.admit(suite->mac[0], false, nullptr);
+    EXPECT_TRUE(suite->table.isPinned(suite->mac[0]));
+    EXPECT_EQ(suite->table.pinnedCount(), 1u);
+}
+
+inline void peerTableFullWhenEveryEntryPinned(PeerTableTests* suite) {
+    for (uint8_t i = 0; i < 4; i++) {
+        suite->table.admit(suite->mac[i], true, nullptr);
+    }
+    EXPECT_EQ(suite->table.admit(suite->mac[4], false, nullptr), PeerTable::Admit::kFull);
+    EXPECT_FALSE(suite->table.contains(suite->mac[4]));
+    EXPECT_EQ(suite->table.getStats().rejected, 1u);
+
+    // Unpinning one makes room
+    EXPECT_TRUE(suite->table.unpin(suite->mac[2]));
+    uint8_t evicted[6] = {};
+    EXPECT_EQ(suite->table.admit(suite->mac[4], false, evicted), PeerTable::Admit::kEvicted);
+    EXPECT_EQ(memcmp(evicted, suite->mac[2], 6), 0);
+}
+
+inline void peerTableRemoveFreesEntry(PeerTableTests* suite) {
+    for (uint8_t i = 0; i < 4; i++) {
+        suite->table.admit(suite->mac[i], false, nullptr);
+    }
+    EXPECT_TRUE(suite->table.remove(suite->mac[3]));
+    EXPECT_FALSE(suite->table.remove(suite->mac[3]));
+    EXPECT_EQ(suite->table.admit(suite->mac[5], false, nullptr), PeerTable::Admit::kAdded);
+    EXPECT_EQ(suite->table.getStats().evictions, 0u);
+
+    suite->table.clear();
+    EXPECT_EQ(suite->table.size(), 0u);
+    EXPECT_FALSE(suite->table.contains(suite->mac[0]));
+}
+
+inline void peerTableTracksMaxFrameLen(PeerTableTests* suite) {
+    suite->table.admit(suite->mac[0], false, nullptr);
+    EXPECT_EQ(suite->table.maxFrameLen(suite->mac[0]), PEER_COMMS_MAX_FRAME_LEN);
+    suite->table.setMaxFrameLen(suite->mac[0], PEER_COMMS_MAX_FRAME_LEN_V2);
+    EXPECT_EQ(suite->table.maxFrameLen(suite->mac[0]), PEER_COMMS_MAX_FRAME_LEN_V2);
+
+    // Caps are recorded without admitting the peer
+    suite->table.setMaxFrameLen(suite->mac[1], PEER_COMMS_MAX_FRAME_LEN_V2);
+    EXPECT_FALSE(suite->table.contains(suite->mac[1]));
+    EXPECT_EQ(suite->table.maxFrameLen(suite->mac[1]), PEER_COMMS_MAX_FRAME_LEN_V2);
+
+    // ...and survive eviction, so a returning peer isn't asked again
+    for (uint8_t i = 1; i < 5; i++) {
+        suite->table.admit(suite->mac[i], false, nullptr);
+    }
+    EXPECT_FALSE(suite->table.contains(suite->mac[0]));
+    EXPECT_EQ(suite->table.admit(suite->mac[0], false, nullptr), PeerTable::Admit::kEvicted);
+    EXPECT_EQ(suite->table.maxFrameLen(suite->mac[0]), PEER_COMMS_MAX_FRAME_LEN_V2);
+    EXPECT_FALSE(suite->table.shouldRequestCaps(suite->mac[0]));
+}
+
+inline void peerTableRequestsCapsOncePerPeer(PeerTableTests* suite) {
+    EXPECT_TRUE(suite->table.shouldRequestCaps(suite->mac[2]));
+    EXPECT_FALSE(suite->table.shouldRequestCaps(suite->mac[2]));
+    // Asking doesn't make up caps the peer never sent
+    EXPECT_EQ(suite->table.maxFrameLen(suite->mac[2]), PEER_COMMS_MAX_FRAME_LEN);
+
+    // Past PEER_CAPS_CAPACITY peers the least recently heard is forgotten
+    for (size_t i = 0; i < PEER_CAPS_CAPACITY; i++) {
+        uint8_t mac[6] = {0x02, 0xCA, 0x00, 0x00, static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(i)};
+        EXPECT_TRUE(suite->table.shouldRequestCaps(mac));
+    }
+    EXPECT_TRUE(suite->table.shouldRequestCaps(suite->mac[2]));
+}
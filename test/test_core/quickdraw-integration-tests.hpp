@@ -405,6 +405,73 @@ inline void packetParsingRejectsMalformedPacket(PacketParsingTests* suite) {
     EXPECT_FALSE(callbackInvoked);
 }
 
+inline void packetParsingCompactRoundTrip(PacketParsingTests* suite) {
+    static const char kMatchId[37] = "123e4567-e89b-12d3-a456-426614174000";
+    QuickdrawCommand sent(nullptr, QDCommand::DRAW_RESULT, kMatchId, "hunt", 312, true);
+
+    uint8_t wire[QUICKDRAW_PACKET_MAX_LEN];
+    size_t wireLen = encodeQuickdrawPacket(sent, wire, true);
+    ASSERT_EQ(wireLen, sizeof(QuickdrawPacketV2));
+    EXPECT_EQ(wire[0], QUICKDRAW_WIRE_VERSION);
+
+    uint8_t macAddr[6] = {0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
+    std::optional<QuickdrawCommand> received = decodeQuickdrawPacket(macAddr, wire, wireLen);
+    ASSERT_TRUE(received.has_value());
+    EXPECT_EQ(received->command, QDCommand::DRAW_RESULT);
+    EXPECT_STREQ(received->matchId, kMatchId);
+    EXPECT_STREQ(received->playerId, "hunt");
+    EXPECT_EQ(received->playerDrawTime, 312L);
+    EXPECT_TRUE(received->isHunter);
+
+    // A wrong version byte is not mistaken for anything else
+    wire[0] = QUICKDRAW_WIRE_VERSION + 1;
+    EXPECT_FALSE(decodeQuickdrawPacket(macAddr, wire, wireLen).has_value());
+    EXPECT_FALSE(decodeQuickdrawPacket(macAddr, wire, wireLen - 1).has_value());
+
+    bool callbackInvoked = false;
+    suite->wirelessManager->setPacketReceivedCallback([&](const QuickdrawCommand&) {
+        callbackInvoked = true;
+    });
+    wire[0] = QUICKDRAW_WIRE_VERSION;
+    EXPECT_EQ(suite->wirelessManager->processQuickdrawCommand(macAddr, wire, wireLen), 1);
+    EXPECT_TRUE(callbackInvoked);
+}
+
+inline void packetParsingAcceptsDeviceLegacyLayout(PacketParsingTests* suite) {
+    // Legacy packet as the ESP32-S3 builds it, with a 4-byte long
+    uint8_t wire[51] = {};
+    const char* matchId = "match-from-older-firmware";
+    memcpy(wire, matchId, strlen(matchId));
+    memcpy(wire + 37, "boun", 4);
+    wire[42] = 0;
+    wire[43] = 0x0F; wire[44] = 0x27;       // 9999
+    wire[47] = QDCommand::NEVER_PRESSED;
+
+    uint8_t macAddr[6] = {0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
+    std::optional<QuickdrawCommand> received = decodeQuickdrawPacket(macAddr, wire, sizeof(wire));
+    ASSERT_TRUE(received.has_value());
+    EXPECT_EQ(received->command, QDCommand::NEVER_PRESSED);
+    EXPECT_STREQ(received->matchId, matchId);
+    EXPECT_STREQ(received->playerId, "boun");
+    EXPECT_EQ(received->playerDrawTime, 9999L);
+    EXPECT_FALSE(received->isHunter);
+}
+
+inline void packetParsingNonUuidMatchIdUsesLegacyLayout(PacketParsingTests* suite) {
+    static const char kShootoutId[37] = "SHT-00000000000000000000000000000003";
+    QuickdrawCommand sent(nullptr, QDCommand::DRAW_RESULT, kShootoutId, "hunt", 120, false);
+
+    uint8_t wire[QUICKDRAW_PACKET_MAX_LEN];
+    size_t wireLen = encodeQuickdrawPacket(sent, wire, true);
+    ASSERT_EQ(wireLen, sizeof(QuickdrawPacket));
+
+    uint8_t macAddr[6] = {0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
+    std::optional<QuickdrawCommand> received = decodeQuickdrawPacket(macAddr, wire, wireLen);
+    ASSERT_TRUE(received.has_value());
+    EXPECT_STREQ(received->matchId, kShootoutId);
+    EXPECT_EQ(received->playerDrawTime, 120L);
+}
+
 inline void listenForMatchResultsSetsOpponentTimeHunter(PacketParsingTests* suite) {
     suite->wirelessManager->setPacketReceivedCallback(
         std::bind(&MatchManager::listenForMatchEvents, suite->matchManager, std::placeholders::_1)
@@ -454,6 +521,78 @@ inline void listenForMatchResultsIgnoresUnexpectedCommands(PacketParsingTests* s
     EXPECT_FALSE(suite->matchManager->getHasReceivedDrawResult());
 }
 
+// ============================================
+// Wire format in a fleet of mixed firmware
+// ============================================
+
+class MixedFleetWireTests : public testing::Test {
+public:
+    void SetUp() override {
+        ON_CALL(peerComms, getPeerCommsState()).WillByDefault(Return(PeerCommsState::CONNECTED));
+        ON_CALL(peerComms, sendData(_, PktType::kQuickdrawCommand, _, _))
+            .WillByDefault(Invoke([this](const uint8_t*, PktType, const uint8_t*, size_t length) {
+                sentLengths.push_back(length);
+                return 0;
+            }));
+        deviceWirelessManager = new WirelessManager(&peerComms, &httpClient);
+        quickdrawManager.initialize(&player, deviceWirelessManager, 100);
+    }
+
+    void TearDown() override {
+        delete deviceWirelessManager;
+    }
+
+    void sendDrawResult(const uint8_t* mac) {
+        QuickdrawCommand command(mac, QDCommand::DRAW_RESULT, kMatchId, "hunt", 312, true);
+        quickdrawManager.broadcastPacket(mac, command);
+    }
+
+    static constexpr const char* kMatchId = "123e4567-e89b-12d3-a456-426614174000";
+
+    NiceMock<MockPeerComms> peerComms;
+    NiceMock<MockHttpClient> httpClient;
+    WirelessManager* deviceWirelessManager = nullptr;
+    QuickdrawWirelessManager quickdrawManager;
+    Player player;
+    std::vector<size_t> sentLengths;
+    uint8_t upgradedMac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0A};
+    uint8_t olderMac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0B};
+};
+
+// Older firmware drops anything but sizeof(QuickdrawPacket), so v2 only goes
+// to a peer that has sent v2 itself
+inline void mixedFleetSendsV2OnlyToPeersThatSentIt(MixedFleetWireTests* suite) {
+    suite->sendDrawResult(suite->upgradedMac);
+    suite->sendDrawResult(suite->olderMac);
+    ASSERT_EQ(suite->sentLengths.size(), 2u);
+    EXPECT_EQ(suite->sentLengths[0], sizeof(QuickdrawPacket));
+    EXPECT_EQ(suite->sentLengths[1], sizeof(QuickdrawPacket));
+
+    QuickdrawCommand fromUpgraded(suite->upgradedMac, QDCommand::MATCH_ID_ACK,
+                                  MixedFleetWireTests::kMatchId, "boun", 0, false);
+    uint8_t wire[QUICKDRAW_PACKET_MAX_LEN];
+    size_t wireLen = encodeQuickdrawPacket(fromUpgraded, wire, true);
+    ASSERT_EQ(wireLen, sizeof(QuickdrawPacketV2));
+    EXPECT_EQ(suite->quickdrawManager.processQuickdrawCommand(suite->upgradedMac, wire, wireLen), 1);
+
+    // A legacy packet teaches nothing
+    wireLen = encodeQuickdrawPacket(fromUpgraded, wire);
+    EXPECT_EQ(suite->quickdrawManager.processQuickdrawCommand(suite->olderMac, wire, wireLen), 1);
+
+    suite->sendDrawResult(suite->upgradedMac);
+    suite->sendDrawResult(suite->olderMac);
+    ASSERT_EQ(suite->sentLengths.size(), 4u);
+    EXPECT_EQ(suite->sentLengths[2], sizeof(QuickdrawPacketV2));
+    EXPECT_EQ(suite->sentLengths[3], sizeof(QuickdrawPacket));
+}
+
+inline void mixedFleetCompactFlagSendsV2ToEveryone(MixedFleetWireTests* suite) {
+    suite->quickdrawManager.setCompactWireFormat(true);
+    suite->sendDrawResult(suite->olderMac);
+    ASSERT_EQ(suite->sentLengths.size(), 1u);
+    EXPECT_EQ(suite->sentLengths[0], sizeof(QuickdrawPacketV2));
+}
+
 // ============================================
 // Callback Chain Tests
 // ============================================
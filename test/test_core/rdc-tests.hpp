@@ -533,3 +533,32 @@ inline void rdcDaisyChainCappedAtMaxPeers(RDCTests* suite) {
     EXPECT_GE(state.peerMacAddresses.size(), 2u);
 }
 
+
+// Wire: [id, count, mac(6) * count], decoded back to the same list
+inline void rdcChainAnnouncementCodecRoundTrip(RDCTests* suite) {
+    (void)suite;
+    std::vector<std::array<uint8_t, 6>> peers = {
+        {0x11, 0x11, 0x11, 0x11, 0x11, 0x11},
+        {0x22, 0x22, 0x22, 0x22, 0x22, 0x22},
+        {0x33, 0x33, 0x33, 0x33, 0x33, 0x33},
+    };
+    std::vector<uint8_t> wire = {0xFF, 0xFF};     // replaced, not appended to
+    EXPECT_EQ(encodeChainAnnouncement(9, peers, wire), 2u + 3u * 6u);
+    ASSERT_EQ(wire.size(), 20u);
+    EXPECT_EQ(wire[0], 9);
+    EXPECT_EQ(wire[1], 3);
+    EXPECT_EQ(wire[2 + 6], 0x22);
+
+    const ChainAnnouncementHdr* hdr = decodePacket<PktType::kChainAnnouncement>(wire.data(), wire.size());
+    ASSERT_NE(hdr, nullptr);
+    std::vector<std::array<uint8_t, 6>> decoded(5);
+    decodeChainAnnouncement(*hdr, decoded);
+    EXPECT_EQ(decoded, peers);
+
+    // An empty list still carries the header
+    EXPECT_EQ(encodeChainAnnouncement(10, {}, wire), 2u);
+    hdr = decodePacket<PktType::kChainAnnouncement>(wire.data(), wire.size());
+    ASSERT_NE(hdr, nullptr);
+    decodeChainAnnouncement(*hdr, decoded);
+    EXPECT_TRUE(decoded.empty());
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+#include "wireless/reliable-channel.hpp"
+#include "utility-tests.hpp"
+
+// ============================================
+// ReliableChannel Tests
+// ============================================
+
+class ReliableChannelTests : public testing::Test {
+public:
+    void SetUp() override {
+        SimpleTimer::setPlatformClock(&clock);
+        channel.setRetransmitCallback([this](const uint8_t*, uint8_t seq, uint8_t, uint32_t) {
+            resent.push_back(seq);
+            return acceptRetransmit;
+        });
+        channel.setAbandonCallback([this](const uint8_t*, uint8_t seq, uint8_t, uint32_t) {
+            abandoned.push_back(seq);
+        });
+    }
+
+    void TearDown() override {
+        SimpleTimer::setPlatformClock(nullptr);
+    }
+
+    // Advances the clock and polls once
+    void step(unsigned long ms) {
+        clock.advance(ms);
+        channel.poll();
+    }
+
+    FakePlatformClock clock;
+    ReliableChannel channel;
+    std::vector<uint8_t> resent;
+    std::vector<uint8_t> abandoned;
+    bool acceptRetransmit = true;
+    uint8_t peerA[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0A};
+    uint8_t peerB[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0B};
+};
+
+inline void reliableChannelSequencesArePerPeerAndSkipZero(ReliableChannelTests* suite) {
+    EXPECT_EQ(suite->channel.nextSeq(suite->peerA), 1);
+    EXPECT_EQ(suite->channel.nextSeq(suite->peerA), 2);
+    EXPECT_EQ(suite->channel.nextSeq(suite->peerB), 1);
+
+    for (int i = 3; i <= 255; i++) {
+        suite->channel.nextSeq(suite->peerA);
+    }
+    EXPECT_EQ(suite->channel.nextSeq(suite->peerA), 1);
+}
+
+inline void reliableChannelBacksOffThenAbandons(ReliableChannelTests* suite) {
+    uint8_t seq = suite->channel.track(suite->peerA, 0);
+    EXPECT_EQ(suite->channel.pendingCount(), 1u);
+
+    // Quiet link: 100ms, then 200, 400, 800 before giving up
+    suite->step(100);
+    EXPECT_TRUE(suite->resent.empty());
+    suite->step(1);
+    ASSERT_EQ(suite->resent.size(), 1u);
+    EXPECT_EQ(suite->resent[0], seq);
+
+    suite->step(200);
+    EXPECT_EQ(suite->resent.size(), 1u);
+    suite->step(1);
+    EXPECT_EQ(suite->resent.size(), 2u);
+    suite->step(401);
+    EXPECT_EQ(suite->resent.size(), 3u);
+
+    suite->step(801);
+    EXPECT_EQ(suite->resent.size(), 3u);
+    ASSERT_EQ(suite->abandoned.size(), 1u);
+    EXPECT_EQ(suite->abandoned[0], seq);
+    EXPECT_EQ(suite->channel.pendingCount(), 0u);
+
+    const ReliableChannel::Stats& stats = suite->channel.getStats();
+    EXPECT_EQ(stats.sends, 1u);
+    EXPECT_EQ(stats.retries, 3u);
+    EXPECT_EQ(stats.abandons, 1u);
+}
+
+inline void reliableChannelAckClearsPendingAndRecordsLatency(ReliableChannelTests* suite) {
+    uint8_t seqA = suite->channel.track(suite->peerA, 0);
+    uint8_t seqB = suite->channel.track(suite->peerB, 1);
+
+    suite->clock.advance(30);
+    EXPECT_FALSE(suite->channel.ack(suite->peerA, seqA, 1));   // wrong tag
+    EXPECT_FALSE(suite->channel.ack(suite->peerB, seqA + 1, 1)); // wrong seq
+    EXPECT_TRUE(suite->channel.ack(suite->peerA, seqA, 0));
+    EXPECT_FALSE(suite->channel.ack(suite->peerA, seqA, 0));   // already cleared
+
+    EXPECT_FALSE(suite->channel.isPending(suite->peerA, 0));
+    EXPECT_TRUE(suite->channel.isPending(suite->peerB, 1));
+    EXPECT_EQ(suite->channel.getStats().ackCount, 1u);
+    EXPECT_EQ(suite->channel.getStats().ackLatencyMsSum, 30u);
+
+    suite->step(100);
+    ASSERT_EQ(suite->resent.size(), 1u);
+    EXPECT_EQ(suite->resent[0], seqB);
+}
+
+inline void reliableChannelRtoTracksMeasuredRtt(ReliableChannelTests* suite) {
+    ReliableChannel::Config config;
+    config.minRtoMs = 20;
+    ReliableChannel channel(config);
+
+    EXPECT_EQ(channel.rtoMs(suite->peerA), config.initialRtoMs);
+
+    // Steady 300ms round trips push the RTO past the 100ms default
+    for (int i = 0; i < 8; i++) {
+        uint8_t seq = channel.track(suite->peerA, 0);
+        suite->clock.advance(300);
+        ASSERT_TRUE(channel.ack(suite->peerA, seq, 0));
+    }
+    unsigned long slowRto = channel.rtoMs(suite->peerA);
+    EXPECT_GT(slowRto, 300u);
+    EXPECT_LE(slowRto, config.maxRtoMs);
+
+    // A peer with fast acks settles near its own RTT, bounded below by minRtoMs
+    for (int i = 0; i < 8; i++) {
+        uint8_t seq = channel.track(suite->peerB, 0);
+        suite->clock.advance(5);
+        ASSERT_TRUE(channel.ack(suite->peerB, seq, 0));
+    }
+    EXPECT_LT(channel.rtoMs(suite->peerB), config.initialRtoMs);
+    EXPECT_GE(channel.rtoMs(suite->peerB), config.minRtoMs);
+
+    // Acks for retransmitted entries are ambiguous and don't move the estimate
+    channel.setRetransmitCallback([](const uint8_t*, uint8_t, uint8_t, uint32_t) { return true; });
+    uint8_t seq = channel.track(suite->peerA, 0);
+    suite->clock.advance(slowRto + 1);
+    channel.poll();
+    suite->clock.advance(1500);
+    ASSERT_TRUE(channel.ack(suite->peerA, seq, 0));
+    EXPECT_EQ(channel.rtoMs(suite->peerA), slowRto);
+}
+
+inline void reliableChannelTrackSupersedesSamePeerAndTag(ReliableChannelTests* suite) {
+    suite->channel.track(suite->peerA, 0);
+    uint8_t newer = suite->channel.track(suite->peerA, 0);
+    suite->channel.trackWithSeq(suite->peerA, 9, 1);
+    EXPECT_EQ(suite->channel.pendingCount(), 2u);
+    EXPECT_EQ(suite->channel.pendingCount(0), 1u);
+
+    suite->step(101);
+    ASSERT_EQ(suite->resent.size(), 2u);
+    EXPECT_EQ(suite->resent[0], newer);
+    EXPECT_EQ(suite->resent[1], 9);
+
+    EXPECT_EQ(suite->channel.cancelTag(1), 1u);
+    EXPECT_EQ(suite->channel.pendingCount(), 1u);
+}
+
+inline void reliableChannelDeclinedRetransmitDropsWithoutAbandon(ReliableChannelTests* suite) {
+    suite->acceptRetransmit = false;
+    suite->channel.track(suite->peerA, 0);
+    suite->step(101);
+
+    EXPECT_EQ(suite->resent.size(), 1u);
+    EXPECT_EQ(suite->channel.pendingCount(), 0u);
+    EXPECT_TRUE(suite->abandoned.empty());
+    EXPECT_EQ(suite->channel.getStats().retries, 0u);
+    EXPECT_EQ(suite->channel.getStats().abandons, 0u);
+}
+
+inline void reliableChannelAbandonCallbackMayClear(ReliableChannelTests* suite) {
+    ReliableChannel::Config config;
+    config.maxRetries = 0;
+    ReliableChannel channel(config);
+    int abandons = 0;
+    channel.setAbandonCallback([&](const uint8_t*, uint8_t, uint8_t, uint32_t) {
+        abandons++;
+        channel.clear();
+    });
+    channel.track(suite->peerA, 0);
+    channel.track(suite->peerB, 0);
+
+    suite->clock.advance(101);
+    channel.poll();
+    EXPECT_EQ(abandons, 1);
+    EXPECT_EQ(channel.pendingCount(), 0u);
+}
+
+inline void reliableChannelSeedsRtoFromLinkEstimate(ReliableChannelTests* suite) {
+    std::vector<unsigned long> observed;
+    suite->channel.setRttObserver([&](const uint8_t*, unsigned long rttMs) { observed.push_back(rttMs); });
+    // Another protocol already measured peerA as a slow link
+    suite->channel.setRttSeed([&](const uint8_t* peer, unsigned long& srttMs, unsigned long& rttvarMs) {
+        if (memcmp(peer, suite->peerA, 6) != 0) {
+            return false;
+        }
+        srttMs = 300;
+        rttvarMs = 50;
+        return true;
+    });
+
+    suite->channel.track(suite->peerA, 0);
+    suite->channel.track(suite->peerB, 0);
+    EXPECT_EQ(suite->channel.rtoMs(suite->peerA), 500u);
+    EXPECT_EQ(suite->channel.rtoMs(suite->peerB), 100u);
+
+    // peerB retries at the default RTO, peerA waits out its seeded one
+    suite->step(101);
+    EXPECT_EQ(suite->resent.size(), 1u);
+    suite->channel.cancel(suite->peerB, 0);
+    suite->step(399);
+    EXPECT_EQ(suite->resent.size(), 1u);
+    suite->step(1);
+    EXPECT_EQ(suite->resent.size(), 2u);
+
+    // Only first-transmission samples are reported
+    uint8_t seq = suite->channel.track(suite->peerB, 1);
+    suite->step(20);
+    ASSERT_TRUE(suite->channel.ack(suite->peerB, seq, 1));
+    ASSERT_EQ(observed.size(), 1u);
+    EXPECT_EQ(observed[0], 20u);
+}
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+#include "wireless/send-scheduler.hpp"
+
+// ============================================
+// SendScheduler Tests
+// ============================================
+
+class SendSchedulerTests : public testing::Test {
+public:
+    // Pushes a cluster of `count` frames; ptr encodes (tag, idx) for checks
+    void pushCluster(const uint8_t* dst, SendPriority priority, uint8_t tag, uint8_t count,
+                     unsigned long nowMs, unsigned long maxAgeMs = 0) {
+        pushClusterTo(scheduler, dst, priority, tag, count, nowMs, maxAgeMs);
+    }
+
+    static void pushClusterTo(SendScheduler& target, const uint8_t* dst, SendPriority priority,
+                              uint8_t tag, uint8_t count, unsigned long nowMs, unsigned long maxAgeMs = 0) {
+        for (uint8_t i = 0; i < count; i++) {
+            QueuedFrame frame = {};
+            memcpy(frame.dstMac, dst, sizeof(frame.dstMac));
+            frame.ptr = reinterpret_cast<uint8_t*>(static_cast<uintptr_t>((tag << 8) | i) + 1);
+            frame.len = 10;
+            frame.packetType = PktType::kDebugPacket;
+            frame.priority = priority;
+            frame.idxInCluster = i;
+            frame.enqueuedMs = nowMs;
+            frame.hasDeadline = maxAgeMs > 0;
+            frame.deadlineMs = nowMs + maxAgeMs;
+            ASSERT_TRUE(target.push(frame));
+        }
+    }
+
+    static uint8_t tagOf(const QueuedFrame& frame) {
+        return static_cast<uint8_t>((reinterpret_cast<uintptr_t>(frame.ptr) - 1) >> 8);
+    }
+
+    bool popNext(unsigned long nowMs, QueuedFrame& out) {
+        return scheduler.next(nowMs, out, [this](const QueuedFrame& f) { dropped.push_back(f); });
+    }
+
+    // Sends everything sendable, completing each frame right away
+    std::vector<uint8_t> drain(unsigned long nowMs) {
+        std::vector<uint8_t> order;
+        QueuedFrame frame;
+        QueuedFrame finished;
+        while (popNext(nowMs, frame)) {
+            order.push_back(tagOf(frame));
+            scheduler.onSendDone(frame.dstMac, true, nowMs, finished);
+        }
+        return order;
+    }
+
+    SendScheduler scheduler;
+    std::vector<QueuedFrame> dropped;
+    uint8_t peerA[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0A};
+    uint8_t peerB[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0B};
+    uint8_t peerC[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0C};
+};
+
+inline void sendSchedulerDuelOvertakesBulk(SendSchedulerTests* suite) {
+    suite->pushCluster(suite->peerA, SendPriority::kBulk, 1, 2, 0);
+    suite->pushCluster(suite->peerA, SendPriority::kControl, 2, 1, 1);
+    suite->pushCluster(suite->peerA, SendPriority::kDuel, 3, 1, 2);
+
+    EXPECT_EQ(suite->drain(5), (std::vector<uint8_t>{3, 2, 1, 1}));
+    EXPECT_TRUE(suite->scheduler.empty());
+    EXPECT_EQ(suite->scheduler.getStats().maxQueueDelayMs, 5u);
+}
+
+inline void sendSchedulerDropsExpiredClusterWhole(SendSchedulerTests* suite) {
+    suite->pushCluster(suite->peerA, SendPriority::kControl, 1, 3, 0, 50);
+    suite->pushCluster(suite->peerA, SendPriority::kControl, 2, 1, 0);
+
+    QueuedFrame frame;
+    ASSERT_TRUE(suite->popNext(51, frame));
+    EXPECT_EQ(SendSchedulerTests::tagOf(frame), 2);
+
+    // Every block of the stale cluster is handed back for release
+    ASSERT_EQ(suite->dropped.size(), 3u);
+    for (const auto& d : suite->dropped) {
+        EXPECT_EQ(SendSchedulerTests::tagOf(d), 1);
+    }
+    EXPECT_EQ(suite->scheduler.getStats().expired[1], 3u);
+    SendScheduler::DestinationStats stats;
+    ASSERT_TRUE(suite->scheduler.getDestinationStats(suite->peerA, stats));
+    EXPECT_EQ(stats.expired, 3u);
+    EXPECT_EQ(stats.depth, 0u);
+}
+
+inline void sendSchedulerNeverCutsStartedCluster(SendSchedulerTests* suite) {
+    suite->pushCluster(suite->peerA, SendPriority::kBulk, 1, 3, 0, 50);
+
+    QueuedFrame frame;
+    QueuedFrame finished;
+    ASSERT_TRUE(suite->popNext(10, frame));
+    EXPECT_EQ(frame.idxInCluster, 0);
+    suite->scheduler.onSendDone(suite->peerA, true, 10, finished);
+
+    // Past the deadline, but the cluster is already on air
+    ASSERT_TRUE(suite->popNext(100, frame));
+    EXPECT_EQ(frame.idxInCluster, 1);
+    suite->scheduler.onSendDone(suite->peerA, true, 100, finished);
+    ASSERT_TRUE(suite->popNext(100, frame));
+    EXPECT_EQ(frame.idxInCluster, 2);
+    EXPECT_TRUE(suite->dropped.empty());
+}
+
+inline void sendSchedulerRejectsPushWhenFull(SendSchedulerTests* suite) {
+    for (size_t i = 0; i < SendScheduler::kCapacity; i++) {
+        suite->pushCluster(suite->peerA, SendPriority::kBulk, 1, 1, 0);
+    }
+    QueuedFrame frame = {};
+    memcpy(frame.dstMac, suite->peerB, sizeof(frame.dstMac));
+    frame.priority = SendPriority::kDuel;
+    EXPECT_FALSE(suite->scheduler.push(frame));
+
+    size_t cleared = 0;
+    suite->scheduler.clear([&cleared](const QueuedFrame&) { cleared++; });
+    EXPECT_EQ(cleared, SendScheduler::kCapacity);
+    EXPECT_TRUE(suite->scheduler.empty());
+    EXPECT_TRUE(suite->scheduler.push(frame));
+}
+
+// Drivers push frames they already hold pool blocks for, so a frame to every
+// block's worth of destinations must fit
+inline void sendSchedulerTakesOneFramePerDestinationUpToCapacity(SendSchedulerTests* suite) {
+    for (size_t i = 0; i < SendScheduler::kCapacity; i++) {
+        uint8_t mac[6] = {0x02, 0x5C, 0x00, 0x00, 0x00, static_cast<uint8_t>(i)};
+        suite->pushCluster(mac, SendPriority::kControl, static_cast<uint8_t>(i), 1, 0);
+    }
+    EXPECT_EQ(suite->scheduler.size(), SendScheduler::kCapacity);
+}
+
+inline void sendSchedulerRoundRobinsDestinations(SendSchedulerTests* suite) {
+    suite->pushCluster(suite->peerA, SendPriority::kControl, 1, 3, 0);
+    suite->pushCluster(suite->peerB, SendPriority::kControl, 2, 2, 0);
+    suite->pushCluster(suite->peerC, SendPriority::kControl, 3, 1, 0);
+
+    // One frame per destination may be on air; the rest wait their turn
+    QueuedFrame frames[3];
+    ASSERT_TRUE(suite->popNext(0, frames[0]));
+    ASSERT_TRUE(suite->popNext(0, frames[1]));
+    ASSERT_TRUE(suite->popNext(0, frames[2]));
+    QueuedFrame extra;
+    EXPECT_FALSE(suite->popNext(0, extra));
+    EXPECT_EQ(suite->scheduler.inFlight(), 3u);
+    EXPECT_EQ(SendSchedulerTests::tagOf(frames[0]), 1);
+    EXPECT_EQ(SendSchedulerTests::tagOf(frames[1]), 2);
+    EXPECT_EQ(SendSchedulerTests::tagOf(frames[2]), 3);
+
+    QueuedFrame finished;
+    for (const auto& frame : frames) {
+        ASSERT_TRUE(suite->scheduler.onSendDone(frame.dstMac, true, 1, finished));
+        EXPECT_EQ(finished.ptr, frame.ptr);
+    }
+    EXPECT_EQ(suite->drain(1), (std::vector<uint8_t>{1, 2, 1}));
+}
+
+inline void sendSchedulerBoundsFramesInFlight(SendSchedulerTests* suite) {
+    SendScheduler::Config config;
+    config.maxInFlight = 2;
+    SendScheduler scheduler(config);
+    SendSchedulerTests::pushClusterTo(scheduler, suite->peerA, SendPriority::kControl, 1, 1, 0);
+    SendSchedulerTests::pushClusterTo(scheduler, suite->peerB, SendPriority::kControl, 2, 1, 0);
+    SendSchedulerTests::pushClusterTo(scheduler, suite->peerC, SendPriority::kControl, 3, 1, 0);
+
+    auto ignore = [](const QueuedFrame&) {};
+    QueuedFrame frame;
+    QueuedFrame finished;
+    ASSERT_TRUE(scheduler.next(0, frame, ignore));
+    ASSERT_TRUE(scheduler.next(0, frame, ignore));
+    EXPECT_FALSE(scheduler.next(0, frame, ignore));
+
+    ASSERT_TRUE(scheduler.onSendDone(suite->peerA, true, 1, finished));
+    ASSERT_TRUE(scheduler.next(1, frame, ignore));
+    EXPECT_EQ(SendSchedulerTests::tagOf(frame), 3);
+    EXPECT_EQ(scheduler.getStats().maxInFlight, 2u);
+}
+
+inline void sendSchedulerBacksOffFailedDestination(SendSchedulerTests* suite) {
+    suite->pushCluster(suite->peerA, SendPriority::kDuel, 1, 1, 0);
+    suite->pushCluster(suite->peerB, SendPriority::kBulk, 2, 1, 0);
+
+    QueuedFrame frame;
+    QueuedFrame finished;
+    ASSERT_TRUE(suite->popNext(0, frame));
+    EXPECT_EQ(SendSchedulerTests::tagOf(frame), 1);
+    EXPECT_FALSE(suite->scheduler.onSendDone(suite->peerA, false, 0, finished));
+
+    // A is held off; B's frame goes instead of spinning on A
+    ASSERT_TRUE(suite->popNext(1, frame));
+    EXPECT_EQ(SendSchedulerTests::tagOf(frame), 2);
+    suite->scheduler.onSendDone(suite->peerB, true, 1, finished);
+    EXPECT_FALSE(suite->popNext(1, frame));
+
+    // Retries back off 2, 4, 8, ... ms and then give up
+    const SendScheduler::Config& config = suite->scheduler.getConfig();
+    unsigned long now = 0;
+    unsigned long backoff = config.backoffBaseMs;
+    for (uint8_t attempt = 1; attempt <= config.maxRetries; attempt++) {
+        now += backoff;
+        ASSERT_TRUE(suite->popNext(now, frame)) << "attempt " << (int)attempt;
+        EXPECT_EQ(SendSchedulerTests::tagOf(frame), 1);
+        bool done = suite->scheduler.onSendDone(suite->peerA, false, now, finished);
+        EXPECT_EQ(done, attempt == config.maxRetries);
+        backoff = std::min(backoff * 2, config.backoffMaxMs);
+    }
+    EXPECT_EQ(SendSchedulerTests::tagOf(finished), 1);
+
+    SendScheduler::DestinationStats stats;
+    ASSERT_TRUE(suite->scheduler.getDestinationStats(suite->peerA, stats));
+    EXPECT_EQ(stats.retries, config.maxRetries);
+    EXPECT_EQ(stats.failed, 1u);
+    EXPECT_EQ(stats.delivered, 0u);
+}
+
+inline void sendSchedulerReportsDestinationDepthAndLatency(SendSchedulerTests* suite) {
+    suite->pushCluster(suite->peerA, SendPriority::kControl, 1, 3, 0);
+    suite->pushCluster(suite->peerB, SendPriority::kControl, 2, 1, 0);
+
+    SendScheduler::DestinationStats stats;
+    ASSERT_TRUE(suite->scheduler.getDestinationStats(suite->peerA, stats));
+    EXPECT_EQ(stats.depth, 3u);
+    EXPECT_EQ(stats.maxDepth, 3u);
+
+    QueuedFrame frame;
+    QueuedFrame finished;
+    ASSERT_TRUE(suite->popNext(10, frame));
+    suite->scheduler.onSendDone(suite->peerA, true, 14, finished);
+    suite->drain(20);
+
+    ASSERT_TRUE(suite->scheduler.getDestinationStats(suite->peerA, stats));
+    EXPECT_EQ(stats.depth, 0u);
+    EXPECT_EQ(stats.started, 3u);
+    EXPECT_EQ(stats.delivered, 3u);
+    EXPECT_EQ(stats.queueDelayMsSum, 10u + 20u + 20u);
+    EXPECT_EQ(stats.queueDelayMsMax, 20u);
+    EXPECT_EQ(stats.txLatencyMsMax, 4u);
+
+    size_t seen = 0;
+    suite->scheduler.forEachDestination([&seen](const uint8_t*, const SendScheduler::DestinationStats&) {
+        seen++;
+    });
+    EXPECT_EQ(seen, 2u);
+    EXPECT_FALSE(suite->scheduler.getDestinationStats(suite->peerC, stats));
+}
+
+inline void sendSchedulerDefaultOptionsByPacketType(SendSchedulerTests* suite) {
+    EXPECT_EQ(defaultSendOptions(PktType::kQuickdrawCommand).priority, SendPriority::kDuel);
+    EXPECT_EQ(defaultSendOptions(PktType::kChainGameEvent).priority, SendPriority::kDuel);
+    EXPECT_EQ(defaultSendOptions(PktType::kShootoutCommand).priority, SendPriority::kControl);
+    EXPECT_EQ(defaultSendOptions(PktType::kPlayerInfoBroadcast).priority, SendPriority::kBulk);
+    EXPECT_EQ(defaultSendOptions(PktType::kDebugPacket).maxAgeMs, 0u);
+}
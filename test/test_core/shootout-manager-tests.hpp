@@ -861,3 +861,28 @@ inline void shootoutBracketRevealDebouncesTransientLoopBreak(ShootoutManagerTest
     EXPECT_EQ(suite->shootout->getPhase(), ShootoutManager::Phase::IDLE);
     EXPECT_TRUE(state.transitionToIdle());
 }
+
+inline void bracketCodecRoundTripAndRejectsMalformed(ShootoutManagerTests* suite) {
+    (void)suite;
+    std::vector<std::array<uint8_t, 6>> bracket = {
+        {0x01, 0, 0, 0, 0, 0}, {0x02, 0, 0, 0, 0, 0}, {0x03, 0, 0, 0, 0, 0}, {0x04, 0, 0, 0, 0, 0}
+    };
+    std::vector<uint8_t> wire;
+    ASSERT_EQ(encodeShootoutBracket(7, bracket, wire), sizeof(ShootoutPacket) + 1 + 4 * 6);
+    EXPECT_EQ(wire[0], static_cast<uint8_t>(ShootoutCmd::BRACKET));
+    EXPECT_EQ(wire[1], 7);
+    EXPECT_EQ(wire[2], 4);
+
+    const uint8_t* payload = wire.data() + sizeof(ShootoutPacket);
+    size_t payloadLen = wire.size() - sizeof(ShootoutPacket);
+    std::vector<std::array<uint8_t, 6>> decoded;
+    ASSERT_TRUE(decodeShootoutBracket(payload, payloadLen, decoded));
+    EXPECT_EQ(decoded, bracket);
+
+    // Truncated, empty, and over kMaxBracketSize leave the output alone
+    EXPECT_FALSE(decodeShootoutBracket(payload, payloadLen - 1, decoded));
+    EXPECT_FALSE(decodeShootoutBracket(payload, 0, decoded));
+    uint8_t oversized[1 + 33 * 6] = {33};
+    EXPECT_FALSE(decodeShootoutBracket(oversized, sizeof(oversized), decoded));
+    EXPECT_EQ(decoded, bracket);
+}
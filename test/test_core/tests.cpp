@@ -20,6 +20,21 @@
 #include "chain-duel-multi-device-fixture.hpp"
 #include "shootout-manager-tests.hpp"
 #include "match-manager-concurrent.hpp"
+#include "packet-ring-tests.hpp"
+#include "frame-pool-tests.hpp"
+#include "fragment-reassembly-tests.hpp"
+#include "reliable-channel-tests.hpp"
+#include "send-scheduler-tests.hpp"
+#include "peer-table-tests.hpp"
+#include "link-quality-tests.hpp"
+#include "multicast-group-tests.hpp"
+#include "duplicate-filter-tests.hpp"
+#include "packet-coalescer-tests.hpp"
+#include "bulk-transfer-tests.hpp"
+#include "packet-registry-tests.hpp"
+#include "traffic-stats-tests.hpp"
+#include "alloc-tracker-tests.hpp"
+#include "loop-profiler-tests.hpp"
 
 #if defined(ARDUINO)
 #include <Arduino.h>
@@ -1067,6 +1082,18 @@ TEST_F(PacketParsingTests, rejectsMalformedPacket) {
     packetParsingRejectsMalformedPacket(this);
 }
 
+TEST_F(PacketParsingTests, compactRoundTrip) {
+    packetParsingCompactRoundTrip(this);
+}
+
+TEST_F(PacketParsingTests, acceptsDeviceLegacyLayout) {
+    packetParsingAcceptsDeviceLegacyLayout(this);
+}
+
+TEST_F(PacketParsingTests, nonUuidMatchIdUsesLegacyLayout) {
+    packetParsingNonUuidMatchIdUsesLegacyLayout(this);
+}
+
 TEST_F(PacketParsingTests, listenForMatchResultsSetsOpponentTimeHunter) {
     listenForMatchResultsSetsOpponentTimeHunter(this);
 }
@@ -1083,6 +1110,14 @@ TEST_F(PacketParsingTests, listenForMatchResultsIgnoresUnexpectedCommands) {
     listenForMatchResultsIgnoresUnexpectedCommands(this);
 }
 
+TEST_F(MixedFleetWireTests, sendsV2OnlyToPeersThatSentIt) {
+    mixedFleetSendsV2OnlyToPeersThatSentIt(this);
+}
+
+TEST_F(MixedFleetWireTests, compactFlagSendsV2ToEveryone) {
+    mixedFleetCompactFlagSendsV2ToEveryone(this);
+}
+
 // ============================================
 // QUICKDRAW INTEGRATION TESTS - CALLBACK CHAIN
 // ============================================
@@ -1235,6 +1270,10 @@ TEST_F(RDCTests, daisyChainCappedAtMaxPeers) {
     rdcDaisyChainCappedAtMaxPeers(this);
 }
 
+TEST_F(RDCTests, chainAnnouncementCodecRoundTrip) {
+    rdcChainAnnouncementCodecRoundTrip(this);
+}
+
 TEST_F(RDCTests, disconnectWipesDaisyChainedPeers) {
     rdcDisconnectWipesDaisyChainedPeers(this);
 }
@@ -1459,6 +1498,159 @@ TEST_F(ShootoutManagerTests, isHunterRestoredAfterTournament) { isHunterRestored
 TEST_F(ShootoutManagerTests, localRDCDisconnectIsIdempotent) { localRDCDisconnectIsIdempotent(this); }
 TEST_F(ShootoutManagerTests, shootoutProposalDebouncesTransientLoopBreak) { shootoutProposalDebouncesTransientLoopBreak(this); }
 TEST_F(ShootoutManagerTests, shootoutBracketRevealDebouncesTransientLoopBreak) { shootoutBracketRevealDebouncesTransientLoopBreak(this); }
+TEST_F(ShootoutManagerTests, bracketCodecRoundTripAndRejectsMalformed) { bracketCodecRoundTripAndRejectsMalformed(this); }
+
+// ============================================
+// PACKET RING TESTS
+// ============================================
+
+TEST_F(PacketRingTests, preservesOrderAndPayload) { packetRingPreservesOrderAndPayload(this); }
+TEST_F(PacketRingTests, fullRingCountsOverflow) { packetRingFullCountsOverflow(this); }
+TEST_F(PacketRingTests, oversizedPayloadCountsDrop) { packetRingOversizedPayloadCountsDrop(this); }
+TEST_F(PacketRingTests, wrapsAroundCapacity) { packetRingWrapsAroundCapacity(this); }
+TEST_F(PacketRingTests, concurrentProducerConsumer) { packetRingConcurrentProducerConsumer(this); }
+
+// ============================================
+// FRAME POOL TESTS
+// ============================================
+
+TEST_F(FramePoolTests, acquireReleaseTracksCounts) { framePoolAcquireReleaseTracksCounts(this); }
+TEST_F(FramePoolTests, exhaustionReturnsNull) { framePoolExhaustionReturnsNull(this); }
+TEST_F(FramePoolTests, reserveChecksWholeCluster) { framePoolReserveChecksWholeCluster(this); }
+TEST_F(FramePoolTests, ignoresForeignPointers) { framePoolIgnoresForeignPointers(this); }
+
+// ============================================
+// FRAGMENT REASSEMBLY TESTS
+// ============================================
+
+TEST_F(FragmentReassemblyTests, inOrderClusterCompletes) { reassemblyInOrderClusterCompletes(this); }
+TEST_F(FragmentReassemblyTests, acceptsOutOfOrderFragments) { reassemblyAcceptsOutOfOrderFragments(this); }
+TEST_F(FragmentReassemblyTests, ignoresDuplicateFragments) { reassemblyIgnoresDuplicateFragments(this); }
+TEST_F(FragmentReassemblyTests, evictsStaleClusters) { reassemblyEvictsStaleClusters(this); }
+TEST_F(FragmentReassemblyTests, requestsOnlyMissingIndices) { reassemblyRequestsOnlyMissingIndices(this); }
+TEST_F(FragmentReassemblyTests, rejectsMalformedFragments) { reassemblyRejectsMalformedFragments(this); }
+TEST_F(FragmentReassemblyTests, retransmitCacheMatchesClusterShape) { retransmitCacheMatchesClusterShape(this); }
+TEST_F(FragmentReassemblyTests, placesV2Fragments) { reassemblyPlacesV2Fragments(this); }
+TEST_F(FragmentReassemblyTests, restartsOnFragmentSizeChange) { reassemblyRestartsOnFragmentSizeChange(this); }
+
+// ============================================
+// RELIABLE CHANNEL TESTS
+// ============================================
+
+TEST_F(ReliableChannelTests, sequencesArePerPeerAndSkipZero) { reliableChannelSequencesArePerPeerAndSkipZero(this); }
+TEST_F(ReliableChannelTests, backsOffThenAbandons) { reliableChannelBacksOffThenAbandons(this); }
+TEST_F(ReliableChannelTests, ackClearsPendingAndRecordsLatency) { reliableChannelAckClearsPendingAndRecordsLatency(this); }
+TEST_F(ReliableChannelTests, rtoTracksMeasuredRtt) { reliableChannelRtoTracksMeasuredRtt(this); }
+TEST_F(ReliableChannelTests, trackSupersedesSamePeerAndTag) { reliableChannelTrackSupersedesSamePeerAndTag(this); }
+TEST_F(ReliableChannelTests, declinedRetransmitDropsWithoutAbandon) { reliableChannelDeclinedRetransmitDropsWithoutAbandon(this); }
+TEST_F(ReliableChannelTests, abandonCallbackMayClear) { reliableChannelAbandonCallbackMayClear(this); }
+TEST_F(ReliableChannelTests, seedsRtoFromLinkEstimate) { reliableChannelSeedsRtoFromLinkEstimate(this); }
+
+// ============================================
+// SEND SCHEDULER TESTS
+// ============================================
+
+TEST_F(SendSchedulerTests, duelOvertakesBulk) { sendSchedulerDuelOvertakesBulk(this); }
+TEST_F(SendSchedulerTests, dropsExpiredClusterWhole) { sendSchedulerDropsExpiredClusterWhole(this); }
+TEST_F(SendSchedulerTests, neverCutsStartedCluster) { sendSchedulerNeverCutsStartedCluster(this); }
+TEST_F(SendSchedulerTests, rejectsPushWhenFull) { sendSchedulerRejectsPushWhenFull(this); }
+TEST_F(SendSchedulerTests, takesOneFramePerDestinationUpToCapacity) { sendSchedulerTakesOneFramePerDestinationUpToCapacity(this); }
+TEST_F(SendSchedulerTests, roundRobinsDestinations) { sendSchedulerRoundRobinsDestinations(this); }
+TEST_F(SendSchedulerTests, boundsFramesInFlight) { sendSchedulerBoundsFramesInFlight(this); }
+TEST_F(SendSchedulerTests, backsOffFailedDestination) { sendSchedulerBacksOffFailedDestination(this); }
+TEST_F(SendSchedulerTests, reportsDestinationDepthAndLatency) { sendSchedulerReportsDestinationDepthAndLatency(this); }
+TEST_F(SendSchedulerTests, defaultOptionsByPacketType) { sendSchedulerDefaultOptionsByPacketType(this); }
+
+// ============================================
+// PEER TABLE TESTS
+// ============================================
+
+TEST_F(PeerTableTests, evictsLeastRecentlyUsed) { peerTableEvictsLeastRecentlyUsed(this); }
+TEST_F(PeerTableTests, pinnedPeersSurvive) { peerTablePinnedPeersSurvive(this); }
+TEST_F(PeerTableTests, fullWhenEveryEntryPinned) { peerTableFullWhenEveryEntryPinned(this); }
+TEST_F(PeerTableTests, removeFreesEntry) { peerTableRemoveFreesEntry(this); }
+TEST_F(PeerTableTests, tracksMaxFrameLen) { peerTableTracksMaxFrameLen(this); }
+TEST_F(PeerTableTests, requestsCapsOncePerPeer) { peerTableRequestsCapsOncePerPeer(this); }
+
+// ============================================
+// LINK QUALITY TESTS
+// ============================================
+
+TEST_F(LinkQualityTests, smoothsDeliveryRatio) { linkQualitySmoothsDeliveryRatio(this); }
+TEST_F(LinkQualityTests, smoothsRttAndRssi) { linkQualitySmoothsRttAndRssi(this); }
+TEST_F(LinkQualityTests, replacesLeastRecentlyUpdated) { linkQualityReplacesLeastRecentlyUpdated(this); }
+
+// ============================================
+// MULTICAST GROUP TESTS
+// ============================================
+
+TEST_F(MulticastGroupTests, tagsAreScoped) { multicastGroupTagsAreScoped(this); }
+TEST_F(MulticastGroupTests, filtersByMembership) { multicastGroupFiltersByMembership(this); }
+TEST_F(MulticastGroupTests, joinIsBounded) { multicastGroupJoinIsBounded(this); }
+TEST_F(MulticastSendTests, isOffByDefault) { multicastSendIsOffByDefault(this); }
+
+// ============================================
+// DUPLICATE FILTER TESTS
+// ============================================
+
+TEST_F(DuplicateFilterTests, dropsRepeatsPerSource) { duplicateFilterDropsRepeatsPerSource(this); }
+TEST_F(DuplicateFilterTests, windowAndHoldExpire) { duplicateFilterWindowAndHoldExpire(this); }
+TEST_F(DuplicateFilterTests, boundsStreams) { duplicateFilterBoundsStreams(this); }
+
+// ============================================
+// PACKET COALESCER TESTS
+// ============================================
+
+TEST_F(PacketCoalescerTests, bundlesPerDestination) { packetCoalescerBundlesPerDestination(this); }
+TEST_F(PacketCoalescerTests, refusesWhatItCannotBundle) { packetCoalescerRefusesWhatItCannotBundle(this); }
+TEST_F(PacketCoalescerTests, rejectsMalformedBundles) { packetCoalescerRejectsMalformedBundles(this); }
+
+// ============================================
+// BULK TRANSFER TESTS
+// ============================================
+
+TEST_F(BulkTransferTests, deliversThroughLoss) { bulkTransferDeliversThroughLoss(this); }
+TEST_F(BulkTransferTests, resumesFromReceivedOffset) { bulkTransferResumesFromReceivedOffset(this); }
+TEST_F(BulkTransferTests, refusesBadTransfers) { bulkTransferRefusesBadTransfers(this); }
+
+// ============================================
+// PACKET REGISTRY TESTS
+// ============================================
+
+TEST_F(PacketRegistryTests, decodeChecksLength) { packetRegistryDecodeChecksLength(this); }
+TEST_F(PacketRegistryTests, handlerDropsMalformed) { packetRegistryHandlerDropsMalformed(this); }
+TEST_F(PacketRegistryTests, tableDispatchesByType) { packetRegistryTableDispatchesByType(this); }
+
+// ============================================
+// TRAFFIC STATS TESTS
+// ============================================
+
+TEST_F(TrafficStatsTests, countsPerTypeAndDirection) { trafficStatsCountsPerTypeAndDirection(this); }
+TEST_F(TrafficStatsTests, formatsRowsAndNames) { trafficStatsFormatsRowsAndNames(this); }
+TEST_F(TrafficStatsTests, schedulerNamesFrameOnAir) { trafficStatsSchedulerNamesFrameOnAir(this); }
+
+// ============================================
+// ALLOCATION TRACKER TESTS
+// ============================================
+
+TEST_F(AllocationTrackerTests, scopeCountsNewAndDelete) { allocTrackerScopeCountsNewAndDelete(this); }
+TEST_F(AllocationTrackerTests, regionsNestAndAccumulate) { allocTrackerRegionsNestAndAccumulate(this); }
+TEST_F(AllocationTrackerTests, regionsOverflowIntoOther) { allocTrackerRegionsOverflowIntoOther(this); }
+TEST_F(AllocationTrackerTests, uncountedIsIgnored) { allocTrackerUncountedIsIgnored(this); }
+TEST_F(DuelAllocationBudgetTests, duelTickAllocatesNothing) { duelTickAllocatesNothing(this); }
+TEST_F(DuelAllocationBudgetTests, chainLoopCheckAllocatesNothing) { chainLoopCheckAllocatesNothing(this); }
+
+// ============================================
+// LOOP PROFILER TESTS
+// ============================================
+
+TEST_F(LoopProfilerTests, bucketEdges) { loopProfilerBucketEdges(this); }
+TEST_F(LoopProfilerTests, recordsCountsAndPercentiles) { loopProfilerRecordsCountsAndPercentiles(this); }
+TEST_F(LoopProfilerTests, scopeTimesWithClock) { loopProfilerScopeTimesWithClock(this); }
+TEST_F(LoopProfilerTests, sectionsOverflowIntoOther) { loopProfilerSectionsOverflowIntoOther(this); }
+TEST_F(LoopProfilerTests, formatsRowsAndHistograms) { loopProfilerFormatsRowsAndHistograms(this); }
+TEST_F(LoopProfilerTests, timesEachDriver) { loopProfilerTimesEachDriver(this); }
+TEST_F(LoopProfilerDeviceTests, timesTicksAndStates) { loopProfilerTimesTicksAndStates(this); }
 
 // ============================================
 // MAIN
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include "wireless/traffic-stats.hpp"
+#include "wireless/send-scheduler.hpp"
+
+// ============================================
+// TrafficStats Tests
+// ============================================
+
+class TrafficStatsTests : public testing::Test {
+public:
+    TrafficStats stats;
+};
+
+inline void trafficStatsCountsPerTypeAndDirection(TrafficStatsTests* suite) {
+    suite->stats.reset(1000);
+    suite->stats.recordTx(PktType::kChainAnnouncement, 20, false, 4);
+    suite->stats.recordTx(PktType::kChainAnnouncement, 20, false, 10);
+    suite->stats.recordFailure(TrafficDirection::kTx, PktType::kChainAnnouncement);
+    suite->stats.recordTx(PktType::kPlayerInfoBroadcast, 250, true, 0);
+    suite->stats.recordRx(PktType::kChainAnnouncement, 20, false);
+    suite->stats.recordFailure(TrafficDirection::kRx, PktType::kChainAnnouncement);
+    // Corrupt type bytes are ignored rather than indexing past the table
+    suite->stats.recordRx(static_cast<PktType>(0xF0), 10, false);
+    suite->stats.recordFailure(TrafficDirection::kTx, PktType::kNumPacketTypes);
+
+    TrafficStats::Snapshot snap;
+    suite->stats.snapshot(3000, snap);
+    EXPECT_EQ(snap.sinceMs, 1000u);
+    EXPECT_EQ(snap.takenMs, 3000u);
+
+    const TrafficCounters& announceTx = snap.get(TrafficDirection::kTx, PktType::kChainAnnouncement);
+    EXPECT_EQ(announceTx.frames, 2u);
+    EXPECT_EQ(announceTx.bytes, 40u);
+    EXPECT_EQ(announceTx.failures, 1u);
+    EXPECT_EQ(announceTx.queueDelayMsSum, 14u);
+    EXPECT_EQ(announceTx.queueDelayMsMax, 10u);
+
+    const TrafficCounters& announceRx = snap.get(TrafficDirection::kRx, PktType::kChainAnnouncement);
+    EXPECT_EQ(announceRx.frames, 1u);
+    EXPECT_EQ(announceRx.failures, 1u);
+
+    TrafficCounters tx = snap.total(TrafficDirection::kTx);
+    EXPECT_EQ(tx.frames, 3u);
+    EXPECT_EQ(tx.bytes, 290u);
+    EXPECT_EQ(tx.fragments, 1u);
+    EXPECT_EQ(snap.total(TrafficDirection::kRx).frames, 1u);
+
+    // 192 us preamble plus 8 us per byte of 802.11 overhead and frame
+    TrafficCounters one;
+    one.frames = 1;
+    one.bytes = 100;
+    EXPECT_EQ(estimateAirtimeUs(one), 192u + (43u + 100u) * 8u);
+
+    suite->stats.reset(5000);
+    suite->stats.snapshot(5000, snap);
+    EXPECT_EQ(snap.total(TrafficDirection::kTx).frames, 0u);
+    EXPECT_EQ(snap.sinceMs, 5000u);
+}
+
+inline void trafficStatsFormatsRowsAndNames(TrafficStatsTests* suite) {
+    suite->stats.recordTx(PktType::kRoleAnnounce, 12, false, 3);
+    suite->stats.recordRx(PktType::kRoleAnnounce, 12, false);
+    TrafficStats::Snapshot snap;
+    suite->stats.snapshot(0, snap);
+
+    char row[160];
+    formatTrafficRow(snap, PktType::kRoleAnnounce, row, sizeof(row));
+    EXPECT_EQ(strncmp(row, "RoleAnnounce tx 1f 12B", 22), 0) << row;
+    EXPECT_NE(strstr(row, "rx 1f 12B"), nullptr) << row;
+
+    EXPECT_STREQ(pktTypeName(PktType::kBulkTransfer), "BulkTransfer");
+    EXPECT_STREQ(pktTypeName(PktType::kNumPacketTypes), "?");
+}
+
+inline void trafficStatsSchedulerNamesFrameOnAir(TrafficStatsTests* suite) {
+    (void)suite;
+    SendScheduler scheduler;
+    uint8_t block[16] = {};
+    QueuedFrame frame = {};
+    uint8_t dst[6] = {0x02, 0, 0, 0, 0, 0x01};
+    memcpy(frame.dstMac, dst, sizeof(dst));
+    frame.ptr = block;
+    frame.len = 12;
+    frame.packetType = PktType::kRoleAnnounce;
+    frame.priority = SendPriority::kControl;
+    ASSERT_TRUE(scheduler.push(frame));
+
+    QueuedFrame peeked;
+    EXPECT_FALSE(scheduler.peekOnAir(dst, peeked));
+    QueuedFrame sent;
+    ASSERT_TRUE(scheduler.next(0, sent, [](const QueuedFrame&) {}));
+    ASSERT_TRUE(scheduler.peekOnAir(dst, peeked));
+    EXPECT_EQ(peeked.packetType, PktType::kRoleAnnounce);
+    EXPECT_EQ(peeked.len, 12u);
+
+    QueuedFrame finished;
+    EXPECT_TRUE(scheduler.onSendDone(dst, true, 1, finished));
+    EXPECT_FALSE(scheduler.peekOnAir(dst, peeked));
+}